@@ -15,6 +15,31 @@
         el.textContent = val
     }
 
+    const latencyPhases = ['dns', 'connect', 'tls', 'write', 'firstByte', 'total']
+
+    const renderPublisherLatency = (publishers) => {
+        const list = document.getElementById('publisherLatency')
+        if (!list) return
+        const rows = []
+        Object.keys(publishers || {}).forEach((name) => {
+            const latency = (publishers[name] && publishers[name].latency) || {}
+            latencyPhases.forEach((phase) => {
+                const stats = latency[phase]
+                if (!stats || !stats.count) return
+                rows.push([`${name} · ${phase}`, `${stats.p50} / ${stats.p95} / ${stats.p99} ms (n=${stats.count})`])
+            })
+        })
+        if (!rows.length) return
+        list.replaceChildren()
+        rows.forEach(([label, value]) => {
+            const dt = document.createElement('dt')
+            dt.textContent = label
+            const dd = document.createElement('dd')
+            dd.textContent = value
+            list.append(dt, dd)
+        })
+    }
+
     async function refreshBridgeInfo() {
         if (!hasBridgeInfo()) return
         try {
@@ -30,6 +55,7 @@
             setField('ipAddress', data.ipAddress)
             setField('wifiRSSI', data.wifiRSSI)
             setField('macAddress', data.macAddress)
+            renderPublisherLatency(data.publishers)
         } catch (err) {
             console.warn('Bridge info refresh failed', err)
         }
@@ -14,16 +14,20 @@
         el.textContent = unit ? `${val} ${unit}`.trim() : val
     }
 
-    let lastMeasurementSeconds = null
+    // Local time of the last measurement; the age display counts up from it
+    // between updates.
+    let measurementAt = null
+    let stream = null
+    let pollHandle = null
 
     const updateMeasurementAgeDisplay = () => {
         if (!hasDeviceInfo()) return
-        if (lastMeasurementSeconds === null) {
+        if (measurementAt === null) {
             setField('measurementAge', '—')
             return
         }
-        const translated =
-            typeof portalTranslate === 'function' ? portalTranslate('T_MEASUREMENT_AGE', { seconds: lastMeasurementSeconds }) : null
+        const seconds = ((Date.now() - measurementAt) / 1000).toFixed(1)
+        const translated = typeof portalTranslate === 'function' ? portalTranslate('T_MEASUREMENT_AGE', { seconds }) : null
         if (!translated || translated === 'T_MEASUREMENT_AGE') {
             setField('measurementAge', '—')
         } else {
@@ -31,17 +35,14 @@
         }
     }
 
-    async function refreshDeviceInfo() {
-        if (!hasDeviceInfo()) return
-        try {
-            const resp = await fetch('/device.json', { cache: 'no-store' })
-            if (!resp.ok) throw new Error('bad status')
-            const data = await resp.json()
-            setField('manufacturer', data.manufacturer)
-            setField('model', data.model)
-            setField('firmware', data.firmware)
-            setField('deviceId', data.deviceId)
-            setField('locale', data.locale)
+    // Applies the fields present in data: the whole /device.json document,
+    // or a delta from /device/stream with only what changed.
+    function applyDeviceInfo(data) {
+        const plain = ['manufacturer', 'model', 'firmware', 'deviceId', 'locale', 'batteryVoltage', 'tubeRate', 'tubeDoseRate', 'tubePulseCount']
+        plain.forEach((key) => {
+            if (key in data) setField(key, data[key])
+        })
+        if ('devicePower' in data) {
             const powerLabel =
                 data.devicePower === '1'
                     ? portalTranslate('T_POWER_ON')
@@ -49,26 +50,74 @@
                     ? portalTranslate('T_POWER_OFF')
                     : data.devicePower
             setField('devicePower', powerLabel)
-            setField('batteryVoltage', data.batteryVoltage)
+        }
+        if ('batteryPercent' in data) {
             setField('batteryPercent', data.batteryPercent ? `${data.batteryPercent} %` : data.batteryPercent)
-            setField('tubeRate', data.tubeRate)
-            setField('tubeDoseRate', data.tubeDoseRate)
-            setField('tubePulseCount', data.tubePulseCount)
-            if (data.measurementAgeMs !== null && data.measurementAgeMs !== undefined) {
-                lastMeasurementSeconds = (data.measurementAgeMs / 1000).toFixed(1)
-            } else {
-                lastMeasurementSeconds = null
-            }
+        }
+        if ('measurementAgeMs' in data) {
+            const age = data.measurementAgeMs
+            measurementAt = age !== null && age !== undefined ? Date.now() - age : null
             updateMeasurementAgeDisplay()
+        }
+    }
+
+    async function refreshDeviceInfo() {
+        if (!hasDeviceInfo()) return
+        try {
+            const resp = await fetch('/device.json', { cache: 'no-store' })
+            if (!resp.ok) throw new Error('bad status')
+            applyDeviceInfo(await resp.json())
         } catch (err) {
             console.warn('Device info refresh failed', err)
         }
     }
 
+    function startPolling() {
+        if (pollHandle) return
+        refreshDeviceInfo()
+        pollHandle = setInterval(refreshDeviceInfo, 10000)
+    }
+
+    // The bridge pushes a delta whenever the detector reports a changed
+    // value; EventSource resumes from the last revision after a reconnect.
+    function openStream() {
+        if (typeof window.EventSource !== 'function') {
+            startPolling()
+            return
+        }
+        stream = new EventSource('/device/stream')
+        stream.addEventListener('message', (event) => {
+            try {
+                applyDeviceInfo(JSON.parse(event.data))
+            } catch (err) {
+                console.warn('Device info event ignored', err)
+            }
+        })
+        stream.addEventListener('error', () => {
+            // CLOSED means the bridge refused the stream (all slots busy).
+            if (stream && stream.readyState === EventSource.CLOSED) {
+                stream.close()
+                stream = null
+                startPolling()
+            }
+        })
+    }
+
     document.addEventListener('portal-locale-ready', updateMeasurementAgeDisplay)
     document.addEventListener('DOMContentLoaded', () => {
         if (!hasDeviceInfo()) return
-        refreshDeviceInfo()
-        setInterval(refreshDeviceInfo, 10000)
+        openStream()
+        setInterval(updateMeasurementAgeDisplay, 1000)
+    })
+    // A hidden tab gives its stream slot back; the new stream starts with
+    // every field.
+    document.addEventListener('visibilitychange', () => {
+        if (!hasDeviceInfo() || pollHandle) return
+        if (document.hidden) {
+            if (stream) stream.close()
+            stream = null
+        } else if (!stream) {
+            openStream()
+        }
     })
 })()
@@ -15,6 +15,12 @@
     let refreshHandle = null
     let isFetching = false
     let lastSeenId = 0
+    // Full "<boot>-<id>" event id, so a stream reopened after a reboot starts
+    // over instead of skipping the new boot's first lines.
+    let lastEventId = ''
+    let stream = null
+    // Set once the stream endpoint failed; the page then polls /logs.json.
+    let pollOnly = typeof window.EventSource !== 'function'
 
     function lineCountLimit(payload) {
         if (payload && Number.isFinite(payload.count) && payload.count > 0) return payload.count
@@ -79,6 +85,50 @@
         }
     }
 
+    function openStream() {
+        if (stream || document.hidden) return
+        const url = lastEventId ? `/logs/stream?after=${encodeURIComponent(lastEventId)}` : '/logs/stream'
+        stream = new EventSource(url)
+        stream.addEventListener('open', () => {
+            setStatus('T_LOG_STATUS_STREAMING', { time: new Date().toLocaleTimeString() })
+        })
+        stream.addEventListener('reset', () => {
+            consoleEl.innerHTML = ''
+        })
+        stream.addEventListener('message', (event) => {
+            append([event.data], lineCountLimit())
+            const id = Number(String(event.lastEventId).split('-').pop())
+            if (Number.isFinite(id) && id > 0) {
+                lastSeenId = id
+                lastEventId = event.lastEventId
+            }
+        })
+        stream.addEventListener('error', () => {
+            // EventSource retries on its own while CONNECTING; CLOSED means
+            // the bridge refused the stream (e.g. all slots busy).
+            if (stream && stream.readyState === EventSource.CLOSED) {
+                closeStream()
+                pollOnly = true
+                setStatus('T_LOG_STATUS_ERROR', {}, true)
+                fetchLogs()
+            }
+        })
+    }
+
+    function closeStream() {
+        if (!stream) return
+        stream.close()
+        stream = null
+    }
+
+    function start() {
+        if (pollOnly) {
+            fetchLogs()
+        } else {
+            openStream()
+        }
+    }
+
     function fetchLogs() {
         if (isFetching) return
         isFetching = true
@@ -156,7 +206,8 @@
     if (clearBtn) {
         clearBtn.addEventListener('click', () => {
             consoleEl.innerHTML = ''
-            lastSeenId = 0
+            // The stream only sends new lines; polling starts over.
+            if (pollOnly) lastSeenId = 0
             setStatus('T_LOG_STATUS_CLEARED')
         })
     }
@@ -167,11 +218,12 @@
                 clearTimeout(refreshHandle)
             }
             refreshHandle = null
+            closeStream()
         } else {
-            fetchLogs()
+            start()
         }
     })
 
     setStatus('T_LOG_STATUS_IDLE')
-    fetchLogs()
+    start()
 })()
@@ -155,7 +155,7 @@
 
     function loadLocale(locale, isFallback) {
         locale = normalizeLocale(locale, 'en')
-        return fetch(`/portal/locales/${locale}.json`, { cache: 'no-store' })
+        return fetch(`/portal/locales/${locale}.json`, { cache: 'no-cache' })
             .then((resp) => {
                 if (!resp.ok) throw new Error(`HTTP ${resp.status}`)
                 return resp.json()
@@ -42,6 +42,22 @@ bool AppConfigStore::load(AppConfig &cfg)
     cfg.mqttFullTopic = prefs_.getString("mqttFullTopic", cfg.mqttFullTopic);
     cfg.mqttFullTopic.trim();
 
+    cfg.mqttTlsEnabled = prefs_.getBool("mqttTls", cfg.mqttTlsEnabled);
+    cfg.mqttTlsCaCert = prefs_.getString("mqttTlsCa", cfg.mqttTlsCaCert);
+    cfg.mqttTlsFingerprint = prefs_.getString("mqttTlsFp", cfg.mqttTlsFingerprint);
+    cfg.mqttAggregateState = prefs_.getBool("mqttAggState", cfg.mqttAggregateState);
+    cfg.mqttDeviceDiscovery = prefs_.getBool("mqttDevDisc", cfg.mqttDeviceDiscovery);
+    cfg.mqttControlEnabled = prefs_.getBool("mqttCmnd", cfg.mqttControlEnabled);
+    cfg.mqttBinaryState = prefs_.getBool("mqttBinary", cfg.mqttBinaryState);
+    cfg.mqttQueueEnabled = prefs_.getBool("mqttQos1", cfg.mqttQueueEnabled);
+    cfg.mqttSpoolEnabled = prefs_.getBool("mqttSpool", cfg.mqttSpoolEnabled);
+    cfg.mqttReplayPerSecond = prefs_.getUInt("mqttReplay", cfg.mqttReplayPerSecond);
+    cfg.mqttDeadbandEnabled = prefs_.getBool("mqttDeadband", cfg.mqttDeadbandEnabled);
+    cfg.mqttRateDeadband = prefs_.getString("mqttDbRate", cfg.mqttRateDeadband);
+    cfg.mqttCountDeadband = prefs_.getString("mqttDbCount", cfg.mqttCountDeadband);
+    cfg.mqttBatteryDeadband = prefs_.getString("mqttDbBatt", cfg.mqttBatteryDeadband);
+    cfg.mqttHeartbeatSeconds = prefs_.getUInt("mqttHeartbeat", cfg.mqttHeartbeatSeconds);
+
     cfg.readIntervalMs = prefs_.getUInt("readInterval", cfg.readIntervalMs);
 
     cfg.openSenseMapEnabled = prefs_.getBool("osemEnabled", cfg.openSenseMapEnabled);
@@ -100,17 +116,41 @@ bool AppConfigStore::load(AppConfig &cfg)
     cfg.safecastUnit.trim();
     cfg.safecastUploadIntervalSeconds = prefs_.getUInt("scUpInt", cfg.safecastUploadIntervalSeconds);
     cfg.safecastDebug = prefs_.getBool("scDebug", cfg.safecastDebug);
+    cfg.influxEnabled = prefs_.getBool("ifxEnabled", cfg.influxEnabled);
+    cfg.influxUrl = prefs_.getString("ifxUrl", cfg.influxUrl);
+    cfg.influxUrl.trim();
+    cfg.influxToken = prefs_.getString("ifxToken", cfg.influxToken);
+    cfg.influxToken.trim();
+    cfg.influxMeasurement = prefs_.getString("ifxMeas", cfg.influxMeasurement);
+    cfg.influxMeasurement.trim();
+    cfg.influxPointIntervalSeconds = prefs_.getUInt("ifxPointSec", cfg.influxPointIntervalSeconds);
+    cfg.influxBatchPoints = prefs_.getUInt("ifxBatch", cfg.influxBatchPoints);
+    cfg.influxFlushSeconds = prefs_.getUInt("ifxFlushSec", cfg.influxFlushSeconds);
+    cfg.influxGzip = prefs_.getBool("ifxGzip", cfg.influxGzip);
+    cfg.logFileEnabled = prefs_.getBool("logFile", cfg.logFileEnabled);
 
     prefs_.end();
 
     if (cfg.readIntervalMs < kMinReadIntervalMs)
         cfg.readIntervalMs = kMinReadIntervalMs;
+    if (cfg.mqttReplayPerSecond < kMinMqttReplayPerSecond || cfg.mqttReplayPerSecond > kMaxMqttReplayPerSecond)
+        cfg.mqttReplayPerSecond = kDefaultMqttReplayPerSecond;
+    if (cfg.mqttHeartbeatSeconds < kMinMqttHeartbeatSeconds || cfg.mqttHeartbeatSeconds > kMaxMqttHeartbeatSeconds)
+        cfg.mqttHeartbeatSeconds = kDefaultMqttHeartbeatSeconds;
     if (!cfg.safecastApiBaseUrl.length())
         cfg.safecastApiBaseUrl = "https://api.safecast.org";
     if (!cfg.safecastUnit.length())
         cfg.safecastUnit = "cpm";
     if (cfg.safecastUploadIntervalSeconds < kMinSafecastUploadIntervalSeconds)
         cfg.safecastUploadIntervalSeconds = kDefaultSafecastUploadIntervalSeconds;
+    if (!cfg.influxMeasurement.length())
+        cfg.influxMeasurement = "radpro";
+    if (cfg.influxPointIntervalSeconds < kMinInfluxPointIntervalSeconds)
+        cfg.influxPointIntervalSeconds = kDefaultInfluxPointIntervalSeconds;
+    if (cfg.influxBatchPoints < kMinInfluxBatchPoints || cfg.influxBatchPoints > kMaxInfluxBatchPoints)
+        cfg.influxBatchPoints = kDefaultInfluxBatchPoints;
+    if (cfg.influxFlushSeconds < kMinInfluxFlushSeconds || cfg.influxFlushSeconds > kMaxInfluxFlushSeconds)
+        cfg.influxFlushSeconds = kDefaultInfluxFlushSeconds;
 
     return true;
 }
@@ -131,6 +171,21 @@ bool AppConfigStore::save(const AppConfig &cfg)
     prefs_.putString("mqttPass", cfg.mqttPassword);
     prefs_.putString("mqttTopic", cfg.mqttTopic);
     prefs_.putString("mqttFullTopic", cfg.mqttFullTopic);
+    prefs_.putBool("mqttTls", cfg.mqttTlsEnabled);
+    prefs_.putString("mqttTlsCa", cfg.mqttTlsCaCert);
+    prefs_.putString("mqttTlsFp", cfg.mqttTlsFingerprint);
+    prefs_.putBool("mqttAggState", cfg.mqttAggregateState);
+    prefs_.putBool("mqttDevDisc", cfg.mqttDeviceDiscovery);
+    prefs_.putBool("mqttCmnd", cfg.mqttControlEnabled);
+    prefs_.putBool("mqttBinary", cfg.mqttBinaryState);
+    prefs_.putBool("mqttQos1", cfg.mqttQueueEnabled);
+    prefs_.putBool("mqttSpool", cfg.mqttSpoolEnabled);
+    prefs_.putUInt("mqttReplay", cfg.mqttReplayPerSecond);
+    prefs_.putBool("mqttDeadband", cfg.mqttDeadbandEnabled);
+    prefs_.putString("mqttDbRate", cfg.mqttRateDeadband);
+    prefs_.putString("mqttDbCount", cfg.mqttCountDeadband);
+    prefs_.putString("mqttDbBatt", cfg.mqttBatteryDeadband);
+    prefs_.putUInt("mqttHeartbeat", cfg.mqttHeartbeatSeconds);
     prefs_.putUInt("readInterval", cfg.readIntervalMs);
     prefs_.putBool("osemEnabled", cfg.openSenseMapEnabled);
     prefs_.putString("osemBoxId", cfg.openSenseBoxId);
@@ -167,6 +222,15 @@ bool AppConfigStore::save(const AppConfig &cfg)
     prefs_.putString("scUnit", cfg.safecastUnit);
     prefs_.putUInt("scUpInt", cfg.safecastUploadIntervalSeconds);
     prefs_.putBool("scDebug", cfg.safecastDebug);
+    prefs_.putBool("ifxEnabled", cfg.influxEnabled);
+    prefs_.putString("ifxUrl", cfg.influxUrl);
+    prefs_.putString("ifxToken", cfg.influxToken);
+    prefs_.putString("ifxMeas", cfg.influxMeasurement);
+    prefs_.putUInt("ifxPointSec", cfg.influxPointIntervalSeconds);
+    prefs_.putUInt("ifxBatch", cfg.influxBatchPoints);
+    prefs_.putUInt("ifxFlushSec", cfg.influxFlushSeconds);
+    prefs_.putBool("ifxGzip", cfg.influxGzip);
+    prefs_.putBool("logFile", cfg.logFileEnabled);
 
     prefs_.end();
     return true;
@@ -19,6 +19,15 @@ constexpr size_t kMqttTopicParamLen = 64;
 constexpr size_t kMqttFullTopicParamLen = 64;
 constexpr size_t kReadIntervalParamLen = 12;
 constexpr size_t kMqttPortParamLen = 6;
+constexpr uint32_t kMinMqttReplayPerSecond = 1;
+constexpr uint32_t kMaxMqttReplayPerSecond = 50;
+constexpr uint32_t kDefaultMqttReplayPerSecond = 10;
+constexpr size_t kMqttDeadbandParamLen = 12;
+constexpr size_t kMqttTlsCaCertLen = 4000;
+constexpr size_t kMqttTlsFingerprintLen = 95;
+constexpr uint32_t kMinMqttHeartbeatSeconds = 10;
+constexpr uint32_t kMaxMqttHeartbeatSeconds = 86400;
+constexpr uint32_t kDefaultMqttHeartbeatSeconds = 300;
 constexpr size_t kOsemBoxIdLen = 64;
 constexpr size_t kOsemApiKeyLen = 80;
 constexpr size_t kOsemSensorIdLen = 64;
@@ -36,6 +45,17 @@ constexpr size_t kSafecastHeightLen = 16;
 constexpr size_t kSafecastLocationNameLen = 80;
 constexpr uint32_t kMinSafecastUploadIntervalSeconds = 60;
 constexpr uint32_t kDefaultSafecastUploadIntervalSeconds = 300;
+constexpr size_t kInfluxUrlLen = 192;
+constexpr size_t kInfluxTokenLen = 128;
+constexpr size_t kInfluxMeasurementLen = 32;
+constexpr uint32_t kMinInfluxPointIntervalSeconds = 1;
+constexpr uint32_t kDefaultInfluxPointIntervalSeconds = 10;
+constexpr uint32_t kMinInfluxBatchPoints = 1;
+constexpr uint32_t kMaxInfluxBatchPoints = 60;
+constexpr uint32_t kDefaultInfluxBatchPoints = 6;
+constexpr uint32_t kMinInfluxFlushSeconds = 5;
+constexpr uint32_t kMaxInfluxFlushSeconds = 3600;
+constexpr uint32_t kDefaultInfluxFlushSeconds = 60;
 
 struct AppConfig
 {
@@ -48,6 +68,21 @@ struct AppConfig
     String mqttPassword;
     String mqttTopic = "radpro/%deviceid%";
     String mqttFullTopic = "%prefix%/%topic%/";
+    bool mqttTlsEnabled = false;
+    String mqttTlsCaCert;
+    String mqttTlsFingerprint;
+    bool mqttAggregateState = false;
+    bool mqttBinaryState = false;
+    bool mqttDeviceDiscovery = false;
+    bool mqttControlEnabled = false;
+    bool mqttQueueEnabled = false;
+    bool mqttSpoolEnabled = false;
+    uint32_t mqttReplayPerSecond = kDefaultMqttReplayPerSecond;
+    bool mqttDeadbandEnabled = false;
+    String mqttRateDeadband = "5%";
+    String mqttCountDeadband = "10";
+    String mqttBatteryDeadband = "0.05";
+    uint32_t mqttHeartbeatSeconds = kDefaultMqttHeartbeatSeconds;
     uint32_t readIntervalMs = 1000;
     bool openSenseMapEnabled = false;
     String openSenseBoxId;
@@ -84,6 +119,15 @@ struct AppConfig
     String safecastUnit = "cpm";
     uint32_t safecastUploadIntervalSeconds = kDefaultSafecastUploadIntervalSeconds;
     bool safecastDebug = false;
+    bool influxEnabled = false;
+    String influxUrl;
+    String influxToken;
+    String influxMeasurement = "radpro";
+    uint32_t influxPointIntervalSeconds = kDefaultInfluxPointIntervalSeconds;
+    uint32_t influxBatchPoints = kDefaultInfluxBatchPoints;
+    uint32_t influxFlushSeconds = kDefaultInfluxFlushSeconds;
+    bool influxGzip = true;
+    bool logFileEnabled = false;
 };
 
 inline bool UpdateStringIfChanged(String &target, const char *value)
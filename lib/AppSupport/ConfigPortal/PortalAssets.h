@@ -0,0 +1,147 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+// HTTP caching for the portal's scripts, styles and locales.
+// tools/compress_portal_assets.py stores a .gz copy of each asset in
+// LittleFS and lists them in kManifestPath, one "<hash> <path>" line each,
+// the hash being the first kHashChars hex digits of the SHA-256 of the
+// original. The hash becomes a strong ETag ("<hash>" or "<hash>-gz" for
+// the compressed copy) and, because the compiled pages link assets as
+// <path>?v=<hash>, decides whether a request may be cached for good.
+namespace PortalAssets
+{
+    constexpr const char *kManifestPath = "/portal/assets.sha";
+    constexpr size_t kHashChars = 16;
+    // "<hash>-gz" in quotes plus the terminator.
+    constexpr size_t kEtagBytes = kHashChars + 6;
+
+    constexpr const char *kImmutableCacheControl = "public, max-age=31536000, immutable";
+    // Unversioned URLs may change under the same name: revalidate each time.
+    constexpr const char *kRevalidateCacheControl = "no-cache";
+
+    // Looks path up in the manifest text and copies its hash into hash.
+    inline bool findHash(const char *manifest, size_t length, const char *path, char (&hash)[kHashChars + 1])
+    {
+        if (!manifest || !path)
+            return false;
+        const size_t pathLength = std::strlen(path);
+        const char *end = manifest + length;
+        for (const char *line = manifest; line < end;)
+        {
+            const char *lineEnd = static_cast<const char *>(std::memchr(line, '\n', static_cast<size_t>(end - line)));
+            if (!lineEnd)
+                lineEnd = end;
+            size_t lineLength = static_cast<size_t>(lineEnd - line);
+            if (lineLength && line[lineLength - 1] == '\r')
+                --lineLength;
+            if (lineLength == kHashChars + 1 + pathLength && line[kHashChars] == ' ' &&
+                std::memcmp(line + kHashChars + 1, path, pathLength) == 0)
+            {
+                std::memcpy(hash, line, kHashChars);
+                hash[kHashChars] = '\0';
+                return true;
+            }
+            line = lineEnd + 1;
+        }
+        return false;
+    }
+
+    inline void formatEtag(const char *hash, bool gzip, char (&out)[kEtagBytes])
+    {
+        size_t used = 0;
+        out[used++] = '"';
+        const size_t hashLength = std::strlen(hash) < kHashChars ? std::strlen(hash) : kHashChars;
+        std::memcpy(out + used, hash, hashLength);
+        used += hashLength;
+        if (gzip)
+        {
+            std::memcpy(out + used, "-gz", 3);
+            used += 3;
+        }
+        out[used++] = '"';
+        out[used] = '\0';
+    }
+
+    namespace detail
+    {
+        inline bool isSpace(char c) { return c == ' ' || c == '\t'; }
+
+        // Calls visit(item, length) for each comma-separated item, trimmed;
+        // stops early when visit returns true.
+        template <typename Visit>
+        bool anyItem(const char *list, Visit &&visit)
+        {
+            if (!list)
+                return false;
+            const char *p = list;
+            while (*p)
+            {
+                while (isSpace(*p) || *p == ',')
+                    ++p;
+                const char *start = p;
+                // Entity tags are quoted and may contain commas.
+                bool quoted = false;
+                while (*p && (quoted || *p != ','))
+                {
+                    if (*p == '"')
+                        quoted = !quoted;
+                    ++p;
+                }
+                const char *stop = p;
+                while (stop > start && isSpace(stop[-1]))
+                    --stop;
+                if (stop > start && visit(start, static_cast<size_t>(stop - start)))
+                    return true;
+            }
+            return false;
+        }
+    } // namespace detail
+
+    // If-None-Match uses the weak comparison: a W/ prefix is ignored, and
+    // "*" matches any current representation.
+    inline bool etagMatches(const char *ifNoneMatch, const char *etag)
+    {
+        if (!etag || !*etag)
+            return false;
+        const size_t etagLength = std::strlen(etag);
+        return detail::anyItem(ifNoneMatch, [&](const char *item, size_t length) {
+            if (length == 1 && item[0] == '*')
+                return true;
+            if (length > 2 && (item[0] == 'W' || item[0] == 'w') && item[1] == '/')
+            {
+                item += 2;
+                length -= 2;
+            }
+            return length == etagLength && std::memcmp(item, etag, length) == 0;
+        });
+    }
+
+    // True when Accept-Encoding lists gzip (or x-gzip) without q=0.
+    inline bool acceptsGzip(const char *acceptEncoding)
+    {
+        return detail::anyItem(acceptEncoding, [](const char *item, size_t length) {
+            size_t name = 0;
+            while (name < length && item[name] != ';' && !detail::isSpace(item[name]))
+                ++name;
+            const bool gzip = (name == 4 && std::strncmp(item, "gzip", 4) == 0) ||
+                              (name == 6 && std::strncmp(item, "x-gzip", 6) == 0);
+            if (!gzip)
+                return false;
+            for (size_t i = name; i + 2 < length; ++i)
+            {
+                if ((item[i] == 'q' || item[i] == 'Q') && item[i + 1] == '=')
+                    return std::strtod(item + i + 2, nullptr) > 0.0;
+            }
+            return true;
+        });
+    }
+} // namespace PortalAssets
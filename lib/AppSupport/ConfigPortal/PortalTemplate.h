@@ -0,0 +1,171 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Portal pages compiled at build time by tools/compile_portal_templates.py.
+// Each page is one flash-resident string holding only its literal text plus
+// a segment list: a segment is either a run of that text or the index of a
+// {{PLACEHOLDER}} in the page's field table. render() walks the list and
+// hands the output to a sink in pieces, so a page view never holds the
+// page in RAM.
+//
+// Values are HTML-escaped unless the page marks the slot as raw markup with
+// triple braces, {{{PLACEHOLDER}}}.
+namespace PortalTemplate
+{
+    constexpr int16_t kLiteral = -1;
+
+    struct Segment
+    {
+        uint32_t offset;
+        uint16_t length;
+        // kLiteral, or an index into Template::fields.
+        int16_t field;
+        // {{{PLACEHOLDER}}}: the value is markup and goes out unescaped.
+        bool raw;
+    };
+
+    struct Template
+    {
+        const char *path;
+        // PortalAssets hash of the source page; differs from the LittleFS
+        // manifest entry once the filesystem carries a newer page.
+        const char *sourceHash;
+        const char *text;
+        const Segment *segments;
+        size_t segmentCount;
+        // Placeholder names including the braces, e.g. "{{LOCALE}}".
+        const char *const *fields;
+        size_t fieldCount;
+    };
+
+    inline const Template *find(const Template *templates, size_t count, const char *path)
+    {
+        if (!templates || !path)
+            return nullptr;
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (std::strcmp(templates[i].path, path) == 0)
+                return &templates[i];
+        }
+        return nullptr;
+    }
+
+    // Coalesces small writes into one buffer so the sink (a chunked HTTP
+    // response) sees a few large pieces; anything at least as large as the
+    // buffer goes straight through, which lets literal text stream from
+    // flash without a copy.
+    template <typename Sink, size_t BufferBytes>
+    class Writer
+    {
+    public:
+        explicit Writer(Sink &sink) : sink_(sink) {}
+
+        void write(const char *data, size_t length)
+        {
+            if (!length)
+                return;
+            if (length >= BufferBytes)
+            {
+                flush();
+                sink_(data, length);
+                return;
+            }
+            if (BufferBytes - used_ < length)
+                flush();
+            std::memcpy(buffer_ + used_, data, length);
+            used_ += length;
+        }
+
+        void flush()
+        {
+            if (!used_)
+                return;
+            sink_(buffer_, used_);
+            used_ = 0;
+        }
+
+    private:
+        Sink &sink_;
+        char buffer_[BufferBytes];
+        size_t used_ = 0;
+    };
+
+    // The entity replacing c in HTML text and attribute values, or nullptr.
+    inline const char *htmlEntity(char c)
+    {
+        switch (c)
+        {
+        case '&':
+            return "&amp;";
+        case '<':
+            return "&lt;";
+        case '>':
+            return "&gt;";
+        case '"':
+            return "&quot;";
+        case '\'':
+            return "&#39;";
+        default:
+            return nullptr;
+        }
+    }
+
+    template <typename Writer>
+    void writeEscaped(Writer &writer, const char *value, size_t length)
+    {
+        size_t run = 0;
+        for (size_t i = 0; i < length; ++i)
+        {
+            const char *entity = htmlEntity(value[i]);
+            if (!entity)
+                continue;
+            writer.write(value + run, i - run);
+            writer.write(entity, std::strlen(entity));
+            run = i + 1;
+        }
+        writer.write(value + run, length - run);
+    }
+
+    // Streams page through sink(data, length). resolve(name, value, length)
+    // looks up a placeholder (by its {{NAME}} form, also for raw slots) and
+    // returns false if the caller has no value; the placeholder is then
+    // written as is, like the String::replace rendering it replaces.
+    template <size_t BufferBytes = 256, typename Resolve, typename Sink>
+    void render(const Template &page, Resolve &&resolve, Sink &&sink)
+    {
+        Writer<Sink, BufferBytes> writer(sink);
+        for (size_t i = 0; i < page.segmentCount; ++i)
+        {
+            const Segment &segment = page.segments[i];
+            if (segment.field == kLiteral)
+            {
+                writer.write(page.text + segment.offset, segment.length);
+                continue;
+            }
+            if (segment.field < 0 || static_cast<size_t>(segment.field) >= page.fieldCount)
+                continue;
+            const char *name = page.fields[segment.field];
+            const char *value = nullptr;
+            size_t length = 0;
+            if (resolve(name, value, length))
+            {
+                if (segment.raw)
+                    writer.write(value, length);
+                else
+                    writeEscaped(writer, value, length);
+            }
+            else
+                writer.write(name, std::strlen(name));
+        }
+        writer.flush();
+    }
+} // namespace PortalTemplate
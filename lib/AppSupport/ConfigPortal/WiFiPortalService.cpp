@@ -4,7 +4,9 @@
 
 #include "ConfigPortal/WiFiPortalService.h"
 
+#include "ConfigPortal/PortalAssets.h"
 #include "ConfigPortal/PortalSecurity.h"
+#include "ConfigPortal/PortalTemplate.h"
 #include "FileSystem/BridgeFileSystem.h"
 #include "Ota/OtaUpdateService.h"
 #include "Mqtt/MqttPublisher.h"
@@ -17,6 +19,8 @@
 #include "OpenRadiation/OpenRadiationPortalView.h"
 #include "OpenRadiation/OpenRadiationProtocol.h"
 #include "Radmon/RadmonPublisher.h"
+#include "Influx/InfluxBackupJson.h"
+#include "Influx/InfluxPublisher.h"
 #include "Safecast/SafecastBackupJson.h"
 #include "Safecast/SafecastConfig.h"
 #include "Safecast/SafecastLogRedaction.h"
@@ -24,7 +28,21 @@
 #include "Safecast/SafecastProtocol.h"
 #include "Safecast/SafecastPublisher.h"
 #include "Logging/LogCursorWindow.h"
+#include "Logging/LogEventStream.h"
+#include "Logging/LogFileWriter.h"
+#include "Logging/LogJsonChunk.h"
+
+// Written into the build directory by tools/compile_portal_templates.py;
+// without it pages are read from LittleFS as before.
+#if defined(__has_include)
+#if __has_include("PortalTemplates.generated.h")
+#include "PortalTemplates.generated.h"
+#define HAS_COMPILED_PORTAL_TEMPLATES 1
+#endif
+#endif
 #include "Publishing/HttpPublishResponse.h"
+#include "Publishing/NumberFormat.h"
+#include "Runtime/AppStateLock.h"
 
 #include <Arduino.h>
 #include <WiFiClientSecure.h>
@@ -239,6 +257,16 @@ String formatSafecastResultHtml(const SafecastPublisher::UploadResult &result)
     html += "</pre></div>";
     return html;
 }
+
+// One pass renders at most this much per stream client, so a large backlog
+// is sent over several portal loop iterations.
+constexpr size_t kLogStreamChunkBytes = 1024;
+constexpr unsigned long kLogStreamKeepAliveMs = 15000;
+// Holds at least one fully escaped line.
+constexpr size_t kLogJsonChunkBytes = 2048;
+// Coalescing buffer for compiled templates; larger runs bypass it.
+constexpr size_t kTemplateChunkBytes = 512;
+static_assert(kLogJsonChunkBytes >= LogJsonChunk::kMaxLineBytes, "log JSON chunk must fit one line");
 } // namespace
 
 WiFiPortalService::WiFiPortalService(AppConfig &config,
@@ -246,16 +274,18 @@ WiFiPortalService::WiFiPortalService(AppConfig &config,
                                      DeviceInfoStore &info,
                                      DebugLogStream &logPort,
                                      LedController &led,
+                                     const PublisherHealth &mqttHealth,
                                      const PublisherHealth &openSenseMapHealth,
                                      const PublisherHealth &gmcMapHealth,
                                      const PublisherHealth &radmonHealth,
                                      const PublisherHealth &openRadiationHealth,
-                                     const PublisherHealth &safecastHealth)
+                                     const PublisherHealth &safecastHealth,
+                                     const PublisherHealth &influxHealth)
     : config_(config),
       store_(store),
       deviceInfo_(info),
       deviceInfoPage_(info),
-      bridgeInfoPage_(openSenseMapHealth, gmcMapHealth, radmonHealth, openRadiationHealth, safecastHealth),
+      bridgeInfoPage_(mqttHealth, openSenseMapHealth, gmcMapHealth, radmonHealth, openRadiationHealth, safecastHealth, influxHealth),
       manager_(),
       log_(logPort),
       led_(led),
@@ -277,6 +307,8 @@ WiFiPortalService::WiFiPortalService(AppConfig &config,
 void WiFiPortalService::begin()
 {
     ensureCsrfToken();
+    while (!streamEpoch_)
+        streamEpoch_ = esp_random();
     manager_.setDebugOutput(true);
     manager_.setClass("invert");
     manager_.setConnectTimeout(10);
@@ -314,6 +346,16 @@ void WiFiPortalService::setSafecastPublisher(SafecastPublisher &publisher)
     safecastPublisher_ = &publisher;
 }
 
+void WiFiPortalService::setPublisherLoopStats(const PublisherLoopStats *stats, size_t count)
+{
+    bridgeInfoPage_.setPublisherLoopStats(stats, count);
+}
+
+void WiFiPortalService::setLogFileWriter(LogFileWriter &writer)
+{
+    logFileWriter_ = &writer;
+}
+
 void WiFiPortalService::notifyOtaStart()
 {
     if (otaHooksFired_)
@@ -509,17 +551,75 @@ void WiFiPortalService::maintain()
         if (millis() >= restartAtMs_)
         {
             log_.println(F("Restarting device to apply configuration changes."));
+            log_.flush();
             delay(100);
             ESP.restart();
         }
     }
 }
 
+bool WiFiPortalService::startTask()
+{
+    if (portalTaskHandle_)
+        return true;
+    // Handlers render pages, stream JSON and run test uploads over TLS.
+    BaseType_t created = xTaskCreatePinnedToCore(&WiFiPortalService::portalTaskThunk,
+                                                 "portal",
+                                                 kPortalTaskStackBytes,
+                                                 this,
+                                                 1,
+                                                 &portalTaskHandle_,
+                                                 1);
+    if (created != pdPASS)
+    {
+        portalTaskHandle_ = nullptr;
+        log_.println(F("Portal task start failed; serving the portal from the main loop."));
+        return false;
+    }
+    log_.println(F("Portal runs on its own task."));
+    return true;
+}
+
+void WiFiPortalService::portalTaskThunk(void *param)
+{
+    WiFiPortalService *service = static_cast<WiFiPortalService *>(param);
+    for (;;)
+    {
+        {
+            // maintain() drives the LED faults and Wi-Fi reconnects.
+            AppStateLock::Guard guard;
+            service->syncIfRequested();
+            service->maintain();
+        }
+        service->process();
+        vTaskDelay(pdMS_TO_TICKS(kPortalTaskIdleMs));
+    }
+}
+
+std::function<void()> WiFiPortalService::withAppState(std::function<void()> handler)
+{
+    return [handler]() {
+        AppStateLock::Guard guard;
+        handler();
+    };
+}
+
 void WiFiPortalService::process()
 {
+    // Once the task runs, only it touches the web server. The cooperative
+    // pump still calls in here from the main loop during network waits.
+    if (portalTaskHandle_ && xTaskGetCurrentTaskHandle() != portalTaskHandle_)
+        return;
     if (manager_.getWebPortalActive() || manager_.getConfigPortalActive())
     {
         manager_.process();
+        serviceLogStreams();
+        serviceDeviceStreams();
+    }
+    else
+    {
+        closeLogStreams();
+        closeDeviceStreams();
     }
 }
 
@@ -585,80 +685,44 @@ void WiFiPortalService::attachParameters()
             return;
         }
         routesRegistered_ = true;
-        log_.println(F("Custom Wi-Fi portal routes: /mqtt /osem /radmon /openradiation /openradiation/dry-run /openradiation/latest /gmc /safecast /device /device.json /bridge /bridge.json /backup /backup.json /backup/restore /logs /logs.json /ota /ota/status /ota/fetch /ota/upload/* /restart"));
+        // EventSource sends the last seen id when it reconnects to /logs/stream;
+        // the other two drive the cached, gzip-encoded asset responses.
+        const char *collectedHeaders[] = {"Last-Event-ID", "If-None-Match", "Accept-Encoding"};
+        manager_.server->collectHeaders(collectedHeaders, sizeof(collectedHeaders) / sizeof(collectedHeaders[0]));
+        log_.println(F("Custom Wi-Fi portal routes: /mqtt /osem /radmon /openradiation /openradiation/dry-run /openradiation/latest /gmc /safecast /influx /device /device.json /bridge /bridge.json /backup /backup.json /backup/restore /logs /logs.json /logs/stream /logs/file /logs/file.txt /logs/previous.txt /ota /ota/status /ota/fetch /ota/upload/* /restart"));
 
-        manager_.server->on("/mqtt", HTTP_GET, [this]() {
+        manager_.server->on("/mqtt", HTTP_GET, withAppState([this]() {
             log_.println(F("HTTP GET /mqtt"));
             MqttPublisher::SendPortalForm(*this);
-        });
-
-        manager_.server->on("/portal/portal.css", HTTP_GET, [this]() {
-            log_.println(F("HTTP GET /portal/portal.css"));
-            if (!sendStaticFile("/portal/portal.css", "text/css"))
-                sendTemplateError("/portal/portal.css");
-        });
-
-        manager_.server->on("/portal/portal-head-bootstrap.js", HTTP_GET, [this]() {
-            log_.println(F("HTTP GET /portal/portal-head-bootstrap.js"));
-            if (!sendStaticFile("/portal/portal-head-bootstrap.js", "application/javascript"))
-                sendTemplateError("/portal/portal-head-bootstrap.js");
-        });
-
-        manager_.server->on("/portal/js/device-info.js", HTTP_GET, [this]() {
-            log_.println(F("HTTP GET /portal/js/device-info.js"));
-            if (!sendStaticFile("/portal/js/device-info.js", "application/javascript"))
-                sendTemplateError("/portal/js/device-info.js");
-        });
+        }));
 
-        manager_.server->on("/portal/js/bridge-info.js", HTTP_GET, [this]() {
-            log_.println(F("HTTP GET /portal/js/bridge-info.js"));
-            if (!sendStaticFile("/portal/js/bridge-info.js", "application/javascript"))
-                sendTemplateError("/portal/js/bridge-info.js");
-        });
-
-        manager_.server->on("/portal/js/backup-page.js", HTTP_GET, [this]() {
-            log_.println(F("HTTP GET /portal/js/backup-page.js"));
-            if (!sendStaticFile("/portal/js/backup-page.js", "application/javascript"))
-                sendTemplateError("/portal/js/backup-page.js");
-        });
-
-        manager_.server->on("/portal/js/log-console.js", HTTP_GET, [this]() {
-            log_.println(F("HTTP GET /portal/js/log-console.js"));
-            if (!sendStaticFile("/portal/js/log-console.js", "application/javascript"))
-                sendTemplateError("/portal/js/log-console.js");
-        });
-
-        manager_.server->on("/portal/portal-locale.js", HTTP_GET, [this]() {
-            log_.println(F("HTTP GET /portal/portal-locale.js"));
-            if (!sendStaticFile("/portal/portal-locale.js", "application/javascript"))
-                sendTemplateError("/portal/portal-locale.js");
-        });
-
-        manager_.server->on("/portal/locales/en.json", HTTP_GET, [this]() {
-            log_.println(F("HTTP GET /portal/locales/en.json"));
-            if (!sendStaticFile("/portal/locales/en.json", "application/json"))
-                sendTemplateError("/portal/locales/en.json");
-        });
-
-        manager_.server->on("/portal/locales/de.json", HTTP_GET, [this]() {
-            log_.println(F("HTTP GET /portal/locales/de.json"));
-            if (!sendStaticFile("/portal/locales/de.json", "application/json"))
-                sendTemplateError("/portal/locales/de.json");
-        });
-
-        manager_.server->on("/portal/js/ota-page.js", HTTP_GET, [this]() {
-            log_.println(F("HTTP GET /portal/js/ota-page.js"));
-            if (!sendStaticFile("/portal/js/ota-page.js", "application/javascript"))
-                sendTemplateError("/portal/js/ota-page.js");
-        });
-
-        manager_.server->on("/portal/js/jszip.min.js", HTTP_GET, [this]() {
-            log_.println(F("HTTP GET /portal/js/jszip.min.js"));
-            if (!sendStaticFile("/portal/js/jszip.min.js", "application/javascript"))
-                sendTemplateError("/portal/js/jszip.min.js");
-        });
+        struct StaticAsset
+        {
+            const char *path;
+            const char *contentType;
+        };
+        static constexpr StaticAsset kStaticAssets[] = {
+            {"/portal/portal.css", "text/css"},
+            {"/portal/portal-head-bootstrap.js", "application/javascript"},
+            {"/portal/js/device-info.js", "application/javascript"},
+            {"/portal/js/bridge-info.js", "application/javascript"},
+            {"/portal/js/backup-page.js", "application/javascript"},
+            {"/portal/js/log-console.js", "application/javascript"},
+            {"/portal/portal-locale.js", "application/javascript"},
+            {"/portal/locales/en.json", "application/json"},
+            {"/portal/locales/de.json", "application/json"},
+            {"/portal/js/ota-page.js", "application/javascript"},
+            {"/portal/js/jszip.min.js", "application/javascript"},
+        };
+        for (const StaticAsset &asset : kStaticAssets)
+        {
+            manager_.server->on(asset.path, HTTP_GET, [this, asset]() {
+                if (!sendStaticFile(asset.path, asset.contentType))
+                    sendTemplateError(asset.path);
+            });
+        }
 
-        manager_.server->on("/mqtt", HTTP_POST, [this]() {
+        manager_.server->on("/mqtt", HTTP_POST, withAppState([this]() {
             log_.println(F("HTTP POST /mqtt"));
             if (!manager_.server)
                 return;
@@ -673,14 +737,14 @@ void WiFiPortalService::attachParameters()
                 hasLoggedIp_ = false;
             }
             MqttPublisher::SendPortalForm(*this, message);
-        });
+        }));
 
-        manager_.server->on("/osem", HTTP_GET, [this]() {
+        manager_.server->on("/osem", HTTP_GET, withAppState([this]() {
             log_.println(F("HTTP GET /osem"));
             OpenSenseMapPublisher::SendPortalForm(*this);
-        });
+        }));
 
-        manager_.server->on("/osem", HTTP_POST, [this]() {
+        manager_.server->on("/osem", HTTP_POST, withAppState([this]() {
             log_.println(F("HTTP POST /osem"));
             if (!manager_.server)
                 return;
@@ -689,14 +753,14 @@ void WiFiPortalService::attachParameters()
             String message;
             OpenSenseMapPublisher::HandlePortalPost(*manager_.server, config_, store_, led_, log_, message);
             OpenSenseMapPublisher::SendPortalForm(*this, message);
-        });
+        }));
 
-        manager_.server->on("/radmon", HTTP_GET, [this]() {
+        manager_.server->on("/radmon", HTTP_GET, withAppState([this]() {
             log_.println(F("HTTP GET /radmon"));
             RadmonPublisher::SendPortalForm(*this);
-        });
+        }));
 
-        manager_.server->on("/radmon", HTTP_POST, [this]() {
+        manager_.server->on("/radmon", HTTP_POST, withAppState([this]() {
             log_.println(F("HTTP POST /radmon"));
             if (!manager_.server)
                 return;
@@ -705,36 +769,36 @@ void WiFiPortalService::attachParameters()
             String message;
             RadmonPublisher::HandlePortalPost(*manager_.server, config_, store_, led_, log_, message);
             RadmonPublisher::SendPortalForm(*this, message);
-        });
+        }));
 
-        manager_.server->on("/openradiation", HTTP_GET, [this]() {
+        manager_.server->on("/openradiation", HTTP_GET, withAppState([this]() {
             log_.println(F("HTTP GET /openradiation"));
             sendOpenRadiationForm();
-        });
+        }));
 
-        manager_.server->on("/openradiation", HTTP_POST, [this]() {
+        manager_.server->on("/openradiation", HTTP_POST, withAppState([this]() {
             log_.println(F("HTTP POST /openradiation"));
             if (!requirePortalPost("/openradiation", {"orDeviceId", "orApiKey", "orUserId", "orUserPwd", "orLatitude", "orLongitude", "orAltitude", "orAccuracy", "orMeasurementEnvironment", "orMeasurementHeight"}))
                 return;
             handleOpenRadiationPost();
-        });
+        }));
 
-        manager_.server->on("/openradiation/dry-run", HTTP_GET, [this]() {
+        manager_.server->on("/openradiation/dry-run", HTTP_GET, withAppState([this]() {
             log_.println(F("HTTP GET /openradiation/dry-run"));
             handleOpenRadiationDryRun();
-        });
+        }));
 
-        manager_.server->on("/openradiation/latest", HTTP_GET, [this]() {
+        manager_.server->on("/openradiation/latest", HTTP_GET, withAppState([this]() {
             log_.println(F("HTTP GET /openradiation/latest"));
             handleOpenRadiationLatest();
-        });
+        }));
 
-        manager_.server->on("/gmc", HTTP_GET, [this]() {
+        manager_.server->on("/gmc", HTTP_GET, withAppState([this]() {
             log_.println(F("HTTP GET /gmc"));
             GmcMapPublisher::SendPortalForm(*this);
-        });
+        }));
 
-        manager_.server->on("/gmc", HTTP_POST, [this]() {
+        manager_.server->on("/gmc", HTTP_POST, withAppState([this]() {
             log_.println(F("HTTP POST /gmc"));
             if (!manager_.server)
                 return;
@@ -743,137 +807,177 @@ void WiFiPortalService::attachParameters()
             String message;
             GmcMapPublisher::HandlePortalPost(*manager_.server, config_, store_, led_, log_, message);
             GmcMapPublisher::SendPortalForm(*this, message);
-        });
+        }));
 
-        manager_.server->on("/safecast", HTTP_GET, [this]() {
+        manager_.server->on("/safecast", HTTP_GET, withAppState([this]() {
             log_.println(F("HTTP GET /safecast"));
             sendSafecastForm(config_);
-        });
+        }));
 
-        manager_.server->on("/safecast", HTTP_POST, [this]() {
+        manager_.server->on("/safecast", HTTP_POST, withAppState([this]() {
             log_.println(F("HTTP POST /safecast"));
             if (!requirePortalPost("/safecast", {"safecastAction", "safecastApiBaseUrl", "safecastCustomApiBaseUrl", "safecastApiKey", "safecastDeviceId", "safecastLatitude", "safecastLongitude", "safecastHeightCm", "safecastLocationName", "safecastUnit", "safecastUploadIntervalSeconds"}))
                 return;
             handleSafecastPost();
-        });
+        }));
+
+        manager_.server->on("/influx", HTTP_GET, withAppState([this]() {
+            log_.println(F("HTTP GET /influx"));
+            InfluxPublisher::SendPortalForm(*this);
+        }));
 
-        manager_.server->on("/device", HTTP_GET, [this]() {
+        manager_.server->on("/influx", HTTP_POST, withAppState([this]() {
+            log_.println(F("HTTP POST /influx"));
+            if (!manager_.server)
+                return;
+            if (!requirePortalPost("/influx", {"influxUrl", "influxToken", "influxMeasurement", "influxPointSeconds", "influxBatchPoints", "influxFlushSeconds"}))
+                return;
+            String message;
+            InfluxPublisher::HandlePortalPost(*manager_.server, config_, store_, led_, log_, message);
+            InfluxPublisher::SendPortalForm(*this, message);
+        }));
+
+        manager_.server->on("/device", HTTP_GET, withAppState([this]() {
             log_.println(F("HTTP GET /device"));
             TemplateReplacements vars;
             appendCommonTemplateVars(vars);
             sendTemplate("/portal/device-info.html", vars);
-        });
+        }));
 
         manager_.server->on("/device.json", HTTP_GET, [this]() {
             log_.println(F("HTTP GET /device.json"));
             deviceInfoPage_.handleJson(&manager_);
         });
 
-        manager_.server->on("/bridge", HTTP_GET, [this]() {
+        manager_.server->on("/device/stream", HTTP_GET, [this]() {
+            handleDeviceStream();
+        });
+
+        manager_.server->on("/bridge", HTTP_GET, withAppState([this]() {
             log_.println(F("HTTP GET /bridge"));
             TemplateReplacements vars;
             appendCommonTemplateVars(vars);
             sendTemplate("/portal/bridge-info.html", vars);
-        });
+        }));
 
-        manager_.server->on("/bridge.json", HTTP_GET, [this]() {
+        manager_.server->on("/bridge.json", HTTP_GET, withAppState([this]() {
             log_.println(F("HTTP GET /bridge.json"));
             bridgeInfoPage_.handleJson(&manager_);
-        });
+        }));
 
-        manager_.server->on("/logs", HTTP_GET, [this]() {
+        manager_.server->on("/logs", HTTP_GET, withAppState([this]() {
             log_.println(F("HTTP GET /logs"));
-            TemplateReplacements vars;
-            appendCommonTemplateVars(vars);
-            sendTemplate("/portal/logs.html", vars);
+            sendLogsPage();
+        }));
+
+        manager_.server->on("/logs/file", HTTP_POST, withAppState([this]() {
+            log_.println(F("HTTP POST /logs/file"));
+            if (!requirePortalPost("/logs/file"))
+                return;
+            handleLogFilePost();
+        }));
+
+        // Flushes LogFileWriter and must not race a rotation, so it holds
+        // the loop off; both files together stay under 128 KB.
+        manager_.server->on("/logs/file.txt", HTTP_GET, withAppState([this]() {
+            handleLogFileDownload();
+        }));
+
+        manager_.server->on("/logs/previous.txt", HTTP_GET, [this]() {
+            handlePreviousBootDownload();
         });
 
         manager_.server->on("/logs.json", HTTP_GET, [this]() {
             handleLogsJson();
         });
 
-        manager_.server->on("/backup", HTTP_GET, [this]() {
+        manager_.server->on("/logs/stream", HTTP_GET, [this]() {
+            handleLogStream();
+        });
+
+        manager_.server->on("/backup", HTTP_GET, withAppState([this]() {
             log_.println(F("HTTP GET /backup"));
             sendConfigBackupPage();
-        });
+        }));
 
-        manager_.server->on("/backup.json", HTTP_GET, [this]() {
+        manager_.server->on("/backup.json", HTTP_GET, withAppState([this]() {
             log_.println(F("HTTP GET /backup.json"));
             handleConfigDownload();
-        });
+        }));
 
-        manager_.server->on("/backup/restore", HTTP_POST, [this]() {
+        manager_.server->on("/backup/restore", HTTP_POST, withAppState([this]() {
             log_.println(F("HTTP POST /backup/restore"));
             if (!requirePortalPost("/backup/restore", {"configJson"}))
                 return;
             handleConfigRestore();
-        });
+        }));
 
-        manager_.server->on("/ota", HTTP_GET, [this]() {
+        manager_.server->on("/ota", HTTP_GET, withAppState([this]() {
             log_.println(F("HTTP GET /ota"));
             sendOtaPage();
-        });
+        }));
 
-        manager_.server->on("/ota/status", HTTP_GET, [this]() {
+        manager_.server->on("/ota/status", HTTP_GET, withAppState([this]() {
             log_.println(F("HTTP GET /ota/status"));
             handleOtaStatus();
-        });
+        }));
 
-        manager_.server->on("/ota/fetch", HTTP_POST, [this]() {
+        manager_.server->on("/ota/fetch", HTTP_POST, withAppState([this]() {
             log_.println(F("HTTP POST /ota/fetch"));
             if (!requirePortalPost("/ota/fetch", {}, true))
                 return;
             handleOtaFetch();
-        });
+        }));
 
-        manager_.server->on("/ota/upload/begin", HTTP_POST, [this]() {
+        manager_.server->on("/ota/upload/begin", HTTP_POST, withAppState([this]() {
             log_.println(F("HTTP POST /ota/upload/begin"));
             if (!requirePortalPost("/ota/upload/begin", {"plain"}, true))
                 return;
             handleOtaUploadBegin();
-        });
+        }));
 
-        manager_.server->on("/ota/upload/part/begin", HTTP_POST, [this]() {
+        manager_.server->on("/ota/upload/part/begin", HTTP_POST, withAppState([this]() {
             log_.println(F("HTTP POST /ota/upload/part/begin"));
             if (!requirePortalPost("/ota/upload/part/begin", {"path", "offset", "size"}, true))
                 return;
             handleOtaUploadPartBegin();
-        });
+        }));
 
-        manager_.server->on("/ota/upload/part/chunk", HTTP_POST, [this]() {
+        manager_.server->on("/ota/upload/part/chunk", HTTP_POST, withAppState([this]() {
             if (!requirePortalPost("/ota/upload/part/chunk", {"plain"}, true))
                 return;
             handleOtaUploadPartChunk();
-        });
+        }));
 
-        manager_.server->on("/ota/upload/part/finish", HTTP_POST, [this]() {
+        manager_.server->on("/ota/upload/part/finish", HTTP_POST, withAppState([this]() {
             log_.println(F("HTTP POST /ota/upload/part/finish"));
             if (!requirePortalPost("/ota/upload/part/finish", {"path"}, true))
                 return;
             handleOtaUploadPartFinish();
-        });
+        }));
 
-        manager_.server->on("/ota/upload/finish", HTTP_POST, [this]() {
+        manager_.server->on("/ota/upload/finish", HTTP_POST, withAppState([this]() {
             log_.println(F("HTTP POST /ota/upload/finish"));
             if (!requirePortalPost("/ota/upload/finish", {}, true))
                 return;
             handleOtaUploadFinish();
-        });
+        }));
 
-        manager_.server->on("/ota/cancel", HTTP_POST, [this]() {
+        manager_.server->on("/ota/cancel", HTTP_POST, withAppState([this]() {
             log_.println(F("HTTP POST /ota/cancel"));
             if (!requirePortalPost("/ota/cancel", {}, true))
                 return;
             handleOtaCancel();
-        });
+        }));
 
-        manager_.server->on("/restart", HTTP_GET, [this]() {
+        manager_.server->on("/restart", HTTP_GET, withAppState([this]() {
             log_.println(F("HTTP GET /restart"));
             manager_.server->send(200, "text/plain", "Restarting...\n");
             log_.println("Restart requested from Wi-Fi portal.");
+            log_.flush();
             delay(200);
             ESP.restart();
-        });
+        }));
 
         manager_.server->onNotFound([this]() {
             if (!manager_.server)
@@ -1293,7 +1397,7 @@ void WiFiPortalService::sendConfigBackupPage(const String &message)
 
     TemplateReplacements vars = {
         {"{{NOTICE_CLASS}}", noticeClass},
-        {"{{NOTICE_TEXT}}", htmlEscape(display)}};
+        {"{{NOTICE_TEXT}}", display}};
 
     appendCommonTemplateVars(vars);
     sendTemplate("/portal/backup.html", vars);
@@ -1372,6 +1476,21 @@ String WiFiPortalService::exportConfigJson() const
     doc["mqttPassword"] = config_.mqttPassword;
     doc["mqttTopic"] = config_.mqttTopic;
     doc["mqttFullTopic"] = config_.mqttFullTopic;
+    doc["mqttTlsEnabled"] = config_.mqttTlsEnabled;
+    doc["mqttTlsCaCert"] = config_.mqttTlsCaCert;
+    doc["mqttTlsFingerprint"] = config_.mqttTlsFingerprint;
+    doc["mqttAggregateState"] = config_.mqttAggregateState;
+    doc["mqttDeviceDiscovery"] = config_.mqttDeviceDiscovery;
+    doc["mqttControlEnabled"] = config_.mqttControlEnabled;
+    doc["mqttBinaryState"] = config_.mqttBinaryState;
+    doc["mqttQueueEnabled"] = config_.mqttQueueEnabled;
+    doc["mqttSpoolEnabled"] = config_.mqttSpoolEnabled;
+    doc["mqttReplayPerSecond"] = config_.mqttReplayPerSecond;
+    doc["mqttDeadbandEnabled"] = config_.mqttDeadbandEnabled;
+    doc["mqttRateDeadband"] = config_.mqttRateDeadband;
+    doc["mqttCountDeadband"] = config_.mqttCountDeadband;
+    doc["mqttBatteryDeadband"] = config_.mqttBatteryDeadband;
+    doc["mqttHeartbeatSeconds"] = config_.mqttHeartbeatSeconds;
     doc["readIntervalMs"] = config_.readIntervalMs;
     doc["openSenseMapEnabled"] = config_.openSenseMapEnabled;
     doc["openSenseBoxId"] = config_.openSenseBoxId;
@@ -1393,6 +1512,8 @@ String WiFiPortalService::exportConfigJson() const
     doc["openRadiationAccuracy"] = config_.openRadiationAccuracy;
     OpenRadiationBackupJson::appendMeasurementConfig(doc, config_);
     SafecastBackupJson::appendConfig(doc, config_);
+    InfluxBackupJson::appendConfig(doc, config_);
+    doc["logFileEnabled"] = config_.logFileEnabled;
 
     String json;
     serializeJsonPretty(doc, json);
@@ -1475,6 +1596,21 @@ bool WiFiPortalService::importConfigJson(const String &body, String &errorMessag
     setString(updated.mqttPassword, doc["mqttPassword"]);
     setString(updated.mqttTopic, doc["mqttTopic"]);
     setString(updated.mqttFullTopic, doc["mqttFullTopic"]);
+    setBool(updated.mqttTlsEnabled, doc["mqttTlsEnabled"]);
+    setString(updated.mqttTlsCaCert, doc["mqttTlsCaCert"]);
+    setString(updated.mqttTlsFingerprint, doc["mqttTlsFingerprint"]);
+    setBool(updated.mqttAggregateState, doc["mqttAggregateState"]);
+    setBool(updated.mqttDeviceDiscovery, doc["mqttDeviceDiscovery"]);
+    setBool(updated.mqttControlEnabled, doc["mqttControlEnabled"]);
+    setBool(updated.mqttBinaryState, doc["mqttBinaryState"]);
+    setBool(updated.mqttQueueEnabled, doc["mqttQueueEnabled"]);
+    setBool(updated.mqttSpoolEnabled, doc["mqttSpoolEnabled"]);
+    setUint32(updated.mqttReplayPerSecond, doc["mqttReplayPerSecond"]);
+    setBool(updated.mqttDeadbandEnabled, doc["mqttDeadbandEnabled"]);
+    setString(updated.mqttRateDeadband, doc["mqttRateDeadband"]);
+    setString(updated.mqttCountDeadband, doc["mqttCountDeadband"]);
+    setString(updated.mqttBatteryDeadband, doc["mqttBatteryDeadband"]);
+    setUint32(updated.mqttHeartbeatSeconds, doc["mqttHeartbeatSeconds"]);
     setUint32(updated.readIntervalMs, doc["readIntervalMs"]);
     setBool(updated.openSenseMapEnabled, doc["openSenseMapEnabled"]);
     setString(updated.openSenseBoxId, doc["openSenseBoxId"]);
@@ -1496,9 +1632,19 @@ bool WiFiPortalService::importConfigJson(const String &body, String &errorMessag
     setFloat(updated.openRadiationAccuracy, doc["openRadiationAccuracy"], 0.0f, 100000.0f);
     OpenRadiationBackupJson::applyMeasurementConfig(doc.as<JsonVariantConst>(), updated);
     SafecastBackupJson::applyConfig(doc.as<JsonVariantConst>(), updated);
+    InfluxBackupJson::applyConfig(doc.as<JsonVariantConst>(), updated);
+    setBool(updated.logFileEnabled, doc["logFileEnabled"]);
 
     if (updated.readIntervalMs < kMinReadIntervalMs)
         updated.readIntervalMs = kMinReadIntervalMs;
+    if (updated.mqttReplayPerSecond < kMinMqttReplayPerSecond)
+        updated.mqttReplayPerSecond = kMinMqttReplayPerSecond;
+    if (updated.mqttReplayPerSecond > kMaxMqttReplayPerSecond)
+        updated.mqttReplayPerSecond = kMaxMqttReplayPerSecond;
+    if (updated.mqttHeartbeatSeconds < kMinMqttHeartbeatSeconds)
+        updated.mqttHeartbeatSeconds = kMinMqttHeartbeatSeconds;
+    if (updated.mqttHeartbeatSeconds > kMaxMqttHeartbeatSeconds)
+        updated.mqttHeartbeatSeconds = kMaxMqttHeartbeatSeconds;
 
     const std::vector<String> changedFields = collectChangedConfigFields(config_, updated);
     if (!store_.save(updated))
@@ -1534,22 +1680,22 @@ void WiFiPortalService::sendSafecastForm(const AppConfig &viewConfig,
 
     TemplateReplacements vars = {
         {"{{NOTICE_CLASS}}", message.length() ? String() : String("hidden")},
-        {"{{NOTICE_TEXT}}", htmlEscape(message)},
+        {"{{NOTICE_TEXT}}", message},
         {"{{RESULT_BLOCK}}", resultHtml},
         {"{{SAFECAST_ENABLED_CHECKED}}", viewConfig.safecastEnabled ? String("checked") : String()},
-        {"{{SAFECAST_API_BASE_URL}}", htmlEscape(viewConfig.safecastApiBaseUrl)},
-        {"{{SAFECAST_EFFECTIVE_API_BASE_URL}}", htmlEscape(effectiveBaseUrl)},
-        {"{{SAFECAST_API_KEY_PLACEHOLDER}}", htmlEscape(apiKeyPlaceholder)},
-        {"{{SAFECAST_DEVICE_ID}}", htmlEscape(viewConfig.safecastDeviceId)},
-        {"{{SAFECAST_LATITUDE}}", htmlEscape(viewConfig.safecastLatitude)},
-        {"{{SAFECAST_LONGITUDE}}", htmlEscape(viewConfig.safecastLongitude)},
-        {"{{SAFECAST_HEIGHT_CM}}", htmlEscape(viewConfig.safecastHeightCm)},
-        {"{{SAFECAST_LOCATION_NAME}}", htmlEscape(viewConfig.safecastLocationName)},
+        {"{{SAFECAST_API_BASE_URL}}", viewConfig.safecastApiBaseUrl},
+        {"{{SAFECAST_EFFECTIVE_API_BASE_URL}}", effectiveBaseUrl},
+        {"{{SAFECAST_API_KEY_PLACEHOLDER}}", apiKeyPlaceholder},
+        {"{{SAFECAST_DEVICE_ID}}", viewConfig.safecastDeviceId},
+        {"{{SAFECAST_LATITUDE}}", viewConfig.safecastLatitude},
+        {"{{SAFECAST_LONGITUDE}}", viewConfig.safecastLongitude},
+        {"{{SAFECAST_HEIGHT_CM}}", viewConfig.safecastHeightCm},
+        {"{{SAFECAST_LOCATION_NAME}}", viewConfig.safecastLocationName},
         {"{{SAFECAST_UNIT_CPM_CHECKED}}", viewConfig.safecastUnit.equalsIgnoreCase("cpm") ? String("checked") : String()},
         {"{{SAFECAST_UNIT_USV_CHECKED}}", viewConfig.safecastUnit.equalsIgnoreCase("usv") ? String("checked") : String()},
         {"{{SAFECAST_UPLOAD_INTERVAL_SECONDS}}", String(viewConfig.safecastUploadIntervalSeconds)},
         {"{{SAFECAST_USE_TEST_API_CHECKED}}", viewConfig.safecastUseTestApi ? String("checked") : String()},
-        {"{{SAFECAST_CUSTOM_API_BASE_URL}}", htmlEscape(viewConfig.safecastCustomApiBaseUrl)},
+        {"{{SAFECAST_CUSTOM_API_BASE_URL}}", viewConfig.safecastCustomApiBaseUrl},
         {"{{SAFECAST_DEBUG_CHECKED}}", viewConfig.safecastDebug ? String("checked") : String()}};
 
     appendCommonTemplateVars(vars);
@@ -1632,7 +1778,14 @@ void WiFiPortalService::handleSafecastPost()
             return;
         }
 
-        const SafecastPublisher::UploadResult result = safecastPublisher_->sendTestUpload(candidate);
+        SafecastPublisher::TestUpload upload;
+        SafecastPublisher::UploadResult result;
+        if (safecastPublisher_->prepareTestUpload(candidate, upload, result))
+        {
+            // The prepared upload is a copy; the main loop runs while it is sent.
+            AppStateLock::Released released;
+            result = safecastPublisher_->sendTestUpload(upload);
+        }
         String message = result.success ? String("Safecast test upload finished.") : String();
         if (!result.success && !result.statusCode && result.errorMessage.length())
             message = result.errorMessage;
@@ -1714,19 +1867,19 @@ void WiFiPortalService::sendOpenRadiationForm(const String &message)
     html += F("<p style='margin:-4px 0 0 0;color:#bbb;font-size:13px;'>The bridge stores these credentials locally in NVS, includes them in outgoing measurement payloads, and redacts them in dry-run previews.</p>");
 
     html += F("<label for='orLatitude'>Latitude</label><input id='orLatitude' name='orLatitude' type='number' step='0.000001' min='-90' max='90' value='");
-    html += String(config_.openRadiationLatitude, 6);
+    html += NumberFormat::Fixed(config_.openRadiationLatitude, 6).c_str();
     html += F("'/>");
 
     html += F("<label for='orLongitude'>Longitude</label><input id='orLongitude' name='orLongitude' type='number' step='0.000001' min='-180' max='180' value='");
-    html += String(config_.openRadiationLongitude, 6);
+    html += NumberFormat::Fixed(config_.openRadiationLongitude, 6).c_str();
     html += F("'/>");
 
     html += F("<label for='orAltitude'>Altitude (m, optional)</label><input id='orAltitude' name='orAltitude' type='number' step='0.1' value='");
-    html += String(config_.openRadiationAltitude, 1);
+    html += NumberFormat::Fixed(config_.openRadiationAltitude, 1).c_str();
     html += F("'/>");
 
     html += F("<label for='orAccuracy'>Position Accuracy (m, optional)</label><input id='orAccuracy' name='orAccuracy' type='number' step='0.1' min='0' value='");
-    html += String(config_.openRadiationAccuracy, 1);
+    html += NumberFormat::Fixed(config_.openRadiationAccuracy, 1).c_str();
     html += F("'/>");
 
     html += F("<label for='orMeasurementEnvironment'>Measurement Environment</label><select id='orMeasurementEnvironment' name='orMeasurementEnvironment'>");
@@ -1738,7 +1891,7 @@ void WiFiPortalService::sendOpenRadiationForm(const String &message)
     html += F("</select>");
 
     html += F("<label for='orMeasurementHeight'>Measurement Height Above Ground (m, optional)</label><input id='orMeasurementHeight' name='orMeasurementHeight' type='number' step='0.1' min='0' max='100' value='");
-    html += String(config_.openRadiationMeasurementHeight, 1);
+    html += NumberFormat::Fixed(config_.openRadiationMeasurementHeight, 1).c_str();
     html += F("'/>");
 
     html += OpenRadiationPortalView::buildLinksSection(mapUrl, latestPath);
@@ -1950,6 +2103,12 @@ void WiFiPortalService::handleOpenRadiationLatest()
         return;
     }
 
+    // Everything below works on copies, so the lookup of up to 15 s does
+    // not hold the main loop off.
+    const float configuredLatitude = config_.openRadiationLatitude;
+    const float configuredLongitude = config_.openRadiationLongitude;
+    AppStateLock::Released released;
+
     WiFiClientSecure client;
     client.setTimeout(15);
     client.setInsecure();
@@ -2021,12 +2180,12 @@ void WiFiPortalService::handleOpenRadiationLatest()
     OpenRadiationPortalView::LatestMeasurementViewModel model;
     model.reportUuid = data["reportUuid"] | reportUuid;
     model.startTime = data["startTime"] | String();
-    model.valueText = String(data["value"] | 0.0f, 4) + " uSv/h";
+    model.valueText = String(NumberFormat::Fixed(data["value"] | 0.0f, 4).c_str()) + " uSv/h";
     model.qualification = data["qualification"] | String();
     model.atypical = data["atypical"] | false;
 
-    const float latitude = data["latitude"] | config_.openRadiationLatitude;
-    const float longitude = data["longitude"] | config_.openRadiationLongitude;
+    const float latitude = data["latitude"] | configuredLatitude;
+    const float longitude = data["longitude"] | configuredLongitude;
     model.mapUrl = OpenRadiationPortalLinks::buildOpenRadiationMapUrl(latitude, longitude);
 
     manager_.server->send(200, "text/html", OpenRadiationPortalView::buildLatestMeasurementPage(model));
@@ -2096,22 +2255,56 @@ bool WiFiPortalService::readFile(const char *path, String &out)
     log_.print(F(" size="));
     log_.println(file.size());
 
+    // Block reads into the reserved String instead of a call per byte.
     out.clear();
     out.reserve(file.size() + 8);
-    while (file.available())
+    char chunk[256];
+    for (;;)
     {
-        out += static_cast<char>(file.read());
+        const size_t read = file.read(reinterpret_cast<uint8_t *>(chunk), sizeof(chunk));
+        if (!read)
+            break;
+        out.concat(chunk, read);
     }
     file.close();
     return true;
 }
 
+const String &WiFiPortalService::assetManifest()
+{
+    if (!assetManifestLoaded_)
+    {
+        // Missing when the filesystem image was built without
+        // compress_portal_assets.py; assets then go out uncompressed and
+        // without validators.
+        assetManifestLoaded_ = true;
+        if (!readFile(PortalAssets::kManifestPath, assetManifest_))
+            assetManifest_ = String();
+    }
+    return assetManifest_;
+}
+
 bool WiFiPortalService::sendStaticFile(const char *path, const char *contentType)
 {
     if (!manager_.server)
         return false;
+    auto &server = *manager_.server;
 
-    File file = LittleFS.open(path, "r");
+    char hash[PortalAssets::kHashChars + 1];
+    const String &manifest = assetManifest();
+    const bool hashed = PortalAssets::findHash(manifest.c_str(), manifest.length(), path, hash);
+
+    File file;
+    bool gzip = false;
+    if (hashed && PortalAssets::acceptsGzip(server.header("Accept-Encoding").c_str()))
+    {
+        String gzipPath(path);
+        gzipPath += ".gz";
+        file = LittleFS.open(gzipPath, "r");
+        gzip = static_cast<bool>(file);
+    }
+    if (!file)
+        file = LittleFS.open(path, "r");
     if (!file)
     {
         if (!remountLittleFsIfNeeded(path))
@@ -2128,12 +2321,29 @@ bool WiFiPortalService::sendStaticFile(const char *path, const char *contentType
         return false;
     }
 
-    log_.print(F("Serving asset: "));
-    log_.print(path);
-    log_.print(F(" size="));
-    log_.println(file.size());
+    if (hashed)
+    {
+        char etag[PortalAssets::kEtagBytes];
+        PortalAssets::formatEtag(hash, gzip, etag);
+        // Pages link assets as <path>?v=<hash>; only a URL naming the
+        // current content may be cached without asking again.
+        const bool versioned = server.hasArg("v") && server.arg("v") == hash;
+        server.sendHeader(F("ETag"), etag);
+        server.sendHeader(F("Cache-Control"),
+                          versioned ? PortalAssets::kImmutableCacheControl : PortalAssets::kRevalidateCacheControl);
+        server.sendHeader(F("Vary"), F("Accept-Encoding"));
+        if (PortalAssets::etagMatches(server.header("If-None-Match").c_str(), etag))
+        {
+            file.close();
+            server.send(304);
+            BRIDGE_LOGD(log_, "Portal", "%s not modified", path);
+            return true;
+        }
+    }
 
-    size_t sent = manager_.server->streamFile(file, contentType);
+    // streamFile() adds Content-Encoding: gzip for a .gz file.
+    const size_t size = file.size();
+    const size_t sent = server.streamFile(file, contentType);
     file.close();
 
     if (sent == 0)
@@ -2143,18 +2353,19 @@ bool WiFiPortalService::sendStaticFile(const char *path, const char *contentType
         return false;
     }
 
-    log_.print(F("Served asset: "));
-    log_.print(path);
-    log_.print(F(" bytes="));
-    log_.println(sent);
+    BRIDGE_LOGD(log_, "Portal", "%s %u/%u bytes%s", path, static_cast<unsigned>(sent), static_cast<unsigned>(size),
+                gzip ? " gzip" : "");
     return true;
 }
 
 void WiFiPortalService::applyTemplateReplacements(String &content, const TemplateReplacements &replacements)
 {
+    // Same rules as PortalTemplate::render(): {{{NAME}}} takes markup,
+    // {{NAME}} the escaped value.
     for (const auto &entry : replacements)
     {
-        content.replace(entry.first, entry.second);
+        content.replace(String("{") + entry.first + "}", entry.second);
+        content.replace(entry.first, htmlEscape(entry.second));
     }
 }
 
@@ -2168,6 +2379,50 @@ bool WiFiPortalService::sendTemplate(const char *path, const TemplateReplacement
         return false;
     }
 
+#ifdef HAS_COMPILED_PORTAL_TEMPLATES
+    const PortalTemplate::Template *page = PortalTemplate::find(PortalTemplates::kAll, PortalTemplates::kCount, path);
+    if (page)
+    {
+        // A filesystem-only update lists a different hash for the page; the
+        // LittleFS copy is newer than the firmware then.
+        char hash[PortalAssets::kHashChars + 1];
+        const String &manifest = assetManifest();
+        if (PortalAssets::findHash(manifest.c_str(), manifest.length(), path, hash) && strcmp(hash, page->sourceHash) != 0)
+        {
+            log_.print(F("LittleFS page differs from compiled template: "));
+            log_.println(path);
+            page = nullptr;
+        }
+    }
+    if (page)
+    {
+        // Literal text streams from flash and values are interleaved as
+        // chunks, so only a small coalescing buffer is needed.
+        auto &server = *manager_.server;
+        server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+        server.send(200, "text/html", "");
+        PortalTemplate::render<kTemplateChunkBytes>(
+            *page,
+            [&replacements](const char *name, const char *&value, size_t &length) {
+                for (const auto &entry : replacements)
+                {
+                    if (entry.first == name)
+                    {
+                        value = entry.second.c_str();
+                        length = entry.second.length();
+                        return true;
+                    }
+                }
+                return false;
+            },
+            [&server](const char *data, size_t length) { server.sendContent(data, length); });
+        server.sendContent("");
+        log_.print(F("Served compiled template: "));
+        log_.println(path);
+        return true;
+    }
+#endif
+
     String content;
     if (!readFile(path, content))
     {
@@ -2337,6 +2592,21 @@ std::vector<String> WiFiPortalService::collectChangedConfigFields(const AppConfi
     RADPRO_APPEND_CHANGED_FIELD(mqttPassword);
     RADPRO_APPEND_CHANGED_FIELD(mqttTopic);
     RADPRO_APPEND_CHANGED_FIELD(mqttFullTopic);
+    RADPRO_APPEND_CHANGED_FIELD(mqttTlsEnabled);
+    RADPRO_APPEND_CHANGED_FIELD(mqttTlsCaCert);
+    RADPRO_APPEND_CHANGED_FIELD(mqttTlsFingerprint);
+    RADPRO_APPEND_CHANGED_FIELD(mqttAggregateState);
+    RADPRO_APPEND_CHANGED_FIELD(mqttDeviceDiscovery);
+    RADPRO_APPEND_CHANGED_FIELD(mqttControlEnabled);
+    RADPRO_APPEND_CHANGED_FIELD(mqttBinaryState);
+    RADPRO_APPEND_CHANGED_FIELD(mqttQueueEnabled);
+    RADPRO_APPEND_CHANGED_FIELD(mqttSpoolEnabled);
+    RADPRO_APPEND_CHANGED_FIELD(mqttReplayPerSecond);
+    RADPRO_APPEND_CHANGED_FIELD(mqttDeadbandEnabled);
+    RADPRO_APPEND_CHANGED_FIELD(mqttRateDeadband);
+    RADPRO_APPEND_CHANGED_FIELD(mqttCountDeadband);
+    RADPRO_APPEND_CHANGED_FIELD(mqttBatteryDeadband);
+    RADPRO_APPEND_CHANGED_FIELD(mqttHeartbeatSeconds);
     RADPRO_APPEND_CHANGED_FIELD(readIntervalMs);
     RADPRO_APPEND_CHANGED_FIELD(openSenseMapEnabled);
     RADPRO_APPEND_CHANGED_FIELD(openSenseBoxId);
@@ -2373,11 +2643,137 @@ std::vector<String> WiFiPortalService::collectChangedConfigFields(const AppConfi
     RADPRO_APPEND_CHANGED_FIELD(safecastUnit);
     RADPRO_APPEND_CHANGED_FIELD(safecastUploadIntervalSeconds);
     RADPRO_APPEND_CHANGED_FIELD(safecastDebug);
+    RADPRO_APPEND_CHANGED_FIELD(influxEnabled);
+    RADPRO_APPEND_CHANGED_FIELD(influxUrl);
+    RADPRO_APPEND_CHANGED_FIELD(influxToken);
+    RADPRO_APPEND_CHANGED_FIELD(influxMeasurement);
+    RADPRO_APPEND_CHANGED_FIELD(influxPointIntervalSeconds);
+    RADPRO_APPEND_CHANGED_FIELD(influxBatchPoints);
+    RADPRO_APPEND_CHANGED_FIELD(influxFlushSeconds);
+    RADPRO_APPEND_CHANGED_FIELD(influxGzip);
+    RADPRO_APPEND_CHANGED_FIELD(logFileEnabled);
 #undef RADPRO_APPEND_CHANGED_FIELD
 
     return changed;
 }
 
+void WiFiPortalService::sendLogsPage(const String &message)
+{
+    if (!manager_.server)
+        return;
+
+    bool isError = message.startsWith(F("ERROR:"));
+    String display = isError ? message.substring(6) : message;
+    display.trim();
+
+    size_t previousBootLength = 0;
+    log_.previousBoot(previousBootLength);
+
+    TemplateReplacements vars = {
+        {"{{NOTICE_CLASS}}", display.length() ? String(isError ? "error" : "success") : String("hidden")},
+        {"{{NOTICE_TEXT}}", display},
+        {"{{LOG_FILE_CHECKED}}", config_.logFileEnabled ? String("checked") : String()},
+        {"{{PREVIOUS_BOOT_CLASS}}", previousBootLength ? String() : String("hidden")}};
+
+    appendCommonTemplateVars(vars);
+    sendTemplate("/portal/logs.html", vars);
+}
+
+void WiFiPortalService::handleLogFilePost()
+{
+    auto &server = *manager_.server;
+    AppConfig updated = config_;
+    updated.logFileEnabled = server.hasArg("logFile") && server.arg("logFile") == "1";
+
+    const std::vector<String> changedFields = collectChangedConfigFields(config_, updated);
+    if (!store_.save(updated))
+    {
+        PortalSecurity::logConfigSaveFailure(log_, "/logs/file", currentClientIp(), changedFields);
+        led_.activateFault(FaultCode::NvsWriteFailure);
+        sendLogsPage(F("ERROR: Failed to save configuration to NVS."));
+        return;
+    }
+
+    // The main loop applies the flag to the LogFileWriter.
+    config_ = updated;
+    led_.clearFault(FaultCode::NvsWriteFailure);
+    logConfigSave("/logs/file", changedFields);
+    sendLogsPage(updated.logFileEnabled ? F("Log file enabled.") : F("Log file disabled; the existing file is kept."));
+}
+
+void WiFiPortalService::handleLogFileDownload()
+{
+    if (!manager_.server)
+        return;
+    log_.println(F("HTTP GET /logs/file.txt"));
+    auto &server = *manager_.server;
+
+    // Whatever is still batched in RAM goes to flash first.
+    if (logFileWriter_)
+        logFileWriter_->flush();
+
+    // Oldest first: the rotated file, then the current one.
+    const char *const paths[] = {LogFileWriter::kRotatedPath, LogFileWriter::kPath};
+    size_t total = 0;
+    for (const char *path : paths)
+    {
+        File file = LittleFS.open(path, "r");
+        if (file)
+        {
+            total += file.size();
+            file.close();
+        }
+    }
+    if (!total)
+    {
+        server.send(404, "text/plain", "No log file on flash.");
+        return;
+    }
+
+    server.sendHeader("Cache-Control", "no-cache, no-store, must-revalidate");
+    server.sendHeader("Content-Disposition", "attachment; filename=\"radpro-wifi-bridge.log\"");
+    server.setContentLength(total);
+    server.send(200, "text/plain", "");
+    char buffer[kLogJsonChunkBytes];
+    size_t sent = 0;
+    for (const char *path : paths)
+    {
+        File file = LittleFS.open(path, "r");
+        while (file && sent < total)
+        {
+            const size_t wanted = total - sent < sizeof(buffer) ? total - sent : sizeof(buffer);
+            const size_t read = file.read(reinterpret_cast<uint8_t *>(buffer), wanted);
+            if (!read)
+                break;
+            server.sendContent(buffer, read);
+            sent += read;
+        }
+        if (file)
+            file.close();
+    }
+}
+
+void WiFiPortalService::handlePreviousBootDownload()
+{
+    if (!manager_.server)
+        return;
+    log_.println(F("HTTP GET /logs/previous.txt"));
+    auto &server = *manager_.server;
+
+    size_t length = 0;
+    const char *text = log_.previousBoot(length);
+    if (!length)
+    {
+        server.send(404, "text/plain", "No log kept from before the last reset.");
+        return;
+    }
+    server.sendHeader("Cache-Control", "no-cache, no-store, must-revalidate");
+    server.sendHeader("Content-Disposition", "attachment; filename=\"radpro-wifi-bridge-previous-boot.log\"");
+    server.setContentLength(length);
+    server.send(200, "text/plain", "");
+    server.sendContent(text, length);
+}
+
 void WiFiPortalService::handleLogsJson()
 {
     if (!manager_.server)
@@ -2387,28 +2783,285 @@ void WiFiPortalService::handleLogsJson()
     if (manager_.server->hasArg("after"))
         afterId = static_cast<uint32_t>(strtoul(manager_.server->arg("after").c_str(), nullptr, 10));
 
-    std::vector<DebugLogEntry> entries;
-    log_.copyEntries(entries);
-    const auto window = LogCursorWindow::select(entries, afterId);
+    // Lines are rendered up to the newest one present now; anything logged
+    // while the response is sent goes to the next poll.
+    const DebugLogWindow window = log_.window();
+    const bool reset = afterId > window.latestId || LogCursorWindow::evicted(afterId, window.oldestId);
+    uint32_t cursor = reset ? 0 : afterId;
+
+    manager_.server->setContentLength(CONTENT_LENGTH_UNKNOWN);
+    manager_.server->send(200, "application/json", "");
+    manager_.server->sendContent("{\"lines\":[");
+
+    // Each chunk is escaped under the log lock and sent after it is released.
+    char buffer[kLogJsonChunkBytes];
+    uint32_t returned = 0;
+    for (;;)
+    {
+        size_t used = 0;
+        log_.visitAfter(cursor, [&](uint32_t id, const char *text, size_t length) {
+            if (id > window.latestId)
+                return false;
+            const size_t next = LogJsonChunk::appendLine(buffer, sizeof(buffer), used, text, length, returned == 0);
+            if (next == used)
+                return false;
+            used = next;
+            cursor = id;
+            ++returned;
+            return true;
+        });
+        if (!used)
+            break;
+        manager_.server->sendContent(buffer, used);
+    }
 
-    JsonDocument doc;
-    JsonArray lines = doc["lines"].to<JsonArray>();
-    for (size_t i = window.startIndex; i < entries.size(); ++i)
+    const int written = snprintf(buffer,
+                                 sizeof(buffer),
+                                 "],\"count\":%lu,\"returnedCount\":%lu,\"oldest\":%lu,\"latest\":%lu,\"reset\":%s}",
+                                 static_cast<unsigned long>(window.count),
+                                 static_cast<unsigned long>(returned),
+                                 static_cast<unsigned long>(window.oldestId),
+                                 static_cast<unsigned long>(returned ? cursor : window.latestId),
+                                 reset ? "true" : "false");
+    if (written > 0)
+        manager_.server->sendContent(buffer, static_cast<size_t>(written));
+    manager_.server->sendContent("");
+}
+
+void WiFiPortalService::handleLogStream()
+{
+    if (!manager_.server)
+        return;
+    log_.println(F("HTTP GET /logs/stream"));
+
+    // An id from another boot (or a malformed one) resets the client's view
+    // and replays the ring from the start.
+    uint32_t afterId = 0;
+    bool resume = true;
+    String lastEventId = manager_.server->header("Last-Event-ID");
+    if (!lastEventId.length() && manager_.server->hasArg("after"))
+        lastEventId = manager_.server->arg("after");
+    if (lastEventId.length())
+        resume = LogEventStream::parseEventId(lastEventId.c_str(), streamEpoch_, afterId);
+
+    LogStreamClient *slot = nullptr;
+    for (auto &stream : logStreams_)
     {
-        const auto &entry = entries[i];
-        lines.add(entry.text);
-        if (doc.overflowed())
-            break;
+        if (stream.active && !stream.client.connected())
+        {
+            stream.client.stop();
+            stream.active = false;
+        }
+        if (!stream.active && !slot)
+            slot = &stream;
+    }
+    if (!slot)
+    {
+        // The page falls back to polling /logs.json.
+        manager_.server->send(503, "text/plain", "Too many log streams");
+        return;
     }
-    doc["count"] = static_cast<uint32_t>(entries.size());
-    doc["returnedCount"] = static_cast<uint32_t>(lines.size());
-    doc["oldest"] = window.oldestId;
-    doc["latest"] = log_.latestId();
-    doc["reset"] = window.reset;
 
-    String body;
-    serializeJson(doc, body);
-    manager_.server->send(200, "application/json", body);
+    // Keep our own handle on the socket; the synchronous WebServer drops its
+    // reference once this handler returns, and later events are written from
+    // the portal loop.
+    WiFiClient &client = manager_.server->client();
+    client.setNoDelay(true);
+    const size_t headLength = sizeof(LogEventStream::kResponseHead) - 1;
+    if (client.write(reinterpret_cast<const uint8_t *>(LogEventStream::kResponseHead), headLength) != headLength)
+    {
+        client.stop();
+        return;
+    }
+    slot->client = client;
+    slot->cursor = afterId;
+    slot->resetPending = !resume || afterId > log_.latestId();
+    if (slot->resetPending)
+        slot->cursor = 0;
+    slot->lastWriteMs = millis();
+    slot->active = true;
+}
+
+void WiFiPortalService::serviceLogStreams()
+{
+    static constexpr size_t kResetLength = sizeof(LogEventStream::kResetEvent) - 1;
+    char buffer[kLogStreamChunkBytes];
+    for (auto &stream : logStreams_)
+    {
+        if (!stream.active)
+            continue;
+        if (!stream.client.connected())
+        {
+            stream.client.stop();
+            stream.active = false;
+            continue;
+        }
+
+        // Events are rendered behind room for a reset marker, copied out of
+        // the ring under the log lock and written to the socket after it is
+        // released, so a slow client never holds up logging.
+        size_t used = kResetLength;
+        uint32_t cursor = stream.cursor;
+        const uint32_t oldest = log_.visitAfter(stream.cursor, [&](uint32_t id, const char *text, size_t length) {
+            const size_t next = LogEventStream::appendEvent(buffer, sizeof(buffer), used, streamEpoch_, id, text, length);
+            if (next == used)
+                return false;
+            used = next;
+            cursor = id;
+            return true;
+        });
+
+        size_t start = kResetLength;
+        if (used > kResetLength && (stream.resetPending || LogCursorWindow::evicted(stream.cursor, oldest)))
+        {
+            std::memcpy(buffer, LogEventStream::kResetEvent, kResetLength);
+            start = 0;
+        }
+
+        const unsigned long now = millis();
+        const uint8_t *data = reinterpret_cast<const uint8_t *>(buffer + start);
+        size_t length = used - start;
+        if (!length)
+        {
+            if (now - stream.lastWriteMs < kLogStreamKeepAliveMs)
+                continue;
+            data = reinterpret_cast<const uint8_t *>(LogEventStream::kKeepAlive);
+            length = sizeof(LogEventStream::kKeepAlive) - 1;
+        }
+
+        if (stream.client.write(data, length) != length)
+        {
+            stream.client.stop();
+            stream.active = false;
+            continue;
+        }
+        stream.cursor = cursor;
+        stream.lastWriteMs = now;
+        if (start == 0)
+            stream.resetPending = false;
+    }
+}
+
+void WiFiPortalService::closeLogStreams()
+{
+    for (auto &stream : logStreams_)
+    {
+        if (!stream.active)
+            continue;
+        stream.client.stop();
+        stream.active = false;
+    }
+}
+
+void WiFiPortalService::handleDeviceStream()
+{
+    if (!manager_.server)
+        return;
+    log_.println(F("HTTP GET /device/stream"));
+
+    const uint32_t since = DeviceInfoDelta::resumeRevision(manager_.server->header("Last-Event-ID").c_str(), streamEpoch_);
+
+    DeviceStreamClient *slot = nullptr;
+    for (auto &stream : deviceStreams_)
+    {
+        if (stream.active && !stream.client.connected())
+        {
+            stream.client.stop();
+            stream.active = false;
+        }
+        if (!stream.active && !slot)
+            slot = &stream;
+    }
+    if (!slot)
+    {
+        // The page falls back to polling /device.json.
+        manager_.server->send(503, "text/plain", "Too many device streams");
+        return;
+    }
+
+    WiFiClient &client = manager_.server->client();
+    client.setNoDelay(true);
+    const size_t headLength = sizeof(LogEventStream::kResponseHead) - 1;
+    if (client.write(reinterpret_cast<const uint8_t *>(LogEventStream::kResponseHead), headLength) != headLength)
+    {
+        client.stop();
+        return;
+    }
+    slot->client = client;
+    // The first event carries everything changed since the client's last
+    // revision: all fields for a new page or a page from before a reboot
+    // (both 0).
+    slot->revision = since;
+    slot->lastWriteMs = millis();
+    slot->active = true;
+}
+
+void WiFiPortalService::serviceDeviceStreams()
+{
+    bool anyActive = false;
+    for (const auto &stream : deviceStreams_)
+        anyActive = anyActive || stream.active;
+    if (!anyActive)
+        return;
+
+    // Only a changed revision costs a snapshot; idle streams just compare
+    // numbers and send a keep-alive now and then.
+    const uint32_t current = deviceInfo_.revision();
+    char json[DeviceInfoDelta::kMaxJsonBytes];
+    char event[DeviceInfoDelta::kMaxJsonBytes + 32];
+    for (auto &stream : deviceStreams_)
+    {
+        if (!stream.active)
+            continue;
+        if (!stream.client.connected())
+        {
+            stream.client.stop();
+            stream.active = false;
+            continue;
+        }
+
+        const unsigned long now = millis();
+        const uint8_t *data = reinterpret_cast<const uint8_t *>(LogEventStream::kKeepAlive);
+        size_t length = sizeof(LogEventStream::kKeepAlive) - 1;
+        uint32_t revision = stream.revision;
+        if (stream.revision != current)
+        {
+            const size_t jsonLength = deviceInfo_.writeDelta(stream.revision, json, sizeof(json), revision);
+            length = LogEventStream::appendEvent(event, sizeof(event), 0, streamEpoch_, revision, json, jsonLength);
+            data = reinterpret_cast<const uint8_t *>(event);
+            if (!jsonLength || !length)
+            {
+                // Cannot happen with the fixed field set; skip rather than
+                // retry the same oversized delta forever.
+                stream.revision = revision;
+                continue;
+            }
+        }
+        else if (now - stream.lastWriteMs < kLogStreamKeepAliveMs)
+        {
+            continue;
+        }
+
+        if (stream.client.write(data, length) != length)
+        {
+            stream.client.stop();
+            stream.active = false;
+            continue;
+        }
+        stream.revision = revision;
+        stream.lastWriteMs = now;
+    }
+}
+
+void WiFiPortalService::closeDeviceStreams()
+{
+    for (auto &stream : deviceStreams_)
+    {
+        if (!stream.active)
+            continue;
+        stream.client.stop();
+        stream.active = false;
+    }
 }
 
 void WiFiPortalService::sendTemplateError(const char *path)
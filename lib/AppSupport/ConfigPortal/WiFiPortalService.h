@@ -24,6 +24,7 @@
 #include "Publishing/PublisherHealth.h"
 
 class SafecastPublisher;
+class LogFileWriter;
 
 class WiFiPortalService
 {
@@ -35,14 +36,20 @@ public:
                       DeviceInfoStore &info,
                       DebugLogStream &logPort,
                       LedController &led,
+                      const PublisherHealth &mqttHealth,
                       const PublisherHealth &openSenseMapHealth,
                       const PublisherHealth &gmcMapHealth,
                       const PublisherHealth &radmonHealth,
                       const PublisherHealth &openRadiationHealth,
-                      const PublisherHealth &safecastHealth);
+                      const PublisherHealth &safecastHealth,
+                      const PublisherHealth &influxHealth);
 
     void begin();
     bool connect(bool forcePortal);
+    // Moves maintain() and process() to a task of their own, so requests
+    // are served while the main loop polls the detector and publishes.
+    bool startTask();
+    bool taskRunning() const { return portalTaskHandle_ != nullptr; }
     void maintain();
     void process();
     void syncIfRequested();
@@ -50,6 +57,8 @@ public:
     void enableStatusLogging();
     void setOtaStartCallback(std::function<void()> cb);
     void setSafecastPublisher(SafecastPublisher &publisher);
+    void setPublisherLoopStats(const PublisherLoopStats *stats, size_t count);
+    void setLogFileWriter(LogFileWriter &writer);
 
 private:
     void prepareConfigPortalAp(const String &ssid);
@@ -58,6 +67,12 @@ private:
     friend class RadmonPublisher;
     friend class GmcMapPublisher;
     friend class SafecastPublisher;
+    friend class InfluxPublisher;
+
+    static constexpr uint32_t kPortalTaskStackBytes = 12288;
+    static constexpr uint32_t kPortalTaskIdleMs = 2;
+    static void portalTaskThunk(void *param);
+    std::function<void()> withAppState(std::function<void()> handler);
 
     void refreshParameters();
     void attachParameters();
@@ -88,6 +103,7 @@ private:
     void applyMenuHtmlForLocale(const String &locale);
     bool remountLittleFsIfNeeded(const char *context);
     void dumpFilesystemContents(const __FlashStringHelper *reason);
+    const String &assetManifest();
     bool sendStaticFile(const char *path, const char *contentType);
     void applyTemplateReplacements(String &content, const TemplateReplacements &replacements);
     void appendCommonTemplateVars(TemplateReplacements &replacements);
@@ -101,7 +117,17 @@ private:
     String csrfHiddenInput() const;
     void logConfigSave(const char *route, const std::vector<String> &changedFields);
     std::vector<String> collectChangedConfigFields(const AppConfig &before, const AppConfig &after) const;
+    void sendLogsPage(const String &message = String());
+    void handleLogFilePost();
+    void handleLogFileDownload();
+    void handlePreviousBootDownload();
     void handleLogsJson();
+    void handleLogStream();
+    void serviceLogStreams();
+    void closeLogStreams();
+    void handleDeviceStream();
+    void serviceDeviceStreams();
+    void closeDeviceStreams();
     void disablePortalPowerSave();
     void restorePortalPowerSave();
     void logPortalState(const char *context);
@@ -147,10 +173,13 @@ private:
     LedController &led_;
     const PublisherHealth &openRadiationHealth_;
     SafecastPublisher *safecastPublisher_ = nullptr;
+    LogFileWriter *logFileWriter_ = nullptr;
 
     bool paramsAttached_;
     String csrfToken_;
     String menuHtml_;
+    String assetManifest_;
+    bool assetManifestLoaded_ = false;
     String menuHtmlRendered_;
     String menuHtmlLocale_;
     wl_status_t lastStatus_;
@@ -182,7 +211,29 @@ private:
     TaskHandle_t otaTaskHandle_ = nullptr;
     portMUX_TYPE otaLock_ = portMUX_INITIALIZER_UNLOCKED;
     TaskHandle_t manifestTaskHandle_ = nullptr;
+    TaskHandle_t portalTaskHandle_ = nullptr;
     bool manifestForceRefresh_ = false;
     std::function<void()> onOtaStart_;
     bool otaHooksFired_ = false;
+    // Per-boot nonce in every SSE event id; see LogEventStream.h.
+    uint32_t streamEpoch_ = 0;
+    struct LogStreamClient
+    {
+        WiFiClient client;
+        uint32_t cursor = 0;
+        unsigned long lastWriteMs = 0;
+        bool resetPending = false;
+        bool active = false;
+    };
+    static constexpr size_t kMaxLogStreams = 2;
+    LogStreamClient logStreams_[kMaxLogStreams];
+    struct DeviceStreamClient
+    {
+        WiFiClient client;
+        uint32_t revision = 0;
+        unsigned long lastWriteMs = 0;
+        bool active = false;
+    };
+    static constexpr size_t kMaxDeviceStreams = 2;
+    DeviceStreamClient deviceStreams_[kMaxDeviceStreams];
 };
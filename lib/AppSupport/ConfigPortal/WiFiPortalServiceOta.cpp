@@ -68,7 +68,7 @@ void WiFiPortalService::sendOtaPage(const String &message)
 
     TemplateReplacements vars = {
         {"{{NOTICE_CLASS}}", noticeClass},
-        {"{{NOTICE_TEXT}}", htmlEscape(display)}};
+        {"{{NOTICE_TEXT}}", display}};
 
     appendCommonTemplateVars(vars);
     sendTemplate("/portal/ota.html", vars);
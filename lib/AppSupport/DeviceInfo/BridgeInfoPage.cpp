@@ -6,16 +6,20 @@
 #include <ArduinoJson.h>
 #include <LittleFS.h>
 
-BridgeInfoPage::BridgeInfoPage(const PublisherHealth &openSenseMapHealth,
+BridgeInfoPage::BridgeInfoPage(const PublisherHealth &mqttHealth,
+                               const PublisherHealth &openSenseMapHealth,
                                const PublisherHealth &gmcMapHealth,
                                const PublisherHealth &radmonHealth,
                                const PublisherHealth &openRadiationHealth,
-                               const PublisherHealth &safecastHealth)
-    : openSenseMapHealth_(openSenseMapHealth),
+                               const PublisherHealth &safecastHealth,
+                               const PublisherHealth &influxHealth)
+    : mqttHealth_(mqttHealth),
+      openSenseMapHealth_(openSenseMapHealth),
       gmcMapHealth_(gmcMapHealth),
       radmonHealth_(radmonHealth),
       openRadiationHealth_(openRadiationHealth),
-      safecastHealth_(safecastHealth)
+      safecastHealth_(safecastHealth),
+      influxHealth_(influxHealth)
 {
 }
 
@@ -36,6 +40,12 @@ void BridgeInfoPage::handlePage(WiFiManager *manager)
     manager->server->send(200, "text/html", html);
 }
 
+void BridgeInfoPage::setPublisherLoopStats(const PublisherLoopStats *stats, size_t count)
+{
+    loopStats_ = stats;
+    loopStatsCount_ = stats ? count : 0;
+}
+
 void BridgeInfoPage::handleJson(WiFiManager *manager)
 {
     if (!manager || !manager->server)
@@ -116,13 +126,42 @@ String BridgeInfoPage::collectJson() const
             json["lastReportUuid"] = snapshot.lastReportUuid;
         else
             json["lastReportUuid"] = nullptr;
+
+        JsonObject latency = json["latency"].to<JsonObject>();
+        for (size_t i = 0; i < kPublishPhaseCount; ++i)
+        {
+            const LatencyHistogram &histogram = snapshot.latency[i];
+            if (!histogram.count())
+                continue;
+            JsonObject phase = latency[publishPhaseKey(static_cast<PublishPhase>(i))].to<JsonObject>();
+            phase["count"] = histogram.count();
+            phase["p50"] = histogram.percentileMs(50);
+            phase["p95"] = histogram.percentileMs(95);
+            phase["p99"] = histogram.percentileMs(99);
+            phase["max"] = histogram.maxMs();
+        }
     };
 
+    appendHealth("mqtt", mqttHealth_.snapshot());
     appendHealth("openSenseMap", openSenseMapHealth_.snapshot());
     appendHealth("gmcMap", gmcMapHealth_.snapshot());
     appendHealth("radmon", radmonHealth_.snapshot());
     appendHealth("openRadiation", openRadiationHealth_.snapshot());
     appendHealth("safecast", safecastHealth_.snapshot());
+    appendHealth("influx", influxHealth_.snapshot());
+
+    JsonObject loopTimes = doc["publisherLoop"].to<JsonObject>();
+    for (size_t i = 0; i < loopStatsCount_; ++i)
+    {
+        const PublisherLoopStats &stats = loopStats_[i];
+        JsonObject json = loopTimes[stats.name].to<JsonObject>();
+        json["enabled"] = stats.enabled;
+        json["calls"] = stats.calls;
+        json["skipped"] = stats.skipped;
+        json["lastUs"] = stats.lastMicros;
+        json["maxUs"] = stats.maxMicros;
+        json["avgUs"] = stats.calls ? static_cast<uint32_t>(stats.totalMicros / stats.calls) : 0;
+    }
 
     String json;
     serializeJson(doc, json);
@@ -10,25 +10,33 @@
 #include <WiFi.h>
 #include <esp_wifi.h>
 #include "Publishing/PublisherHealth.h"
+#include "Publishing/PublisherRegistry.h"
 
 class BridgeInfoPage
 {
 public:
-    BridgeInfoPage(const PublisherHealth &openSenseMapHealth,
+    BridgeInfoPage(const PublisherHealth &mqttHealth,
+                   const PublisherHealth &openSenseMapHealth,
                    const PublisherHealth &gmcMapHealth,
                    const PublisherHealth &radmonHealth,
                    const PublisherHealth &openRadiationHealth,
-                   const PublisherHealth &safecastHealth);
+                   const PublisherHealth &safecastHealth,
+                   const PublisherHealth &influxHealth);
 
     void handlePage(WiFiManager *manager);
     void handleJson(WiFiManager *manager);
+    void setPublisherLoopStats(const PublisherLoopStats *stats, size_t count);
 
 private:
     String collectJson() const;
 
+    const PublisherHealth &mqttHealth_;
     const PublisherHealth &openSenseMapHealth_;
     const PublisherHealth &gmcMapHealth_;
     const PublisherHealth &radmonHealth_;
     const PublisherHealth &openRadiationHealth_;
     const PublisherHealth &safecastHealth_;
+    const PublisherHealth &influxHealth_;
+    const PublisherLoopStats *loopStats_ = nullptr;
+    size_t loopStatsCount_ = 0;
 };
@@ -0,0 +1,169 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "Logging/LogEventStream.h"
+#include "Logging/LogJsonChunk.h"
+#include "Publishing/NumberFormat.h"
+
+// Change tracking behind /device/stream. DeviceInfoStore bumps a revision
+// whenever a field actually changes and remembers the revision per field,
+// so a stream that last sent revision R only sends the fields changed after
+// R, as a JSON object with the /device.json keys:
+//
+//   {"tubeRate":"12.5","tubePulseCount":"8812","measurementAgeMs":0}
+//
+// Cleared fields are sent as null. Revisions restart at 0 with every boot,
+// so the SSE id carries the boot epoch (see LogEventStream.h) and
+// resumeRevision() maps an id from another boot to 0. Not thread-safe;
+// DeviceInfoStore serialises access.
+namespace DeviceInfoDelta
+{
+enum Field : uint8_t
+{
+    Manufacturer,
+    Model,
+    Firmware,
+    BridgeFirmware,
+    DeviceId,
+    Locale,
+    DevicePower,
+    BatteryVoltage,
+    BatteryPercent,
+    TubeRate,
+    TubeDoseRate,
+    TubePulseCount,
+    FieldCount,
+};
+
+static constexpr const char *kFieldNames[FieldCount] = {
+    "manufacturer",
+    "model",
+    "firmware",
+    "bridgeFirmware",
+    "deviceId",
+    "locale",
+    "devicePower",
+    "batteryVoltage",
+    "batteryPercent",
+    "tubeRate",
+    "tubeDoseRate",
+    "tubePulseCount",
+};
+
+static constexpr uint32_t kAllFields = (1UL << FieldCount) - 1;
+static constexpr uint32_t kMeasurementFields = (1UL << TubeRate) | (1UL << TubeDoseRate) | (1UL << TubePulseCount);
+
+// Every field, escaped, plus the measurement age.
+static constexpr size_t kMaxJsonBytes = 1024;
+
+constexpr uint32_t bit(Field field) { return 1UL << field; }
+
+class Revisions
+{
+public:
+    uint32_t current() const { return current_; }
+
+    void touch(Field field) { fields_[field] = ++current_; }
+
+    // Fields changed after revision since; 0 or a revision ahead of
+    // current gets everything.
+    uint32_t changedSince(uint32_t since) const
+    {
+        if (!since || since > current_)
+            return kAllFields;
+        uint32_t mask = 0;
+        for (size_t i = 0; i < FieldCount; ++i)
+        {
+            if (fields_[i] > since)
+                mask |= 1UL << i;
+        }
+        return mask;
+    }
+
+private:
+    uint32_t current_ = 0;
+    uint32_t fields_[FieldCount] = {};
+};
+
+// Revision to resume a stream from, given the client's Last-Event-ID. An
+// id from another boot is 0 even when this boot has reached the same
+// number, because the fields behind that number differ.
+inline uint32_t resumeRevision(const char *lastEventId, uint32_t epoch)
+{
+    uint32_t since = 0;
+    LogEventStream::parseEventId(lastEventId, epoch, since);
+    return since;
+}
+
+// Writes the fields in mask as a JSON object; valueOf(field, length)
+// returns a field's text, empty meaning null. measurementAgeMs is added
+// when a measurement field is included; negative means no measurement
+// yet. Returns the length, or 0 if out is too small.
+template <typename ValueOf>
+size_t writeJson(char *out, size_t capacity, uint32_t mask, ValueOf &&valueOf, long measurementAgeMs)
+{
+    if (!out || capacity < 2)
+        return 0;
+    size_t used = 0;
+    auto put = [&](const char *text, size_t length) {
+        if (capacity - used < length)
+            return false;
+        std::memcpy(out + used, text, length);
+        used += length;
+        return true;
+    };
+    auto putKey = [&](const char *name) {
+        return (used == 1 || put(",", 1)) && put("\"", 1) && put(name, std::strlen(name)) && put("\":", 2);
+    };
+
+    put("{", 1);
+    for (size_t i = 0; i < FieldCount; ++i)
+    {
+        if (!(mask & (1UL << i)))
+            continue;
+        if (!putKey(kFieldNames[i]))
+            return 0;
+        size_t length = 0;
+        const char *value = valueOf(static_cast<Field>(i), length);
+        if (!value || !length)
+        {
+            if (!put("null", 4))
+                return 0;
+            continue;
+        }
+        const size_t next = LogJsonChunk::appendLine(out, capacity, used, value, length, true);
+        if (next == used)
+            return 0;
+        used = next;
+    }
+    if (mask & kMeasurementFields)
+    {
+        if (!putKey("measurementAgeMs"))
+            return 0;
+        if (measurementAgeMs < 0)
+        {
+            if (!put("null", 4))
+                return 0;
+        }
+        else
+        {
+            char digits[NumberFormat::kMaxChars];
+            const size_t length = NumberFormat::formatUnsigned(digits, sizeof(digits), static_cast<uint32_t>(measurementAgeMs));
+            if (!put(digits, length))
+                return 0;
+        }
+    }
+    if (!put("}", 1))
+        return 0;
+    return used;
+}
+} // namespace DeviceInfoDelta
@@ -15,7 +15,7 @@ DeviceInfoStore::DeviceInfoStore()
 void DeviceInfoStore::setBridgeFirmware(const String &version)
 {
     portENTER_CRITICAL(&mux_);
-    bridgeFirmware_ = version;
+    assign(bridgeFirmware_, version, DeviceInfoDelta::BridgeFirmware);
     portEXIT_CRITICAL(&mux_);
 }
 
@@ -25,9 +25,17 @@ void DeviceInfoStore::setManufacturerFromModel(const String &model)
         return;
     int space = model.indexOf(' ');
     if (space > 0)
-        manufacturer_ = model.substring(0, space);
+        assign(manufacturer_, model.substring(0, space), DeviceInfoDelta::Manufacturer);
     else
-        manufacturer_ = model;
+        assign(manufacturer_, model, DeviceInfoDelta::Manufacturer);
+}
+
+void DeviceInfoStore::assign(String &field, const String &value, DeviceInfoDelta::Field id, bool always)
+{
+    if (!always && field == value)
+        return;
+    field = value;
+    revisions_.touch(id);
 }
 
 void DeviceInfoStore::update(DeviceManager::CommandType type, const String &value)
@@ -37,37 +45,37 @@ void DeviceInfoStore::update(DeviceManager::CommandType type, const String &valu
     switch (type)
     {
     case DeviceManager::CommandType::DeviceId:
-        deviceId_ = value;
+        assign(deviceId_, value, DeviceInfoDelta::DeviceId);
         break;
     case DeviceManager::CommandType::DeviceModel:
-        model_ = value;
+        assign(model_, value, DeviceInfoDelta::Model);
         setManufacturerFromModel(value);
         break;
     case DeviceManager::CommandType::DeviceFirmware:
-        firmware_ = value;
+        assign(firmware_, value, DeviceInfoDelta::Firmware);
         break;
     case DeviceManager::CommandType::DeviceLocale:
-        locale_ = value;
+        assign(locale_, value, DeviceInfoDelta::Locale);
         break;
     case DeviceManager::CommandType::DevicePower:
-        devicePower_ = value;
+        assign(devicePower_, value, DeviceInfoDelta::DevicePower);
         break;
     case DeviceManager::CommandType::DeviceBatteryVoltage:
-        batteryVoltage_ = value;
+        assign(batteryVoltage_, value, DeviceInfoDelta::BatteryVoltage);
         break;
     case DeviceManager::CommandType::DeviceBatteryPercent:
-        batteryPercent_ = value;
+        assign(batteryPercent_, value, DeviceInfoDelta::BatteryPercent);
         break;
     case DeviceManager::CommandType::TubePulseCount:
-        tubePulseCount_ = value;
+        assign(tubePulseCount_, value, DeviceInfoDelta::TubePulseCount, true);
         measurementUpdatedMs_ = now;
         break;
     case DeviceManager::CommandType::TubeRate:
-        tubeRate_ = value;
+        assign(tubeRate_, value, DeviceInfoDelta::TubeRate, true);
         measurementUpdatedMs_ = now;
         break;
     case DeviceManager::CommandType::TubeDoseRate:
-        tubeDoseRate_ = value;
+        assign(tubeDoseRate_, value, DeviceInfoDelta::TubeDoseRate, true);
         measurementUpdatedMs_ = now;
         break;
     default:
@@ -78,23 +86,25 @@ void DeviceInfoStore::update(DeviceManager::CommandType type, const String &valu
 
 void DeviceInfoStore::clearLiveData()
 {
+    const String empty;
     portENTER_CRITICAL(&mux_);
-    devicePower_ = "";
-    batteryVoltage_ = "";
-    batteryPercent_ = "";
-    tubeRate_ = "";
-    tubeDoseRate_ = "";
-    tubePulseCount_ = "";
+    assign(devicePower_, empty, DeviceInfoDelta::DevicePower);
+    assign(batteryVoltage_, empty, DeviceInfoDelta::BatteryVoltage);
+    assign(batteryPercent_, empty, DeviceInfoDelta::BatteryPercent);
+    assign(tubeRate_, empty, DeviceInfoDelta::TubeRate);
+    assign(tubeDoseRate_, empty, DeviceInfoDelta::TubeDoseRate);
+    assign(tubePulseCount_, empty, DeviceInfoDelta::TubePulseCount);
     measurementUpdatedMs_ = 0;
     portEXIT_CRITICAL(&mux_);
 }
 
 void DeviceInfoStore::clearMeasurements()
 {
+    const String empty;
     portENTER_CRITICAL(&mux_);
-    tubeRate_ = "";
-    tubeDoseRate_ = "";
-    tubePulseCount_ = "";
+    assign(tubeRate_, empty, DeviceInfoDelta::TubeRate);
+    assign(tubeDoseRate_, empty, DeviceInfoDelta::TubeDoseRate);
+    assign(tubePulseCount_, empty, DeviceInfoDelta::TubePulseCount);
     measurementUpdatedMs_ = 0;
     portEXIT_CRITICAL(&mux_);
 }
@@ -103,11 +113,90 @@ DeviceInfoSnapshot DeviceInfoStore::snapshot() const
 {
     DeviceInfoSnapshot snap;
     portENTER_CRITICAL(&mux_);
+    fillSnapshot(snap);
+    portEXIT_CRITICAL(&mux_);
+    return snap;
+}
+
+uint32_t DeviceInfoStore::revision() const
+{
+    portENTER_CRITICAL(&mux_);
+    const uint32_t current = revisions_.current();
+    portEXIT_CRITICAL(&mux_);
+    return current;
+}
+
+uint32_t DeviceInfoStore::changesSince(uint32_t since, DeviceInfoSnapshot &snap, uint32_t &mask) const
+{
+    portENTER_CRITICAL(&mux_);
+    fillSnapshot(snap);
+    mask = revisions_.changedSince(since);
+    const uint32_t current = revisions_.current();
+    portEXIT_CRITICAL(&mux_);
+    return current;
+}
+
+size_t DeviceInfoStore::writeDelta(uint32_t since, char *out, size_t capacity, uint32_t &revision) const
+{
+    DeviceInfoSnapshot snap;
+    uint32_t mask = 0;
+    revision = changesSince(since, snap, mask);
+    auto valueOf = [&snap](DeviceInfoDelta::Field field, size_t &length) -> const char * {
+        const String *value = nullptr;
+        switch (field)
+        {
+        case DeviceInfoDelta::Manufacturer:
+            value = &snap.manufacturer;
+            break;
+        case DeviceInfoDelta::Model:
+            value = &snap.model;
+            break;
+        case DeviceInfoDelta::Firmware:
+            value = &snap.firmware;
+            break;
+        case DeviceInfoDelta::BridgeFirmware:
+            value = &snap.bridgeFirmware;
+            break;
+        case DeviceInfoDelta::DeviceId:
+            value = &snap.deviceId;
+            break;
+        case DeviceInfoDelta::Locale:
+            value = &snap.locale;
+            break;
+        case DeviceInfoDelta::DevicePower:
+            value = &snap.devicePower;
+            break;
+        case DeviceInfoDelta::BatteryVoltage:
+            value = &snap.batteryVoltage;
+            break;
+        case DeviceInfoDelta::BatteryPercent:
+            value = &snap.batteryPercent;
+            break;
+        case DeviceInfoDelta::TubeRate:
+            value = &snap.tubeRate;
+            break;
+        case DeviceInfoDelta::TubeDoseRate:
+            value = &snap.tubeDoseRate;
+            break;
+        case DeviceInfoDelta::TubePulseCount:
+            value = &snap.tubePulseCount;
+            break;
+        default:
+            break;
+        }
+        length = value ? value->length() : 0;
+        return value ? value->c_str() : nullptr;
+    };
+    return DeviceInfoDelta::writeJson(out, capacity, mask, valueOf,
+                                      snap.hasMeasurement ? static_cast<long>(snap.measurementAgeMs) : -1L);
+}
+
+void DeviceInfoStore::fillSnapshot(DeviceInfoSnapshot &snap) const
+{
     snap.manufacturer = manufacturer_;
     snap.model = model_;
     snap.firmware = firmware_;
     snap.bridgeFirmware = bridgeFirmware_;
-    snap.bridgeFirmware = bridgeFirmware_;
     snap.deviceId = deviceId_;
     snap.locale = locale_;
     snap.devicePower = devicePower_;
@@ -116,12 +205,19 @@ DeviceInfoSnapshot DeviceInfoStore::snapshot() const
     snap.tubeRate = tubeRate_;
     snap.tubeDoseRate = tubeDoseRate_;
     snap.tubePulseCount = tubePulseCount_;
+    snap.hasMeasurement = measurementUpdatedMs_ != 0;
     if (measurementUpdatedMs_)
         snap.measurementAgeMs = millis() - measurementUpdatedMs_;
     else
         snap.measurementAgeMs = 0;
+}
+
+String DeviceInfoStore::deviceId() const
+{
+    portENTER_CRITICAL(&mux_);
+    String id = deviceId_;
     portEXIT_CRITICAL(&mux_);
-    return snap;
+    return id;
 }
 
 String DeviceInfoStore::toJson() const
@@ -8,6 +8,7 @@
 
 #include <Arduino.h>
 #include "DeviceManager.h"
+#include "DeviceInfo/DeviceInfoDelta.h"
 #include <freertos/FreeRTOS.h>
 
 struct DeviceInfoSnapshot
@@ -25,6 +26,7 @@ struct DeviceInfoSnapshot
     String tubeDoseRate;
     String tubePulseCount;
     unsigned long measurementAgeMs = 0;
+    bool hasMeasurement = false;
 };
 
 class DeviceInfoStore
@@ -38,10 +40,25 @@ public:
     void clearLiveData();
 
     DeviceInfoSnapshot snapshot() const;
+    String deviceId() const;
     String toJson() const;
 
+    // Bumped whenever a field changes value.
+    uint32_t revision() const;
+    // Takes a snapshot and the mask of DeviceInfoDelta fields changed after
+    // revision since. Returns the revision the snapshot belongs to.
+    uint32_t changesSince(uint32_t since, DeviceInfoSnapshot &snap, uint32_t &mask) const;
+    // Writes the fields changed after revision since as a JSON object (see
+    // DeviceInfoDelta.h) and sets revision to the one it reflects. Returns
+    // the length, 0 if out is too small.
+    size_t writeDelta(uint32_t since, char *out, size_t capacity, uint32_t &revision) const;
+
 private:
     void setManufacturerFromModel(const String &model);
+    // Touches the field's revision when the value changed, or always for a
+    // fresh reading so streams pass on the reset measurement age.
+    void assign(String &field, const String &value, DeviceInfoDelta::Field id, bool always = false);
+    void fillSnapshot(DeviceInfoSnapshot &snap) const;
 
     mutable portMUX_TYPE mux_;
     String manufacturer_;
@@ -57,4 +74,5 @@ private:
     String tubeDoseRate_;
     String tubePulseCount_;
     unsigned long measurementUpdatedMs_ = 0;
+    DeviceInfoDelta::Revisions revisions_;
 };
@@ -8,15 +8,23 @@
 
 #include <Arduino.h>
 #include <cmath>
+#include "Publishing/NumberFormat.h"
 
 namespace GmcMapPayload
 {
-inline String formatCpm(float cpm)
+// Whole counts per minute, rounded half up; anything not positive is "0".
+inline size_t formatCpm(char *out, size_t capacity, float cpm)
 {
     if (!std::isfinite(cpm) || cpm <= 0.0f)
-        return "0";
+        return NumberFormat::formatUnsigned(out, capacity, 0);
+    return NumberFormat::formatFixed(out, capacity, cpm, 0);
+}
 
-    return String(static_cast<long>(std::floor(cpm + 0.5f)));
+inline String formatCpm(float cpm)
+{
+    char text[NumberFormat::kMaxChars];
+    formatCpm(text, sizeof(text), cpm);
+    return String(text);
 }
 
 inline String buildLogQuery(const String &accountId,
@@ -29,10 +37,13 @@ inline String buildLogQuery(const String &accountId,
     query += accountId;
     query += "&GID=";
     query += deviceId;
+    char cpmText[NumberFormat::kMaxChars];
     query += "&CPM=";
-    query += formatCpm(cpm);
+    formatCpm(cpmText, sizeof(cpmText), cpm);
+    query += cpmText;
     query += "&ACPM=";
-    query += formatCpm(acpm);
+    formatCpm(cpmText, sizeof(cpmText), acpm);
+    query += cpmText;
     query += "&uSV=";
     query += uSv;
     return query;
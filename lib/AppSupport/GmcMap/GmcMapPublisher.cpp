@@ -15,6 +15,7 @@
 #include "GmcMap/GmcMapPortalLinks.h"
 #include "GmcMap/GmcMapPayload.h"
 #include "Publishing/HttpPublishResponse.h"
+#include "Publishing/PublishPhaseTimer.h"
 #include "Runtime/CooperativePump.h"
 
 namespace
@@ -291,17 +292,17 @@ void GmcMapPublisher::SendPortalForm(WiFiPortalService &portal, const String &me
     if (!portal.manager_.server)
         return;
 
-    String notice = WiFiPortalService::htmlEscape(message);
+    const String &notice = message;
     const String deviceHistoryUrl = GmcMapPortalLinks::buildGmcMapDeviceHistoryUrl(
         portal.config_.gmcMapDeviceId);
     WiFiPortalService::TemplateReplacements vars = {
         {"{{NOTICE_CLASS}}", notice.length() ? String() : String("hidden")},
         {"{{NOTICE_TEXT}}", notice},
         {"{{GMC_ENABLED_CHECKED}}", portal.config_.gmcMapEnabled ? String("checked") : String()},
-        {"{{GMC_ACCOUNT}}", WiFiPortalService::htmlEscape(portal.config_.gmcMapAccountId)},
-        {"{{GMC_DEVICE}}", WiFiPortalService::htmlEscape(portal.config_.gmcMapDeviceId)},
+        {"{{GMC_ACCOUNT}}", portal.config_.gmcMapAccountId},
+        {"{{GMC_DEVICE}}", portal.config_.gmcMapDeviceId},
         {"{{GMC_DEVICE_LINK_CLASS}}", deviceHistoryUrl.length() ? String() : String("hidden")},
-        {"{{GMC_DEVICE_URL}}", WiFiPortalService::htmlEscape(deviceHistoryUrl)}};
+        {"{{GMC_DEVICE_URL}}", deviceHistoryUrl}};
 
     portal.appendCommonTemplateVars(vars);
     portal.sendTemplate("/portal/gmc.html", vars);
@@ -309,14 +310,25 @@ void GmcMapPublisher::SendPortalForm(WiFiPortalService &portal, const String &me
 
 bool GmcMapPublisher::sendRequest(const String &query)
 {
+    PublishPhaseTimer timer(&health_);
+    IPAddress address;
+    if (!WiFi.hostByName(kHost, address))
+    {
+        log_.println("GMCMap: DNS lookup failed.");
+        health_.noteFailure(millis(), "dns failed");
+        return false;
+    }
+    timer.lap(PublishPhase::Dns);
+
     WiFiClient client;
     client.setTimeout(10);
-    if (!client.connect(kHost, kPort))
+    if (!client.connect(address, kPort))
     {
         log_.println("GMCMap: connect failed.");
         health_.noteFailure(millis(), "connect failed");
         return false;
     }
+    timer.lap(PublishPhase::Connect);
 
     String request;
     request.reserve(query.length() + 80);
@@ -336,12 +348,18 @@ bool GmcMapPublisher::sendRequest(const String &query)
     }
 
     client.flush();
+    timer.lap(PublishPhase::RequestWrite);
 
     const auto response = HttpPublishResponse::readStatus(
         client,
         10000,
         []() { return millis(); },
         []() { CooperativePump::service(); });
+    if (response.statusLine.length())
+    {
+        timer.lap(PublishPhase::FirstByte);
+        timer.finish();
+    }
 
     if (!response.success)
     {
@@ -20,6 +20,8 @@ class WiFiPortalService;
 class GmcMapPublisher
 {
 public:
+    static constexpr const char *kPublisherName = "gmcMap";
+
     GmcMapPublisher(AppConfig &config, Print &log, const char *bridgeVersion, PublisherHealth &health);
 
     void begin();
@@ -27,6 +29,7 @@ public:
     void loop();
     void onCommandResult(DeviceManager::CommandType type, const String &value);
     void clearPendingData();
+    bool isEnabled() const;
     void setPaused(bool paused) { paused_ = paused; }
     static void SendPortalForm(WiFiPortalService &portal, const String &message = String());
     static void HandlePortalPost(WebServer &server,
@@ -37,7 +40,6 @@ public:
                                  String &message);
 
 private:
-    bool isEnabled() const;
     bool publishPending();
     bool sendRequest(const String &query);
     void syncHealthState();
@@ -0,0 +1,65 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <ArduinoJson.h>
+
+#include "AppConfig/AppConfig.h"
+
+namespace InfluxBackupJson
+{
+inline void appendConfig(JsonDocument &doc, const AppConfig &config)
+{
+    doc["influxEnabled"] = config.influxEnabled;
+    doc["influxUrl"] = config.influxUrl;
+    doc["influxToken"] = config.influxToken;
+    doc["influxMeasurement"] = config.influxMeasurement;
+    doc["influxPointIntervalSeconds"] = config.influxPointIntervalSeconds;
+    doc["influxBatchPoints"] = config.influxBatchPoints;
+    doc["influxFlushSeconds"] = config.influxFlushSeconds;
+    doc["influxGzip"] = config.influxGzip;
+}
+
+inline void applyConfig(JsonVariantConst input, AppConfig &config)
+{
+    auto setString = [](String &target, JsonVariantConst value) {
+        if (!value.is<const char *>())
+            return;
+        String text(value.as<const char *>());
+        text.trim();
+        target = text;
+    };
+
+    auto setBool = [](bool &target, JsonVariantConst value) {
+        if (!value.isNull())
+            target = value.as<bool>();
+    };
+
+    auto setClamped = [](uint32_t &target, JsonVariantConst value, uint32_t minValue, uint32_t maxValue) {
+        if (value.isNull())
+            return;
+        uint32_t parsed = value.as<uint32_t>();
+        if (parsed < minValue)
+            parsed = minValue;
+        if (parsed > maxValue)
+            parsed = maxValue;
+        target = parsed;
+    };
+
+    setBool(config.influxEnabled, input["influxEnabled"]);
+    setString(config.influxUrl, input["influxUrl"]);
+    setString(config.influxToken, input["influxToken"]);
+    setString(config.influxMeasurement, input["influxMeasurement"]);
+    setClamped(config.influxPointIntervalSeconds, input["influxPointIntervalSeconds"], kMinInfluxPointIntervalSeconds, 86400);
+    setClamped(config.influxBatchPoints, input["influxBatchPoints"], kMinInfluxBatchPoints, kMaxInfluxBatchPoints);
+    setClamped(config.influxFlushSeconds, input["influxFlushSeconds"], kMinInfluxFlushSeconds, kMaxInfluxFlushSeconds);
+    setBool(config.influxGzip, input["influxGzip"]);
+
+    if (!config.influxMeasurement.length())
+        config.influxMeasurement = "radpro";
+}
+} // namespace InfluxBackupJson
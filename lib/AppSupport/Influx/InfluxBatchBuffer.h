@@ -0,0 +1,104 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "Influx/InfluxLineProtocol.h"
+
+// Fixed-size queue of line-protocol points. New points are formatted in place
+// at the tail (beginLine/commitLine), batches are sent straight from the head
+// and the same storage holds the backlog while the endpoint is unreachable.
+// When full, the oldest whole points are dropped to make room.
+class InfluxBatchBuffer
+{
+public:
+    static constexpr size_t kCapacityBytes = 12288;
+    static constexpr size_t kMaxLines = 160;
+
+    // Returns where the next point should be written, with room for at least
+    // kMaxLineBytes. droppedLines reports how many old points were evicted.
+    char *beginLine(size_t &capacity, size_t &droppedLines)
+    {
+        droppedLines = 0;
+        while (count_ && (count_ >= kMaxLines || kCapacityBytes - used_ < InfluxLineProtocol::kMaxLineBytes))
+        {
+            consume(1);
+            ++droppedLines;
+        }
+        capacity = InfluxLineProtocol::kMaxLineBytes;
+        return data_ + used_;
+    }
+
+    void commitLine(size_t length, unsigned long nowMs)
+    {
+        if (!length || length > InfluxLineProtocol::kMaxLineBytes || count_ >= kMaxLines)
+            return;
+        const size_t slot = (head_ + count_) % kMaxLines;
+        lengths_[slot] = static_cast<uint16_t>(length);
+        enqueuedMs_[slot] = nowMs;
+        used_ += length;
+        ++count_;
+    }
+
+    // Byte length of the longest whole-line prefix that fits into maxBytes.
+    size_t batchBytes(size_t maxBytes, size_t &lines) const
+    {
+        size_t bytes = 0;
+        lines = 0;
+        while (lines < count_)
+        {
+            const size_t length = lengths_[(head_ + lines) % kMaxLines];
+            if (bytes + length > maxBytes)
+                break;
+            bytes += length;
+            ++lines;
+        }
+        return bytes;
+    }
+
+    void consume(size_t lines)
+    {
+        size_t bytes = 0;
+        while (lines-- && count_)
+        {
+            bytes += lengths_[head_];
+            head_ = (head_ + 1) % kMaxLines;
+            --count_;
+        }
+        if (bytes)
+            std::memmove(data_, data_ + bytes, used_ - bytes);
+        used_ -= bytes;
+    }
+
+    void clear()
+    {
+        used_ = 0;
+        head_ = 0;
+        count_ = 0;
+    }
+
+    unsigned long oldestAgeMs(unsigned long nowMs) const
+    {
+        return count_ ? nowMs - enqueuedMs_[head_] : 0;
+    }
+
+    const char *data() const { return data_; }
+    size_t size() const { return used_; }
+    size_t lineCount() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+private:
+    char data_[kCapacityBytes];
+    uint16_t lengths_[kMaxLines] = {};
+    unsigned long enqueuedMs_[kMaxLines] = {};
+    size_t used_ = 0;
+    size_t head_ = 0;
+    size_t count_ = 0;
+};
@@ -0,0 +1,212 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Single-block gzip encoder for line-protocol batches: greedy LZ77 with one
+// hash candidate per position and the fixed Huffman tables from RFC 1951.
+// Repeated measurement, tag and field names make up most of a batch, which
+// this catches without the 30+ KiB state of a dynamic-Huffman deflater.
+namespace InfluxGzip
+{
+static constexpr size_t kHashBits = 10;
+static constexpr size_t kMinMatch = 3;
+static constexpr size_t kMaxMatch = 258;
+static constexpr size_t kMaxDistance = 32768;
+static constexpr size_t kHeaderBytes = 10;
+static constexpr size_t kTrailerBytes = 8;
+
+struct Workspace
+{
+    // Position + 1 of the last occurrence of each 3-byte hash; 0 is empty.
+    uint16_t head[1u << kHashBits];
+};
+
+inline uint32_t crc32(const uint8_t *data, size_t length, uint32_t crc = 0)
+{
+    static const uint32_t kNibbleTable[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C};
+    crc = ~crc;
+    for (size_t i = 0; i < length; ++i)
+    {
+        crc ^= data[i];
+        crc = (crc >> 4) ^ kNibbleTable[crc & 0x0F];
+        crc = (crc >> 4) ^ kNibbleTable[crc & 0x0F];
+    }
+    return ~crc;
+}
+
+namespace detail
+{
+static const uint16_t kLengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                         35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+static const uint8_t kLengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                         3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+static const uint16_t kDistanceBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129,
+                                           193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097,
+                                           6145, 8193, 12289, 16385, 24577};
+static const uint8_t kDistanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6,
+                                           6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+class BitWriter
+{
+public:
+    BitWriter(uint8_t *out, size_t capacity, size_t pos) : out_(out), capacity_(capacity), pos_(pos) {}
+
+    void putBits(uint32_t value, unsigned count)
+    {
+        bits_ |= value << bitCount_;
+        bitCount_ += count;
+        while (bitCount_ >= 8)
+        {
+            putByte(static_cast<uint8_t>(bits_));
+            bits_ >>= 8;
+            bitCount_ -= 8;
+        }
+    }
+
+    // Huffman codes go out most significant bit first.
+    void putCode(uint32_t code, unsigned length)
+    {
+        uint32_t reversed = 0;
+        for (unsigned i = 0; i < length; ++i)
+            reversed |= ((code >> i) & 1u) << (length - 1 - i);
+        putBits(reversed, length);
+    }
+
+    void putByte(uint8_t value)
+    {
+        if (pos_ >= capacity_)
+        {
+            overflow_ = true;
+            return;
+        }
+        out_[pos_++] = value;
+    }
+
+    void alignToByte()
+    {
+        if (bitCount_)
+            putBits(0, 8 - bitCount_);
+    }
+
+    size_t position() const { return pos_; }
+    bool overflow() const { return overflow_; }
+
+private:
+    uint8_t *out_;
+    size_t capacity_;
+    size_t pos_;
+    uint32_t bits_ = 0;
+    unsigned bitCount_ = 0;
+    bool overflow_ = false;
+};
+
+inline void putLiteralLength(BitWriter &writer, unsigned symbol)
+{
+    if (symbol < 144)
+        writer.putCode(0x30 + symbol, 8);
+    else if (symbol < 256)
+        writer.putCode(0x190 + (symbol - 144), 9);
+    else if (symbol < 280)
+        writer.putCode(symbol - 256, 7);
+    else
+        writer.putCode(0xC0 + (symbol - 280), 8);
+}
+
+inline void putMatch(BitWriter &writer, size_t length, size_t distance)
+{
+    unsigned index = 28;
+    while (kLengthBase[index] > length)
+        --index;
+    putLiteralLength(writer, 257 + index);
+    writer.putBits(static_cast<uint32_t>(length - kLengthBase[index]), kLengthExtra[index]);
+
+    index = 29;
+    while (kDistanceBase[index] > distance)
+        --index;
+    writer.putCode(index, 5);
+    writer.putBits(static_cast<uint32_t>(distance - kDistanceBase[index]), kDistanceExtra[index]);
+}
+
+inline uint32_t hash3(const uint8_t *p)
+{
+    const uint32_t value = (static_cast<uint32_t>(p[0]) << 16) | (static_cast<uint32_t>(p[1]) << 8) | p[2];
+    return (value * 2654435761u) >> (32 - kHashBits);
+}
+
+inline void putLe32(BitWriter &writer, uint32_t value)
+{
+    for (int i = 0; i < 4; ++i)
+        writer.putByte(static_cast<uint8_t>(value >> (8 * i)));
+}
+} // namespace detail
+
+// Compresses input into a complete gzip member. Returns the encoded size, or
+// 0 when it would not fit into capacity (callers then send the input as is).
+inline size_t compress(const uint8_t *input, size_t length, uint8_t *out, size_t capacity, Workspace &workspace)
+{
+    if (!input || !out || length > 0xFFFF || capacity < kHeaderBytes + kTrailerBytes)
+        return 0;
+
+    static const uint8_t kHeader[kHeaderBytes] = {0x1F, 0x8B, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF};
+    std::memcpy(out, kHeader, kHeaderBytes);
+    std::memset(workspace.head, 0, sizeof(workspace.head));
+
+    detail::BitWriter writer(out, capacity - kTrailerBytes, kHeaderBytes);
+    writer.putBits(1, 1); // BFINAL
+    writer.putBits(1, 2); // BTYPE = fixed Huffman
+
+    size_t pos = 0;
+    while (pos < length && !writer.overflow())
+    {
+        size_t matchLength = 0;
+        size_t matchDistance = 0;
+        if (pos + kMinMatch <= length)
+        {
+            const uint32_t hash = detail::hash3(input + pos);
+            const size_t candidate = workspace.head[hash];
+            workspace.head[hash] = static_cast<uint16_t>(pos + 1);
+            if (candidate && pos - (candidate - 1) <= kMaxDistance)
+            {
+                const uint8_t *previous = input + candidate - 1;
+                const size_t limit = (length - pos) < kMaxMatch ? (length - pos) : kMaxMatch;
+                while (matchLength < limit && previous[matchLength] == input[pos + matchLength])
+                    ++matchLength;
+                matchDistance = pos - (candidate - 1);
+            }
+        }
+
+        if (matchLength >= kMinMatch)
+        {
+            detail::putMatch(writer, matchLength, matchDistance);
+            for (size_t i = 1; i < matchLength && pos + i + kMinMatch <= length; ++i)
+                workspace.head[detail::hash3(input + pos + i)] = static_cast<uint16_t>(pos + i + 1);
+            pos += matchLength;
+        }
+        else
+        {
+            detail::putLiteralLength(writer, input[pos]);
+            ++pos;
+        }
+    }
+
+    detail::putLiteralLength(writer, 256);
+    writer.alignToByte();
+    if (writer.overflow())
+        return 0;
+
+    detail::BitWriter trailer(out, capacity, writer.position());
+    detail::putLe32(trailer, crc32(input, length));
+    detail::putLe32(trailer, static_cast<uint32_t>(length));
+    return trailer.overflow() ? 0 : trailer.position();
+}
+} // namespace InfluxGzip
@@ -0,0 +1,161 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "Publishing/NumberFormat.h"
+
+// InfluxDB line protocol, written straight into a caller-owned buffer:
+//   radpro,device=<id> cpm=42.5,dose_rate=0.27,pulses=1234i 1760000000123456789
+namespace InfluxLineProtocol
+{
+// Longest point formatPoint() may produce, including the newline.
+static constexpr size_t kMaxLineBytes = 256;
+
+static constexpr const char *kMeasurementSpecials = ", ";
+static constexpr const char *kTagSpecials = ",= ";
+
+struct Point
+{
+    const char *measurement = nullptr;
+    const char *deviceId = nullptr;
+    const char *cpm = nullptr;
+    const char *doseRate = nullptr;
+    const char *pulses = nullptr;
+    uint32_t seconds = 0;
+    uint32_t nanoseconds = 0;
+};
+
+// Accepts the finite decimal text the device reports; rejects anything that
+// would need quoting or change the field type on the server.
+inline bool isFloatText(const char *text)
+{
+    if (!text || !*text)
+        return false;
+    for (const char *p = text; *p; ++p)
+    {
+        const char c = *p;
+        if (!((c >= '0' && c <= '9') || c == '.' || c == '-' || c == '+' || c == 'e' || c == 'E'))
+            return false;
+    }
+    char *end = nullptr;
+    const double parsed = std::strtod(text, &end);
+    return end && *end == '\0' && std::isfinite(parsed);
+}
+
+inline bool isIntegerText(const char *text)
+{
+    if (!text || !*text)
+        return false;
+    const char *p = text;
+    if (*p == '-')
+        ++p;
+    if (!*p)
+        return false;
+    for (; *p; ++p)
+    {
+        if (*p < '0' || *p > '9')
+            return false;
+    }
+    return true;
+}
+
+namespace detail
+{
+inline bool put(char *out, size_t capacity, size_t &pos, char c)
+{
+    if (pos >= capacity)
+        return false;
+    out[pos++] = c;
+    return true;
+}
+
+inline bool putText(char *out, size_t capacity, size_t &pos, const char *text)
+{
+    for (const char *p = text; *p; ++p)
+    {
+        if (!put(out, capacity, pos, *p))
+            return false;
+    }
+    return true;
+}
+
+inline bool putEscaped(char *out, size_t capacity, size_t &pos, const char *text, const char *specials)
+{
+    for (const char *p = text; *p; ++p)
+    {
+        // Line protocol has no escape for line breaks; drop them.
+        if (*p == '\n' || *p == '\r')
+            continue;
+        if (std::strchr(specials, *p) && !put(out, capacity, pos, '\\'))
+            return false;
+        if (!put(out, capacity, pos, *p))
+            return false;
+    }
+    return true;
+}
+
+inline bool putField(char *out, size_t capacity, size_t &pos, bool &first, const char *key, const char *value, const char *suffix)
+{
+    if (!first && !put(out, capacity, pos, ','))
+        return false;
+    first = false;
+    return putText(out, capacity, pos, key) &&
+           put(out, capacity, pos, '=') &&
+           putText(out, capacity, pos, value) &&
+           putText(out, capacity, pos, suffix);
+}
+} // namespace detail
+
+// Writes one newline-terminated point and returns its length, or 0 when the
+// point has no valid field or does not fit. Nothing past the returned length
+// is meaningful; the buffer is not NUL-terminated.
+inline size_t formatPoint(char *out, size_t capacity, const Point &point)
+{
+    if (!out || !point.measurement || !*point.measurement)
+        return 0;
+
+    size_t pos = 0;
+    if (!detail::putEscaped(out, capacity, pos, point.measurement, kMeasurementSpecials))
+        return 0;
+    if (point.deviceId && *point.deviceId)
+    {
+        if (!detail::putText(out, capacity, pos, ",device=") ||
+            !detail::putEscaped(out, capacity, pos, point.deviceId, kTagSpecials))
+            return 0;
+    }
+    if (!detail::put(out, capacity, pos, ' '))
+        return 0;
+
+    bool first = true;
+    if (isFloatText(point.cpm) && !detail::putField(out, capacity, pos, first, "cpm", point.cpm, ""))
+        return 0;
+    if (isFloatText(point.doseRate) && !detail::putField(out, capacity, pos, first, "dose_rate", point.doseRate, ""))
+        return 0;
+    if (isIntegerText(point.pulses) && !detail::putField(out, capacity, pos, first, "pulses", point.pulses, "i"))
+        return 0;
+    if (first)
+        return 0;
+
+    // Seconds followed by the nanoseconds zero-padded to nine digits.
+    char seconds[NumberFormat::kMaxChars];
+    char nanoseconds[NumberFormat::kMaxChars];
+    NumberFormat::formatUnsigned(seconds, sizeof(seconds), point.seconds);
+    NumberFormat::formatUnsignedPadded(nanoseconds, sizeof(nanoseconds), point.nanoseconds % 1000000000UL, 9);
+    if (!detail::put(out, capacity, pos, ' ') ||
+        !detail::putText(out, capacity, pos, seconds) ||
+        !detail::putText(out, capacity, pos, nanoseconds) ||
+        !detail::put(out, capacity, pos, '\n'))
+        return 0;
+    return pos;
+}
+} // namespace InfluxLineProtocol
@@ -0,0 +1,556 @@
+// SPDX-FileCopyrightText: 2026 André Fiedler
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "Influx/InfluxPublisher.h"
+
+#include <WiFi.h>
+#include <sys/time.h>
+#include "ConfigPortal/PortalSecurity.h"
+#include "ConfigPortal/WiFiPortalService.h"
+#include <WebServer.h>
+#include "Influx/InfluxLineProtocol.h"
+#include "Led/LedController.h"
+#include "Publishing/HttpPublishResponse.h"
+#include "Publishing/PublishPhaseTimer.h"
+#include "Publishing/SecretRedaction.h"
+#include "Runtime/CooperativePump.h"
+
+namespace
+{
+    constexpr unsigned long kResponseWaitMs = 10000;
+    constexpr unsigned long kMinPostGapMs = 1000;
+    constexpr unsigned long kRetryBackoffMs = 30000;
+    constexpr unsigned long kMaxRetryBackoffMs = 300000;
+    constexpr time_t kMinValidEpoch = 1704067200; // 2024-01-01
+
+    bool parseUnsigned(const String &text, uint32_t &out)
+    {
+        if (!text.length() || text.length() > 9)
+            return false;
+        uint32_t value = 0;
+        for (size_t i = 0; i < text.length(); ++i)
+        {
+            const char c = text[i];
+            if (c < '0' || c > '9')
+                return false;
+            value = value * 10 + static_cast<uint32_t>(c - '0');
+        }
+        out = value;
+        return true;
+    }
+}
+
+InfluxPublisher::InfluxPublisher(AppConfig &config, Print &log, const char *bridgeVersion, PublisherHealth &health)
+    : config_(config),
+      log_(log),
+      bridgeVersion_(bridgeVersion ? bridgeVersion : ""),
+      health_(health)
+{
+}
+
+void InfluxPublisher::begin()
+{
+    updateConfig();
+    syncHealthState();
+}
+
+void InfluxPublisher::updateConfig()
+{
+    if (config_.influxUrl != parsedUrl_)
+    {
+        parsedUrl_ = config_.influxUrl;
+        endpoint_ = HttpEndpoint::Endpoint{};
+        endpointValid_ = HttpEndpoint::parseBaseUrl(parsedUrl_, endpoint_) && endpoint_.basePath.length();
+        gzipRejected_ = false;
+        suppressUntilMs_ = 0;
+        retryBackoffMs_ = 0;
+        if (config_.influxEnabled && parsedUrl_.length() && !endpointValid_)
+            log_.println("Influx: write URL is invalid; expected http(s)://host[:port]/path?query.");
+    }
+    syncHealthState();
+}
+
+void InfluxPublisher::loop()
+{
+    syncHealthState();
+    if (paused_)
+        return;
+    publishPending();
+}
+
+void InfluxPublisher::clearPendingData()
+{
+    // Buffered points already carry their own timestamps, so only the
+    // half-built sample is discarded.
+    pendingCpm_ = "";
+    pendingPulses_ = "";
+    suppressUntilMs_ = 0;
+    syncHealthState();
+}
+
+void InfluxPublisher::onCommandResult(DeviceManager::CommandType type, const String &value)
+{
+    if (paused_)
+        return;
+    switch (type)
+    {
+    case DeviceManager::CommandType::DeviceId:
+        if (value.length())
+            deviceId_ = value;
+        break;
+    case DeviceManager::CommandType::TubeRate:
+        pendingCpm_ = value;
+        break;
+    case DeviceManager::CommandType::TubePulseCount:
+        pendingPulses_ = value;
+        break;
+    case DeviceManager::CommandType::TubeDoseRate:
+        appendPoint(value);
+        break;
+    default:
+        break;
+    }
+    syncHealthState();
+}
+
+bool InfluxPublisher::isEnabled() const
+{
+    return config_.influxEnabled && endpointValid_;
+}
+
+void InfluxPublisher::appendPoint(const String &doseRate)
+{
+    if (!isEnabled())
+        return;
+
+    const unsigned long now = millis();
+    if (havePoint_ && now - lastPointMs_ < config_.influxPointIntervalSeconds * 1000UL)
+        return;
+
+    // The timestamp is taken when the poll cycle closes, not when the batch
+    // is sent, so points buffered through an outage land at the right time.
+    timeval tv = {};
+    gettimeofday(&tv, nullptr);
+    if (tv.tv_sec < kMinValidEpoch)
+    {
+        if (!waitingForTimeLogged_)
+            log_.println("Influx: waiting for valid system time before buffering points.");
+        waitingForTimeLogged_ = true;
+        return;
+    }
+    waitingForTimeLogged_ = false;
+
+    InfluxLineProtocol::Point point;
+    point.measurement = config_.influxMeasurement.c_str();
+    point.deviceId = deviceId_.c_str();
+    point.cpm = pendingCpm_.c_str();
+    point.doseRate = doseRate.c_str();
+    point.pulses = pendingPulses_.c_str();
+    point.seconds = static_cast<uint32_t>(tv.tv_sec);
+    point.nanoseconds = static_cast<uint32_t>(tv.tv_usec) * 1000UL;
+
+    size_t capacity = 0;
+    size_t dropped = 0;
+    char *line = batch_.beginLine(capacity, dropped);
+    if (dropped)
+    {
+        if (!droppedPoints_)
+            log_.println("Influx: buffer full; dropping oldest points.");
+        droppedPoints_ += dropped;
+    }
+
+    const size_t length = InfluxLineProtocol::formatPoint(line, capacity, point);
+    if (!length)
+        return;
+    batch_.commitLine(length, now);
+    lastPointMs_ = now;
+    havePoint_ = true;
+    pendingCpm_ = "";
+    pendingPulses_ = "";
+}
+
+bool InfluxPublisher::batchDue(unsigned long now) const
+{
+    if (batch_.empty())
+        return false;
+    if (lastAttemptMs_ && now - lastAttemptMs_ < kMinPostGapMs)
+        return false;
+    if (batch_.lineCount() >= config_.influxBatchPoints)
+        return true;
+    return batch_.oldestAgeMs(now) >= config_.influxFlushSeconds * 1000UL;
+}
+
+bool InfluxPublisher::publishPending()
+{
+    if (!isEnabled() || batch_.empty())
+    {
+        syncHealthState();
+        return false;
+    }
+
+    if (WiFi.status() != WL_CONNECTED)
+    {
+        syncHealthState();
+        return true;
+    }
+
+    const unsigned long now = millis();
+    if (suppressUntilMs_ && now < suppressUntilMs_)
+    {
+        syncHealthState();
+        return true;
+    }
+    if (!batchDue(now))
+    {
+        syncHealthState();
+        return true;
+    }
+
+    size_t lines = 0;
+    const size_t bytes = batch_.batchBytes(kMaxBatchBytes, lines);
+    const char *body = batch_.data();
+    size_t bodyLength = bytes;
+    bool gzip = false;
+    if (config_.influxGzip && !gzipRejected_)
+    {
+        const size_t packed = InfluxGzip::compress(reinterpret_cast<const uint8_t *>(batch_.data()),
+                                                   bytes,
+                                                   gzipBuffer_,
+                                                   sizeof(gzipBuffer_),
+                                                   gzipWorkspace_);
+        if (packed && packed < bytes)
+        {
+            body = reinterpret_cast<const char *>(gzipBuffer_);
+            bodyLength = packed;
+            gzip = true;
+        }
+    }
+
+    log_.print("Influx: POST ");
+    log_.print(static_cast<unsigned long>(lines));
+    log_.print(lines == 1 ? " point, " : " points, ");
+    log_.print(static_cast<unsigned long>(bodyLength));
+    log_.println(gzip ? " bytes gzip" : " bytes");
+
+    lastAttemptMs_ = now;
+    health_.noteAttempt(now);
+    SendOutcome outcome = SendOutcome::Failed;
+    if (endpoint_.secure)
+    {
+        WiFiClientSecure client;
+        client.setTimeout(kResponseWaitMs / 1000);
+        client.setInsecure();
+        outcome = sendBatch(client, body, bodyLength, gzip);
+    }
+    else
+    {
+        WiFiClient client;
+        client.setTimeout(kResponseWaitMs / 1000);
+        outcome = sendBatch(client, body, bodyLength, gzip);
+    }
+
+    switch (outcome)
+    {
+    case SendOutcome::Delivered:
+        batch_.consume(lines);
+        retryBackoffMs_ = 0;
+        suppressUntilMs_ = 0;
+        if (droppedPoints_)
+        {
+            log_.print("Influx: ");
+            log_.print(static_cast<unsigned long>(droppedPoints_));
+            log_.println(" points were dropped while the endpoint was unreachable.");
+            droppedPoints_ = 0;
+        }
+        break;
+    case SendOutcome::Rejected:
+        // A malformed batch would be rejected forever; drop it and move on.
+        log_.print("Influx: server rejected ");
+        log_.print(static_cast<unsigned long>(lines));
+        log_.println(" points; dropping them.");
+        batch_.consume(lines);
+        suppressUntilMs_ = 0;
+        break;
+    case SendOutcome::GzipRejected:
+        log_.println("Influx: server refused the gzip body; sending uncompressed from now on.");
+        gzipRejected_ = true;
+        lastAttemptMs_ = 0;
+        break;
+    case SendOutcome::Failed:
+        retryBackoffMs_ = retryBackoffMs_ ? retryBackoffMs_ * 2 : kRetryBackoffMs;
+        if (retryBackoffMs_ > kMaxRetryBackoffMs)
+            retryBackoffMs_ = kMaxRetryBackoffMs;
+        suppressUntilMs_ = millis() + retryBackoffMs_;
+        break;
+    }
+
+    syncHealthState();
+    return true;
+}
+
+void InfluxPublisher::syncHealthState()
+{
+    health_.setEnabled(isEnabled());
+    health_.setPaused(paused_);
+    health_.setPending(!batch_.empty());
+}
+
+template <typename Client>
+InfluxPublisher::SendOutcome InfluxPublisher::sendBatch(Client &client, const char *body, size_t bodyLength, bool gzip)
+{
+    PublishPhaseTimer timer(&health_);
+    IPAddress address;
+    if (!WiFi.hostByName(endpoint_.host.c_str(), address))
+    {
+        log_.println("Influx: DNS lookup failed.");
+        health_.noteFailure(millis(), "dns failed");
+        return SendOutcome::Failed;
+    }
+    timer.lap(PublishPhase::Dns);
+
+    // TLS needs the host name for SNI; plain HTTP reuses the resolved address.
+    const bool connected = endpoint_.secure
+                               ? client.connect(endpoint_.host.c_str(), endpoint_.port)
+                               : client.connect(address, endpoint_.port);
+    if (!connected)
+    {
+        log_.println("Influx: connect failed.");
+        health_.noteFailure(millis(), "connect failed");
+        return SendOutcome::Failed;
+    }
+    timer.lap(endpoint_.secure ? PublishPhase::TlsHandshake : PublishPhase::Connect);
+
+    String request;
+    request.reserve(endpoint_.basePath.length() + config_.influxToken.length() + 220);
+    request += "POST ";
+    request += endpoint_.basePath;
+    request += " HTTP/1.1\r\nHost: ";
+    request += endpoint_.host;
+    if (config_.influxToken.length())
+    {
+        request += "\r\nAuthorization: Token ";
+        request += config_.influxToken;
+    }
+    request += "\r\nContent-Type: text/plain; charset=utf-8";
+    if (gzip)
+        request += "\r\nContent-Encoding: gzip";
+    request += "\r\nContent-Length: ";
+    request += String(static_cast<unsigned long>(bodyLength));
+    request += "\r\nConnection: close\r\nUser-Agent: RadPro-WiFi-Bridge/";
+    request += bridgeVersion_;
+    request += "\r\n\r\n";
+
+    if (client.print(request) != request.length() ||
+        client.write(reinterpret_cast<const uint8_t *>(body), bodyLength) != bodyLength)
+    {
+        log_.println("Influx: send failed.");
+        health_.noteFailure(millis(), "send failed");
+        return SendOutcome::Failed;
+    }
+
+    client.flush();
+    timer.lap(PublishPhase::RequestWrite);
+
+    const auto response = HttpPublishResponse::readStatus(
+        client,
+        kResponseWaitMs,
+        []() { return millis(); },
+        []() { CooperativePump::service(); });
+    if (response.statusLine.length())
+    {
+        timer.lap(PublishPhase::FirstByte);
+        timer.finish();
+    }
+
+    if (!response.success)
+    {
+        switch (response.failure)
+        {
+        case HttpPublishResponse::FailureKind::NoResponse:
+            log_.print("Influx: no response before ");
+            if (client.connected())
+                log_.println("timeout");
+            else
+                log_.println("disconnect");
+            health_.noteFailure(millis(), "no response", 0, response.statusLine, response.trace);
+            return SendOutcome::Failed;
+        case HttpPublishResponse::FailureKind::InvalidStatusLine:
+            log_.print("Influx: unexpected status line: ");
+            log_.println(response.statusLine.length() ? response.statusLine : String("<empty>"));
+            health_.noteFailure(millis(), "invalid status line", 0, response.statusLine, response.trace);
+            return SendOutcome::Failed;
+        case HttpPublishResponse::FailureKind::HttpError:
+            log_.print("Influx: HTTP ");
+            log_.println(response.statusCode);
+            health_.noteFailure(millis(), "http error", response.statusCode, response.statusLine, response.trace);
+            if (gzip && (response.statusCode == 400 || response.statusCode == 415))
+                return SendOutcome::GzipRejected;
+            if (response.statusCode == 400 || response.statusCode == 422)
+                return SendOutcome::Rejected;
+            return SendOutcome::Failed;
+        case HttpPublishResponse::FailureKind::ReadError:
+            log_.println("Influx: response read error.");
+            health_.noteFailure(millis(), "read error", 0, response.statusLine, response.trace);
+            return SendOutcome::Failed;
+        case HttpPublishResponse::FailureKind::None:
+            break;
+        }
+        return SendOutcome::Failed;
+    }
+
+    health_.noteSuccess(millis(), response.statusCode, response.statusLine);
+
+    while (client.connected() || client.available())
+        client.read();
+
+    return SendOutcome::Delivered;
+}
+
+void InfluxPublisher::HandlePortalPost(WebServer &server,
+                                       AppConfig &config,
+                                       AppConfigStore &store,
+                                       LedController &led,
+                                       Print &log,
+                                       String &message)
+{
+    const bool enabled = server.hasArg("influxEnabled") && server.arg("influxEnabled") == "1";
+    const bool gzip = server.hasArg("influxGzip") && server.arg("influxGzip") == "1";
+    String url = server.arg("influxUrl");
+    String token = server.arg("influxToken");
+    String measurement = server.arg("influxMeasurement");
+    String pointInterval = server.arg("influxPointSeconds");
+    String batchPoints = server.arg("influxBatchPoints");
+    String flushSeconds = server.arg("influxFlushSeconds");
+
+    url.trim();
+    token.trim();
+    measurement.trim();
+    pointInterval.trim();
+    batchPoints.trim();
+    flushSeconds.trim();
+
+    HttpEndpoint::Endpoint endpoint;
+    if (url.length() && (!HttpEndpoint::parseBaseUrl(url, endpoint) || !endpoint.basePath.length()))
+    {
+        message = F("Write URL must look like http(s)://host:port/api/v2/write?org=...&bucket=...");
+        return;
+    }
+    if (enabled && !url.length())
+    {
+        message = F("Write URL is required when InfluxDB publishing is enabled.");
+        return;
+    }
+
+    uint32_t pointSeconds = 0;
+    uint32_t batch = 0;
+    uint32_t flush = 0;
+    if (!parseUnsigned(pointInterval, pointSeconds) || pointSeconds < kMinInfluxPointIntervalSeconds)
+    {
+        message = F("Point interval must be at least 1 second.");
+        return;
+    }
+    if (!parseUnsigned(batchPoints, batch) || batch < kMinInfluxBatchPoints || batch > kMaxInfluxBatchPoints)
+    {
+        message = F("Batch size must be between 1 and 60 points.");
+        return;
+    }
+    if (!parseUnsigned(flushSeconds, flush) || flush < kMinInfluxFlushSeconds || flush > kMaxInfluxFlushSeconds)
+    {
+        message = F("Flush interval must be between 5 and 3600 seconds.");
+        return;
+    }
+    if (!measurement.length())
+        measurement = "radpro";
+
+    bool changed = false;
+    std::vector<String> changedFields;
+    if (config.influxEnabled != enabled)
+    {
+        config.influxEnabled = enabled;
+        PortalSecurity::appendChangedField(changedFields, "influxEnabled", true);
+        changed = true;
+    }
+    bool fieldChanged = UpdateStringIfChanged(config.influxUrl, url.c_str());
+    PortalSecurity::appendChangedField(changedFields, "influxUrl", fieldChanged);
+    changed |= fieldChanged;
+
+    // An empty token field keeps the stored token, as on the Safecast page.
+    if (token.length())
+    {
+        fieldChanged = UpdateStringIfChanged(config.influxToken, token.c_str());
+        PortalSecurity::appendChangedField(changedFields, "influxToken", fieldChanged);
+        changed |= fieldChanged;
+    }
+
+    fieldChanged = UpdateStringIfChanged(config.influxMeasurement, measurement.c_str());
+    PortalSecurity::appendChangedField(changedFields, "influxMeasurement", fieldChanged);
+    changed |= fieldChanged;
+
+    if (config.influxPointIntervalSeconds != pointSeconds)
+    {
+        config.influxPointIntervalSeconds = pointSeconds;
+        PortalSecurity::appendChangedField(changedFields, "influxPointIntervalSeconds", true);
+        changed = true;
+    }
+    if (config.influxBatchPoints != batch)
+    {
+        config.influxBatchPoints = batch;
+        PortalSecurity::appendChangedField(changedFields, "influxBatchPoints", true);
+        changed = true;
+    }
+    if (config.influxFlushSeconds != flush)
+    {
+        config.influxFlushSeconds = flush;
+        PortalSecurity::appendChangedField(changedFields, "influxFlushSeconds", true);
+        changed = true;
+    }
+    if (config.influxGzip != gzip)
+    {
+        config.influxGzip = gzip;
+        PortalSecurity::appendChangedField(changedFields, "influxGzip", true);
+        changed = true;
+    }
+
+    if (changed)
+    {
+        if (store.save(config))
+        {
+            PortalSecurity::logConfigSave(log, "/influx", server.client().remoteIP().toString(), changedFields);
+            led.clearFault(FaultCode::NvsWriteFailure);
+            message = F("InfluxDB settings saved.");
+        }
+        else
+        {
+            PortalSecurity::logConfigSaveFailure(log, "/influx", server.client().remoteIP().toString(), changedFields);
+            log.println("Preferences write failed; InfluxDB configuration not saved.");
+            led.activateFault(FaultCode::NvsWriteFailure);
+            message = F("Failed to save settings.");
+        }
+        return;
+    }
+
+    message = F("No changes detected.");
+}
+
+void InfluxPublisher::SendPortalForm(WiFiPortalService &portal, const String &message)
+{
+    if (!portal.manager_.server)
+        return;
+
+    const String &notice = message;
+    WiFiPortalService::TemplateReplacements vars = {
+        {"{{NOTICE_CLASS}}", notice.length() ? String() : String("hidden")},
+        {"{{NOTICE_TEXT}}", notice},
+        {"{{INFLUX_ENABLED_CHECKED}}", portal.config_.influxEnabled ? String("checked") : String()},
+        {"{{INFLUX_URL}}", portal.config_.influxUrl},
+        {"{{INFLUX_TOKEN_PLACEHOLDER}}", SecretRedaction::maskSecretForDisplay(portal.config_.influxToken)},
+        {"{{INFLUX_MEASUREMENT}}", portal.config_.influxMeasurement},
+        {"{{INFLUX_POINT_SECONDS}}", String(portal.config_.influxPointIntervalSeconds)},
+        {"{{INFLUX_BATCH_POINTS}}", String(portal.config_.influxBatchPoints)},
+        {"{{INFLUX_FLUSH_SECONDS}}", String(portal.config_.influxFlushSeconds)},
+        {"{{INFLUX_GZIP_CHECKED}}", portal.config_.influxGzip ? String("checked") : String()}};
+
+    portal.appendCommonTemplateVars(vars);
+    portal.sendTemplate("/portal/influx.html", vars);
+}
@@ -0,0 +1,86 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <WiFiClient.h>
+#include <WiFiClientSecure.h>
+#include "AppConfig/AppConfig.h"
+#include "DeviceManager.h"
+#include "Influx/InfluxBatchBuffer.h"
+#include "Influx/InfluxGzip.h"
+#include "Publishing/HttpEndpoint.h"
+#include "Publishing/PublisherHealth.h"
+
+class WebServer;
+class WiFiPortalService;
+class LedController;
+
+class InfluxPublisher
+{
+public:
+    static constexpr const char *kPublisherName = "influx";
+    // Upper bound for one POST body; a backlog drains in batches of this size.
+    static constexpr size_t kMaxBatchBytes = 4096;
+
+    InfluxPublisher(AppConfig &config, Print &log, const char *bridgeVersion, PublisherHealth &health);
+
+    void begin();
+    void updateConfig();
+    void loop();
+    void onCommandResult(DeviceManager::CommandType type, const String &value);
+    void clearPendingData();
+    bool isEnabled() const;
+    void setPaused(bool paused) { paused_ = paused; }
+    size_t bufferedPoints() const { return batch_.lineCount(); }
+    static void SendPortalForm(WiFiPortalService &portal, const String &message = String());
+    static void HandlePortalPost(WebServer &server,
+                                 AppConfig &config,
+                                 AppConfigStore &store,
+                                 LedController &led,
+                                 Print &log,
+                                 String &message);
+
+private:
+    enum class SendOutcome
+    {
+        Delivered,
+        Rejected,
+        GzipRejected,
+        Failed,
+    };
+
+    void appendPoint(const String &doseRate);
+    bool publishPending();
+    bool batchDue(unsigned long now) const;
+    template <typename Client>
+    SendOutcome sendBatch(Client &client, const char *body, size_t bodyLength, bool gzip);
+    void syncHealthState();
+
+    AppConfig &config_;
+    Print &log_;
+    String bridgeVersion_;
+    PublisherHealth &health_;
+    String parsedUrl_;
+    HttpEndpoint::Endpoint endpoint_;
+    bool endpointValid_ = false;
+    String deviceId_;
+    String pendingCpm_;
+    String pendingPulses_;
+    unsigned long lastPointMs_ = 0;
+    bool havePoint_ = false;
+    bool waitingForTimeLogged_ = false;
+    size_t droppedPoints_ = 0;
+    unsigned long lastAttemptMs_ = 0;
+    unsigned long suppressUntilMs_ = 0;
+    unsigned long retryBackoffMs_ = 0;
+    bool gzipRejected_ = false;
+    bool paused_ = false;
+    InfluxBatchBuffer batch_;
+    InfluxGzip::Workspace gzipWorkspace_;
+    uint8_t gzipBuffer_[kMaxBatchBytes];
+};
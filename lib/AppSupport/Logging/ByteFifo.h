@@ -0,0 +1,97 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Byte queue over caller-provided memory between log writers and the UART
+// drain task. A write that does not fit is dropped whole, so the console
+// never shows a message cut in the middle; the dropped bytes are counted
+// until the drain reports them.
+//
+// Not thread-safe; DebugLogStream serialises access.
+class ByteFifo
+{
+public:
+    void attach(uint8_t *buffer, size_t capacity)
+    {
+        buffer_ = buffer;
+        capacity_ = buffer ? capacity : 0;
+        head_ = 0;
+        size_ = 0;
+        dropped_ = 0;
+    }
+
+    bool ready() const { return capacity_ != 0; }
+    bool empty() const { return size_ == 0; }
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+
+    bool push(const uint8_t *data, size_t length)
+    {
+        if (!data || !length)
+            return true;
+        if (length > capacity_ - size_)
+        {
+            dropped_ += static_cast<uint32_t>(length);
+            return false;
+        }
+        const size_t tail = (head_ + size_) % capacity_;
+        const size_t first = capacity_ - tail < length ? capacity_ - tail : length;
+        std::memcpy(buffer_ + tail, data, first);
+        std::memcpy(buffer_, data + first, length - first);
+        size_ += length;
+        return true;
+    }
+
+    // Copies and removes up to maxLength of the oldest bytes.
+    size_t pop(uint8_t *out, size_t maxLength)
+    {
+        size_t length = size_ < maxLength ? size_ : maxLength;
+        if (!out || !length)
+            return 0;
+        const size_t first = capacity_ - head_ < length ? capacity_ - head_ : length;
+        std::memcpy(out, buffer_ + head_, first);
+        std::memcpy(out + first, buffer_, length - first);
+        head_ = (head_ + length) % capacity_;
+        size_ -= length;
+        return length;
+    }
+
+    // Like pop(), but stops in front of the first stop byte, which stays
+    // queued. Returns 0 when the oldest byte is the stop byte.
+    size_t popUntil(uint8_t *out, size_t maxLength, uint8_t stop)
+    {
+        size_t length = size_ < maxLength ? size_ : maxLength;
+        for (size_t i = 0; i < length; ++i)
+        {
+            if (buffer_[(head_ + i) % capacity_] == stop)
+            {
+                length = i;
+                break;
+            }
+        }
+        return pop(out, length);
+    }
+
+    // Bytes dropped since the last call.
+    uint32_t takeDropped()
+    {
+        uint32_t dropped = dropped_;
+        dropped_ = 0;
+        return dropped;
+    }
+
+private:
+    uint8_t *buffer_ = nullptr;
+    size_t capacity_ = 0;
+    size_t head_ = 0;
+    size_t size_ = 0;
+    uint32_t dropped_ = 0;
+};
@@ -3,36 +3,185 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "Logging/DebugLogStream.h"
+#include <esp_attr.h>
+#include <esp_heap_caps.h>
+
+namespace
+{
+    // About 400 lines of typical length; the slot ring caps the count.
+    constexpr size_t kPsramArenaBytes = 64 * 1024;
+    constexpr size_t kInternalArenaBytes = 16 * 1024;
+    // About 1.4 s of output at 115200 baud.
+    constexpr size_t kUartQueueBytes = 16 * 1024;
+    constexpr size_t kDrainChunkBytes = 128;
+    // Queued record: marker, little-endian length, record.
+    constexpr size_t kRecordFrameHeader = 3;
+    constexpr uint32_t kFlushTimeoutMs = 1000;
+    // Records grow when formatted, so the rendered tail gets more room.
+    constexpr size_t kPreviousBootBytes = 8 * 1024;
+
+    // Survives a warm reset; RTC slow memory on the ESP32-S3 is 8 KB. Words
+    // keep the LogTail header aligned.
+    RTC_NOINIT_ATTR uint32_t rtcTailMemory[1024];
+
+    void *allocatePreferPsram(size_t bytes)
+    {
+        void *memory = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        return memory ? memory : malloc(bytes);
+    }
+}
 
 DebugLogStream::DebugLogStream(HardwareSerial &serial, size_t maxEntries)
     : serial_(serial),
       maxEntries_(maxEntries ? maxEntries : 1),
-      nextId_(1),
       mutex_(xSemaphoreCreateMutex())
 {
+    // Allocated once for the lifetime of the bridge, so logging a line
+    // never touches the heap.
+    size_t arenaBytes = kPsramArenaBytes;
+    arena_ = static_cast<char *>(heap_caps_malloc(arenaBytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+    if (!arena_)
+    {
+        arenaBytes = kInternalArenaBytes;
+        arena_ = static_cast<char *>(malloc(arenaBytes));
+    }
+    slots_ = static_cast<LogRing::Slot *>(allocatePreferPsram(maxEntries_ * sizeof(LogRing::Slot)));
+    if (arena_ && slots_)
+        ring_.attach(arena_, arenaBytes, slots_, maxEntries_);
+    uartBuffer_ = static_cast<uint8_t *>(allocatePreferPsram(kUartQueueBytes));
+    uartFifo_.attach(uartBuffer_, uartBuffer_ ? kUartQueueBytes : 0);
+    StructuredLog::attach(*this, *this);
 }
 
 DebugLogStream::~DebugLogStream()
 {
+    StructuredLog::detach(*this);
+    if (drainTask_)
+        vTaskDelete(drainTask_);
     if (mutex_)
         vSemaphoreDelete(mutex_);
+    free(previousBoot_);
+    free(uartBuffer_);
+    free(slots_);
+    free(arena_);
 }
 
 void DebugLogStream::begin(unsigned long baud)
 {
     serial_.begin(baud);
+    startDrain();
 }
 
 void DebugLogStream::begin(unsigned long baud, uint32_t config)
 {
     serial_.begin(baud, config);
+    startDrain();
 }
 
 void DebugLogStream::end()
 {
+    flush();
     serial_.end();
 }
 
+void DebugLogStream::beginCrashTail(uint32_t firmwareId, bool keepPrevious)
+{
+    if (!mutex_ || xSemaphoreTake(mutex_, portMAX_DELAY) != pdTRUE)
+        return;
+    if (keepPrevious && !previousBoot_ && tail_.adopt(rtcTailMemory, sizeof(rtcTailMemory), firmwareId) && tail_.size())
+    {
+        char *text = static_cast<char *>(allocatePreferPsram(kPreviousBootBytes));
+        const size_t length = text ? tail_.render(text, kPreviousBootBytes) : 0;
+        if (length)
+        {
+            char *shrunk = static_cast<char *>(realloc(text, length));
+            previousBoot_ = shrunk ? shrunk : text;
+            previousBootLength_ = length;
+        }
+        else
+        {
+            free(text);
+        }
+    }
+    tail_.reset(rtcTailMemory, sizeof(rtcTailMemory), firmwareId);
+    xSemaphoreGive(mutex_);
+}
+
+void DebugLogStream::startDrain()
+{
+    if (drainTask_ || !mutex_ || !uartFifo_.ready())
+        return;
+    // Without the task every write goes to the UART directly, as before.
+    // Formatting records (snprintf with floats) needs more than copying.
+    if (xTaskCreatePinnedToCore(&DebugLogStream::drainTaskThunk,
+                                "logDrain",
+                                4096,
+                                this,
+                                1,
+                                &drainTask_,
+                                tskNO_AFFINITY) != pdPASS)
+    {
+        drainTask_ = nullptr;
+    }
+}
+
+void DebugLogStream::drainTaskThunk(void *param)
+{
+    static_cast<DebugLogStream *>(param)->runDrain();
+}
+
+void DebugLogStream::runDrain()
+{
+    uint8_t chunk[kDrainChunkBytes];
+    uint8_t record[LogRecord::kMaxRecordBytes];
+    for (;;)
+    {
+        size_t length = 0;
+        size_t recordLength = 0;
+        uint32_t dropped = 0;
+        if (xSemaphoreTake(mutex_, portMAX_DELAY) == pdTRUE)
+        {
+            length = uartFifo_.popUntil(chunk, sizeof(chunk), LogRing::kRecordMarker);
+            if (!length && !uartFifo_.empty())
+            {
+                uint8_t header[kRecordFrameHeader];
+                uartFifo_.pop(header, sizeof(header));
+                recordLength = static_cast<size_t>(header[1]) | (static_cast<size_t>(header[2]) << 8);
+                uartFifo_.pop(record, recordLength);
+            }
+            else if (!length)
+            {
+                dropped = uartFifo_.takeDropped();
+            }
+            xSemaphoreGive(mutex_);
+        }
+
+        if (length)
+        {
+            serial_.write(chunk, length);
+            continue;
+        }
+        if (recordLength)
+        {
+            char line[LogRecord::kMaxTextBytes + 2];
+            size_t lineLength = LogRecord::format(record, recordLength, line, LogRecord::kMaxTextBytes);
+            line[lineLength++] = '\r';
+            line[lineLength++] = '\n';
+            serial_.write(reinterpret_cast<const uint8_t *>(line), lineLength);
+            continue;
+        }
+        if (dropped)
+        {
+            char note[48];
+            int written = snprintf(note, sizeof(note), "[log] %lu bytes dropped\r\n", static_cast<unsigned long>(dropped));
+            if (written > 0)
+                serial_.write(reinterpret_cast<const uint8_t *>(note), static_cast<size_t>(written));
+            continue;
+        }
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
+
 int DebugLogStream::available()
 {
     return serial_.available();
@@ -50,69 +199,119 @@ int DebugLogStream::peek()
 
 void DebugLogStream::flush()
 {
+    // Give the drain task a bounded chance to empty the queue, e.g. before
+    // a restart.
+    if (drainTask_ && xTaskGetCurrentTaskHandle() != drainTask_)
+    {
+        unsigned long started = millis();
+        while (millis() - started < kFlushTimeoutMs)
+        {
+            bool empty = true;
+            if (xSemaphoreTake(mutex_, portMAX_DELAY) == pdTRUE)
+            {
+                empty = uartFifo_.empty();
+                xSemaphoreGive(mutex_);
+            }
+            if (empty)
+                break;
+            xTaskNotifyGive(drainTask_);
+            delay(1);
+        }
+    }
     serial_.flush();
 }
 
 size_t DebugLogStream::write(uint8_t ch)
 {
-    size_t written = serial_.write(ch);
-    if (mutex_ && xSemaphoreTake(mutex_, portMAX_DELAY) == pdTRUE)
-    {
-        appendCharLocked(static_cast<char>(ch));
-        xSemaphoreGive(mutex_);
-    }
-    return written;
+    return write(&ch, 1);
 }
 
 size_t DebugLogStream::write(const uint8_t *buffer, size_t size)
 {
-    size_t written = serial_.write(buffer, size);
-    if (size && mutex_ && xSemaphoreTake(mutex_, portMAX_DELAY) == pdTRUE)
+    if (!buffer || !size)
+        return 0;
+
+    bool queued = false;
+    if (mutex_ && xSemaphoreTake(mutex_, portMAX_DELAY) == pdTRUE)
     {
-        for (size_t i = 0; i < size; ++i)
+        ring_.append(buffer, size);
+        tail_.append(buffer, size);
+        if (drainTask_)
         {
-            appendCharLocked(static_cast<char>(buffer[i]));
+            // A full queue drops the write from the console only.
+            pushText(buffer, size);
+            queued = true;
         }
         xSemaphoreGive(mutex_);
     }
-    return written;
+
+    if (queued)
+    {
+        xTaskNotifyGive(drainTask_);
+        return size;
+    }
+    return serial_.write(buffer, size);
 }
 
-void DebugLogStream::copyEntries(std::vector<DebugLogEntry> &out) const
+void DebugLogStream::pushText(const uint8_t *buffer, size_t size)
 {
-    out.clear();
-    if (!mutex_)
-        return;
-    if (xSemaphoreTake(mutex_, portMAX_DELAY) != pdTRUE)
+    // NUL marks a record in the queue, so text goes in around it; the
+    // console would not show it anyway.
+    const uint8_t *end = buffer + size;
+    while (buffer < end)
+    {
+        const uint8_t *marker = static_cast<const uint8_t *>(memchr(buffer, LogRing::kRecordMarker, end - buffer));
+        const uint8_t *stop = marker ? marker : end;
+        uartFifo_.push(buffer, stop - buffer);
+        buffer = marker ? marker + 1 : end;
+    }
+}
+
+void DebugLogStream::writeRecord(const uint8_t *record, size_t length)
+{
+    if (!record || !length || length > LogRecord::kMaxRecordBytes)
         return;
 
-    out.reserve(entries_.size() + (currentLine_.length() ? 1 : 0));
-    for (const auto &entry : entries_)
+    uint8_t frame[kRecordFrameHeader + LogRecord::kMaxRecordBytes];
+    frame[0] = LogRing::kRecordMarker;
+    frame[1] = static_cast<uint8_t>(length);
+    frame[2] = static_cast<uint8_t>(length >> 8);
+    memcpy(frame + kRecordFrameHeader, record, length);
+
+    bool queued = false;
+    if (mutex_ && xSemaphoreTake(mutex_, portMAX_DELAY) == pdTRUE)
     {
-        out.push_back(entry);
+        ring_.appendRecord(record, length);
+        tail_.appendRecord(record, length);
+        if (drainTask_)
+        {
+            uartFifo_.push(frame, kRecordFrameHeader + length);
+            queued = true;
+        }
+        xSemaphoreGive(mutex_);
     }
 
-    if (currentLine_.length())
+    if (queued)
     {
-        DebugLogEntry pending{nextId_, currentLine_};
-        out.push_back(pending);
+        xTaskNotifyGive(drainTask_);
+        return;
     }
-
-    xSemaphoreGive(mutex_);
+    // No drain task yet: format for the UART right here.
+    char line[LogRecord::kMaxTextBytes + 2];
+    size_t lineLength = LogRecord::format(record, length, line, LogRecord::kMaxTextBytes);
+    line[lineLength++] = '\r';
+    line[lineLength++] = '\n';
+    serial_.write(reinterpret_cast<const uint8_t *>(line), lineLength);
 }
 
 uint32_t DebugLogStream::latestId() const
 {
-    uint32_t latest = nextId_ ? nextId_ - 1 : 0;
     if (!mutex_)
-        return latest;
+        return 0;
     if (xSemaphoreTake(mutex_, portMAX_DELAY) != pdTRUE)
-        return latest;
+        return 0;
 
-    if (!entries_.empty())
-        latest = entries_.back().id;
-    else if (currentLine_.length())
-        latest = nextId_;
+    uint32_t latest = ring_.latestId();
 
     xSemaphoreGive(mutex_);
     return latest;
@@ -126,44 +325,24 @@ size_t DebugLogStream::entryCount() const
     if (xSemaphoreTake(mutex_, portMAX_DELAY) != pdTRUE)
         return count;
 
-    count = entries_.size();
-    if (currentLine_.length())
-        ++count;
+    count = ring_.count();
 
     xSemaphoreGive(mutex_);
     return count;
 }
 
-void DebugLogStream::appendCharLocked(char c)
+DebugLogWindow DebugLogStream::window() const
 {
-    if (c == '\r')
-        return;
-
-    if (c == '\n')
-    {
-        pushLineLocked(currentLine_);
-        currentLine_.clear();
-        return;
-    }
-
-    currentLine_ += c;
+    DebugLogWindow window;
+    if (!mutex_)
+        return window;
+    if (xSemaphoreTake(mutex_, portMAX_DELAY) != pdTRUE)
+        return window;
 
-    constexpr size_t kMaxLineLength = 320;
-    if (currentLine_.length() >= kMaxLineLength)
-    {
-        pushLineLocked(currentLine_);
-        currentLine_.clear();
-    }
-}
+    window.oldestId = ring_.oldestId();
+    window.latestId = ring_.lastCompleteId();
+    window.count = window.oldestId ? window.latestId - window.oldestId + 1 : 0;
 
-void DebugLogStream::pushLineLocked(const String &line)
-{
-    DebugLogEntry entry;
-    entry.id = nextId_++;
-    entry.text = line;
-    entries_.push_back(entry);
-    if (entries_.size() > maxEntries_)
-    {
-        entries_.erase(entries_.begin());
-    }
+    xSemaphoreGive(mutex_);
+    return window;
 }
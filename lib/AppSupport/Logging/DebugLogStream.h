@@ -10,14 +10,37 @@
 #include <vector>
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "Logging/ByteFifo.h"
+#include "Logging/LogRing.h"
+#include "Logging/LogTail.h"
+#include "Logging/StructuredLog.h"
 
-struct DebugLogEntry
+// Complete lines held by the ring, read in one lock for cursor readers.
+struct DebugLogWindow
 {
-    uint32_t id;
-    String text;
+    uint32_t oldestId = 0;
+    uint32_t latestId = 0;
+    size_t count = 0;
 };
 
-class DebugLogStream : public Stream
+// Mirrors everything written to the debug UART into a LogRing so the portal
+// can show recent lines. The ring lives in one preallocated arena (PSRAM
+// when present); a write takes the mutex once per buffer, not per byte.
+//
+// After begin() the UART is fed by a low-priority drain task through a
+// ByteFifo, so a full UART FIFO never stalls the writer. Writes that find
+// the queue full are dropped from the console only (the ring keeps them)
+// and reported as "[log] N bytes dropped". flush() waits for the drain.
+//
+// BRIDGE_LOG* calls on this stream arrive as LogRecords and are queued in
+// binary in both the ring and the UART queue (behind a NUL marker, which
+// text writes never carry); the drain task and the portal readers format
+// them.
+//
+// beginCrashTail() also mirrors the output into a LogTail in RTC memory; the
+// tail a warm reset left behind is kept as text for previousBoot().
+class DebugLogStream : public Stream, public LogRecordSink
 {
 public:
     DebugLogStream(HardwareSerial &serial, size_t maxEntries = 400);
@@ -35,20 +58,55 @@ public:
     size_t write(uint8_t ch) override;
     size_t write(const uint8_t *buffer, size_t size) override;
     using Print::write;
+    void writeRecord(const uint8_t *record, size_t length) override;
 
-    void copyEntries(std::vector<DebugLogEntry> &out) const;
     uint32_t latestId() const;
     size_t entryCount() const;
     size_t maxEntries() const { return maxEntries_; }
+    DebugLogWindow window() const;
+
+    // Starts mirroring into the RTC tail. With keepPrevious (a warm reset)
+    // the tail of the previous boot is rendered first, if it belongs to the
+    // same firmware build. Call before the first line is logged.
+    void beginCrashTail(uint32_t firmwareId, bool keepPrevious);
+    // Console text the previous boot left in the RTC tail; empty if none.
+    const char *previousBoot(size_t &length) const
+    {
+        length = previousBootLength_;
+        return previousBoot_;
+    }
+
+    // Calls fn(id, text, length) for complete lines newer than afterId until
+    // fn returns false, straight from the ring. The log mutex is held
+    // throughout, so fn must only copy and never log. Returns the oldest
+    // stored id (0 while empty) so callers can detect evicted lines.
+    template <typename Fn>
+    uint32_t visitAfter(uint32_t afterId, Fn &&fn) const
+    {
+        if (!mutex_ || xSemaphoreTake(mutex_, portMAX_DELAY) != pdTRUE)
+            return 0;
+        const uint32_t oldest = ring_.oldestId();
+        ring_.forEachAfter(afterId, fn);
+        xSemaphoreGive(mutex_);
+        return oldest;
+    }
 
 private:
-    void appendCharLocked(char c);
-    void pushLineLocked(const String &line);
+    void pushText(const uint8_t *buffer, size_t size);
+    void startDrain();
+    static void drainTaskThunk(void *param);
+    void runDrain();
 
     HardwareSerial &serial_;
     size_t maxEntries_;
-    String currentLine_;
-    std::vector<DebugLogEntry> entries_;
-    uint32_t nextId_;
+    char *arena_ = nullptr;
+    LogRing::Slot *slots_ = nullptr;
+    LogRing ring_;
+    uint8_t *uartBuffer_ = nullptr;
+    ByteFifo uartFifo_;
+    TaskHandle_t drainTask_ = nullptr;
+    LogTail tail_;
+    char *previousBoot_ = nullptr;
+    size_t previousBootLength_ = 0;
     SemaphoreHandle_t mutex_;
 };
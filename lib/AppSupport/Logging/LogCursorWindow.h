@@ -21,6 +21,13 @@ struct Selection
     bool reset = false;
 };
 
+// True when lines right after afterId were evicted from a store whose
+// oldest id is oldestId. A cursor of 0 means "everything" and never resets.
+inline bool evicted(uint32_t afterId, uint32_t oldestId)
+{
+    return afterId != 0 && oldestId != 0 && afterId < oldestId && oldestId - afterId > 1;
+}
+
 template <typename Entry>
 Selection select(const std::vector<Entry> &entries, uint32_t afterId)
 {
@@ -37,7 +44,7 @@ Selection select(const std::vector<Entry> &entries, uint32_t afterId)
         return selection;
     }
 
-    if (afterId < selection.oldestId && (selection.oldestId - afterId) > 1)
+    if (evicted(afterId, selection.oldestId))
     {
         selection.reset = true;
         selection.returnedCount = entries.size();
@@ -0,0 +1,106 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "Logging/LogRing.h"
+#include "Publishing/NumberFormat.h"
+
+// Server-Sent Events framing for /logs/stream. Each log line becomes
+//
+//   id: <epoch>-<line id>
+//   data: <text>
+//
+// so EventSource resumes from Last-Event-ID after a reconnect. The epoch is
+// a nonce drawn at boot: line ids restart with every boot, and an id kept
+// by the browser from before a reboot must not be read as a position in the
+// new ring. LogRing lines never contain '\n' ('\r' is dropped on append),
+// so one data field holds the whole line.
+namespace LogEventStream
+{
+// Response head written before the first event; retry sets the browser's
+// reconnect delay.
+static constexpr char kResponseHead[] = "HTTP/1.1 200 OK\r\n"
+                                        "Content-Type: text/event-stream\r\n"
+                                        "Cache-Control: no-cache\r\n"
+                                        "Connection: keep-alive\r\n"
+                                        "\r\n"
+                                        "retry: 3000\n\n";
+
+// Tells the client that lines after its cursor were evicted, so it clears
+// its view before the oldest stored lines follow.
+static constexpr char kResetEvent[] = "event: reset\ndata:\n\n";
+
+// Comment line that keeps idle connections and proxies open.
+static constexpr char kKeepAlive[] = ":\n\n";
+
+// Upper bound for one event: both field names, the epoch and id, a full
+// line and the separators.
+static constexpr size_t kMaxEventBytes = LogRing::kMaxLineLength + 48;
+
+// Appends one event to out[used..capacity). Returns the new length, or
+// used unchanged if the event does not fit.
+inline size_t appendEvent(char *out, size_t capacity, size_t used, uint32_t epoch, uint32_t id, const char *text, size_t length)
+{
+    char epochDigits[NumberFormat::kMaxChars];
+    const size_t epochLength = NumberFormat::formatUnsigned(epochDigits, sizeof(epochDigits), epoch);
+    char digits[NumberFormat::kMaxChars];
+    const size_t idLength = NumberFormat::formatUnsigned(digits, sizeof(digits), id);
+    const size_t needed = 4 + epochLength + 1 + idLength + 1 + 6 + length + 2;
+    if (!out || used > capacity || capacity - used < needed)
+        return used;
+
+    char *cursor = out + used;
+    std::memcpy(cursor, "id: ", 4);
+    cursor += 4;
+    std::memcpy(cursor, epochDigits, epochLength);
+    cursor += epochLength;
+    *cursor++ = '-';
+    std::memcpy(cursor, digits, idLength);
+    cursor += idLength;
+    *cursor++ = '\n';
+    std::memcpy(cursor, "data: ", 6);
+    cursor += 6;
+    if (length)
+        std::memcpy(cursor, text, length);
+    cursor += length;
+    *cursor++ = '\n';
+    *cursor++ = '\n';
+    return used + needed;
+}
+
+// Reads an "<epoch>-<id>" event id. Returns true and sets id when it was
+// written during this boot; anything else (another epoch, a bare number,
+// garbage) sets id to 0 and returns false, so the caller starts over.
+inline bool parseEventId(const char *text, uint32_t epoch, uint32_t &id)
+{
+    id = 0;
+    uint32_t parts[2] = {0, 0};
+    size_t part = 0;
+    bool digits = false;
+    for (const char *c = text; c && *c; ++c)
+    {
+        if (*c == '-' && part == 0 && digits)
+        {
+            part = 1;
+            digits = false;
+            continue;
+        }
+        if (*c < '0' || *c > '9')
+            return false;
+        parts[part] = parts[part] * 10 + static_cast<uint32_t>(*c - '0');
+        digits = true;
+    }
+    if (part != 1 || !digits || parts[0] != epoch)
+        return false;
+    id = parts[1];
+    return true;
+}
+} // namespace LogEventStream
@@ -0,0 +1,78 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Lines waiting in RAM for the next append to the flash log. Flash is
+// written in a few large appends instead of one per line: a batch goes out
+// once it is mostly full or has aged, and never sooner than
+// kMinWriteIntervalMs after the previous append.
+//
+// Not thread-safe; LogFileWriter runs it from the main loop.
+class LogFileBatch
+{
+public:
+    static constexpr uint32_t kMinWriteIntervalMs = 60UL * 1000UL;
+    static constexpr uint32_t kMaxAgeMs = 10UL * 60UL * 1000UL;
+
+    void attach(char *buffer, size_t capacity)
+    {
+        buffer_ = buffer;
+        capacity_ = buffer ? capacity : 0;
+        used_ = 0;
+    }
+
+    bool ready() const { return capacity_ != 0; }
+    bool empty() const { return used_ == 0; }
+    size_t size() const { return used_; }
+    const char *data() const { return buffer_; }
+
+    // Adds text plus '\n'. Returns false, leaving the batch unchanged, when
+    // it does not fit.
+    bool add(const char *text, size_t length, uint32_t nowMs)
+    {
+        if (!ready() || length + 1 > capacity_ - used_)
+            return false;
+        if (!used_)
+            firstAddedMs_ = nowMs;
+        if (length)
+            std::memcpy(buffer_ + used_, text, length);
+        used_ += length;
+        buffer_[used_++] = '\n';
+        return true;
+    }
+
+    bool mostlyFull() const { return used_ >= capacity_ - capacity_ / 4; }
+
+    bool due(uint32_t nowMs) const
+    {
+        if (empty())
+            return false;
+        if (written_ && nowMs - lastWriteMs_ < kMinWriteIntervalMs)
+            return false;
+        return mostlyFull() || nowMs - firstAddedMs_ >= kMaxAgeMs;
+    }
+
+    // Empties the batch after its bytes were appended (or given up on).
+    void markWritten(uint32_t nowMs)
+    {
+        used_ = 0;
+        lastWriteMs_ = nowMs;
+        written_ = true;
+    }
+
+private:
+    char *buffer_ = nullptr;
+    size_t capacity_ = 0;
+    size_t used_ = 0;
+    uint32_t firstAddedMs_ = 0;
+    uint32_t lastWriteMs_ = 0;
+    bool written_ = false;
+};
@@ -0,0 +1,135 @@
+// SPDX-FileCopyrightText: 2026 André Fiedler
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "Logging/LogFileWriter.h"
+
+#include <LittleFS.h>
+#include <esp_heap_caps.h>
+#include "Logging/LogCursorWindow.h"
+#include "Logging/StructuredLog.h"
+
+namespace
+{
+    // Collecting takes the log mutex, so once a second is plenty; the ring
+    // holds minutes of output.
+    constexpr uint32_t kCollectIntervalMs = 1000;
+}
+
+LogFileWriter::~LogFileWriter()
+{
+    free(buffer_);
+}
+
+void LogFileWriter::setEnabled(bool enabled)
+{
+    if (enabled == enabled_)
+        return;
+    if (!enabled)
+    {
+        flush();
+        enabled_ = false;
+        return;
+    }
+
+    if (!buffer_)
+    {
+        buffer_ = static_cast<char *>(heap_caps_malloc(kBatchBytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+        if (!buffer_)
+            buffer_ = static_cast<char *>(malloc(kBatchBytes));
+        if (!buffer_)
+        {
+            BRIDGE_LOGE(source_, "LogFile", "no memory for a %u byte batch", static_cast<unsigned>(kBatchBytes));
+            return;
+        }
+        batch_.attach(buffer_, kBatchBytes);
+    }
+    // The first start takes the whole ring, boot messages included; after
+    // a pause only new lines, so the gap is not reported as lost.
+    if (cursor_)
+        cursor_ = source_.window().latestId;
+    enabled_ = true;
+    failureLogged_ = false;
+    BRIDGE_LOGI(source_, "LogFile", "writing %s (max %u KB, rotated to %s)", kPath, static_cast<unsigned>(kMaxFileBytes / 1024), kRotatedPath);
+}
+
+void LogFileWriter::loop()
+{
+    if (!enabled_)
+        return;
+    const uint32_t now = millis();
+    if (now - lastCollectMs_ >= kCollectIntervalMs)
+    {
+        lastCollectMs_ = now;
+        collect(now);
+    }
+    if (batch_.due(now))
+        writeBatch(now);
+}
+
+void LogFileWriter::flush()
+{
+    if (!enabled_)
+        return;
+    const uint32_t now = millis();
+    collect(now);
+    if (!batch_.empty())
+        writeBatch(now);
+}
+
+void LogFileWriter::collect(uint32_t nowMs)
+{
+    const DebugLogWindow window = source_.window();
+    if (LogCursorWindow::evicted(cursor_, window.oldestId))
+    {
+        char note[64];
+        const int length = snprintf(note,
+                                    sizeof(note),
+                                    "[log] %lu lines evicted before they reached flash",
+                                    static_cast<unsigned long>(window.oldestId - cursor_ - 1));
+        if (length <= 0 || !batch_.add(note, static_cast<size_t>(length), nowMs))
+            return;
+        cursor_ = window.oldestId - 1;
+    }
+
+    // Copies only; the log mutex is held while the lambda runs.
+    source_.visitAfter(cursor_, [&](uint32_t id, const char *text, size_t length) {
+        if (!batch_.add(text, length, nowMs))
+            return false;
+        cursor_ = id;
+        return true;
+    });
+}
+
+void LogFileWriter::writeBatch(uint32_t nowMs)
+{
+    const size_t length = batch_.size();
+    File file = LittleFS.open(kPath, "a");
+    if (file && file.size() + length > kMaxFileBytes)
+    {
+        file.close();
+        LittleFS.remove(kRotatedPath);
+        LittleFS.rename(kPath, kRotatedPath);
+        file = LittleFS.open(kPath, "a");
+    }
+
+    size_t written = 0;
+    if (file)
+    {
+        written = file.write(reinterpret_cast<const uint8_t *>(batch_.data()), length);
+        file.close();
+    }
+    // A failed batch is dropped rather than retried, so a full or missing
+    // filesystem cannot turn into a write loop.
+    batch_.markWritten(nowMs);
+    if (written == length)
+    {
+        failureLogged_ = false;
+        return;
+    }
+    if (!failureLogged_)
+    {
+        BRIDGE_LOGW(source_, "LogFile", "append to %s failed (%u of %u bytes)", kPath, static_cast<unsigned>(written), static_cast<unsigned>(length));
+        failureLogged_ = true;
+    }
+}
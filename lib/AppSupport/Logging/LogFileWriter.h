@@ -0,0 +1,50 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include "Logging/DebugLogStream.h"
+#include "Logging/LogFileBatch.h"
+
+// Optional log file on LittleFS. Complete lines are read from the
+// DebugLogStream ring through a cursor into a LogFileBatch and appended to
+// kPath in large, rate-limited writes. Once the file would exceed
+// kMaxFileBytes it becomes kRotatedPath, so the log takes at most twice
+// that on flash. Lines the ring evicted before they were collected are
+// noted in the file.
+class LogFileWriter
+{
+public:
+    static constexpr const char *kPath = "/bridge.log";
+    static constexpr const char *kRotatedPath = "/bridge.1.log";
+    static constexpr size_t kMaxFileBytes = 64 * 1024;
+    static constexpr size_t kBatchBytes = 4 * 1024;
+
+    explicit LogFileWriter(DebugLogStream &source) : source_(source) {}
+    ~LogFileWriter();
+
+    // Disabling writes out what is already collected.
+    void setEnabled(bool enabled);
+    bool enabled() const { return enabled_; }
+
+    void loop();
+    // Appends the current batch now, ignoring the rate limit; used before a
+    // download.
+    void flush();
+
+private:
+    void collect(uint32_t nowMs);
+    void writeBatch(uint32_t nowMs);
+
+    DebugLogStream &source_;
+    char *buffer_ = nullptr;
+    LogFileBatch batch_;
+    uint32_t cursor_ = 0;
+    uint32_t lastCollectMs_ = 0;
+    bool enabled_ = false;
+    bool failureLogged_ = false;
+};
@@ -0,0 +1,62 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Logging/LogRing.h"
+
+// JSON string encoding for /logs.json, written line by line into a caller
+// buffer that is sent as one HTTP chunk. Quotes, backslashes and control
+// characters are escaped; other bytes (UTF-8 included) pass through.
+namespace LogJsonChunk
+{
+// A line of nothing but control characters, its quotes and a comma.
+static constexpr size_t kMaxLineBytes = LogRing::kMaxLineLength * 6 + 3;
+
+// Appends text as a JSON string to out[used..capacity), preceded by a comma
+// unless it is the first array element. Returns the new length, or used
+// unchanged if it does not fit.
+inline size_t appendLine(char *out, size_t capacity, size_t used, const char *text, size_t length, bool first)
+{
+    static constexpr char kHex[] = "0123456789abcdef";
+    if (!out || used > capacity)
+        return used;
+
+    size_t at = used;
+    auto put = [&](char c) {
+        if (at >= capacity)
+            return false;
+        out[at++] = c;
+        return true;
+    };
+
+    if (!first && !put(','))
+        return used;
+    if (!put('"'))
+        return used;
+    for (size_t i = 0; i < length; ++i)
+    {
+        const uint8_t c = static_cast<uint8_t>(text[i]);
+        bool ok = true;
+        if (c == '"' || c == '\\')
+            ok = put('\\') && put(static_cast<char>(c));
+        else if (c == '\t')
+            ok = put('\\') && put('t');
+        else if (c < 0x20)
+            ok = put('\\') && put('u') && put('0') && put('0') && put(kHex[c >> 4]) && put(kHex[c & 0x0F]);
+        else
+            ok = put(static_cast<char>(c));
+        if (!ok)
+            return used;
+    }
+    if (!put('"'))
+        return used;
+    return at;
+}
+} // namespace LogJsonChunk
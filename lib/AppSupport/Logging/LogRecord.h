@@ -0,0 +1,420 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+
+enum class LogLevel : uint8_t
+{
+    None = 0,
+    Error,
+    Warn,
+    Info,
+    Debug,
+};
+
+// A log call kept in binary until someone reads it: level, the addresses of
+// the tag and printf-style format (both string literals, so they live as
+// long as the firmware) and the raw arguments. format() renders the text
+// only when a line goes to the UART or the portal.
+//
+//   offset  content
+//    0      level
+//    1      argument count
+//    2      tag pointer
+//    2+P    format pointer (P = sizeof(const char *))
+//    2+2P   arguments, each a type byte followed by its value; strings
+//           are a length byte and the bytes, cut at kMaxStringBytes
+//
+// Records are host-endian and only ever read back on the same device.
+namespace LogRecord
+{
+static constexpr size_t kMaxRecordBytes = 256;
+static constexpr size_t kMaxStringBytes = 96;
+// Formatted text, terminator included; matches a LogRing line.
+static constexpr size_t kMaxTextBytes = 320;
+
+enum ArgType : uint8_t
+{
+    Signed32 = 1,
+    Unsigned32,
+    Signed64,
+    Unsigned64,
+    Float64,
+    Char,
+    Text,
+};
+
+namespace detail
+{
+static constexpr size_t kHeaderBytes = 2 + 2 * sizeof(const char *);
+
+struct Writer
+{
+    uint8_t *out;
+    size_t capacity;
+    size_t used;
+    uint8_t count;
+    bool full;
+
+    bool reserve(size_t bytes)
+    {
+        if (full || capacity - used < bytes)
+        {
+            full = true;
+            return false;
+        }
+        return true;
+    }
+
+    template <typename T>
+    void putValue(ArgType type, T value)
+    {
+        if (!reserve(1 + sizeof(T)))
+            return;
+        out[used++] = type;
+        std::memcpy(out + used, &value, sizeof(T));
+        used += sizeof(T);
+        ++count;
+    }
+
+    void putText(const char *text, size_t length)
+    {
+        if (!text)
+        {
+            text = "(null)";
+            length = 6;
+        }
+        if (length > kMaxStringBytes)
+            length = kMaxStringBytes;
+        if (!reserve(2 + length))
+            return;
+        out[used++] = Text;
+        out[used++] = static_cast<uint8_t>(length);
+        std::memcpy(out + used, text, length);
+        used += length;
+        ++count;
+    }
+};
+
+template <typename T, typename = void>
+struct HasCStr : std::false_type
+{
+};
+
+template <typename T>
+struct HasCStr<T, decltype(void(std::declval<const T &>().c_str()), void(std::declval<const T &>().length()))>
+    : std::true_type
+{
+};
+
+inline void put(Writer &writer, const char *text) { writer.putText(text, text ? std::strlen(text) : 0); }
+inline void put(Writer &writer, char *text) { put(writer, static_cast<const char *>(text)); }
+inline void put(Writer &writer, char c) { writer.putValue(Char, c); }
+inline void put(Writer &writer, bool value) { writer.putValue(Signed32, static_cast<int32_t>(value)); }
+
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type put(Writer &writer, T value)
+{
+    using Raw = typename std::conditional<std::is_enum<T>::value, std::underlying_type<T>, std::common_type<T>>::type::type;
+    const Raw raw = static_cast<Raw>(value);
+    if (std::is_signed<Raw>::value)
+    {
+        if (sizeof(Raw) <= 4)
+            writer.putValue(Signed32, static_cast<int32_t>(raw));
+        else
+            writer.putValue(Signed64, static_cast<int64_t>(raw));
+    }
+    else
+    {
+        if (sizeof(Raw) <= 4)
+            writer.putValue(Unsigned32, static_cast<uint32_t>(raw));
+        else
+            writer.putValue(Unsigned64, static_cast<uint64_t>(raw));
+    }
+}
+
+template <typename T>
+typename std::enable_if<std::is_floating_point<T>::value>::type put(Writer &writer, T value)
+{
+    writer.putValue(Float64, static_cast<double>(value));
+}
+
+// String, std::string and anything else with c_str() and length().
+template <typename T>
+typename std::enable_if<HasCStr<T>::value>::type put(Writer &writer, const T &text)
+{
+    writer.putText(text.c_str(), static_cast<size_t>(text.length()));
+}
+
+inline void putAll(Writer &) {}
+
+template <typename First, typename... Rest>
+void putAll(Writer &writer, const First &first, const Rest &...rest)
+{
+    put(writer, first);
+    putAll(writer, rest...);
+}
+
+struct Reader
+{
+    const uint8_t *in;
+    size_t length;
+    size_t at;
+    uint8_t remaining;
+
+    // Returns false when no (complete) argument is left.
+    bool next(ArgType &type, const uint8_t *&value, size_t &size)
+    {
+        if (!remaining || at >= length)
+            return false;
+        type = static_cast<ArgType>(in[at++]);
+        switch (type)
+        {
+        case Signed32:
+        case Unsigned32:
+            size = 4;
+            break;
+        case Signed64:
+        case Unsigned64:
+        case Float64:
+            size = 8;
+            break;
+        case Char:
+            size = 1;
+            break;
+        case Text:
+            if (at >= length)
+                return false;
+            size = in[at++];
+            break;
+        default:
+            return false;
+        }
+        if (length - at < size)
+            return false;
+        value = in + at;
+        at += size;
+        --remaining;
+        return true;
+    }
+};
+
+template <typename T>
+T load(const uint8_t *value)
+{
+    T result;
+    std::memcpy(&result, value, sizeof(T));
+    return result;
+}
+
+inline bool isOneOf(char c, const char *set) { return c && std::strchr(set, c) != nullptr; }
+
+// Renders one conversion with the caller's flags, width and precision but
+// the argument's real type, so a mismatched specifier cannot misread it.
+inline int renderArg(char *out, size_t capacity, const char *flags, size_t flagsLength, char conversion, ArgType type, const uint8_t *value, size_t size)
+{
+    char spec[24];
+    if (flagsLength > sizeof(spec) - 5)
+        flagsLength = sizeof(spec) - 5;
+    spec[0] = '%';
+    std::memcpy(spec + 1, flags, flagsLength);
+    char *tail = spec + 1 + flagsLength;
+
+    switch (type)
+    {
+    case Signed32:
+    case Signed64:
+    case Unsigned32:
+    case Unsigned64:
+    {
+        const bool isSigned = type == Signed32 || type == Signed64;
+        const int64_t signedValue = type == Signed32   ? load<int32_t>(value)
+                                    : type == Signed64 ? load<int64_t>(value)
+                                                       : 0;
+        // Like printf, %x of a negative int shows its 32-bit pattern.
+        const uint64_t unsignedValue = type == Unsigned32   ? load<uint32_t>(value)
+                                       : type == Unsigned64 ? load<uint64_t>(value)
+                                       : type == Signed32   ? static_cast<uint32_t>(signedValue)
+                                                            : static_cast<uint64_t>(signedValue);
+        if (conversion == 'c')
+        {
+            std::strcpy(tail, "c");
+            return std::snprintf(out, capacity, spec, static_cast<int>(unsignedValue & 0xFF));
+        }
+        if (!isOneOf(conversion, "diouxX"))
+            conversion = isSigned ? 'd' : 'u';
+        tail[0] = 'l';
+        tail[1] = 'l';
+        tail[2] = conversion;
+        tail[3] = '\0';
+        if (conversion == 'd' || conversion == 'i')
+            return std::snprintf(out, capacity, spec, static_cast<long long>(isSigned ? signedValue : static_cast<int64_t>(unsignedValue)));
+        return std::snprintf(out, capacity, spec, static_cast<unsigned long long>(unsignedValue));
+    }
+    case Float64:
+        tail[0] = isOneOf(conversion, "fFeEgGaA") ? conversion : 'g';
+        tail[1] = '\0';
+        return std::snprintf(out, capacity, spec, load<double>(value));
+    case Char:
+        std::strcpy(tail, "c");
+        return std::snprintf(out, capacity, spec, static_cast<int>(static_cast<char>(value[0])));
+    case Text:
+    {
+        // Stored text is not terminated; an explicit precision can only
+        // shorten it further.
+        int precision = static_cast<int>(size);
+        const char *dot = static_cast<const char *>(std::memchr(flags, '.', flagsLength));
+        if (dot)
+        {
+            tail = spec + 1 + (dot - flags);
+            const int requested = std::atoi(dot + 1);
+            if (requested < precision)
+                precision = requested;
+        }
+        std::strcpy(tail, ".*s");
+        return std::snprintf(out, capacity, spec, precision, reinterpret_cast<const char *>(value));
+    }
+    }
+    return 0;
+}
+} // namespace detail
+
+// Encodes one call into out. Arguments that no longer fit are left out and
+// render as "?". Returns the record length, or 0 if out cannot even hold
+// the header.
+template <typename... Args>
+size_t encode(uint8_t *out, size_t capacity, LogLevel level, const char *tag, const char *format, const Args &...args)
+{
+    if (!out || capacity < detail::kHeaderBytes)
+        return 0;
+    out[0] = static_cast<uint8_t>(level);
+    std::memcpy(out + 2, &tag, sizeof(tag));
+    std::memcpy(out + 2 + sizeof(tag), &format, sizeof(format));
+    detail::Writer writer{out, capacity, detail::kHeaderBytes, 0, false};
+    detail::putAll(writer, args...);
+    out[1] = writer.count;
+    return writer.used;
+}
+
+inline LogLevel level(const uint8_t *record, size_t length)
+{
+    return record && length ? static_cast<LogLevel>(record[0]) : LogLevel::None;
+}
+
+inline char levelLetter(LogLevel level)
+{
+    switch (level)
+    {
+    case LogLevel::Error:
+        return 'E';
+    case LogLevel::Warn:
+        return 'W';
+    case LogLevel::Info:
+        return 'I';
+    case LogLevel::Debug:
+        return 'D';
+    default:
+        return '-';
+    }
+}
+
+inline const char *levelName(LogLevel level)
+{
+    switch (level)
+    {
+    case LogLevel::Error:
+        return "error";
+    case LogLevel::Warn:
+        return "warn";
+    case LogLevel::Info:
+        return "info";
+    case LogLevel::Debug:
+        return "debug";
+    default:
+        return "none";
+    }
+}
+
+// Renders "[L] tag: message" into out, cut to capacity - 1 bytes. Returns
+// the text length; out is always terminated when capacity > 0.
+inline size_t format(const uint8_t *record, size_t length, char *out, size_t capacity)
+{
+    if (!out || !capacity)
+        return 0;
+    out[0] = '\0';
+    if (!record || length < detail::kHeaderBytes)
+        return 0;
+
+    const char *tag;
+    const char *fmt;
+    std::memcpy(&tag, record + 2, sizeof(tag));
+    std::memcpy(&fmt, record + 2 + sizeof(tag), sizeof(fmt));
+
+    size_t used = 0;
+    auto advance = [&](int written) {
+        if (written <= 0)
+            return;
+        used += static_cast<size_t>(written);
+        if (used > capacity - 1)
+            used = capacity - 1;
+    };
+    advance(std::snprintf(out, capacity, "[%c] %s: ", levelLetter(static_cast<LogLevel>(record[0])), tag ? tag : ""));
+
+    detail::Reader reader{record, length, detail::kHeaderBytes, record[1]};
+    for (const char *p = fmt ? fmt : ""; *p && used < capacity - 1; ++p)
+    {
+        if (*p != '%')
+        {
+            out[used++] = *p;
+            continue;
+        }
+        if (p[1] == '%')
+        {
+            out[used++] = '%';
+            ++p;
+            continue;
+        }
+        const char *flags = p + 1;
+        const char *q = flags;
+        while (detail::isOneOf(*q, "-+ #0"))
+            ++q;
+        while (*q >= '0' && *q <= '9')
+            ++q;
+        if (*q == '.')
+        {
+            ++q;
+            while (*q >= '0' && *q <= '9')
+                ++q;
+        }
+        const size_t flagsLength = static_cast<size_t>(q - flags);
+        while (detail::isOneOf(*q, "hlLqjzt"))
+            ++q;
+        if (!*q)
+            break;
+        const char conversion = *q;
+        p = q;
+
+        ArgType type;
+        const uint8_t *value = nullptr;
+        size_t size = 0;
+        if (!reader.next(type, value, size))
+        {
+            out[used++] = '?';
+            continue;
+        }
+        advance(detail::renderArg(out + used, capacity - used, flags, flagsLength, conversion, type, value, size));
+    }
+    out[used] = '\0';
+    return used;
+}
+} // namespace LogRecord
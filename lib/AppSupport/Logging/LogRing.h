@@ -0,0 +1,227 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "Logging/LogRecord.h"
+
+// Line store over caller-provided memory: a byte arena used as a ring plus
+// a ring of slots (id, offset, length), one per line. Appending never
+// allocates; the oldest lines are evicted when either ring is full. A line
+// may wrap around the end of the arena, so readers get each line through a
+// scratch copy in forEach().
+//
+// A line may also hold a LogRecord, stored behind a kRecordMarker byte and
+// formatted only when a reader visits it. Text lines never contain that
+// byte because append() drops it.
+//
+// Not thread-safe; DebugLogStream serialises access.
+class LogRing
+{
+public:
+    static constexpr size_t kMaxLineLength = 320;
+    static constexpr uint8_t kRecordMarker = 0x00;
+    static_assert(LogRecord::kMaxRecordBytes < kMaxLineLength, "a record must fit one line");
+
+    struct Slot
+    {
+        uint32_t id;
+        uint32_t offset;
+        uint16_t length;
+    };
+
+    void attach(char *arena, size_t arenaBytes, Slot *slots, size_t slotCount)
+    {
+        arena_ = arena;
+        arenaBytes_ = arena ? arenaBytes : 0;
+        slots_ = slots;
+        slotCapacity_ = slots ? slotCount : 0;
+        head_ = 0;
+        count_ = 0;
+        used_ = 0;
+        start_ = 0;
+        pendingLength_ = 0;
+    }
+
+    bool ready() const { return arenaBytes_ && slotCapacity_; }
+    size_t capacity() const { return slotCapacity_; }
+    size_t arenaBytes() const { return arenaBytes_; }
+
+    // Splits on '\n', drops '\r' and breaks lines at kMaxLineLength.
+    void append(const uint8_t *data, size_t size)
+    {
+        if (!ready() || !data)
+            return;
+        for (size_t i = 0; i < size; ++i)
+        {
+            const char c = static_cast<char>(data[i]);
+            if (c == '\r' || c == static_cast<char>(kRecordMarker))
+                continue;
+            if (c == '\n')
+            {
+                commit();
+                continue;
+            }
+            pending_[pendingLength_++] = c;
+            if (pendingLength_ >= kMaxLineLength)
+                commit();
+        }
+    }
+
+    // Stores a record as a line of its own, after any unterminated text.
+    void appendRecord(const uint8_t *record, size_t length)
+    {
+        if (!ready() || !record || !length)
+            return;
+        if (pendingLength_)
+            commit();
+        if (length > kMaxLineLength - 1)
+            length = kMaxLineLength - 1;
+        pending_[0] = static_cast<char>(kRecordMarker);
+        std::memcpy(pending_ + 1, record, length);
+        pendingLength_ = length + 1;
+        commit();
+    }
+
+    // Stored lines plus the unterminated one, if any.
+    size_t count() const { return count_ + (pendingLength_ ? 1 : 0); }
+
+    // Id of the newest complete line. The unterminated line only counts
+    // while nothing else is stored; clients re-read it once it completes.
+    uint32_t latestId() const
+    {
+        if (count_)
+            return slot(count_ - 1).id;
+        if (pendingLength_)
+            return nextId_;
+        return nextId_ - 1;
+    }
+
+    // Calls fn(id, text, length) oldest first, ending with the unterminated
+    // line under the id it will get. text is only valid during the call.
+    template <typename Fn>
+    void forEach(Fn &&fn) const
+    {
+        char scratch[kMaxLineLength];
+        for (size_t i = 0; i < count_; ++i)
+        {
+            const Slot &entry = slot(i);
+            size_t length = entry.length;
+            const char *text = resolve(entry, scratch, length);
+            fn(entry.id, text, length);
+        }
+        if (pendingLength_)
+            fn(nextId_, static_cast<const char *>(pending_), pendingLength_);
+    }
+
+    // Ids of the oldest and newest complete lines, 0 while none is stored.
+    uint32_t oldestId() const { return count_ ? slot(0).id : 0; }
+    uint32_t lastCompleteId() const { return count_ ? slot(count_ - 1).id : 0; }
+
+    // Calls fn(id, text, length) for complete lines newer than afterId,
+    // oldest first, until fn returns false. The unterminated line is left
+    // out so a streaming reader never sees it change under the same id.
+    template <typename Fn>
+    void forEachAfter(uint32_t afterId, Fn &&fn) const
+    {
+        if (!count_)
+            return;
+        // Ids are consecutive, so the cursor maps straight to a slot index.
+        const uint32_t oldest = oldestId();
+        size_t start = afterId < oldest ? 0 : static_cast<size_t>(afterId - oldest) + 1;
+        char scratch[kMaxLineLength];
+        for (size_t i = start; i < count_; ++i)
+        {
+            const Slot &entry = slot(i);
+            size_t length = entry.length;
+            const char *text = resolve(entry, scratch, length);
+            if (!fn(entry.id, text, length))
+                return;
+        }
+    }
+
+private:
+    const Slot &slot(size_t index) const { return slots_[(head_ + index) % slotCapacity_]; }
+
+    // Text of a stored line: in place when it does not wrap, otherwise
+    // copied to scratch; records are formatted into scratch.
+    const char *resolve(const Slot &entry, char (&scratch)[kMaxLineLength], size_t &length) const
+    {
+        const size_t first = arenaBytes_ - entry.offset;
+        const char *text = arena_ + entry.offset;
+        if (entry.length > first)
+        {
+            std::memcpy(scratch, arena_ + entry.offset, first);
+            std::memcpy(scratch + first, arena_, entry.length - first);
+            text = scratch;
+        }
+        if (!entry.length || static_cast<uint8_t>(text[0]) != kRecordMarker)
+            return text;
+
+        const size_t recordLength = entry.length - 1;
+        if (text != scratch)
+        {
+            length = LogRecord::format(reinterpret_cast<const uint8_t *>(text + 1), recordLength, scratch, sizeof(scratch));
+            return scratch;
+        }
+        uint8_t record[kMaxLineLength];
+        std::memcpy(record, text + 1, recordLength);
+        length = LogRecord::format(record, recordLength, scratch, sizeof(scratch));
+        return scratch;
+    }
+
+    void evictOldest()
+    {
+        used_ -= slots_[head_].length;
+        head_ = (head_ + 1) % slotCapacity_;
+        --count_;
+        start_ = count_ ? slots_[head_].offset : 0;
+        if (!count_)
+            used_ = 0;
+    }
+
+    void commit()
+    {
+        size_t length = pendingLength_;
+        pendingLength_ = 0;
+        if (length > arenaBytes_)
+            length = arenaBytes_;
+
+        while (count_ && (count_ == slotCapacity_ || arenaBytes_ - used_ < length))
+            evictOldest();
+
+        const size_t offset = (start_ + used_) % arenaBytes_;
+        const size_t first = arenaBytes_ - offset < length ? arenaBytes_ - offset : length;
+        std::memcpy(arena_ + offset, pending_, first);
+        std::memcpy(arena_, pending_ + first, length - first);
+
+        Slot &entry = slots_[(head_ + count_) % slotCapacity_];
+        entry.id = nextId_++;
+        entry.offset = static_cast<uint32_t>(offset);
+        entry.length = static_cast<uint16_t>(length);
+        if (!count_)
+            start_ = offset;
+        ++count_;
+        used_ += length;
+    }
+
+    char *arena_ = nullptr;
+    size_t arenaBytes_ = 0;
+    Slot *slots_ = nullptr;
+    size_t slotCapacity_ = 0;
+    size_t head_ = 0;
+    size_t count_ = 0;
+    // Live bytes start at start_ and run used_ bytes around the ring.
+    size_t start_ = 0;
+    size_t used_ = 0;
+    uint32_t nextId_ = 1;
+    char pending_[kMaxLineLength];
+    size_t pendingLength_ = 0;
+};
@@ -0,0 +1,249 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "Logging/LogRecord.h"
+
+// The last few KB of console output kept in memory that survives a warm
+// reset (RTC slow memory on the ESP32). The layout is a Header followed by
+// a byte ring holding text bytes and record frames
+//
+//   0x00, length (u16 LE), LogRecord
+//
+// the same framing DebugLogStream uses for its UART queue. Eviction drops a
+// frame whole, so the ring always starts at a text byte or a frame.
+//
+// After a reset adopt() checks the header and walks every frame before it
+// trusts the content; the firmware id ties records to the build whose
+// format strings they point at. Not thread-safe; DebugLogStream serialises
+// access.
+class LogTail
+{
+public:
+    static constexpr uint32_t kMagic = 0x4C544131; // "LTA1"
+    static constexpr uint8_t kFrameMarker = 0x00;
+    static constexpr size_t kFrameHeader = 3;
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t firmwareId;
+        uint32_t head;
+        uint32_t size;
+        // Non-zero once bytes were evicted; the first line is then partial.
+        uint32_t wrapped;
+    };
+
+    // Starts an empty tail in memory.
+    void reset(void *memory, size_t bytes, uint32_t firmwareId)
+    {
+        if (!bind(memory, bytes))
+            return;
+        header_->magic = 0;
+        header_->firmwareId = firmwareId;
+        header_->head = 0;
+        header_->size = 0;
+        header_->wrapped = 0;
+        header_->magic = kMagic;
+    }
+
+    // Takes over what a previous boot left in memory. Returns false, and
+    // stays detached, unless it is a well-formed tail of the same build.
+    bool adopt(void *memory, size_t bytes, uint32_t firmwareId)
+    {
+        if (!bind(memory, bytes))
+            return false;
+        const Header &header = *header_;
+        if (header.magic != kMagic || header.firmwareId != firmwareId ||
+            header.head >= capacity_ || header.size > capacity_ || !framesValid())
+        {
+            header_ = nullptr;
+            data_ = nullptr;
+            capacity_ = 0;
+            return false;
+        }
+        return true;
+    }
+
+    bool ready() const { return header_ != nullptr; }
+    size_t size() const { return header_ ? header_->size : 0; }
+    size_t capacity() const { return capacity_; }
+
+    // Console text; NUL bytes are dropped like everywhere else in the log.
+    void append(const uint8_t *data, size_t length)
+    {
+        if (!ready() || !data)
+            return;
+        const uint8_t *end = data + length;
+        while (data < end)
+        {
+            const uint8_t *marker = static_cast<const uint8_t *>(std::memchr(data, kFrameMarker, end - data));
+            const uint8_t *stop = marker ? marker : end;
+            putText(data, static_cast<size_t>(stop - data));
+            data = marker ? marker + 1 : end;
+        }
+    }
+
+    void appendRecord(const uint8_t *record, size_t length)
+    {
+        if (!ready() || !record || !length || length > LogRecord::kMaxRecordBytes ||
+            kFrameHeader + length > capacity_)
+            return;
+        makeRoom(kFrameHeader + length);
+        const uint8_t frame[kFrameHeader] = {kFrameMarker,
+                                             static_cast<uint8_t>(length),
+                                             static_cast<uint8_t>(length >> 8)};
+        copyIn(frame, kFrameHeader, 0);
+        copyIn(record, length, kFrameHeader);
+        header_->size += static_cast<uint32_t>(kFrameHeader + length);
+    }
+
+    // Renders the tail as console text, records formatted and ended with
+    // "\r\n". A line cut by eviction is left out. Returns the length;
+    // output stops at capacity.
+    size_t render(char *out, size_t capacity) const
+    {
+        if (!ready() || !out)
+            return 0;
+        size_t used = 0;
+        size_t at = 0;
+        const size_t size = header_->size;
+        if (header_->wrapped)
+        {
+            while (at < size && byteAt(at) != kFrameMarker && byteAt(at) != '\n')
+                ++at;
+            if (at < size && byteAt(at) == '\n')
+                ++at;
+        }
+
+        uint8_t record[LogRecord::kMaxRecordBytes];
+        char line[LogRecord::kMaxTextBytes + 2];
+        while (at < size && used < capacity)
+        {
+            const uint8_t c = byteAt(at);
+            if (c != kFrameMarker)
+            {
+                out[used++] = static_cast<char>(c);
+                ++at;
+                continue;
+            }
+            const size_t length = frameLength(at);
+            for (size_t i = 0; i < length; ++i)
+                record[i] = byteAt(at + kFrameHeader + i);
+            at += kFrameHeader + length;
+            size_t lineLength = LogRecord::format(record, length, line, LogRecord::kMaxTextBytes);
+            line[lineLength++] = '\r';
+            line[lineLength++] = '\n';
+            const size_t fits = capacity - used < lineLength ? capacity - used : lineLength;
+            std::memcpy(out + used, line, fits);
+            used += fits;
+        }
+        return used;
+    }
+
+private:
+    bool bind(void *memory, size_t bytes)
+    {
+        header_ = nullptr;
+        data_ = nullptr;
+        capacity_ = 0;
+        if (!memory || bytes <= sizeof(Header) + kFrameHeader)
+            return false;
+        header_ = static_cast<Header *>(memory);
+        data_ = static_cast<uint8_t *>(memory) + sizeof(Header);
+        capacity_ = bytes - sizeof(Header);
+        return true;
+    }
+
+    uint8_t byteAt(size_t offset) const { return data_[(header_->head + offset) % capacity_]; }
+
+    size_t frameLength(size_t offset) const
+    {
+        return static_cast<size_t>(byteAt(offset + 1)) | (static_cast<size_t>(byteAt(offset + 2)) << 8);
+    }
+
+    bool framesValid() const
+    {
+        const size_t size = header_->size;
+        size_t at = 0;
+        while (at < size)
+        {
+            if (byteAt(at) != kFrameMarker)
+            {
+                ++at;
+                continue;
+            }
+            if (size - at < kFrameHeader)
+                return false;
+            const size_t length = frameLength(at);
+            if (!length || length > LogRecord::kMaxRecordBytes || size - at - kFrameHeader < length)
+                return false;
+            at += kFrameHeader + length;
+        }
+        return true;
+    }
+
+    void putText(const uint8_t *data, size_t length)
+    {
+        if (!length)
+            return;
+        if (length > capacity_)
+        {
+            data += length - capacity_;
+            length = capacity_;
+        }
+        makeRoom(length);
+        copyIn(data, length, 0);
+        header_->size += static_cast<uint32_t>(length);
+    }
+
+    // Evicts from the front until bytes fit. The header is updated before
+    // the new bytes land and grows only once they are complete, so a reset
+    // in between leaves a consistent tail.
+    void makeRoom(size_t bytes)
+    {
+        Header &header = *header_;
+        size_t head = header.head;
+        size_t size = header.size;
+        if (capacity_ - size >= bytes)
+            return;
+        while (size && capacity_ - size < bytes)
+        {
+            size_t drop = 1;
+            if (data_[head] == kFrameMarker)
+            {
+                const size_t length = static_cast<size_t>(data_[(head + 1) % capacity_]) |
+                                      (static_cast<size_t>(data_[(head + 2) % capacity_]) << 8);
+                drop = kFrameHeader + length;
+            }
+            if (drop > size)
+                drop = size;
+            head = (head + drop) % capacity_;
+            size -= drop;
+        }
+        header.wrapped = 1;
+        header.head = static_cast<uint32_t>(size ? head : 0);
+        header.size = static_cast<uint32_t>(size);
+    }
+
+    // Writes behind the stored bytes, skip bytes past the current end.
+    void copyIn(const uint8_t *data, size_t length, size_t skip)
+    {
+        const size_t tail = (header_->head + header_->size + skip) % capacity_;
+        const size_t first = capacity_ - tail < length ? capacity_ - tail : length;
+        std::memcpy(data_ + tail, data, first);
+        std::memcpy(data_, data + first, length - first);
+    }
+
+    Header *header_ = nullptr;
+    uint8_t *data_ = nullptr;
+    size_t capacity_ = 0;
+};
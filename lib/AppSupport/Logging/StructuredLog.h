@@ -0,0 +1,113 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include "Logging/LogRecord.h"
+
+// Highest level compiled in: 0 none, 1 error, 2 warn, 3 info, 4 debug.
+// Calls above it vanish at compile time, arguments included.
+#ifndef BRIDGE_LOG_LEVEL
+#define BRIDGE_LOG_LEVEL 3
+#endif
+
+// Level the runtime filter starts at; the console's log command moves it
+// up to BRIDGE_LOG_LEVEL.
+#ifndef BRIDGE_LOG_DEFAULT_LEVEL
+#define BRIDGE_LOG_DEFAULT_LEVEL (BRIDGE_LOG_LEVEL < 3 ? BRIDGE_LOG_LEVEL : 3)
+#endif
+
+// Receives encoded records instead of text; DebugLogStream implements it.
+class LogRecordSink
+{
+public:
+    virtual void writeRecord(const uint8_t *record, size_t length) = 0;
+
+protected:
+    ~LogRecordSink() = default;
+};
+
+// Structured logging for code that holds a Print &. Calls aimed at the
+// attached Print are encoded with LogRecord and handed to its sink without
+// formatting; any other Print (tests, a plain Serial) gets the formatted
+// line right away.
+//
+//   BRIDGE_LOGW(log_, "MQTT", "queue full; %lu dropped", dropped);
+//
+// tag and format must be string literals: records keep only their address.
+namespace StructuredLog
+{
+namespace detail
+{
+struct State
+{
+    Print *target = nullptr;
+    LogRecordSink *sink = nullptr;
+    LogLevel level = static_cast<LogLevel>(BRIDGE_LOG_DEFAULT_LEVEL);
+};
+
+inline State &state()
+{
+    static State instance;
+    return instance;
+}
+} // namespace detail
+
+inline void attach(Print &target, LogRecordSink &sink)
+{
+    detail::state().target = &target;
+    detail::state().sink = &sink;
+}
+
+inline void detach(LogRecordSink &sink)
+{
+    if (detail::state().sink != &sink)
+        return;
+    detail::state().target = nullptr;
+    detail::state().sink = nullptr;
+}
+
+// Runtime filter below the compile-time one.
+inline void setLevel(LogLevel level) { detail::state().level = level; }
+inline LogLevel level() { return detail::state().level; }
+
+inline bool enabled(LogLevel level)
+{
+    return level != LogLevel::None && static_cast<uint8_t>(level) <= static_cast<uint8_t>(detail::state().level);
+}
+
+template <typename... Args>
+void write(Print &out, LogLevel level, const char *tag, const char *format, const Args &...args)
+{
+    if (!enabled(level))
+        return;
+    uint8_t record[LogRecord::kMaxRecordBytes];
+    const size_t length = LogRecord::encode(record, sizeof(record), level, tag, format, args...);
+    detail::State &current = detail::state();
+    if (current.sink && &out == current.target)
+    {
+        current.sink->writeRecord(record, length);
+        return;
+    }
+    char text[LogRecord::kMaxTextBytes];
+    const size_t textLength = LogRecord::format(record, length, text, sizeof(text));
+    out.write(reinterpret_cast<const uint8_t *>(text), textLength);
+    out.println();
+}
+} // namespace StructuredLog
+
+#define BRIDGE_LOG(out, level, tag, ...)                                            \
+    do                                                                              \
+    {                                                                               \
+        if (static_cast<int>(level) <= BRIDGE_LOG_LEVEL)                            \
+            StructuredLog::write((out), (level), (tag), __VA_ARGS__);               \
+    } while (0)
+
+#define BRIDGE_LOGE(out, tag, ...) BRIDGE_LOG(out, LogLevel::Error, tag, __VA_ARGS__)
+#define BRIDGE_LOGW(out, tag, ...) BRIDGE_LOG(out, LogLevel::Warn, tag, __VA_ARGS__)
+#define BRIDGE_LOGI(out, tag, ...) BRIDGE_LOG(out, LogLevel::Info, tag, __VA_ARGS__)
+#define BRIDGE_LOGD(out, tag, ...) BRIDGE_LOG(out, LogLevel::Debug, tag, __VA_ARGS__)
@@ -0,0 +1,77 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <Client.h>
+#include "Mqtt/MqttQos1.h"
+
+// Pass-through Client that PubSubClient talks to. Every byte PubSubClient
+// reads also goes through an InboundFramer so PUBACKs for our own QoS 1
+// publishes can be matched even though PubSubClient drops them.
+class MqttAckTapClient : public Client
+{
+public:
+    explicit MqttAckTapClient(Client &inner) : inner_(&inner) {}
+
+    // Switches between the plain and the TLS client; only while disconnected.
+    void setInner(Client &inner)
+    {
+        inner_ = &inner;
+        framer_.reset();
+    }
+
+    int connect(IPAddress ip, uint16_t port) override
+    {
+        framer_.reset();
+        return inner_->connect(ip, port);
+    }
+
+    int connect(const char *host, uint16_t port) override
+    {
+        framer_.reset();
+        return inner_->connect(host, port);
+    }
+
+    size_t write(uint8_t value) override { return inner_->write(value); }
+    size_t write(const uint8_t *buffer, size_t size) override { return inner_->write(buffer, size); }
+    int available() override { return inner_->available(); }
+
+    int read() override
+    {
+        int value = inner_->read();
+        if (value >= 0)
+            framer_.feed(static_cast<uint8_t>(value));
+        return value;
+    }
+
+    int read(uint8_t *buffer, size_t size) override
+    {
+        int count = inner_->read(buffer, size);
+        if (count > 0)
+            framer_.feed(buffer, static_cast<size_t>(count));
+        return count;
+    }
+
+    int peek() override { return inner_->peek(); }
+    void flush() override { inner_->flush(); }
+
+    void stop() override
+    {
+        inner_->stop();
+        framer_.reset();
+    }
+
+    uint8_t connected() override { return inner_->connected(); }
+    operator bool() override { return static_cast<bool>(*inner_); }
+
+    bool takeAck(uint16_t &packetId) { return framer_.takeAck(packetId); }
+
+private:
+    Client *inner_;
+    MqttQos1::InboundFramer framer_;
+};
@@ -0,0 +1,187 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+// One poll cycle as a fixed 32-byte little-endian record for machine
+// ingestion, published next to the text topics:
+//
+//   offset  type  content
+//    0      u8    version (kVersion)
+//    1      u8    field mask, bit n set when Field n is present
+//    2      u8    flags, bit 0 = device power on
+//    3      u8    reserved, 0
+//    4      u32   sequence number, 1 for the first frame after boot
+//    8      u32   sample time in Unix seconds, 0 while the clock is unset
+//   12      f32   tube rate (cpm)
+//   16      f32   dose rate (µSv/h)
+//   20      u32   tube pulse count
+//   24      f32   battery voltage (V)
+//   28      f32   battery percent
+//
+// Absent values are encoded as 0 with their mask bit clear. Later versions
+// may only append fields, so readers can accept any frame of at least
+// kFrameBytes with a version they know.
+class MqttBinaryFrame
+{
+public:
+    static constexpr uint8_t kVersion = 1;
+    static constexpr size_t kFrameBytes = 32;
+
+    enum Field : uint8_t
+    {
+        TubeRate = 0,
+        TubeDoseRate,
+        TubePulseCount,
+        BatteryVoltage,
+        BatteryPercent,
+        DevicePower,
+        kFieldCount,
+    };
+
+    struct Decoded
+    {
+        uint8_t version = 0;
+        uint8_t mask = 0;
+        bool powerOn = false;
+        uint32_t sequence = 0;
+        uint32_t timestamp = 0;
+        float tubeRate = 0;
+        float doseRate = 0;
+        uint32_t pulseCount = 0;
+        float batteryVoltage = 0;
+        float batteryPercent = 0;
+    };
+
+    bool has(Field field) const { return (mask_ & bit(field)) != 0; }
+    bool empty() const { return mask_ == 0; }
+
+    void clear()
+    {
+        mask_ = 0;
+        powerOn_ = false;
+        timestamp_ = 0;
+    }
+
+    void setTimestamp(uint32_t timestamp) { timestamp_ = timestamp; }
+
+    // Parses the device's text value into the slot; returns false and leaves
+    // the field absent if it is not a finite number.
+    bool set(Field field, const char *text)
+    {
+        if (field >= kFieldCount || !text || !*text)
+            return false;
+        char *end = nullptr;
+        if (field == DevicePower)
+        {
+            unsigned long power = std::strtoul(text, &end, 10);
+            if (end == text || *end || power > 1)
+                return false;
+            powerOn_ = power == 1;
+        }
+        else if (field == TubePulseCount)
+        {
+            if (*text == '-')
+                return false;
+            unsigned long count = std::strtoul(text, &end, 10);
+            if (end == text || *end || count > UINT32_MAX)
+                return false;
+            pulseCount_ = static_cast<uint32_t>(count);
+        }
+        else
+        {
+            double value = std::strtod(text, &end);
+            if (end == text || *end || !std::isfinite(value))
+                return false;
+            values_[field] = static_cast<float>(value);
+        }
+        mask_ |= bit(field);
+        return true;
+    }
+
+    // Returns kFrameBytes, or 0 if out is too small.
+    size_t encode(uint8_t *out, size_t capacity, uint32_t sequence) const
+    {
+        if (!out || capacity < kFrameBytes)
+            return 0;
+        out[0] = kVersion;
+        out[1] = mask_;
+        out[2] = (has(DevicePower) && powerOn_) ? 0x01 : 0x00;
+        out[3] = 0;
+        putU32(out + 4, sequence);
+        putU32(out + 8, timestamp_);
+        putF32(out + 12, has(TubeRate) ? values_[TubeRate] : 0.0f);
+        putF32(out + 16, has(TubeDoseRate) ? values_[TubeDoseRate] : 0.0f);
+        putU32(out + 20, has(TubePulseCount) ? pulseCount_ : 0);
+        putF32(out + 24, has(BatteryVoltage) ? values_[BatteryVoltage] : 0.0f);
+        putF32(out + 28, has(BatteryPercent) ? values_[BatteryPercent] : 0.0f);
+        return kFrameBytes;
+    }
+
+    // Reference decoder for the layout above.
+    static bool decode(const uint8_t *in, size_t length, Decoded &out)
+    {
+        out = Decoded();
+        if (!in || length < kFrameBytes || in[0] != kVersion)
+            return false;
+        out.version = in[0];
+        out.mask = in[1];
+        out.powerOn = (in[2] & 0x01) != 0;
+        out.sequence = getU32(in + 4);
+        out.timestamp = getU32(in + 8);
+        out.tubeRate = getF32(in + 12);
+        out.doseRate = getF32(in + 16);
+        out.pulseCount = getU32(in + 20);
+        out.batteryVoltage = getF32(in + 24);
+        out.batteryPercent = getF32(in + 28);
+        return true;
+    }
+
+private:
+    static uint8_t bit(Field field) { return static_cast<uint8_t>(1u << field); }
+
+    static void putU32(uint8_t *out, uint32_t value)
+    {
+        out[0] = static_cast<uint8_t>(value);
+        out[1] = static_cast<uint8_t>(value >> 8);
+        out[2] = static_cast<uint8_t>(value >> 16);
+        out[3] = static_cast<uint8_t>(value >> 24);
+    }
+
+    static void putF32(uint8_t *out, float value)
+    {
+        uint32_t raw;
+        static_assert(sizeof(raw) == sizeof(value), "IEEE 754 binary32 expected");
+        std::memcpy(&raw, &value, sizeof(raw));
+        putU32(out, raw);
+    }
+
+    static uint32_t getU32(const uint8_t *in)
+    {
+        return static_cast<uint32_t>(in[0]) | (static_cast<uint32_t>(in[1]) << 8) |
+               (static_cast<uint32_t>(in[2]) << 16) | (static_cast<uint32_t>(in[3]) << 24);
+    }
+
+    static float getF32(const uint8_t *in)
+    {
+        uint32_t raw = getU32(in);
+        float value;
+        std::memcpy(&value, &raw, sizeof(value));
+        return value;
+    }
+
+    float values_[kFieldCount] = {};
+    uint32_t pulseCount_ = 0;
+    uint32_t timestamp_ = 0;
+    uint8_t mask_ = 0;
+    bool powerOn_ = false;
+};
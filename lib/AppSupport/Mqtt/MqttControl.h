@@ -0,0 +1,148 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+// A request received on the cmnd/<topic>/<command> tree. The command is the
+// topic leaf, its argument the payload as plain text:
+//   interval    "<ms> [<seconds>]", "default" or "0"
+//   datalog     optional RadPro datalog arguments (digits and spaces)
+//   randomdata  ignored
+//   poll        ignored
+//   republish   ignored
+struct MqttControlRequest
+{
+    enum class Kind : uint8_t
+    {
+        Interval,
+        DataLog,
+        RandomData,
+        Poll,
+        Republish,
+    };
+
+    static constexpr size_t kMaxArgsLength = 32;
+    static constexpr size_t kMaxPayloadLength = 64;
+
+    Kind kind = Kind::Poll;
+    // 0 returns to the configured read interval.
+    uint32_t intervalMs = 0;
+    // 0 keeps the override until it is reset or the bridge restarts.
+    uint32_t durationSeconds = 0;
+    char args[kMaxArgsLength + 1] = {};
+
+    static const char *name(Kind kind)
+    {
+        switch (kind)
+        {
+        case Kind::Interval:
+            return "interval";
+        case Kind::DataLog:
+            return "datalog";
+        case Kind::RandomData:
+            return "randomdata";
+        case Kind::Poll:
+            return "poll";
+        case Kind::Republish:
+            return "republish";
+        }
+        return "";
+    }
+
+    // Returns nullptr on success, otherwise a short error for the response.
+    static const char *parse(const char *command,
+                             const uint8_t *payload,
+                             size_t length,
+                             uint32_t minIntervalMs,
+                             MqttControlRequest &out)
+    {
+        out = MqttControlRequest();
+        if (!command)
+            return "unknown command";
+        if (length > kMaxPayloadLength)
+            return "payload too long";
+
+        char text[kMaxPayloadLength + 1];
+        if (length)
+            std::memcpy(text, payload, length);
+        text[length] = '\0';
+        const char *arg = trim(text);
+
+        if (std::strcmp(command, "interval") == 0)
+        {
+            out.kind = Kind::Interval;
+            if (!*arg || std::strcmp(arg, "default") == 0)
+                return nullptr;
+            char *end = nullptr;
+            unsigned long interval = std::strtoul(arg, &end, 10);
+            if (end == arg || (*end && *end != ' '))
+                return "expected <ms> [<seconds>]";
+            unsigned long duration = 0;
+            const char *rest = trim(end);
+            if (*rest)
+            {
+                duration = std::strtoul(rest, &end, 10);
+                if (end == rest || *trim(end))
+                    return "expected <ms> [<seconds>]";
+            }
+            if (interval && interval < minIntervalMs)
+                return "interval below minimum";
+            if (interval > UINT32_MAX || duration > UINT32_MAX / 1000UL)
+                return "value out of range";
+            out.intervalMs = static_cast<uint32_t>(interval);
+            out.durationSeconds = static_cast<uint32_t>(duration);
+            return nullptr;
+        }
+        if (std::strcmp(command, "datalog") == 0)
+        {
+            out.kind = Kind::DataLog;
+            // The arguments end up in a device command line; keep them inert.
+            size_t argLength = std::strlen(arg);
+            if (argLength > kMaxArgsLength)
+                return "arguments too long";
+            for (size_t i = 0; i < argLength; ++i)
+            {
+                if ((arg[i] < '0' || arg[i] > '9') && arg[i] != ' ')
+                    return "arguments must be digits";
+            }
+            std::memcpy(out.args, arg, argLength + 1);
+            return nullptr;
+        }
+        if (std::strcmp(command, "randomdata") == 0)
+        {
+            out.kind = Kind::RandomData;
+            return nullptr;
+        }
+        if (std::strcmp(command, "poll") == 0)
+        {
+            out.kind = Kind::Poll;
+            return nullptr;
+        }
+        if (std::strcmp(command, "republish") == 0)
+        {
+            out.kind = Kind::Republish;
+            return nullptr;
+        }
+        return "unknown command";
+    }
+
+private:
+    static char *trim(char *text)
+    {
+        while (*text == ' ' || *text == '\t' || *text == '\r' || *text == '\n')
+            ++text;
+        size_t length = std::strlen(text);
+        while (length && (text[length - 1] == ' ' || text[length - 1] == '\t' ||
+                          text[length - 1] == '\r' || text[length - 1] == '\n'))
+            text[--length] = '\0';
+        return text;
+    }
+};
@@ -0,0 +1,92 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// FIFO of outbound MQTT messages held in one fixed block of RAM. A message is
+// stored as its topic slot (resolved to a topic string when it is sent), the
+// retain flag and the payload bytes. MqttPublisher pops the head into its
+// encoded in-flight packet and keeps that copy until the broker sends PUBACK.
+class MqttOutboundQueue
+{
+public:
+    static constexpr size_t kCapacityBytes = 4096;
+    static constexpr size_t kMaxEntries = 96;
+    static constexpr size_t kMaxPayloadBytes = 512;
+
+    struct Entry
+    {
+        uint8_t slot = 0;
+        bool retain = false;
+        const char *payload = nullptr;
+        size_t length = 0;
+    };
+
+    bool fits(size_t length) const
+    {
+        return count_ < kMaxEntries && kCapacityBytes - used_ >= length;
+    }
+
+    bool push(uint8_t slot, const char *payload, size_t length, bool retain)
+    {
+        if (!payload || length > kMaxPayloadBytes || !fits(length))
+            return false;
+        const size_t index = (head_ + count_) % kMaxEntries;
+        slots_[index] = slot;
+        retain_[index] = retain;
+        lengths_[index] = static_cast<uint16_t>(length);
+        std::memcpy(data_ + used_, payload, length);
+        used_ += length;
+        ++count_;
+        return true;
+    }
+
+    bool front(Entry &entry) const
+    {
+        if (!count_)
+            return false;
+        entry.slot = slots_[head_];
+        entry.retain = retain_[head_];
+        entry.payload = data_;
+        entry.length = lengths_[head_];
+        return true;
+    }
+
+    void pop()
+    {
+        if (!count_)
+            return;
+        const size_t length = lengths_[head_];
+        std::memmove(data_, data_ + length, used_ - length);
+        used_ -= length;
+        head_ = (head_ + 1) % kMaxEntries;
+        --count_;
+    }
+
+    void clear()
+    {
+        used_ = 0;
+        head_ = 0;
+        count_ = 0;
+    }
+
+    size_t size() const { return count_; }
+    size_t bytes() const { return used_; }
+    bool empty() const { return count_ == 0; }
+
+private:
+    char data_[kCapacityBytes];
+    uint16_t lengths_[kMaxEntries] = {};
+    uint8_t slots_[kMaxEntries] = {};
+    bool retain_[kMaxEntries] = {};
+    size_t used_ = 0;
+    size_t head_ = 0;
+    size_t count_ = 0;
+};
@@ -6,16 +6,53 @@
 #include <ArduinoJson.h>
 #include "ConfigPortal/PortalSecurity.h"
 #include "ConfigPortal/WiFiPortalService.h"
+#include "Logging/StructuredLog.h"
 #include "Mqtt/MqttFaultPolicy.h"
+#include "Mqtt/MqttQos1.h"
 #include <WebServer.h>
+#include <time.h>
 
 namespace
 {
+    constexpr time_t kMinValidEpoch = 1704067200; // 2024-01-01
+    constexpr const char *kStateLeaf = "state";
+    constexpr const char *kBinaryLeaf = "binary";
+    constexpr unsigned long kAckTimeoutMs = 10000;
+    constexpr unsigned long kDropLogIntervalMs = 10000;
+
     JsonDocument &getDiscoveryDoc()
     {
         static JsonDocument doc;
         return doc;
     }
+
+    struct DiscoveryEntry
+    {
+        DeviceManager::CommandType type;
+        const char *component;
+        const char *objectId;
+        const char *name;
+        const char *unit;
+        const char *deviceClass;
+        const char *stateClass;
+        const char *payloadOn;
+        const char *payloadOff;
+        const char *icon;
+    };
+
+    const DiscoveryEntry kEntities[] = {
+        {DeviceManager::CommandType::DevicePower, "binary_sensor", "power", "Power", nullptr, "power", nullptr, "ON", "OFF", "mdi:power-plug"},
+        {DeviceManager::CommandType::DeviceBatteryVoltage, "sensor", "battery_voltage", "Battery Voltage", "V", "voltage", "measurement", nullptr, nullptr, "mdi:flash"},
+        {DeviceManager::CommandType::DeviceBatteryPercent, "sensor", "battery", "Battery", "%", "battery", "measurement", nullptr, nullptr, "mdi:battery"},
+        {DeviceManager::CommandType::TubeRate, "sensor", "tube_rate", "Tube Rate", "cpm", nullptr, "measurement", nullptr, nullptr, "mdi:chart-line"},
+        {DeviceManager::CommandType::TubeDoseRate, "sensor", "tube_dose_rate", "Dose Rate", "µSv/h", nullptr, "measurement", nullptr, nullptr, "mdi:radioactive"},
+        {DeviceManager::CommandType::TubePulseCount, "sensor", "tube_pulse_count", "Tube Pulse Count", nullptr, nullptr, "total_increasing", nullptr, nullptr, "mdi:pulse"},
+        {DeviceManager::CommandType::DeviceSensitivity, "sensor", "tube_sensitivity", "Tube Sensitivity", "cpm/µSv/h", nullptr, nullptr, nullptr, nullptr, "mdi:tune-vertical"},
+        {DeviceManager::CommandType::TubeDeadTime, "sensor", "tube_dead_time", "Tube Dead Time", "s", nullptr, nullptr, nullptr, nullptr, "mdi:timer-outline"},
+        {DeviceManager::CommandType::TubeHVFrequency, "sensor", "tube_hv_frequency", "Tube HV Frequency", "Hz", "frequency", "measurement", nullptr, nullptr, "mdi:waveform"},
+        {DeviceManager::CommandType::TubeHVDutyCycle, "sensor", "tube_hv_duty_cycle", "Tube HV Duty Cycle", nullptr, nullptr, nullptr, nullptr, nullptr, "mdi:sine-wave"}};
+
+    constexpr size_t kEntityCount = sizeof(kEntities) / sizeof(kEntities[0]);
 }
 
 const std::array<DeviceManager::CommandType, 15> MqttPublisher::kRetainedTypes_ = {
@@ -37,11 +74,14 @@ const std::array<DeviceManager::CommandType, 15> MqttPublisher::kRetainedTypes_
 
 #include <ctype.h>
 
-MqttPublisher::MqttPublisher(AppConfig &config, Print &log, LedController &led)
+MqttPublisher::MqttPublisher(AppConfig &config, Print &log, LedController &led, PublisherHealth &health)
     : config_(config),
       log_(log),
-      mqtt_client_(wifi_client_),
-      led_(led)
+      ack_tap_(wifi_client_),
+      mqtt_client_(ack_tap_),
+      led_(led),
+      health_(health),
+      spool_(log)
 {
     uint64_t mac = ESP.getEfuseMac();
     char buf[17];
@@ -58,15 +98,25 @@ void MqttPublisher::begin()
 {
     // Discovery payloads can get fairly large; use a bigger MQTT buffer.
     mqtt_client_.setBufferSize(1024);
+    mqtt_client_.setCallback([this](char *topic, uint8_t *payload, unsigned int length)
+                             { onControlMessage(topic, payload, length); });
+    spool_.begin();
     updateConfig();
 }
 
 void MqttPublisher::updateConfig()
 {
+    health_.setEnabled(config_.mqttEnabled);
+
+    // The connect task owns the client; pick up changes once it is done.
+    if (connectRunning())
+        return;
+
     if (paused_)
     {
         if (mqtt_client_.connected())
             mqtt_client_.disconnect();
+        connectState_ = ConnectState::Idle;
         return;
     }
 
@@ -78,6 +128,7 @@ void MqttPublisher::updateConfig()
     {
         if (mqtt_client_.connected())
             mqtt_client_.disconnect();
+        connectState_ = ConnectState::Idle;
         led_.clearFault(FaultCode::MqttUnreachable);
         led_.clearFault(FaultCode::MqttAuthFailure);
         led_.clearFault(FaultCode::MqttConnectionReset);
@@ -100,7 +151,66 @@ void MqttPublisher::updateConfig()
     {
         currentDeviceName_ = config_.deviceName;
         discoveryPublished_ = false;
+        deviceDiscoveryDirty_ = true;
+        versionDiscoveryDone_ = false;
+    }
+
+    if (deviceDiscovery_ != config_.mqttDeviceDiscovery)
+    {
+        deviceDiscovery_ = config_.mqttDeviceDiscovery;
+        discoveryPublished_ = false;
+        deviceDiscoveryDirty_ = true;
         versionDiscoveryDone_ = false;
+        discoveryIndex_ = 0;
+        lastDiscoveryAttempt_ = 0;
+    }
+
+    if (deadbandEnabled_ != config_.mqttDeadbandEnabled ||
+        heartbeatSeconds_ != config_.mqttHeartbeatSeconds ||
+        rateDeadbandText_ != config_.mqttRateDeadband ||
+        countDeadbandText_ != config_.mqttCountDeadband ||
+        batteryDeadbandText_ != config_.mqttBatteryDeadband)
+    {
+        applyDeadbandConfig();
+    }
+
+    if (controlEnabled_ != config_.mqttControlEnabled)
+    {
+        controlEnabled_ = config_.mqttControlEnabled;
+        controlPending_ = false;
+    }
+
+    if (queueMode_ != config_.mqttQueueEnabled)
+    {
+        // Leaving QoS 1 mode drops the RAM queue; a spool file stays on flash
+        // and is replayed the next time the queue is enabled.
+        queueMode_ = config_.mqttQueueEnabled;
+        queue_.clear();
+        if (inflightLength_ && inflightFromSpool_)
+            spool_.rewind();
+        inflightLength_ = 0;
+        inflightSent_ = false;
+    }
+
+    if (aggregateMode_ != config_.mqttAggregateState)
+    {
+        // Entities switch between leaf topics and the state topic.
+        aggregateMode_ = config_.mqttAggregateState;
+        aggregate_.clear();
+        aggregateChanged_ = false;
+        aggregatePending_ = false;
+        aggregatePayloadLength_ = 0;
+        discoveryPublished_ = false;
+        deviceDiscoveryDirty_ = true;
+        discoveryIndex_ = 0;
+        lastDiscoveryAttempt_ = 0;
+    }
+
+    if (binaryMode_ != config_.mqttBinaryState)
+    {
+        binaryMode_ = config_.mqttBinaryState;
+        binaryFrame_.clear();
+        binaryChanged_ = false;
     }
 
     if (host == currentHost_ && port == currentPort_ &&
@@ -108,7 +218,10 @@ void MqttPublisher::updateConfig()
         config_.mqttPassword == currentPassword_ &&
         config_.mqttClient == clientIdBase_ &&
         config_.mqttTopic == topicTemplate_ &&
-        config_.mqttFullTopic == fullTopicTemplate_)
+        config_.mqttFullTopic == fullTopicTemplate_ &&
+        config_.mqttTlsEnabled == currentTls_ &&
+        config_.mqttTlsCaCert == currentTlsCa_ &&
+        config_.mqttTlsFingerprint == currentTlsFingerprint_)
     {
         return;
     }
@@ -120,9 +233,16 @@ void MqttPublisher::updateConfig()
     clientIdBase_ = config_.mqttClient;
     topicTemplate_ = config_.mqttTopic;
     fullTopicTemplate_ = config_.mqttFullTopic;
+    bool tlsChanged = currentTls_ != config_.mqttTlsEnabled ||
+                      currentTlsCa_ != config_.mqttTlsCaCert ||
+                      currentTlsFingerprint_ != config_.mqttTlsFingerprint;
+    currentTls_ = config_.mqttTlsEnabled;
+    currentTlsCa_ = config_.mqttTlsCaCert;
+    currentTlsFingerprint_ = config_.mqttTlsFingerprint;
 
     topicDirty_ = true;
     discoveryPublished_ = false;
+    deviceDiscoveryDirty_ = true;
     versionDiscoveryDone_ = false;
     bridgeVersionDirty_ = true;
     lastDiscoveryAttempt_ = 0;
@@ -134,7 +254,8 @@ void MqttPublisher::updateConfig()
         log_.print("MQTT config updated: host=");
         log_.print(currentHost_);
         log_.print(" port=");
-        log_.println(currentPort_);
+        log_.print(currentPort_);
+        log_.println(currentTls_ ? " tls=on" : "");
     }
     else
     {
@@ -145,6 +266,14 @@ void MqttPublisher::updateConfig()
     {
         mqtt_client_.disconnect();
     }
+    connectState_ = ConnectState::Idle;
+
+    if (tlsChanged)
+    {
+        if (currentTls_ && !tls_client_.setTrustAnchors(currentTlsCa_, currentTlsFingerprint_))
+            log_.println("MQTT TLS fingerprint invalid; expected 64 hex digits.");
+        ack_tap_.setInner(currentTls_ ? static_cast<Client &>(tls_client_) : static_cast<Client &>(wifi_client_));
+    }
 
     if (currentHost_.length())
     {
@@ -162,7 +291,8 @@ void MqttPublisher::loop()
 {
     if (paused_)
     {
-        if (mqtt_client_.connected())
+        discardFinishedConnect();
+        if (clientReady())
             mqtt_client_.disconnect();
         return;
     }
@@ -173,16 +303,34 @@ void MqttPublisher::loop()
     if (!configValid_)
         return;
 
-    if (!mqtt_client_.connected())
+    // A cycle whose last result never arrived is sent as it is.
+    if (!aggregate_.empty())
+    {
+        unsigned long staleMs = config_.readIntervalMs * 2UL;
+        if (millis() - aggregateStartedMs_ >= staleMs)
+            flushAggregate();
+    }
+    if (!binaryFrame_.empty())
+    {
+        unsigned long staleMs = config_.readIntervalMs * 2UL;
+        if (millis() - binaryStartedMs_ >= staleMs)
+            flushBinary();
+    }
+
+    if (!clientReady())
     {
         ensureConnected();
     }
 
-    if (mqtt_client_.connected())
+    if (clientReady())
     {
         mqtt_client_.loop();
+        syncControlSubscription();
+        handleControl();
         publishDiscovery();
         republishRetained();
+        if (queueMode_)
+            serviceQueue();
     }
 }
 
@@ -191,9 +339,8 @@ void MqttPublisher::onCommandResult(DeviceManager::CommandType type, const Strin
     if (paused_)
         return;
 
-    if (!config_.mqttEnabled)
-        return;
-
+    // Identity arrives even while MQTT is disabled, so enabling it later
+    // still publishes under the right device.
     switch (type)
     {
     case DeviceManager::CommandType::DeviceModel:
@@ -201,6 +348,7 @@ void MqttPublisher::onCommandResult(DeviceManager::CommandType type, const Strin
         {
             deviceModel_ = value;
             discoveryPublished_ = false;
+            deviceDiscoveryDirty_ = true;
         }
         return;
     case DeviceManager::CommandType::DeviceFirmware:
@@ -208,6 +356,7 @@ void MqttPublisher::onCommandResult(DeviceManager::CommandType type, const Strin
         {
             deviceFirmware_ = value;
             discoveryPublished_ = false;
+            deviceDiscoveryDirty_ = true;
         }
         return;
     case DeviceManager::CommandType::DeviceLocale:
@@ -225,12 +374,36 @@ void MqttPublisher::onCommandResult(DeviceManager::CommandType type, const Strin
         deviceSlug_ = makeSlug(value);
         topicDirty_ = true;
         discoveryPublished_ = false;
+        deviceDiscoveryDirty_ = true;
         markAllPending();
         discoveryIndex_ = 0;
-        publishCommand(type, value, true);
+        resetDeadbandFilters();
+        if (config_.mqttEnabled)
+            publishCommand(type, value, true);
         return;
     }
 
+    if (!config_.mqttEnabled)
+        return;
+
+    bool changed = !deadbandEnabled_ || passesDeadband(type, value);
+
+    if (binaryMode_)
+        collectBinary(type, value, changed);
+
+    if (aggregateMode_)
+    {
+        const char *leaf = aggregatedLeaf(type);
+        if (leaf)
+        {
+            collectAggregate(type, leaf, value, changed);
+            return;
+        }
+    }
+
+    if (!changed)
+        return;
+
     if (type == DeviceManager::CommandType::DevicePower)
     {
         String payload = (value == "1" ? "ON" : (value == "0" ? "OFF" : value));
@@ -250,13 +423,28 @@ void MqttPublisher::onCommandResult(DeviceManager::CommandType type, const Strin
     publishCommand(type, value, retain);
 }
 
-void MqttPublisher::pause(bool paused)
+void MqttPublisher::setPaused(bool paused)
 {
     paused_ = paused;
-    if (paused_ && mqtt_client_.connected())
-    {
+    health_.setPaused(paused);
+    if (!paused_)
+        return;
+    // An attempt still running is discarded by loop() once it finishes.
+    discardFinishedConnect();
+    if (clientReady())
         mqtt_client_.disconnect();
-    }
+}
+
+bool MqttPublisher::clientReady()
+{
+    return !connectRunning() && mqtt_client_.connected();
+}
+
+void MqttPublisher::discardFinishedConnect()
+{
+    const ConnectState state = connectState_.load();
+    if (state == ConnectState::Succeeded || state == ConnectState::Failed)
+        connectState_ = ConnectState::Idle;
 }
 
 bool MqttPublisher::ensureConnected()
@@ -264,6 +452,14 @@ bool MqttPublisher::ensureConnected()
     if (!configValid_ || currentHost_.isEmpty())
         return false;
 
+    // Never block the caller: DNS, TCP connect and CONNACK run on a short-lived
+    // task and the result is picked up here on a later loop pass.
+    if (connectRunning())
+        return false;
+
+    if (connectState_.load() != ConnectState::Idle)
+        return finishConnect();
+
     if (mqtt_client_.connected())
     {
         led_.clearFault(FaultCode::MqttUnreachable);
@@ -276,11 +472,16 @@ bool MqttPublisher::ensureConnected()
         return false;
 
     unsigned long now = millis();
-    if (now - lastReconnectAttempt_ < 5000)
+    if (lastReconnectAttempt_ != 0 && now - lastReconnectAttempt_ < 5000)
         return false;
 
     lastReconnectAttempt_ = now;
+    startConnect();
+    return false;
+}
 
+void MqttPublisher::startConnect()
+{
     String clientId = clientIdBase_.length() ? clientIdBase_ : String("radpro-bridge");
     String slug = sanitizedDeviceId();
     if (slug.length())
@@ -291,22 +492,85 @@ bool MqttPublisher::ensureConnected()
             clientId += slug;
         }
     }
+    connectClientId_ = clientId;
+    connectState_ = ConnectState::Connecting;
+    connectStartedMs_ = millis();
+    health_.noteAttempt(connectStartedMs_);
+
+    // The mbedTLS handshake needs a considerably deeper stack.
+    BaseType_t created = xTaskCreatePinnedToCore(&MqttPublisher::connectTaskThunk,
+                                                 "mqttConnect",
+                                                 currentTls_ ? 8192 : 4096,
+                                                 this,
+                                                 1,
+                                                 nullptr,
+                                                 1);
+    if (created != pdPASS)
+    {
+        connectState_ = ConnectState::Idle;
+        log_.println("MQTT connect task start failed.");
+    }
+}
 
+void MqttPublisher::connectTaskThunk(void *param)
+{
+    MqttPublisher *publisher = static_cast<MqttPublisher *>(param);
+    publisher->runConnect();
+    vTaskDelete(nullptr);
+}
+
+void MqttPublisher::runConnect()
+{
+    // Only the fields below are touched here; the main loop leaves the client
+    // and the connection settings alone while connectState_ is Connecting.
+    // Storing the result is the task's last access to the publisher.
     bool connected = false;
     if (currentUser_.length())
     {
-        connected = mqtt_client_.connect(clientId.c_str(), currentUser_.c_str(), currentPassword_.c_str());
+        connected = mqtt_client_.connect(connectClientId_.c_str(), currentUser_.c_str(), currentPassword_.c_str());
     }
     else
     {
-        connected = mqtt_client_.connect(clientId.c_str());
+        connected = mqtt_client_.connect(connectClientId_.c_str());
+    }
+
+    connectResult_ = mqtt_client_.state();
+    connectState_ = connected ? ConnectState::Succeeded : ConnectState::Failed;
+}
+
+bool MqttPublisher::finishConnect()
+{
+    bool connected = connectState_.load() == ConnectState::Succeeded;
+    int state = connectResult_.load();
+    connectState_ = ConnectState::Idle;
+    if (connected && !mqtt_client_.connected())
+    {
+        // Dropped between CONNACK and this pass; retry without announcing.
+        connected = false;
+        state = mqtt_client_.state();
     }
+    // Back off from the end of a slow attempt, not from its start.
+    lastReconnectAttempt_ = millis();
 
-    int state = mqtt_client_.state();
+    unsigned long now = millis();
+    health_.notePhase(PublishPhase::Total, now - connectStartedMs_);
+    String statusLine;
+    if (currentTls_)
+    {
+        health_.notePhase(PublishPhase::Connect, tls_client_.lastConnectMs());
+        if (tls_client_.lastHandshakeMs())
+        {
+            health_.notePhase(PublishPhase::TlsHandshake, tls_client_.lastHandshakeMs());
+            statusLine = tls_client_.lastResumed() ? "TLS session resumed" : "TLS full handshake";
+            BRIDGE_LOGI(log_, "MQTT", "%s in %lu ms.", statusLine, tls_client_.lastHandshakeMs());
+        }
+    }
 
     if (connected)
     {
+        health_.noteSuccess(now, state, statusLine);
         log_.println("MQTT connected.");
+        subscribedFilter_ = String();
         discoveryPublished_ = false;
         lastDiscoveryAttempt_ = 0;
         markAllPending();
@@ -314,14 +578,26 @@ bool MqttPublisher::ensureConnected()
         bridgeVersionDirty_ = true;
         republishRetained();
         discoveryIndex_ = 0;
+        if (inflightLength_ && inflightSent_)
+        {
+            // Clean session: the broker forgot it, so send it again as DUP.
+            inflightSent_ = false;
+            inflightPacket_[0] |= MqttQos1::kFlagDup;
+        }
         led_.clearFault(FaultCode::MqttUnreachable);
         led_.clearFault(FaultCode::MqttAuthFailure);
         led_.clearFault(FaultCode::MqttConnectionReset);
     }
     else
     {
-        log_.print("MQTT connect failed: ");
-        log_.println(state);
+        String error = String("MQTT state ") + state;
+        if (currentTls_ && tls_client_.lastError()[0])
+        {
+            error += ", TLS ";
+            error += tls_client_.lastError();
+        }
+        health_.noteFailure(now, error, state, statusLine);
+        BRIDGE_LOGW(log_, "MQTT", "connect failed: %s", error);
         led_.clearFault(FaultCode::MqttUnreachable);
         led_.clearFault(FaultCode::MqttAuthFailure);
         led_.clearFault(FaultCode::MqttConnectionReset);
@@ -346,19 +622,43 @@ void MqttPublisher::refreshTopics()
     base.replace("%DeviceId%", slug);
     while (base.endsWith("/"))
         base.remove(base.length() - 1);
-    topicBase_ = base;
 
-    fullTopicPattern_ = fullTopicTemplate_.length() ? fullTopicTemplate_ : String("%prefix%/%topic%/");
-    if (!fullTopicPattern_.length())
-        fullTopicPattern_ = "%prefix%/%topic%/";
+    String full = fullTopicTemplate_.length() ? fullTopicTemplate_ : String("%prefix%/%topic%/");
+    full.replace("%topic%", base);
+    if (!full.endsWith("/"))
+        full += '/';
+    topicPrefix_ = full;
+    topicPrefix_.replace("%prefix%", "stat");
+    controlPrefix_ = full;
+    controlPrefix_.replace("%prefix%", "cmnd");
+    controlFilter_ = controlPrefix_ + '#';
+    controlResultTopic_ = topicPrefix_ + "result";
+
+    // Expanded once per template/device change so publishing never builds
+    // topic strings.
+    for (size_t i = 0; i < commandTopics_.size(); ++i)
+    {
+        const char *leaf = commandLeaf(static_cast<DeviceManager::CommandType>(i));
+        commandTopics_[i] = leaf ? topicPrefix_ + leaf : String();
+    }
+    stateTopic_ = topicPrefix_ + kStateLeaf;
+    binaryTopic_ = topicPrefix_ + kBinaryLeaf;
+    bridgeVersionTopic_ = topicPrefix_ + "bridgeVersion";
 
     topicDirty_ = false;
 }
 
+const String &MqttPublisher::commandTopic(DeviceManager::CommandType type)
+{
+    if (topicDirty_)
+        refreshTopics();
+    return commandTopics_[static_cast<size_t>(type)];
+}
+
 bool MqttPublisher::publishCommand(DeviceManager::CommandType type, const String &payload, bool retain)
 {
-    String leaf = commandLeaf(type);
-    if (!leaf.length())
+    const String &topic = commandTopic(type);
+    if (!topic.length())
         return false;
 
     RetainedState *entry = retain ? retainedEntry(type) : nullptr;
@@ -366,10 +666,13 @@ bool MqttPublisher::publishCommand(DeviceManager::CommandType type, const String
     {
         entry->payload = payload;
         entry->hasValue = true;
-        entry->pending = true;
+        entry->pending = !queueMode_;
     }
 
-    bool ok = publish(leaf, payload, retain);
+    if (queueMode_)
+        return enqueue(static_cast<uint8_t>(type), payload.c_str(), payload.length(), retain);
+
+    bool ok = publish(topic, payload.c_str(), retain);
     if (entry && ok)
         entry->pending = false;
     else if (entry && !ok)
@@ -377,23 +680,7 @@ bool MqttPublisher::publishCommand(DeviceManager::CommandType type, const String
     return ok;
 }
 
-String MqttPublisher::buildTopic(const String &leaf) const
-{
-    String pattern = fullTopicPattern_.length() ? fullTopicPattern_ : String("%prefix%/%topic%/");
-    String topic = topicBase_.length() ? topicBase_ : "radpro/" + sanitizedDeviceId();
-
-    String result = pattern;
-    result.replace("%prefix%", "stat");
-    result.replace("%topic%", topic);
-    if (!result.endsWith("/"))
-        result += '/';
-
-    String out = result;
-    out += leaf;
-    return out;
-}
-
-String MqttPublisher::commandLeaf(DeviceManager::CommandType type) const
+const char *MqttPublisher::commandLeaf(DeviceManager::CommandType type)
 {
     switch (type)
     {
@@ -402,7 +689,7 @@ String MqttPublisher::commandLeaf(DeviceManager::CommandType type) const
     case DeviceManager::CommandType::DeviceModel:
     case DeviceManager::CommandType::DeviceFirmware:
     case DeviceManager::CommandType::DeviceLocale:
-        return String();
+        return nullptr;
     case DeviceManager::CommandType::DevicePower:
         return "devicePower";
     case DeviceManager::CommandType::DeviceBatteryVoltage:
@@ -436,7 +723,7 @@ String MqttPublisher::commandLeaf(DeviceManager::CommandType type) const
     case DeviceManager::CommandType::DataLog:
         return "dataLog";
     default:
-        return String();
+        return nullptr;
     }
 }
 
@@ -475,7 +762,12 @@ String MqttPublisher::sanitizedDeviceId() const
     return fallbackId_;
 }
 
-bool MqttPublisher::publish(const String &leaf, const String &payload, bool retain)
+bool MqttPublisher::publish(const String &topic, const char *payload, bool retain)
+{
+    return publish(topic, reinterpret_cast<const uint8_t *>(payload), payload ? strlen(payload) : 0, retain);
+}
+
+bool MqttPublisher::publish(const String &topic, const uint8_t *payload, size_t length, bool retain)
 {
     if (!config_.mqttEnabled)
     {
@@ -484,7 +776,7 @@ bool MqttPublisher::publish(const String &leaf, const String &payload, bool reta
         return true;
     }
 
-    if (!leaf.length())
+    if (!topic.length())
     {
         if (publishCallback_)
             publishCallback_(false);
@@ -498,15 +790,12 @@ bool MqttPublisher::publish(const String &leaf, const String &payload, bool reta
         return false;
     }
 
-    if (topicDirty_)
-        refreshTopics();
-
     if (WiFi.status() != WL_CONNECTED)
     {
         unsigned long now = millis();
         if (now - lastPublishWarning_ > 5000)
         {
-            log_.println("MQTT publish skipped: Wi-Fi disconnected.");
+            BRIDGE_LOGW(log_, "MQTT", "publish skipped: Wi-Fi disconnected.");
             lastPublishWarning_ = now;
         }
         return false;
@@ -517,7 +806,7 @@ bool MqttPublisher::publish(const String &leaf, const String &payload, bool reta
         unsigned long now = millis();
         if (now - lastPublishWarning_ > 5000)
         {
-            log_.println("MQTT publish skipped: not connected.");
+            BRIDGE_LOGW(log_, "MQTT", "publish skipped: not connected.");
             lastPublishWarning_ = now;
         }
         if (publishCallback_)
@@ -525,21 +814,482 @@ bool MqttPublisher::publish(const String &leaf, const String &payload, bool reta
         return false;
     }
 
-    String topic = buildTopic(leaf);
-    bool ok = mqtt_client_.publish(topic.c_str(), payload.c_str(), retain);
+    bool ok = mqtt_client_.publish(topic.c_str(), payload, static_cast<unsigned int>(length), retain);
     if (publishCallback_)
         publishCallback_(ok);
     return ok;
 }
 
+const String &MqttPublisher::slotTopic(uint8_t slot)
+{
+    static const String kNoTopic;
+    if (topicDirty_)
+        refreshTopics();
+    if (slot == kStateSlot)
+        return stateTopic_;
+    if (slot == kBinarySlot)
+        return binaryTopic_;
+    if (slot < commandTopics_.size())
+        return commandTopics_[slot];
+    return kNoTopic;
+}
+
+bool MqttPublisher::enqueue(uint8_t slot, const char *payload, size_t length, bool retain)
+{
+    if (length > MqttOutboundQueue::kMaxPayloadBytes)
+    {
+        BRIDGE_LOGW(log_, "MQTT", "message of %u bytes too large for the queue; dropped.", length);
+        return false;
+    }
+
+    // Make room by moving the oldest messages to flash, or dropping them.
+    while (!queue_.fits(length) && !queue_.empty())
+    {
+        MqttOutboundQueue::Entry oldest;
+        queue_.front(oldest);
+        bool spooled = config_.mqttSpoolEnabled && !paused_ &&
+                       spool_.append(oldest.slot, oldest.payload, oldest.length, oldest.retain);
+        if (!spooled)
+            ++queueDropped_;
+        queue_.pop();
+    }
+
+    if (queueDropped_)
+    {
+        unsigned long now = millis();
+        if (lastDropLogMs_ == 0 || now - lastDropLogMs_ >= kDropLogIntervalMs)
+        {
+            BRIDGE_LOGW(log_, "MQTT", "queue full; messages dropped so far: %lu", queueDropped_);
+            lastDropLogMs_ = now;
+        }
+    }
+
+    return queue_.push(slot, payload, length, retain);
+}
+
+bool MqttPublisher::loadNextQueued()
+{
+    uint8_t slot = 0;
+    bool retain = false;
+    const char *payload = nullptr;
+    size_t length = 0;
+    // The spool always holds older messages than the RAM queue.
+    bool fromSpool = !spool_.empty() && !paused_;
+    if (fromSpool)
+    {
+        if (!spool_.take(slot, retain, spoolPayload_, sizeof(spoolPayload_), length))
+            return false;
+        payload = spoolPayload_;
+    }
+    else
+    {
+        MqttOutboundQueue::Entry entry;
+        if (!queue_.front(entry))
+            return false;
+        slot = entry.slot;
+        retain = entry.retain;
+        payload = entry.payload;
+        length = entry.length;
+    }
+
+    const String &topic = slotTopic(slot);
+    uint16_t packetId = nextPacketId_++;
+    if (!nextPacketId_)
+        nextPacketId_ = 1;
+    size_t headerLength = topic.length()
+                              ? MqttQos1::encodePublishHeader(inflightPacket_, sizeof(inflightPacket_), topic.c_str(), packetId, length, retain, false)
+                              : 0;
+    if (headerLength && headerLength + length <= sizeof(inflightPacket_))
+    {
+        memcpy(inflightPacket_ + headerLength, payload, length);
+        inflightLength_ = headerLength + length;
+        inflightPacketId_ = packetId;
+        inflightSent_ = false;
+        inflightFromSpool_ = fromSpool;
+    }
+    else
+    {
+        ++queueDropped_;
+        log_.println("MQTT queued message has no usable topic; dropped.");
+        if (fromSpool)
+            spool_.commit();
+    }
+
+    if (!fromSpool)
+        queue_.pop();
+    return inflightLength_ != 0;
+}
+
+void MqttPublisher::serviceQueue()
+{
+    uint16_t ackId = 0;
+    while (ack_tap_.takeAck(ackId))
+    {
+        if (inflightLength_ && inflightSent_ && ackId == inflightPacketId_)
+        {
+            inflightLength_ = 0;
+            inflightSent_ = false;
+            if (inflightFromSpool_)
+                spool_.commit();
+            if (publishCallback_)
+                publishCallback_(true);
+        }
+    }
+
+    if (!inflightLength_ && !loadNextQueued())
+        return;
+
+    unsigned long now = millis();
+    if (inflightSent_)
+    {
+        if (now - inflightSentMs_ < kAckTimeoutMs)
+            return;
+        inflightPacket_[0] |= MqttQos1::kFlagDup;
+    }
+    else
+    {
+        uint32_t rate = config_.mqttReplayPerSecond ? config_.mqttReplayPerSecond : kDefaultMqttReplayPerSecond;
+        if (lastQueueSendMs_ != 0 && now - lastQueueSendMs_ < 1000UL / rate)
+            return;
+    }
+
+    // One message in flight at a time keeps retained topics in order.
+    size_t written = mqtt_client_.write(inflightPacket_, inflightLength_);
+    lastQueueSendMs_ = now;
+    inflightSentMs_ = now;
+    inflightSent_ = true;
+    if (written != inflightLength_ && publishCallback_)
+        publishCallback_(false);
+}
+
+void MqttPublisher::onControlMessage(const char *topic, const uint8_t *payload, unsigned int length)
+{
+    if (!controlEnabled_ || !topic || !controlPrefix_.length())
+        return;
+    if (strncmp(topic, controlPrefix_.c_str(), controlPrefix_.length()) != 0)
+        return;
+    if (controlPending_)
+    {
+        log_.println("MQTT command ignored; previous command still pending.");
+        return;
+    }
+
+    // Copy out now: the payload points into PubSubClient's buffer.
+    controlCommand_ = topic + controlPrefix_.length();
+    controlPayloadLength_ = length;
+    memcpy(controlPayload_, payload, length < sizeof(controlPayload_) ? length : sizeof(controlPayload_));
+    controlPending_ = true;
+}
+
+void MqttPublisher::syncControlSubscription()
+{
+    if (topicDirty_)
+        refreshTopics();
+    static const String kNoFilter;
+    const String &wanted = controlEnabled_ ? controlFilter_ : kNoFilter;
+    if (subscribedFilter_ == wanted)
+        return;
+
+    if (subscribedFilter_.length())
+        mqtt_client_.unsubscribe(subscribedFilter_.c_str());
+    subscribedFilter_ = String();
+    if (wanted.length() && mqtt_client_.subscribe(wanted.c_str()))
+    {
+        subscribedFilter_ = wanted;
+        log_.print("MQTT listening for commands on ");
+        log_.println(wanted);
+    }
+}
+
+void MqttPublisher::handleControl()
+{
+    if (!controlPending_)
+        return;
+    controlPending_ = false;
+
+    MqttControlRequest request;
+    const char *error = MqttControlRequest::parse(controlCommand_.c_str(),
+                                                  controlPayload_,
+                                                  controlPayloadLength_,
+                                                  kMinReadIntervalMs,
+                                                  request);
+    if (!error)
+    {
+        if (request.kind == MqttControlRequest::Kind::Republish)
+        {
+            markAllPending();
+            discoveryPublished_ = false;
+            discoveryIndex_ = 0;
+            lastDiscoveryAttempt_ = 0;
+            versionDiscoveryDone_ = false;
+            bridgeVersionDirty_ = true;
+        }
+        else if (controlHandler_)
+        {
+            error = controlHandler_(request);
+        }
+        else
+        {
+            error = "not supported";
+        }
+    }
+
+    // Echo the command name only when it is a known one.
+    const char *command = error && strcmp(error, "unknown command") == 0 ? "" : MqttControlRequest::name(request.kind);
+    char result[160];
+    if (error)
+        snprintf(result, sizeof(result), "{\"cmd\":\"%s\",\"ok\":false,\"error\":\"%s\"}", command, error);
+    else if (request.kind == MqttControlRequest::Kind::Interval)
+        snprintf(result, sizeof(result), "{\"cmd\":\"%s\",\"ok\":true,\"intervalMs\":%lu,\"durationS\":%lu}",
+                 command,
+                 static_cast<unsigned long>(request.intervalMs ? request.intervalMs : config_.readIntervalMs),
+                 static_cast<unsigned long>(request.intervalMs ? request.durationSeconds : 0));
+    else
+        snprintf(result, sizeof(result), "{\"cmd\":\"%s\",\"ok\":true}", command);
+
+    BRIDGE_LOGI(log_, "MQTT", "command %s: %s", controlCommand_, error ? error : "ok");
+    publish(controlResultTopic_, result, false);
+}
+
+void MqttPublisher::applyDeadbandConfig()
+{
+    deadbandEnabled_ = config_.mqttDeadbandEnabled;
+    heartbeatSeconds_ = config_.mqttHeartbeatSeconds;
+    rateDeadbandText_ = config_.mqttRateDeadband;
+    countDeadbandText_ = config_.mqttCountDeadband;
+    batteryDeadbandText_ = config_.mqttBatteryDeadband;
+
+    // An unparsable threshold falls back to publishing every change.
+    bool valid = DeadbandSpec::parse(rateDeadbandText_.c_str(), rateDeadband_);
+    valid = DeadbandSpec::parse(countDeadbandText_.c_str(), countDeadband_) && valid;
+    valid = DeadbandSpec::parse(batteryDeadbandText_.c_str(), batteryDeadband_) && valid;
+    if (deadbandEnabled_ && !valid)
+        log_.println("MQTT deadband setting invalid; publishing every change for that metric.");
+    resetDeadbandFilters();
+}
+
+void MqttPublisher::resetDeadbandFilters()
+{
+    powerFilter_.reset();
+    rateFilter_.reset();
+    countFilter_.reset();
+    batteryFilter_.reset();
+    rateHeld_ = false;
+    batteryHeld_ = false;
+}
+
+bool MqttPublisher::passesDeadband(DeviceManager::CommandType type, const String &value)
+{
+    const uint32_t now = millis();
+    const uint32_t heartbeatMs = heartbeatSeconds_ * 1000UL;
+    char *end = nullptr;
+    double reading = strtod(value.c_str(), &end);
+    if (end == value.c_str())
+        reading = NAN;
+
+    switch (type)
+    {
+    case DeviceManager::CommandType::DevicePower:
+        return powerFilter_.shouldPublish(reading, now, DeadbandSpec(), heartbeatMs);
+    case DeviceManager::CommandType::TubePulseCount:
+        return countFilter_.shouldPublish(reading, now, countDeadband_, heartbeatMs);
+    case DeviceManager::CommandType::TubeRate:
+        rateHeld_ = !rateFilter_.shouldPublish(reading, now, rateDeadband_, heartbeatMs);
+        return !rateHeld_;
+    case DeviceManager::CommandType::TubeDoseRate:
+        return !rateHeld_;
+    case DeviceManager::CommandType::DeviceBatteryVoltage:
+        batteryHeld_ = !batteryFilter_.shouldPublish(reading, now, batteryDeadband_, heartbeatMs);
+        return !batteryHeld_;
+    case DeviceManager::CommandType::DeviceBatteryPercent:
+        return !batteryHeld_;
+    default:
+        return true;
+    }
+}
+
+const char *MqttPublisher::aggregatedLeaf(DeviceManager::CommandType type)
+{
+    // The values requested on every poll cycle; one-off settings such as the
+    // tube sensitivity keep their own retained topics.
+    switch (type)
+    {
+    case DeviceManager::CommandType::DevicePower:
+        return "devicePower";
+    case DeviceManager::CommandType::TubePulseCount:
+        return "tubePulseCount";
+    case DeviceManager::CommandType::TubeRate:
+        return "tubeRate";
+    case DeviceManager::CommandType::TubeDoseRate:
+        return "tubeDoseRate";
+    case DeviceManager::CommandType::DeviceBatteryVoltage:
+        return "deviceBatteryVoltage";
+    case DeviceManager::CommandType::DeviceBatteryPercent:
+        return "deviceBatteryPercent";
+    default:
+        return nullptr;
+    }
+}
+
+void MqttPublisher::collectAggregate(DeviceManager::CommandType type, const char *leaf, const String &value, bool changed)
+{
+    const char *payload = value.c_str();
+    if (type == DeviceManager::CommandType::DevicePower)
+        payload = value == "1" ? "ON" : (value == "0" ? "OFF" : value.c_str());
+
+    // A repeated leaf means the previous cycle ended without its last result.
+    if (aggregate_.has(leaf))
+        flushAggregate();
+    if (aggregate_.empty())
+        aggregateStartedMs_ = millis();
+    aggregate_.set(leaf, payload);
+    aggregateChanged_ |= changed;
+
+    // DeviceBatteryPercent is derived from the last request of a poll cycle.
+    if (type == DeviceManager::CommandType::DeviceBatteryPercent)
+        flushAggregate();
+}
+
+void MqttPublisher::flushAggregate()
+{
+    if (aggregate_.empty())
+        return;
+
+    // With deadbands on, a cycle in which nothing moved is not sent at all.
+    bool changed = aggregateChanged_;
+    aggregateChanged_ = false;
+    if (!changed)
+    {
+        aggregate_.clear();
+        return;
+    }
+
+    time_t now = time(nullptr);
+    uint32_t timestamp = now >= kMinValidEpoch ? static_cast<uint32_t>(now) : 0;
+    size_t length = aggregate_.serialize(aggregatePayload_, sizeof(aggregatePayload_), timestamp);
+    aggregate_.clear();
+    if (!length)
+    {
+        log_.println("MQTT state payload too large; poll cycle dropped.");
+        return;
+    }
+
+    aggregatePayloadLength_ = length;
+    if (queueMode_)
+    {
+        enqueue(kStateSlot, aggregatePayload_, length, true);
+        return;
+    }
+
+    aggregatePending_ = true;
+    if (topicDirty_)
+        refreshTopics();
+    if (publish(stateTopic_, aggregatePayload_, true))
+        aggregatePending_ = false;
+    else
+        lastRepublishAttempt_ = 0;
+}
+
+bool MqttPublisher::binaryField(DeviceManager::CommandType type, MqttBinaryFrame::Field &field)
+{
+    switch (type)
+    {
+    case DeviceManager::CommandType::DevicePower:
+        field = MqttBinaryFrame::DevicePower;
+        return true;
+    case DeviceManager::CommandType::TubePulseCount:
+        field = MqttBinaryFrame::TubePulseCount;
+        return true;
+    case DeviceManager::CommandType::TubeRate:
+        field = MqttBinaryFrame::TubeRate;
+        return true;
+    case DeviceManager::CommandType::TubeDoseRate:
+        field = MqttBinaryFrame::TubeDoseRate;
+        return true;
+    case DeviceManager::CommandType::DeviceBatteryVoltage:
+        field = MqttBinaryFrame::BatteryVoltage;
+        return true;
+    case DeviceManager::CommandType::DeviceBatteryPercent:
+        field = MqttBinaryFrame::BatteryPercent;
+        return true;
+    default:
+        return false;
+    }
+}
+
+void MqttPublisher::collectBinary(DeviceManager::CommandType type, const String &value, bool changed)
+{
+    MqttBinaryFrame::Field field;
+    if (!binaryField(type, field))
+        return;
+
+    // Same cycle boundaries as collectAggregate().
+    if (binaryFrame_.has(field))
+        flushBinary();
+    if (binaryFrame_.empty())
+    {
+        binaryStartedMs_ = millis();
+        time_t now = time(nullptr);
+        binaryFrame_.setTimestamp(now >= kMinValidEpoch ? static_cast<uint32_t>(now) : 0);
+    }
+    binaryFrame_.set(field, value.c_str());
+    binaryChanged_ |= changed;
+
+    if (type == DeviceManager::CommandType::DeviceBatteryPercent)
+        flushBinary();
+}
+
+void MqttPublisher::flushBinary()
+{
+    if (binaryFrame_.empty())
+        return;
+
+    bool changed = binaryChanged_;
+    binaryChanged_ = false;
+    if (!changed)
+    {
+        binaryFrame_.clear();
+        return;
+    }
+
+    uint8_t frame[MqttBinaryFrame::kFrameBytes];
+    size_t length = binaryFrame_.encode(frame, sizeof(frame), ++binarySequence_);
+    binaryFrame_.clear();
+
+    // Frames are a stream, not a state: never retained. Without the QoS 1
+    // queue a frame missed while offline shows up as a sequence gap.
+    if (queueMode_)
+    {
+        enqueue(kBinarySlot, reinterpret_cast<const char *>(frame), length, false);
+        return;
+    }
+    if (topicDirty_)
+        refreshTopics();
+    publish(binaryTopic_, frame, length, false);
+}
+
 void MqttPublisher::publishDiscovery()
 {
-    if (discoveryPublished_ || !configValid_ || !mqtt_client_.connected())
+    if (discoveryPublished_ || !configValid_ || !clientReady())
         return;
 
     if (!deviceId_.length())
         return;
 
+    if (deviceDiscovery_)
+    {
+        unsigned long now = millis();
+        if (lastDiscoveryAttempt_ != 0 && now - lastDiscoveryAttempt_ < 1000)
+            return;
+        lastDiscoveryAttempt_ = now;
+        if (publishDeviceDiscovery())
+        {
+            discoveryPublished_ = true;
+            versionDiscoveryDone_ = true;
+        }
+        return;
+    }
+
     if (!versionDiscoveryDone_)
     {
         if (!publishVersionDiscovery())
@@ -553,34 +1303,7 @@ void MqttPublisher::publishDiscovery()
     if (!ensureConnected())
         return;
 
-    struct DiscoveryEntry
-    {
-        DeviceManager::CommandType type;
-        const char *component;
-        const char *objectId;
-        const char *name;
-        const char *unit;
-        const char *deviceClass;
-        const char *stateClass;
-        const char *payloadOn;
-        const char *payloadOff;
-        const char *icon;
-    };
-
-    static const DiscoveryEntry kEntities[] = {
-        {DeviceManager::CommandType::DevicePower, "binary_sensor", "power", "Power", nullptr, "power", nullptr, "ON", "OFF", "mdi:power-plug"},
-        {DeviceManager::CommandType::DeviceBatteryVoltage, "sensor", "battery_voltage", "Battery Voltage", "V", "voltage", "measurement", nullptr, nullptr, "mdi:flash"},
-        {DeviceManager::CommandType::DeviceBatteryPercent, "sensor", "battery", "Battery", "%", "battery", "measurement", nullptr, nullptr, "mdi:battery"},
-        {DeviceManager::CommandType::TubeRate, "sensor", "tube_rate", "Tube Rate", "cpm", nullptr, "measurement", nullptr, nullptr, "mdi:chart-line"},
-        {DeviceManager::CommandType::TubeDoseRate, "sensor", "tube_dose_rate", "Dose Rate", "µSv/h", nullptr, "measurement", nullptr, nullptr, "mdi:radioactive"},
-        {DeviceManager::CommandType::TubePulseCount, "sensor", "tube_pulse_count", "Tube Pulse Count", nullptr, nullptr, "total_increasing", nullptr, nullptr, "mdi:pulse"},
-        {DeviceManager::CommandType::DeviceSensitivity, "sensor", "tube_sensitivity", "Tube Sensitivity", "cpm/µSv/h", nullptr, nullptr, nullptr, nullptr, "mdi:tune-vertical"},
-        {DeviceManager::CommandType::TubeDeadTime, "sensor", "tube_dead_time", "Tube Dead Time", "s", nullptr, nullptr, nullptr, nullptr, "mdi:timer-outline"},
-        {DeviceManager::CommandType::TubeHVFrequency, "sensor", "tube_hv_frequency", "Tube HV Frequency", "Hz", "frequency", "measurement", nullptr, nullptr, "mdi:waveform"},
-        {DeviceManager::CommandType::TubeHVDutyCycle, "sensor", "tube_hv_duty_cycle", "Tube HV Duty Cycle", nullptr, nullptr, nullptr, nullptr, nullptr, "mdi:sine-wave"}};
-
-    size_t entityCount = sizeof(kEntities) / sizeof(kEntities[0]);
-    if (discoveryIndex_ >= entityCount)
+    if (discoveryIndex_ >= kEntityCount)
     {
         discoveryPublished_ = true;
         return;
@@ -604,7 +1327,7 @@ void MqttPublisher::publishDiscovery()
                                entry.icon))
     {
         discoveryIndex_++;
-        if (discoveryIndex_ >= entityCount)
+        if (discoveryIndex_ >= kEntityCount)
             discoveryPublished_ = true;
     }
 }
@@ -622,13 +1345,19 @@ bool MqttPublisher::publishDiscoveryEntity(DeviceManager::CommandType type,
                                            const char *entityCategory,
                                            const char *leafOverride)
 {
-    String leaf = (leafOverride && *leafOverride) ? String(leafOverride) : commandLeaf(type);
-    if (!leaf.length())
+    const bool overridden = leafOverride && *leafOverride;
+    if (!overridden && !commandLeaf(type))
         return true;
 
-    String stateTopic = buildTopic(leaf);
-    if (!stateTopic.length())
-        return false;
+    if (topicDirty_)
+        refreshTopics();
+
+    const char *aggregateField = (aggregateMode_ && !overridden) ? aggregatedLeaf(type) : nullptr;
+    String stateTopic;
+    if (overridden)
+        stateTopic = topicPrefix_ + leafOverride;
+    else
+        stateTopic = aggregateField ? stateTopic_ : commandTopics_[static_cast<size_t>(type)];
 
     String deviceIdSlug = sanitizedDeviceId();
     String discoveryTopic = String("homeassistant/") + component + "/" + deviceIdSlug + "/" + objectId + "/config";
@@ -645,6 +1374,8 @@ bool MqttPublisher::publishDiscoveryEntity(DeviceManager::CommandType type,
     doc.clear();
     doc["name"] = fullName;
     doc["state_topic"] = stateTopic;
+    if (aggregateField)
+        doc["value_template"] = String("{{ value_json.") + aggregateField + " }}";
     doc["unique_id"] = objectUid;
     String deviceNameSlug = makeSlug(deviceName);
     String objectIdField;
@@ -690,20 +1421,15 @@ bool MqttPublisher::publishDiscoveryEntity(DeviceManager::CommandType type,
     size_t neededLen = discoveryTopic.length() + payloadLen + 16;
     if (neededLen > mqtt_client_.getBufferSize())
     {
-        log_.print("MQTT discovery payload too large for ");
-        log_.println(discoveryTopic);
-        log_.print("Required bytes: ");
-        log_.println(neededLen);
-        log_.print("Buffer size: ");
-        log_.println(mqtt_client_.getBufferSize());
+        BRIDGE_LOGE(log_, "MQTT", "discovery payload too large for %s: required %u bytes, buffer %u",
+                    discoveryTopic, neededLen, mqtt_client_.getBufferSize());
         led_.activateFault(FaultCode::MqttDiscoveryTooLarge);
         return false;
     }
 
     if (!mqtt_client_.beginPublish(discoveryTopic.c_str(), payloadLen, true))
     {
-        log_.print("MQTT discovery publish begin failed for ");
-        log_.println(discoveryTopic);
+        BRIDGE_LOGW(log_, "MQTT", "discovery publish begin failed for %s", discoveryTopic);
         return false;
     }
 
@@ -711,8 +1437,120 @@ bool MqttPublisher::publishDiscoveryEntity(DeviceManager::CommandType type,
     bool ok = mqtt_client_.endPublish();
     if (!ok)
     {
-        log_.print("MQTT discovery publish failed for ");
-        log_.println(discoveryTopic);
+        BRIDGE_LOGW(log_, "MQTT", "discovery publish failed for %s", discoveryTopic);
+    }
+    else
+    {
+        led_.clearFault(FaultCode::MqttDiscoveryTooLarge);
+    }
+    return ok;
+}
+
+void MqttPublisher::buildDeviceDiscovery()
+{
+    if (topicDirty_)
+        refreshTopics();
+
+    String deviceIdSlug = sanitizedDeviceId();
+    String deviceName = deviceNameForDiscovery();
+    String deviceNameSlug = makeSlug(deviceName);
+    String base = topicPrefix_;
+    while (base.endsWith("/"))
+        base.remove(base.length() - 1);
+
+    JsonDocument &doc = getDiscoveryDoc();
+    doc.clear();
+    doc["~"] = base;
+
+    JsonObject device = doc["dev"].to<JsonObject>();
+    JsonArray identifiers = device["ids"].to<JsonArray>();
+    identifiers.add(String("radpro-") + deviceIdSlug);
+    device["mf"] = "Bosean";
+    device["mdl"] = deviceModelForDiscovery();
+    device["name"] = deviceName;
+    if (deviceFirmware_.length())
+        device["sw"] = deviceFirmware_;
+
+    JsonObject origin = doc["o"].to<JsonObject>();
+    origin["name"] = "RadPro WiFi Bridge";
+    if (bridgeVersion_.length())
+        origin["sw"] = bridgeVersion_;
+
+    // Abbreviated keys keep the single payload small; "~" expands to the
+    // topic base in every stat_t.
+    JsonObject components = doc["cmps"].to<JsonObject>();
+    auto addComponent = [&](const DiscoveryEntry &entry, const char *leaf, const char *entityCategory) {
+        String uniqueId = deviceIdSlug + "_" + entry.objectId;
+        JsonObject cmp = components[uniqueId].to<JsonObject>();
+        cmp["p"] = entry.component;
+        cmp["name"] = entry.name;
+        cmp["uniq_id"] = uniqueId;
+        cmp["obj_id"] = deviceNameSlug.length() ? deviceNameSlug + "_" + entry.objectId : uniqueId;
+
+        const char *aggregateField = leaf ? nullptr : (aggregateMode_ ? aggregatedLeaf(entry.type) : nullptr);
+        if (aggregateField)
+        {
+            cmp["stat_t"] = String("~/") + kStateLeaf;
+            cmp["val_tpl"] = String("{{ value_json.") + aggregateField + " }}";
+        }
+        else
+        {
+            cmp["stat_t"] = String("~/") + (leaf ? leaf : commandLeaf(entry.type));
+        }
+        if (entry.unit)
+            cmp["unit_of_meas"] = entry.unit;
+        if (entry.deviceClass)
+            cmp["dev_cla"] = entry.deviceClass;
+        if (entry.stateClass)
+            cmp["stat_cla"] = entry.stateClass;
+        if (entry.icon)
+            cmp["ic"] = entry.icon;
+        if (entry.payloadOn)
+        {
+            cmp["pl_on"] = entry.payloadOn;
+            if (entry.payloadOff)
+                cmp["pl_off"] = entry.payloadOff;
+        }
+        if (entityCategory)
+            cmp["ent_cat"] = entityCategory;
+    };
+
+    for (const auto &entry : kEntities)
+        addComponent(entry, nullptr, nullptr);
+
+    if (bridgeVersion_.length())
+    {
+        static const DiscoveryEntry kVersionEntity = {DeviceManager::CommandType::DeviceId, "sensor", "bridge_version", "Bridge Firmware Version", nullptr, nullptr, nullptr, nullptr, nullptr, "mdi:chip"};
+        addComponent(kVersionEntity, "bridgeVersion", "diagnostic");
+    }
+
+    deviceDiscoveryTopic_ = String("homeassistant/device/") + deviceIdSlug + "/config";
+    deviceDiscoveryPayload_ = String();
+    deviceDiscoveryPayload_.reserve(measureJson(doc) + 1);
+    serializeJson(doc, deviceDiscoveryPayload_);
+    doc.clear();
+    deviceDiscoveryDirty_ = false;
+}
+
+bool MqttPublisher::publishDeviceDiscovery()
+{
+    if (topicDirty_ || deviceDiscoveryDirty_ || !deviceDiscoveryPayload_.length())
+        buildDeviceDiscovery();
+
+    // Streamed with beginPublish, so the payload is not bound by the
+    // PubSubClient buffer size.
+    const size_t payloadLen = deviceDiscoveryPayload_.length();
+    if (!mqtt_client_.beginPublish(deviceDiscoveryTopic_.c_str(), payloadLen, true))
+    {
+        BRIDGE_LOGW(log_, "MQTT", "discovery publish begin failed for %s", deviceDiscoveryTopic_);
+        return false;
+    }
+
+    mqtt_client_.write(reinterpret_cast<const uint8_t *>(deviceDiscoveryPayload_.c_str()), payloadLen);
+    bool ok = mqtt_client_.endPublish();
+    if (!ok)
+    {
+        BRIDGE_LOGW(log_, "MQTT", "discovery publish failed for %s", deviceDiscoveryTopic_);
     }
     else
     {
@@ -751,7 +1589,9 @@ bool MqttPublisher::publishBridgeVersion()
         return true;
     }
 
-    bool ok = publish("bridgeVersion", bridgeVersion_, true);
+    if (topicDirty_)
+        refreshTopics();
+    bool ok = publish(bridgeVersionTopic_, bridgeVersion_.c_str(), true);
     if (ok)
         bridgeVersionDirty_ = false;
     return ok;
@@ -773,6 +1613,59 @@ bool MqttPublisher::HandlePortalPost(WebServer &server,
     String fullTopic = server.arg("mqttFullTopic");
     String intervalStr = server.arg("readInterval");
     bool enabled = server.hasArg("mqttEnabled") && server.arg("mqttEnabled") == "1";
+    bool aggregate = server.hasArg("mqttAggregate") && server.arg("mqttAggregate") == "1";
+    bool deviceDiscovery = server.hasArg("mqttDeviceDiscovery") && server.arg("mqttDeviceDiscovery") == "1";
+    bool controlEnabled = server.hasArg("mqttControl") && server.arg("mqttControl") == "1";
+    bool binaryState = server.hasArg("mqttBinary") && server.arg("mqttBinary") == "1";
+    bool queueEnabled = server.hasArg("mqttQueue") && server.arg("mqttQueue") == "1";
+    bool spoolEnabled = server.hasArg("mqttSpool") && server.arg("mqttSpool") == "1";
+    String replayStr = server.arg("mqttReplayRate");
+    replayStr.trim();
+    bool deadbandEnabled = server.hasArg("mqttDeadband") && server.arg("mqttDeadband") == "1";
+    String rateDeadband = server.arg("mqttDbRate");
+    String countDeadband = server.arg("mqttDbCount");
+    String batteryDeadband = server.arg("mqttDbBattery");
+    String heartbeatStr = server.arg("mqttHeartbeat");
+    rateDeadband.trim();
+    countDeadband.trim();
+    batteryDeadband.trim();
+    heartbeatStr.trim();
+
+    bool tlsEnabled = server.hasArg("mqttTls") && server.arg("mqttTls") == "1";
+    String tlsCa = server.arg("mqttTlsCa");
+    String tlsFingerprint = server.arg("mqttTlsFingerprint");
+    tlsCa.replace("\r\n", "\n");
+    tlsCa.trim();
+    tlsFingerprint.trim();
+
+    uint8_t parsedFingerprint[TlsFingerprint::kBytes];
+    bool fingerprintEmpty = false;
+    bool fingerprintValid = TlsFingerprint::parse(tlsFingerprint.c_str(), parsedFingerprint, &fingerprintEmpty);
+    if (tlsFingerprint.length() > kMqttTlsFingerprintLen || (!fingerprintValid && !fingerprintEmpty))
+    {
+        message = F("The TLS fingerprint must be a SHA-256 fingerprint (64 hex digits).");
+        return false;
+    }
+    if (tlsCa.length() > kMqttTlsCaCertLen ||
+        (tlsCa.length() && tlsCa.indexOf("-----BEGIN CERTIFICATE-----") < 0))
+    {
+        message = F("The CA certificate must be a PEM certificate.");
+        return false;
+    }
+    if (tlsEnabled && !tlsCa.length() && !fingerprintValid)
+    {
+        message = F("TLS needs a CA certificate or a certificate fingerprint.");
+        return false;
+    }
+
+    DeadbandSpec parsedDeadband;
+    if (rateDeadband.length() > kMqttDeadbandParamLen || !DeadbandSpec::parse(rateDeadband.c_str(), parsedDeadband) ||
+        countDeadband.length() > kMqttDeadbandParamLen || !DeadbandSpec::parse(countDeadband.c_str(), parsedDeadband) ||
+        batteryDeadband.length() > kMqttDeadbandParamLen || !DeadbandSpec::parse(batteryDeadband.c_str(), parsedDeadband))
+    {
+        message = F("Deadbands must be a number such as 0.5 or a percentage such as 5%.");
+        return false;
+    }
 
     host.trim();
     client.trim();
@@ -803,6 +1696,19 @@ bool MqttPublisher::HandlePortalPost(WebServer &server,
     fieldChanged = UpdateStringIfChanged(config.mqttFullTopic, fullTopic.c_str());
     PortalSecurity::appendChangedField(changedFields, "mqttFullTopic", fieldChanged);
     changed |= fieldChanged;
+    fieldChanged = UpdateStringIfChanged(config.mqttTlsCaCert, tlsCa.c_str());
+    PortalSecurity::appendChangedField(changedFields, "mqttTlsCaCert", fieldChanged);
+    changed |= fieldChanged;
+    fieldChanged = UpdateStringIfChanged(config.mqttTlsFingerprint, tlsFingerprint.c_str());
+    PortalSecurity::appendChangedField(changedFields, "mqttTlsFingerprint", fieldChanged);
+    changed |= fieldChanged;
+
+    if (config.mqttTlsEnabled != tlsEnabled)
+    {
+        config.mqttTlsEnabled = tlsEnabled;
+        PortalSecurity::appendChangedField(changedFields, "mqttTlsEnabled", true);
+        changed = true;
+    }
 
     if (config.mqttEnabled != enabled)
     {
@@ -811,6 +1717,88 @@ bool MqttPublisher::HandlePortalPost(WebServer &server,
         changed = true;
     }
 
+    if (config.mqttAggregateState != aggregate)
+    {
+        config.mqttAggregateState = aggregate;
+        PortalSecurity::appendChangedField(changedFields, "mqttAggregateState", true);
+        changed = true;
+    }
+
+    if (config.mqttDeviceDiscovery != deviceDiscovery)
+    {
+        config.mqttDeviceDiscovery = deviceDiscovery;
+        PortalSecurity::appendChangedField(changedFields, "mqttDeviceDiscovery", true);
+        changed = true;
+    }
+
+    if (config.mqttControlEnabled != controlEnabled)
+    {
+        config.mqttControlEnabled = controlEnabled;
+        PortalSecurity::appendChangedField(changedFields, "mqttControlEnabled", true);
+        changed = true;
+    }
+
+    if (config.mqttBinaryState != binaryState)
+    {
+        config.mqttBinaryState = binaryState;
+        PortalSecurity::appendChangedField(changedFields, "mqttBinaryState", true);
+        changed = true;
+    }
+
+    if (config.mqttQueueEnabled != queueEnabled)
+    {
+        config.mqttQueueEnabled = queueEnabled;
+        PortalSecurity::appendChangedField(changedFields, "mqttQueueEnabled", true);
+        changed = true;
+    }
+
+    if (config.mqttSpoolEnabled != spoolEnabled)
+    {
+        config.mqttSpoolEnabled = spoolEnabled;
+        PortalSecurity::appendChangedField(changedFields, "mqttSpoolEnabled", true);
+        changed = true;
+    }
+
+    uint32_t replayRate = strtoul(replayStr.c_str(), nullptr, 10);
+    if (replayRate < kMinMqttReplayPerSecond)
+        replayRate = kMinMqttReplayPerSecond;
+    if (replayRate > kMaxMqttReplayPerSecond)
+        replayRate = kMaxMqttReplayPerSecond;
+    if (config.mqttReplayPerSecond != replayRate)
+    {
+        config.mqttReplayPerSecond = replayRate;
+        PortalSecurity::appendChangedField(changedFields, "mqttReplayPerSecond", true);
+        changed = true;
+    }
+
+    if (config.mqttDeadbandEnabled != deadbandEnabled)
+    {
+        config.mqttDeadbandEnabled = deadbandEnabled;
+        PortalSecurity::appendChangedField(changedFields, "mqttDeadbandEnabled", true);
+        changed = true;
+    }
+    fieldChanged = UpdateStringIfChanged(config.mqttRateDeadband, rateDeadband.c_str());
+    PortalSecurity::appendChangedField(changedFields, "mqttRateDeadband", fieldChanged);
+    changed |= fieldChanged;
+    fieldChanged = UpdateStringIfChanged(config.mqttCountDeadband, countDeadband.c_str());
+    PortalSecurity::appendChangedField(changedFields, "mqttCountDeadband", fieldChanged);
+    changed |= fieldChanged;
+    fieldChanged = UpdateStringIfChanged(config.mqttBatteryDeadband, batteryDeadband.c_str());
+    PortalSecurity::appendChangedField(changedFields, "mqttBatteryDeadband", fieldChanged);
+    changed |= fieldChanged;
+
+    uint32_t heartbeat = strtoul(heartbeatStr.c_str(), nullptr, 10);
+    if (heartbeat < kMinMqttHeartbeatSeconds)
+        heartbeat = kMinMqttHeartbeatSeconds;
+    if (heartbeat > kMaxMqttHeartbeatSeconds)
+        heartbeat = kMaxMqttHeartbeatSeconds;
+    if (config.mqttHeartbeatSeconds != heartbeat)
+    {
+        config.mqttHeartbeatSeconds = heartbeat;
+        PortalSecurity::appendChangedField(changedFields, "mqttHeartbeatSeconds", true);
+        changed = true;
+    }
+
     uint32_t parsedPort = strtoul(portStr.c_str(), nullptr, 10);
     if (parsedPort == 0 || parsedPort > 65535)
         parsedPort = config.mqttPort;
@@ -857,18 +1845,40 @@ void MqttPublisher::SendPortalForm(WiFiPortalService &portal, const String &mess
     if (!portal.manager_.server)
         return;
 
-    String notice = WiFiPortalService::htmlEscape(message);
+    const String &notice = message;
     WiFiPortalService::TemplateReplacements vars = {
         {"{{NOTICE_CLASS}}", notice.length() ? String() : String("hidden")},
         {"{{NOTICE_TEXT}}", notice},
         {"{{MQTT_ENABLED_CHECKED}}", portal.config_.mqttEnabled ? String("checked") : String()},
-        {"{{MQTT_HOST}}", WiFiPortalService::htmlEscape(portal.config_.mqttHost)},
+        {"{{MQTT_HOST}}", portal.config_.mqttHost},
         {"{{MQTT_PORT}}", String(portal.config_.mqttPort)},
-        {"{{MQTT_CLIENT}}", WiFiPortalService::htmlEscape(portal.config_.mqttClient)},
-        {"{{MQTT_USER}}", WiFiPortalService::htmlEscape(portal.config_.mqttUser)},
-        {"{{MQTT_PASS}}", WiFiPortalService::htmlEscape(portal.config_.mqttPassword)},
-        {"{{MQTT_TOPIC}}", WiFiPortalService::htmlEscape(portal.config_.mqttTopic)},
-        {"{{MQTT_FULL_TOPIC}}", WiFiPortalService::htmlEscape(portal.config_.mqttFullTopic)},
+        {"{{MQTT_CLIENT}}", portal.config_.mqttClient},
+        {"{{MQTT_USER}}", portal.config_.mqttUser},
+        {"{{MQTT_PASS}}", portal.config_.mqttPassword},
+        {"{{MQTT_TOPIC}}", portal.config_.mqttTopic},
+        {"{{MQTT_FULL_TOPIC}}", portal.config_.mqttFullTopic},
+        {"{{MQTT_TLS_CHECKED}}", portal.config_.mqttTlsEnabled ? String("checked") : String()},
+        {"{{MQTT_TLS_CA}}", portal.config_.mqttTlsCaCert},
+        {"{{MQTT_TLS_CA_MAXLEN}}", String(kMqttTlsCaCertLen)},
+        {"{{MQTT_TLS_FINGERPRINT}}", portal.config_.mqttTlsFingerprint},
+        {"{{MQTT_TLS_FINGERPRINT_MAXLEN}}", String(kMqttTlsFingerprintLen)},
+        {"{{MQTT_AGGREGATE_CHECKED}}", portal.config_.mqttAggregateState ? String("checked") : String()},
+        {"{{MQTT_DEVICE_DISCOVERY_CHECKED}}", portal.config_.mqttDeviceDiscovery ? String("checked") : String()},
+        {"{{MQTT_CONTROL_CHECKED}}", portal.config_.mqttControlEnabled ? String("checked") : String()},
+        {"{{MQTT_BINARY_CHECKED}}", portal.config_.mqttBinaryState ? String("checked") : String()},
+        {"{{MQTT_QUEUE_CHECKED}}", portal.config_.mqttQueueEnabled ? String("checked") : String()},
+        {"{{MQTT_SPOOL_CHECKED}}", portal.config_.mqttSpoolEnabled ? String("checked") : String()},
+        {"{{MQTT_REPLAY_MIN}}", String(kMinMqttReplayPerSecond)},
+        {"{{MQTT_REPLAY_MAX}}", String(kMaxMqttReplayPerSecond)},
+        {"{{MQTT_REPLAY_RATE}}", String(portal.config_.mqttReplayPerSecond)},
+        {"{{MQTT_DEADBAND_CHECKED}}", portal.config_.mqttDeadbandEnabled ? String("checked") : String()},
+        {"{{MQTT_DB_RATE}}", portal.config_.mqttRateDeadband},
+        {"{{MQTT_DB_COUNT}}", portal.config_.mqttCountDeadband},
+        {"{{MQTT_DB_BATTERY}}", portal.config_.mqttBatteryDeadband},
+        {"{{MQTT_DB_MAXLEN}}", String(kMqttDeadbandParamLen)},
+        {"{{MQTT_HEARTBEAT_MIN}}", String(kMinMqttHeartbeatSeconds)},
+        {"{{MQTT_HEARTBEAT_MAX}}", String(kMaxMqttHeartbeatSeconds)},
+        {"{{MQTT_HEARTBEAT}}", String(portal.config_.mqttHeartbeatSeconds)},
         {"{{READ_INTERVAL_MIN}}", String(kMinReadIntervalMs)},
         {"{{READ_INTERVAL}}", String(portal.config_.readIntervalMs)}};
 
@@ -910,13 +1920,15 @@ void MqttPublisher::markAllPending()
         if (state.hasValue)
             state.pending = true;
     }
+    if (aggregatePayloadLength_)
+        aggregatePending_ = true;
     lastRepublishAttempt_ = 0;
     bridgeVersionDirty_ = true;
 }
 
 void MqttPublisher::republishRetained()
 {
-    if (!mqtt_client_.connected())
+    if (!clientReady())
         return;
 
     if (topicDirty_)
@@ -932,14 +1944,13 @@ void MqttPublisher::republishRetained()
         if (!state.hasValue || !state.pending)
             continue;
 
-        String leaf = commandLeaf(state.type);
-        if (!leaf.length())
+        const String &topic = commandTopics_[static_cast<size_t>(state.type)];
+        if (!topic.length())
         {
             state.pending = false;
             continue;
         }
 
-        String topic = buildTopic(leaf);
         bool ok = mqtt_client_.publish(topic.c_str(), state.payload.c_str(), true);
         if (ok)
         {
@@ -954,6 +1965,12 @@ void MqttPublisher::republishRetained()
         }
     }
 
+    if (aggregatePending_)
+    {
+        if (mqtt_client_.publish(stateTopic_.c_str(), aggregatePayload_, true))
+            aggregatePending_ = false;
+    }
+
     if (bridgeVersionDirty_)
         publishBridgeVersion();
 }
@@ -969,8 +1986,9 @@ void MqttPublisher::setBridgeVersion(const String &version)
     bridgeVersionDirty_ = true;
     versionDiscoveryDone_ = false;
     discoveryPublished_ = false;
+    deviceDiscoveryDirty_ = true;
     lastDiscoveryAttempt_ = 0;
 
-    if (mqtt_client_.connected())
+    if (clientReady())
         publishBridgeVersion();
 }
@@ -9,11 +9,23 @@
 #include <Arduino.h>
 #include <WiFi.h>
 #include <PubSubClient.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 #include <array>
+#include <atomic>
 #include <functional>
 #include "AppConfig/AppConfig.h"
 #include "DeviceManager.h"
 #include "Led/LedController.h"
+#include "Mqtt/MqttAckTapClient.h"
+#include "Mqtt/MqttBinaryFrame.h"
+#include "Mqtt/MqttControl.h"
+#include "Mqtt/MqttOutboundQueue.h"
+#include "Mqtt/MqttSpool.h"
+#include "Mqtt/MqttStateAggregate.h"
+#include "Mqtt/MqttTlsClient.h"
+#include "Publishing/PublishDeadband.h"
+#include "Publishing/PublisherHealth.h"
 
 class WebServer;
 class WiFiPortalService;
@@ -21,15 +33,28 @@ class WiFiPortalService;
 class MqttPublisher
 {
 public:
-    MqttPublisher(AppConfig &config, Print &log, LedController &led);
+    static constexpr const char *kPublisherName = "mqtt";
+    // Runs an accepted control request; returns nullptr or an error text.
+    using ControlHandler = std::function<const char *(const MqttControlRequest &)>;
+
+    MqttPublisher(AppConfig &config, Print &log, LedController &led, PublisherHealth &health);
 
     void begin();
     void updateConfig();
     void loop();
     void onCommandResult(DeviceManager::CommandType type, const String &value);
     void setPublishCallback(std::function<void(bool)> cb) { publishCallback_ = std::move(cb); }
+    void setControlHandler(ControlHandler handler) { controlHandler_ = std::move(handler); }
     void setBridgeVersion(const String &version);
-    void pause(bool paused);
+    void setPaused(bool paused);
+    bool isEnabled() const { return config_.mqttEnabled; }
+    // Only a partly collected aggregated poll cycle is dropped; the QoS 1
+    // queue keeps everything that was already handed to it.
+    void clearPendingData()
+    {
+        aggregate_.clear();
+        binaryFrame_.clear();
+    }
     static void SendPortalForm(WiFiPortalService &portal, const String &message = String());
     static bool HandlePortalPost(WebServer &server,
                                  AppConfig &config,
@@ -39,7 +64,22 @@ public:
                                  String &message);
 
 private:
+    enum class ConnectState : uint8_t
+    {
+        Idle,
+        Connecting,
+        Succeeded,
+        Failed,
+    };
+
+    bool clientReady();
     bool ensureConnected();
+    void startConnect();
+    static void connectTaskThunk(void *param);
+    void runConnect();
+    bool finishConnect();
+    bool connectRunning() const { return connectState_.load() == ConnectState::Connecting; }
+    void discardFinishedConnect();
     void refreshTopics();
     void publishDiscovery();
     bool publishDiscoveryEntity(DeviceManager::CommandType type,
@@ -54,18 +94,37 @@ private:
                                 const char *icon = nullptr,
                                 const char *entityCategory = nullptr,
                                 const char *leafOverride = nullptr);
-    String buildTopic(const String &leaf) const;
-    String commandLeaf(DeviceManager::CommandType type) const;
+    const String &commandTopic(DeviceManager::CommandType type);
+    static const char *commandLeaf(DeviceManager::CommandType type);
     String makeSlug(const String &raw) const;
     String sanitizedDeviceId() const;
-    bool publish(const String &leaf, const String &payload, bool retain = true);
+    bool publish(const String &topic, const char *payload, bool retain = true);
+    bool publish(const String &topic, const uint8_t *payload, size_t length, bool retain);
     bool publishCommand(DeviceManager::CommandType type, const String &payload, bool retain = true);
     String deviceNameForDiscovery() const;
     String deviceModelForDiscovery() const;
     void markAllPending();
     void republishRetained();
     bool publishVersionDiscovery();
+    void buildDeviceDiscovery();
+    bool publishDeviceDiscovery();
     bool publishBridgeVersion();
+    static const char *aggregatedLeaf(DeviceManager::CommandType type);
+    void collectAggregate(DeviceManager::CommandType type, const char *leaf, const String &value, bool changed);
+    void flushAggregate();
+    static bool binaryField(DeviceManager::CommandType type, MqttBinaryFrame::Field &field);
+    void collectBinary(DeviceManager::CommandType type, const String &value, bool changed);
+    void flushBinary();
+    const String &slotTopic(uint8_t slot);
+    bool enqueue(uint8_t slot, const char *payload, size_t length, bool retain);
+    bool loadNextQueued();
+    void serviceQueue();
+    void applyDeadbandConfig();
+    void resetDeadbandFilters();
+    bool passesDeadband(DeviceManager::CommandType type, const String &value);
+    void onControlMessage(const char *topic, const uint8_t *payload, unsigned int length);
+    void syncControlSubscription();
+    void handleControl();
     struct RetainedState
     {
         DeviceManager::CommandType type;
@@ -78,6 +137,8 @@ private:
     AppConfig &config_;
     Print &log_;
     WiFiClient wifi_client_;
+    MqttTlsClient tls_client_;
+    MqttAckTapClient ack_tap_;
     PubSubClient mqtt_client_;
 
     String currentHost_;
@@ -87,15 +148,28 @@ private:
     String clientIdBase_;
     String topicTemplate_;
     String fullTopicTemplate_;
+    bool currentTls_ = false;
+    String currentTlsCa_;
+    String currentTlsFingerprint_;
     bool configValid_ = false;
     bool topicDirty_ = true;
     unsigned long lastReconnectAttempt_ = 0;
+    // Written by the connect task, polled by the loop. Connecting means the
+    // task is running and owns the client.
+    std::atomic<ConnectState> connectState_{ConnectState::Idle};
+    std::atomic<int> connectResult_{0};
+    String connectClientId_;
+    unsigned long connectStartedMs_ = 0;
     unsigned long lastPublishWarning_ = 0;
     String deviceId_;
     String deviceSlug_;
     String fallbackId_;
-    String topicBase_;
-    String fullTopicPattern_;
+    static constexpr size_t kCommandTypeCount = static_cast<size_t>(DeviceManager::CommandType::Generic) + 1;
+    String topicPrefix_;
+    std::array<String, kCommandTypeCount> commandTopics_;
+    String stateTopic_;
+    String binaryTopic_;
+    String bridgeVersionTopic_;
     std::function<void(bool)> publishCallback_;
     String currentDeviceName_;
     String deviceModel_;
@@ -105,11 +179,82 @@ private:
     unsigned long lastDiscoveryAttempt_ = 0;
     unsigned long lastRepublishAttempt_ = 0;
     size_t discoveryIndex_ = 0;
+    bool deviceDiscovery_ = false;
+    bool deviceDiscoveryDirty_ = true;
+    String deviceDiscoveryTopic_;
+    String deviceDiscoveryPayload_;
     static const std::array<DeviceManager::CommandType, 15> kRetainedTypes_;
     std::array<RetainedState, kRetainedTypes_.size()> retainedStates_;
     LedController &led_;
+    PublisherHealth &health_;
     String bridgeVersion_;
     bool bridgeVersionDirty_ = true;
     bool versionDiscoveryDone_ = false;
     bool paused_ = false;
+    bool aggregateMode_ = false;
+    MqttStateAggregate aggregate_;
+    unsigned long aggregateStartedMs_ = 0;
+    char aggregatePayload_[MqttStateAggregate::kMaxPayloadBytes];
+    size_t aggregatePayloadLength_ = 0;
+    bool aggregatePending_ = false;
+
+    // Same poll cycle as the aggregate, kept separately so both encodings
+    // can be enabled at once. The sequence counts frames built since boot.
+    bool binaryMode_ = false;
+    MqttBinaryFrame binaryFrame_;
+    unsigned long binaryStartedMs_ = 0;
+    bool binaryChanged_ = false;
+    uint32_t binarySequence_ = 0;
+
+    // Topic slots are CommandType indices plus the aggregated state and
+    // binary frame topics.
+    static constexpr uint8_t kStateSlot = static_cast<uint8_t>(kCommandTypeCount);
+    static constexpr uint8_t kBinarySlot = kStateSlot + 1;
+    static constexpr size_t kPacketBytes = 800;
+    bool queueMode_ = false;
+    MqttOutboundQueue queue_;
+    MqttSpool spool_;
+    char spoolPayload_[MqttOutboundQueue::kMaxPayloadBytes];
+    // The message awaiting PUBACK, kept as the encoded PUBLISH packet.
+    uint8_t inflightPacket_[kPacketBytes];
+    size_t inflightLength_ = 0;
+    uint16_t inflightPacketId_ = 0;
+    bool inflightSent_ = false;
+    bool inflightFromSpool_ = false;
+    unsigned long inflightSentMs_ = 0;
+    uint16_t nextPacketId_ = 1;
+    unsigned long lastQueueSendMs_ = 0;
+    size_t queueDropped_ = 0;
+    unsigned long lastDropLogMs_ = 0;
+
+    // Change filters for the polled metrics. Dose rate and battery percent
+    // are derived from rate and voltage and follow their decision.
+    bool deadbandEnabled_ = false;
+    uint32_t heartbeatSeconds_ = 0;
+    String rateDeadbandText_;
+    String countDeadbandText_;
+    String batteryDeadbandText_;
+    DeadbandSpec rateDeadband_;
+    DeadbandSpec countDeadband_;
+    DeadbandSpec batteryDeadband_;
+    DeadbandFilter powerFilter_;
+    DeadbandFilter rateFilter_;
+    DeadbandFilter countFilter_;
+    DeadbandFilter batteryFilter_;
+    bool rateHeld_ = false;
+    bool batteryHeld_ = false;
+    bool aggregateChanged_ = false;
+
+    // cmnd/<topic>/# control requests; one is buffered between loop passes
+    // because PubSubClient reuses its buffer for the next publish.
+    ControlHandler controlHandler_;
+    bool controlEnabled_ = false;
+    String controlPrefix_;
+    String controlFilter_;
+    String controlResultTopic_;
+    String subscribedFilter_;
+    bool controlPending_ = false;
+    String controlCommand_;
+    uint8_t controlPayload_[MqttControlRequest::kMaxPayloadLength];
+    size_t controlPayloadLength_ = 0;
 };
@@ -0,0 +1,172 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// The QoS 1 pieces PubSubClient lacks: an encoder for PUBLISH packets with a
+// packet identifier, and a framer that follows the inbound byte stream and
+// picks out PUBACKs. PubSubClient reads and discards PUBACK packets itself, so
+// the framer is fed from a client wrapper that sees every byte it reads.
+namespace MqttQos1
+{
+static constexpr uint8_t kPublish = 0x30;
+static constexpr uint8_t kPubAck = 0x40;
+static constexpr uint8_t kFlagDup = 0x08;
+static constexpr uint8_t kFlagQos1 = 0x02;
+static constexpr uint8_t kFlagRetain = 0x01;
+
+// Writes the fixed header, topic and packet identifier of a QoS 1 PUBLISH
+// whose payload follows directly. Returns the header length, or 0 if it does
+// not fit into capacity.
+inline size_t encodePublishHeader(uint8_t *out,
+                                  size_t capacity,
+                                  const char *topic,
+                                  uint16_t packetId,
+                                  size_t payloadLength,
+                                  bool retain,
+                                  bool dup)
+{
+    if (!out || !topic || !packetId)
+        return 0;
+    const size_t topicLength = std::strlen(topic);
+    if (!topicLength || topicLength > 0xFFFF)
+        return 0;
+
+    size_t remaining = 2 + topicLength + 2 + payloadLength;
+    if (remaining > 268435455u)
+        return 0;
+
+    uint8_t lengthBytes[4];
+    size_t lengthCount = 0;
+    do
+    {
+        uint8_t digit = static_cast<uint8_t>(remaining % 128);
+        remaining /= 128;
+        if (remaining)
+            digit |= 0x80;
+        lengthBytes[lengthCount++] = digit;
+    } while (remaining);
+
+    const size_t headerLength = 1 + lengthCount + 2 + topicLength + 2;
+    if (headerLength > capacity)
+        return 0;
+
+    size_t pos = 0;
+    out[pos++] = static_cast<uint8_t>(kPublish | kFlagQos1 | (retain ? kFlagRetain : 0) | (dup ? kFlagDup : 0));
+    std::memcpy(out + pos, lengthBytes, lengthCount);
+    pos += lengthCount;
+    out[pos++] = static_cast<uint8_t>(topicLength >> 8);
+    out[pos++] = static_cast<uint8_t>(topicLength & 0xFF);
+    std::memcpy(out + pos, topic, topicLength);
+    pos += topicLength;
+    out[pos++] = static_cast<uint8_t>(packetId >> 8);
+    out[pos++] = static_cast<uint8_t>(packetId & 0xFF);
+    return pos;
+}
+
+class InboundFramer
+{
+public:
+    static constexpr size_t kAckSlots = 8;
+
+    void reset()
+    {
+        state_ = State::Header;
+        ackHead_ = 0;
+        ackCount_ = 0;
+    }
+
+    void feed(const uint8_t *data, size_t length)
+    {
+        for (size_t i = 0; i < length; ++i)
+            feed(data[i]);
+    }
+
+    void feed(uint8_t byte)
+    {
+        switch (state_)
+        {
+        case State::Header:
+            type_ = byte & 0xF0;
+            remaining_ = 0;
+            multiplier_ = 1;
+            bodyPos_ = 0;
+            state_ = State::Length;
+            break;
+        case State::Length:
+            remaining_ += static_cast<uint32_t>(byte & 0x7F) * multiplier_;
+            multiplier_ *= 128;
+            if (byte & 0x80)
+            {
+                // More than four length bytes is a protocol error; resync.
+                if (multiplier_ > 128UL * 128UL * 128UL)
+                    state_ = State::Header;
+                break;
+            }
+            if (remaining_ == 0)
+                state_ = State::Header;
+            else
+                state_ = State::Body;
+            break;
+        case State::Body:
+            if (type_ == kPubAck && bodyPos_ < 2)
+                idBytes_[bodyPos_] = byte;
+            ++bodyPos_;
+            if (bodyPos_ >= remaining_)
+            {
+                if (type_ == kPubAck && remaining_ == 2)
+                    pushAck(static_cast<uint16_t>((idBytes_[0] << 8) | idBytes_[1]));
+                state_ = State::Header;
+            }
+            break;
+        }
+    }
+
+    // Oldest PUBACK identifier not taken yet.
+    bool takeAck(uint16_t &packetId)
+    {
+        if (!ackCount_)
+            return false;
+        packetId = acks_[ackHead_];
+        ackHead_ = (ackHead_ + 1) % kAckSlots;
+        --ackCount_;
+        return true;
+    }
+
+private:
+    enum class State : uint8_t
+    {
+        Header,
+        Length,
+        Body,
+    };
+
+    void pushAck(uint16_t packetId)
+    {
+        if (ackCount_ == kAckSlots)
+        {
+            ackHead_ = (ackHead_ + 1) % kAckSlots;
+            --ackCount_;
+        }
+        acks_[(ackHead_ + ackCount_) % kAckSlots] = packetId;
+        ++ackCount_;
+    }
+
+    State state_ = State::Header;
+    uint8_t type_ = 0;
+    uint32_t remaining_ = 0;
+    uint32_t multiplier_ = 1;
+    uint32_t bodyPos_ = 0;
+    uint8_t idBytes_[2] = {};
+    uint16_t acks_[kAckSlots] = {};
+    size_t ackHead_ = 0;
+    size_t ackCount_ = 0;
+};
+} // namespace MqttQos1
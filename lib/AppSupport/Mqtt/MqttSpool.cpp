@@ -0,0 +1,152 @@
+// SPDX-FileCopyrightText: 2026 André Fiedler
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "Mqtt/MqttSpool.h"
+
+#include <LittleFS.h>
+
+namespace
+{
+    constexpr uint8_t kRecordMagic = 0xA5;
+    constexpr uint8_t kFlagRetain = 0x01;
+    constexpr size_t kRecordHeaderBytes = 5;
+}
+
+void MqttSpool::begin()
+{
+    readOffset_ = 0;
+    ackedOffset_ = 0;
+    fileSize_ = 0;
+    uncommitted_ = 0;
+    File file = LittleFS.open(kPath, "r");
+    if (!file)
+        return;
+    fileSize_ = file.size();
+    file.close();
+
+    File offset = LittleFS.open(kOffsetPath, "r");
+    if (offset)
+    {
+        uint8_t bytes[4] = {};
+        if (offset.read(bytes, sizeof(bytes)) == sizeof(bytes))
+        {
+            const size_t saved = (static_cast<size_t>(bytes[0]) << 24) | (static_cast<size_t>(bytes[1]) << 16) |
+                                 (static_cast<size_t>(bytes[2]) << 8) | bytes[3];
+            // take() discards the spool if this is not a record boundary.
+            if (saved <= fileSize_)
+                readOffset_ = ackedOffset_ = saved;
+        }
+        offset.close();
+    }
+
+    if (empty())
+    {
+        clear();
+        return;
+    }
+    log_.print("MQTT spool holds ");
+    log_.print(static_cast<unsigned long>(pendingBytes()));
+    log_.println(" bytes; replaying after connect.");
+}
+
+bool MqttSpool::append(uint8_t slot, const char *payload, size_t length, bool retain)
+{
+    if (!payload || length > 0xFFFF)
+        return false;
+    if (fileSize_ + kRecordHeaderBytes + length > kMaxBytes)
+        return false;
+
+    File file = LittleFS.open(kPath, "a");
+    if (!file)
+        return false;
+
+    uint8_t header[kRecordHeaderBytes] = {kRecordMagic,
+                                          slot,
+                                          static_cast<uint8_t>(retain ? kFlagRetain : 0),
+                                          static_cast<uint8_t>(length >> 8),
+                                          static_cast<uint8_t>(length & 0xFF)};
+    size_t written = file.write(header, sizeof(header));
+    written += file.write(reinterpret_cast<const uint8_t *>(payload), length);
+    file.close();
+    if (written != sizeof(header) + length)
+    {
+        // A torn record would poison every later read; start over.
+        log_.println("MQTT spool write failed; spool discarded.");
+        clear();
+        return false;
+    }
+    fileSize_ += written;
+    return true;
+}
+
+bool MqttSpool::take(uint8_t &slot, bool &retain, char *payload, size_t capacity, size_t &length)
+{
+    if (empty())
+        return false;
+
+    File file = LittleFS.open(kPath, "r");
+    if (!file || !file.seek(readOffset_))
+    {
+        clear();
+        return false;
+    }
+
+    uint8_t header[kRecordHeaderBytes];
+    bool ok = file.read(header, sizeof(header)) == sizeof(header) && header[0] == kRecordMagic;
+    length = ok ? (static_cast<size_t>(header[3]) << 8) | header[4] : 0;
+    ok = ok && length <= capacity &&
+         file.read(reinterpret_cast<uint8_t *>(payload), length) == length;
+    file.close();
+    if (!ok)
+    {
+        log_.println("MQTT spool record unreadable; spool discarded.");
+        clear();
+        return false;
+    }
+
+    slot = header[1];
+    retain = (header[2] & kFlagRetain) != 0;
+    readOffset_ += kRecordHeaderBytes + length;
+    return true;
+}
+
+void MqttSpool::commit()
+{
+    if (ackedOffset_ == readOffset_)
+        return;
+    ackedOffset_ = readOffset_;
+    if (ackedOffset_ >= fileSize_)
+    {
+        // The final record is delivered; only now may the file go.
+        clear();
+        return;
+    }
+    if (++uncommitted_ < kCommitEvery)
+        return;
+    uncommitted_ = 0;
+    saveAckedOffset();
+}
+
+void MqttSpool::saveAckedOffset()
+{
+    File file = LittleFS.open(kOffsetPath, "w");
+    if (!file)
+        return;
+    const uint8_t bytes[4] = {static_cast<uint8_t>(ackedOffset_ >> 24),
+                              static_cast<uint8_t>(ackedOffset_ >> 16),
+                              static_cast<uint8_t>(ackedOffset_ >> 8),
+                              static_cast<uint8_t>(ackedOffset_ & 0xFF)};
+    file.write(bytes, sizeof(bytes));
+    file.close();
+}
+
+void MqttSpool::clear()
+{
+    LittleFS.remove(kPath);
+    LittleFS.remove(kOffsetPath);
+    fileSize_ = 0;
+    readOffset_ = 0;
+    ackedOffset_ = 0;
+    uncommitted_ = 0;
+}
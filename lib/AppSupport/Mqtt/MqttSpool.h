@@ -0,0 +1,49 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+// Append-only LittleFS file that takes the oldest queued MQTT messages when
+// the RAM queue is full. Records are read back in order. A taken record
+// stays in the file until commit() reports the broker's ack, so a reboot in
+// between replays it; the file is removed once the last record is acked.
+// The acknowledged offset is saved to kOffsetPath every kCommitEvery acks,
+// so a reboot replays at most that many delivered messages (QoS 1 is
+// at-least-once anyway).
+class MqttSpool
+{
+public:
+    static constexpr const char *kPath = "/mqtt-spool.bin";
+    static constexpr const char *kOffsetPath = "/mqtt-spool.pos";
+    static constexpr size_t kMaxBytes = 64 * 1024;
+    static constexpr uint8_t kCommitEvery = 16;
+
+    explicit MqttSpool(Print &log) : log_(log) {}
+
+    void begin();
+    bool append(uint8_t slot, const char *payload, size_t length, bool retain);
+    // Reads the oldest record not taken yet into payload.
+    bool take(uint8_t &slot, bool &retain, char *payload, size_t capacity, size_t &length);
+    // Every record taken so far was acknowledged by the broker.
+    void commit();
+    // Records taken but not acknowledged are taken again.
+    void rewind() { readOffset_ = ackedOffset_; }
+    void clear();
+    // Nothing left to take; taken records may still await their ack.
+    bool empty() const { return readOffset_ >= fileSize_; }
+    size_t pendingBytes() const { return empty() ? 0 : fileSize_ - readOffset_; }
+
+private:
+    void saveAckedOffset();
+
+    Print &log_;
+    size_t fileSize_ = 0;
+    size_t readOffset_ = 0;
+    size_t ackedOffset_ = 0;
+    uint8_t uncommitted_ = 0;
+};
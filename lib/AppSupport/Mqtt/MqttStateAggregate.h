@@ -0,0 +1,209 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Collects one poll cycle of leaf values and renders them as a single compact
+// JSON object, e.g. {"ts":1760000000,"tubeRate":42.5,"devicePower":"ON"}.
+// Leaf names must be string literals; values are copied into fixed slots so a
+// cycle never touches the heap until it is published.
+class MqttStateAggregate
+{
+public:
+    static constexpr size_t kMaxFields = 8;
+    static constexpr size_t kMaxValueBytes = 24;
+    static constexpr size_t kMaxPayloadBytes = 320;
+
+    static bool isJsonNumber(const char *text)
+    {
+        if (!text || !*text)
+            return false;
+        const char *p = text;
+        if (*p == '-')
+            ++p;
+        if (*p == '0')
+        {
+            ++p;
+        }
+        else if (*p >= '1' && *p <= '9')
+        {
+            while (*p >= '0' && *p <= '9')
+                ++p;
+        }
+        else
+        {
+            return false;
+        }
+        if (*p == '.')
+        {
+            ++p;
+            if (*p < '0' || *p > '9')
+                return false;
+            while (*p >= '0' && *p <= '9')
+                ++p;
+        }
+        if (*p == 'e' || *p == 'E')
+        {
+            ++p;
+            if (*p == '+' || *p == '-')
+                ++p;
+            if (*p < '0' || *p > '9')
+                return false;
+            while (*p >= '0' && *p <= '9')
+                ++p;
+        }
+        return *p == '\0';
+    }
+
+    bool has(const char *leaf) const
+    {
+        return find(leaf) != nullptr;
+    }
+
+    // Stores or replaces a value. Values longer than kMaxValueBytes - 1 and
+    // fields beyond kMaxFields are rejected.
+    bool set(const char *leaf, const char *value)
+    {
+        if (!leaf || !*leaf || !value)
+            return false;
+        const size_t length = std::strlen(value);
+        if (length >= kMaxValueBytes)
+            return false;
+
+        Field *field = find(leaf);
+        if (!field)
+        {
+            if (count_ >= kMaxFields)
+                return false;
+            field = &fields_[count_++];
+            field->leaf = leaf;
+        }
+        std::memcpy(field->value, value, length + 1);
+        return true;
+    }
+
+    void clear() { count_ = 0; }
+    bool empty() const { return count_ == 0; }
+    size_t fieldCount() const { return count_; }
+
+    // Writes the object in insertion order. timestamp is omitted when 0 (clock
+    // not yet set). Returns the length without terminator, or 0 if it does
+    // not fit into capacity.
+    size_t serialize(char *out, size_t capacity, uint32_t timestamp) const
+    {
+        if (!out || !capacity)
+            return 0;
+        Writer writer{out, capacity, 0, false};
+        writer.put('{');
+        bool first = true;
+        if (timestamp)
+        {
+            writer.put("\"ts\":");
+            writer.putUnsigned(timestamp);
+            first = false;
+        }
+        for (size_t i = 0; i < count_; ++i)
+        {
+            if (!first)
+                writer.put(',');
+            first = false;
+            writer.putQuoted(fields_[i].leaf);
+            writer.put(':');
+            if (isJsonNumber(fields_[i].value))
+                writer.put(fields_[i].value);
+            else
+                writer.putQuoted(fields_[i].value);
+        }
+        writer.put('}');
+        if (writer.overflow || writer.length >= capacity)
+            return 0;
+        out[writer.length] = '\0';
+        return writer.length;
+    }
+
+private:
+    struct Field
+    {
+        const char *leaf;
+        char value[kMaxValueBytes];
+    };
+
+    struct Writer
+    {
+        char *out;
+        size_t capacity;
+        size_t length;
+        bool overflow;
+
+        void put(char c)
+        {
+            if (length + 1 >= capacity)
+            {
+                overflow = true;
+                return;
+            }
+            out[length++] = c;
+        }
+
+        void put(const char *text)
+        {
+            while (*text)
+                put(*text++);
+        }
+
+        void putUnsigned(uint32_t value)
+        {
+            char digits[10];
+            size_t n = 0;
+            do
+            {
+                digits[n++] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            } while (value);
+            while (n)
+                put(digits[--n]);
+        }
+
+        void putQuoted(const char *text)
+        {
+            put('"');
+            for (; *text; ++text)
+            {
+                const unsigned char c = static_cast<unsigned char>(*text);
+                if (c == '"' || c == '\\')
+                {
+                    put('\\');
+                    put(static_cast<char>(c));
+                }
+                else if (c >= 0x20)
+                {
+                    put(static_cast<char>(c));
+                }
+            }
+            put('"');
+        }
+    };
+
+    const Field *find(const char *leaf) const
+    {
+        for (size_t i = 0; i < count_; ++i)
+            if (std::strcmp(fields_[i].leaf, leaf) == 0)
+                return &fields_[i];
+        return nullptr;
+    }
+
+    Field *find(const char *leaf)
+    {
+        return const_cast<Field *>(static_cast<const MqttStateAggregate *>(this)->find(leaf));
+    }
+
+    Field fields_[kMaxFields];
+    size_t count_ = 0;
+};
@@ -0,0 +1,384 @@
+// SPDX-FileCopyrightText: 2026 André Fiedler
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "Mqtt/MqttTlsClient.h"
+
+#include <lwip/sockets.h>
+#include <mbedtls/error.h>
+#include <mbedtls/sha256.h>
+#include <mbedtls/version.h>
+
+namespace
+{
+    constexpr uint32_t kHandshakeTimeoutMs = 10000;
+    // Longest a single write() waits for the socket; the rest is staged.
+    constexpr unsigned long kWriteWaitMs = 5;
+    constexpr const char *kDrbgPersonalization = "radpro-mqtt";
+
+    void sha256(const unsigned char *data, size_t length, uint8_t *digest)
+    {
+#if MBEDTLS_VERSION_NUMBER >= 0x03000000
+        mbedtls_sha256(data, length, digest, 0);
+#else
+        mbedtls_sha256_ret(data, length, digest, 0);
+#endif
+    }
+
+    bool wouldBlock(int ret)
+    {
+        return ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE;
+    }
+}
+
+MqttTlsClient::MqttTlsClient()
+{
+    mbedtls_ssl_session_init(&session_);
+}
+
+MqttTlsClient::~MqttTlsClient()
+{
+    stop();
+    mbedtls_ssl_session_free(&session_);
+}
+
+bool MqttTlsClient::setTrustAnchors(const String &caPem, const String &fingerprint)
+{
+    caPem_ = caPem;
+    caPem_.trim();
+    bool empty = false;
+    hasFingerprint_ = TlsFingerprint::parse(fingerprint.c_str(), fingerprint_, &empty);
+    forgetSession();
+    return hasFingerprint_ || empty;
+}
+
+void MqttTlsClient::forgetSession()
+{
+    mbedtls_ssl_session_free(&session_);
+    mbedtls_ssl_session_init(&session_);
+    hasSession_ = false;
+    sessionHost_ = String();
+    sessionPort_ = 0;
+}
+
+int MqttTlsClient::connect(IPAddress ip, uint16_t port)
+{
+    return connect(ip.toString().c_str(), port);
+}
+
+int MqttTlsClient::connect(const char *host, uint16_t port)
+{
+    stop();
+    lastError_[0] = '\0';
+    lastConnectMs_ = 0;
+    lastHandshakeMs_ = 0;
+    lastResumed_ = false;
+    certificateSeen_ = false;
+
+    if (!caPem_.length() && !hasFingerprint_)
+    {
+        snprintf(lastError_, sizeof(lastError_), "%s", "no CA certificate or fingerprint configured");
+        return 0;
+    }
+
+    mbedtls_net_init(&net_);
+    mbedtls_ssl_init(&ssl_);
+    mbedtls_ssl_config_init(&conf_);
+    mbedtls_x509_crt_init(&ca_);
+    mbedtls_entropy_init(&entropy_);
+    mbedtls_ctr_drbg_init(&drbg_);
+    contextReady_ = true;
+
+    int ret = mbedtls_ctr_drbg_seed(&drbg_,
+                                    mbedtls_entropy_func,
+                                    &entropy_,
+                                    reinterpret_cast<const unsigned char *>(kDrbgPersonalization),
+                                    strlen(kDrbgPersonalization));
+    if (ret != 0)
+        return fail("rng", ret);
+
+    if (caPem_.length())
+    {
+        ret = mbedtls_x509_crt_parse(&ca_,
+                                     reinterpret_cast<const unsigned char *>(caPem_.c_str()),
+                                     caPem_.length() + 1);
+        if (ret != 0)
+            return fail("CA certificate", ret);
+    }
+
+    unsigned long started = millis();
+    char portText[6];
+    snprintf(portText, sizeof(portText), "%u", static_cast<unsigned>(port));
+    ret = mbedtls_net_connect(&net_, host, portText, MBEDTLS_NET_PROTO_TCP);
+    if (ret != 0)
+        return fail("connect", ret);
+    lastConnectMs_ = millis() - started;
+    int noDelay = 1;
+    setsockopt(net_.fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+    ret = mbedtls_ssl_config_defaults(&conf_,
+                                      MBEDTLS_SSL_IS_CLIENT,
+                                      MBEDTLS_SSL_TRANSPORT_STREAM,
+                                      MBEDTLS_SSL_PRESET_DEFAULT);
+    if (ret != 0)
+        return fail("config", ret);
+    // The verify result is checked after the handshake so a fingerprint pin
+    // can stand in for a CA; OPTIONAL still runs the full chain check.
+    mbedtls_ssl_conf_authmode(&conf_, MBEDTLS_SSL_VERIFY_OPTIONAL);
+    if (caPem_.length())
+        mbedtls_ssl_conf_ca_chain(&conf_, &ca_, nullptr);
+    mbedtls_ssl_conf_verify(&conf_, &MqttTlsClient::verifyCertificate, this);
+    mbedtls_ssl_conf_rng(&conf_, mbedtls_ctr_drbg_random, &drbg_);
+    mbedtls_ssl_conf_read_timeout(&conf_, kHandshakeTimeoutMs);
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+    mbedtls_ssl_conf_session_tickets(&conf_, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+#endif
+
+    ret = mbedtls_ssl_setup(&ssl_, &conf_);
+    if (ret != 0)
+        return fail("setup", ret);
+    ret = mbedtls_ssl_set_hostname(&ssl_, host);
+    if (ret != 0)
+        return fail("hostname", ret);
+    mbedtls_ssl_set_bio(&ssl_, &net_, mbedtls_net_send, nullptr, mbedtls_net_recv_timeout);
+
+    bool offered = hasSession_ && sessionPort_ == port && sessionHost_ == host &&
+                   mbedtls_ssl_set_session(&ssl_, &session_) == 0;
+
+    unsigned long handshakeStarted = millis();
+    while ((ret = mbedtls_ssl_handshake(&ssl_)) != 0)
+    {
+        if (!wouldBlock(ret) || millis() - handshakeStarted > kHandshakeTimeoutMs)
+        {
+            // A rejected resumption must not poison the next attempt.
+            forgetSession();
+            return fail("handshake", ret);
+        }
+        delay(1);
+    }
+    lastHandshakeMs_ = millis() - handshakeStarted;
+
+    if (mbedtls_ssl_get_verify_result(&ssl_) != 0)
+    {
+        forgetSession();
+        return fail("certificate not trusted", 0);
+    }
+
+    // The verify callback only runs when the server sent its certificate,
+    // i.e. on a full handshake.
+    lastResumed_ = offered && !certificateSeen_;
+
+    mbedtls_ssl_session_free(&session_);
+    mbedtls_ssl_session_init(&session_);
+    hasSession_ = mbedtls_ssl_get_session(&ssl_, &session_) == 0;
+    if (hasSession_)
+    {
+        sessionHost_ = host;
+        sessionPort_ = port;
+    }
+
+    // From here on reads must not block the MQTT loop.
+    mbedtls_net_set_nonblock(&net_);
+    mbedtls_ssl_set_bio(&ssl_, &net_, mbedtls_net_send, mbedtls_net_recv, nullptr);
+    connected_ = true;
+    return 1;
+}
+
+int MqttTlsClient::verifyCertificate(void *context, mbedtls_x509_crt *certificate, int depth, uint32_t *flags)
+{
+    MqttTlsClient *self = static_cast<MqttTlsClient *>(context);
+    self->certificateSeen_ = true;
+    if (!self->hasFingerprint_)
+        return 0;
+
+    if (depth > 0)
+    {
+        // Without a CA the pinned leaf is the trust anchor; the chain above
+        // it does not matter.
+        if (!self->caPem_.length())
+            *flags = 0;
+        return 0;
+    }
+
+    uint8_t digest[TlsFingerprint::kBytes];
+    sha256(certificate->raw.p, certificate->raw.len, digest);
+    if (memcmp(digest, self->fingerprint_, sizeof(digest)) != 0)
+        *flags |= MBEDTLS_X509_BADCERT_NOT_TRUSTED;
+    else if (!self->caPem_.length())
+        *flags = 0;
+    return 0;
+}
+
+size_t MqttTlsClient::write(uint8_t value)
+{
+    return write(&value, 1);
+}
+
+size_t MqttTlsClient::write(const uint8_t *buffer, size_t size)
+{
+    if (!connected_ || !buffer)
+        return 0;
+
+    // PubSubClient treats a short write as a failed packet, so whatever the
+    // socket does not take within kWriteWaitMs is staged and sent from later
+    // calls. Only a full staging buffer shortens the write.
+    size_t accepted = kStagedBytes - stagedLength_;
+    if (accepted > size)
+        accepted = size;
+    memcpy(staged_ + stagedLength_, buffer, accepted);
+    stagedLength_ += accepted;
+    if (!sendStaged(kWriteWaitMs))
+        return 0;
+    return accepted;
+}
+
+bool MqttTlsClient::sendStaged(unsigned long waitMs)
+{
+    unsigned long started = millis();
+    while (connected_ && stagedLength_)
+    {
+        // After WANT_WRITE mbedTLS must be called again with the same length.
+        size_t chunk = retryLength_ ? retryLength_ : stagedLength_;
+        int ret = mbedtls_ssl_write(&ssl_, staged_, chunk);
+        if (ret > 0)
+        {
+            size_t sent = static_cast<size_t>(ret);
+            stagedLength_ -= sent;
+            memmove(staged_, staged_ + sent, stagedLength_);
+            retryLength_ = 0;
+            continue;
+        }
+        if (!wouldBlock(ret))
+        {
+            fail("write", ret);
+            return false;
+        }
+        retryLength_ = chunk;
+        if (millis() - started >= waitMs)
+            break;
+        delay(1);
+    }
+    return connected_;
+}
+
+bool MqttTlsClient::pumpRecord()
+{
+    // Reading one byte processes pending records (alerts, close_notify) and
+    // keeps it for the next read().
+    uint8_t value = 0;
+    int ret = mbedtls_ssl_read(&ssl_, &value, 1);
+    if (ret > 0)
+    {
+        peeked_ = value;
+        return true;
+    }
+    if (wouldBlock(ret))
+        return true;
+    if (ret == 0 || ret == MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY)
+    {
+        stop();
+        return false;
+    }
+    fail("read", ret);
+    return false;
+}
+
+int MqttTlsClient::available()
+{
+    if (!connected_)
+        return peeked_ >= 0 ? 1 : 0;
+    if (peeked_ < 0 && !mbedtls_ssl_get_bytes_avail(&ssl_) && !pumpRecord())
+        return 0;
+    return (peeked_ >= 0 ? 1 : 0) + static_cast<int>(mbedtls_ssl_get_bytes_avail(&ssl_));
+}
+
+int MqttTlsClient::read()
+{
+    uint8_t value = 0;
+    return read(&value, 1) == 1 ? value : -1;
+}
+
+int MqttTlsClient::read(uint8_t *buffer, size_t size)
+{
+    if (!buffer || !size)
+        return 0;
+
+    int count = 0;
+    if (peeked_ >= 0)
+    {
+        buffer[count++] = static_cast<uint8_t>(peeked_);
+        peeked_ = -1;
+        if (--size == 0)
+            return count;
+    }
+    if (!connected_)
+        return count ? count : -1;
+
+    int ret = mbedtls_ssl_read(&ssl_, buffer + count, size);
+    if (ret > 0)
+        return count + ret;
+    if (ret == 0 || ret == MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY)
+        stop();
+    else if (!wouldBlock(ret))
+        fail("read", ret);
+    return count ? count : -1;
+}
+
+int MqttTlsClient::peek()
+{
+    if (peeked_ < 0)
+    {
+        uint8_t value = 0;
+        if (read(&value, 1) != 1)
+            return -1;
+        peeked_ = value;
+    }
+    return peeked_;
+}
+
+void MqttTlsClient::stop()
+{
+    if (connected_)
+        mbedtls_ssl_close_notify(&ssl_);
+    release();
+}
+
+uint8_t MqttTlsClient::connected()
+{
+    if (connected_ && stagedLength_)
+        sendStaged(0);
+    if (connected_ && peeked_ < 0 && !mbedtls_ssl_get_bytes_avail(&ssl_))
+        pumpRecord();
+    return connected_ ? 1 : 0;
+}
+
+int MqttTlsClient::fail(const char *context, int ret)
+{
+    int written = snprintf(lastError_, sizeof(lastError_), "%s", context);
+    if (ret != 0 && written > 0 && static_cast<size_t>(written) < sizeof(lastError_) - 2)
+    {
+        size_t used = static_cast<size_t>(written);
+        lastError_[used++] = ':';
+        lastError_[used++] = ' ';
+        mbedtls_strerror(ret, lastError_ + used, sizeof(lastError_) - used);
+    }
+    release();
+    return 0;
+}
+
+void MqttTlsClient::release()
+{
+    connected_ = false;
+    peeked_ = -1;
+    stagedLength_ = 0;
+    retryLength_ = 0;
+    if (!contextReady_)
+        return;
+    mbedtls_ssl_free(&ssl_);
+    mbedtls_ssl_config_free(&conf_);
+    mbedtls_x509_crt_free(&ca_);
+    mbedtls_ctr_drbg_free(&drbg_);
+    mbedtls_entropy_free(&entropy_);
+    mbedtls_net_free(&net_);
+    contextReady_ = false;
+}
@@ -0,0 +1,95 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <Client.h>
+#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/entropy.h>
+#include <mbedtls/net_sockets.h>
+#include <mbedtls/ssl.h>
+#include <mbedtls/x509_crt.h>
+#include "Mqtt/TlsFingerprint.h"
+
+// TLS Client for the broker connection, built on mbedTLS directly because
+// WiFiClientSecure starts every connection with a full handshake. The session
+// negotiated by a successful handshake is kept and offered on the next
+// connect to the same host, so reconnects on a flaky link resume it instead
+// of repeating the certificate exchange.
+//
+// Trust comes from a pinned CA certificate (PEM), a pinned SHA-256
+// fingerprint of the broker certificate, or both; without either, connect()
+// refuses to run.
+class MqttTlsClient : public Client
+{
+public:
+    MqttTlsClient();
+    ~MqttTlsClient() override;
+
+    // Returns false if the fingerprint is set but malformed.
+    bool setTrustAnchors(const String &caPem, const String &fingerprint);
+    void forgetSession();
+
+    int connect(IPAddress ip, uint16_t port) override;
+    int connect(const char *host, uint16_t port) override;
+    size_t write(uint8_t value) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    int available() override;
+    int read() override;
+    int read(uint8_t *buffer, size_t size) override;
+    int peek() override;
+    void flush() override {}
+    void stop() override;
+    uint8_t connected() override;
+    operator bool() override { return connected_; }
+
+    // Timings of the last connect(); written by the connecting task and read
+    // once it has finished.
+    uint32_t lastConnectMs() const { return lastConnectMs_; }
+    uint32_t lastHandshakeMs() const { return lastHandshakeMs_; }
+    bool lastResumed() const { return lastResumed_; }
+    const char *lastError() const { return lastError_; }
+
+private:
+    static int verifyCertificate(void *context, mbedtls_x509_crt *certificate, int depth, uint32_t *flags);
+    int fail(const char *context, int ret);
+    void release();
+    bool pumpRecord();
+    bool sendStaged(unsigned long waitMs);
+
+    String caPem_;
+    uint8_t fingerprint_[TlsFingerprint::kBytes] = {};
+    bool hasFingerprint_ = false;
+
+    mbedtls_net_context net_;
+    mbedtls_ssl_context ssl_;
+    mbedtls_ssl_config conf_;
+    mbedtls_x509_crt ca_;
+    mbedtls_entropy_context entropy_;
+    mbedtls_ctr_drbg_context drbg_;
+    bool contextReady_ = false;
+    bool connected_ = false;
+    int peeked_ = -1;
+    bool certificateSeen_ = false;
+
+    // Encoded MQTT packets the socket has not taken yet; holds one full
+    // PubSubClient buffer plus a QoS 1 packet.
+    static constexpr size_t kStagedBytes = 2048;
+    uint8_t staged_[kStagedBytes];
+    size_t stagedLength_ = 0;
+    size_t retryLength_ = 0;
+
+    mbedtls_ssl_session session_;
+    bool hasSession_ = false;
+    String sessionHost_;
+    uint16_t sessionPort_ = 0;
+
+    uint32_t lastConnectMs_ = 0;
+    uint32_t lastHandshakeMs_ = 0;
+    bool lastResumed_ = false;
+    char lastError_[96] = {};
+};
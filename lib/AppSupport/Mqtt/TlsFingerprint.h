@@ -0,0 +1,65 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// SHA-256 certificate fingerprint as shown by browsers and
+// `openssl x509 -fingerprint -sha256`: 64 hex digits, optionally separated
+// by colons or spaces.
+namespace TlsFingerprint
+{
+static constexpr size_t kBytes = 32;
+// Longest accepted text: 32 byte pairs with a separator between each.
+static constexpr size_t kMaxTextLength = kBytes * 3 - 1;
+
+inline int hexValue(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+// Returns false unless text holds exactly 32 bytes. An empty text is
+// reported through empty so callers can treat it as "not configured".
+inline bool parse(const char *text, uint8_t (&out)[kBytes], bool *empty = nullptr)
+{
+    size_t count = 0;
+    int high = -1;
+    bool any = false;
+    for (const char *p = text; p && *p; ++p)
+    {
+        if (*p == ':' || *p == ' ')
+        {
+            if (high >= 0)
+                return false;
+            continue;
+        }
+        int value = hexValue(*p);
+        if (value < 0)
+            return false;
+        any = true;
+        if (high < 0)
+        {
+            high = value;
+            continue;
+        }
+        if (count == kBytes)
+            return false;
+        out[count++] = static_cast<uint8_t>((high << 4) | value);
+        high = -1;
+    }
+    if (empty)
+        *empty = !any;
+    return high < 0 && count == kBytes;
+}
+} // namespace TlsFingerprint
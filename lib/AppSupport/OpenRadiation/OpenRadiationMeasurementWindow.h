@@ -7,6 +7,8 @@
 #pragma once
 
 #include <Arduino.h>
+#include <array>
+#include <cstddef>
 
 namespace OpenRadiationMeasurementWindow
 {
@@ -50,4 +52,73 @@ inline void replaceMeasurementWindow(MeasurementWindowState &state,
     state.startTime = startTime;
     state.startPulseCount = startPulseCount;
 }
+
+// A measurement window that has ended and still has to be submitted. The
+// report UUID is fixed when the window closes so every retry reuses it.
+struct ClosedMeasurementWindow
+{
+    String startTime;
+    String endTime;
+    String startPulseCount;
+    String endPulseCount;
+    float doseRate = 0.0f;
+    String reportUuid;
+};
+
+// Bounded FIFO of closed windows, drained oldest first once the API is
+// reachable again. When full, the oldest window is overwritten.
+static constexpr size_t kBacklogCapacity = 12;
+
+struct MeasurementBacklog
+{
+    std::array<ClosedMeasurementWindow, kBacklogCapacity> windows;
+    size_t head = 0;
+    size_t count = 0;
+};
+
+inline bool hasClosedWindowUuid(const MeasurementBacklog &backlog, const String &reportUuid)
+{
+    for (size_t i = 0; i < backlog.count; ++i)
+    {
+        if (backlog.windows[(backlog.head + i) % kBacklogCapacity].reportUuid == reportUuid)
+            return true;
+    }
+    return false;
+}
+
+// Returns false when the window was not queued (no UUID or a duplicate).
+// droppedOldest reports whether a full backlog lost its oldest window.
+inline bool pushClosedWindow(MeasurementBacklog &backlog,
+                             const ClosedMeasurementWindow &window,
+                             bool &droppedOldest)
+{
+    droppedOldest = false;
+    if (!window.reportUuid.length() || hasClosedWindowUuid(backlog, window.reportUuid))
+        return false;
+
+    if (backlog.count == kBacklogCapacity)
+    {
+        backlog.head = (backlog.head + 1) % kBacklogCapacity;
+        backlog.count -= 1;
+        droppedOldest = true;
+    }
+
+    backlog.windows[(backlog.head + backlog.count) % kBacklogCapacity] = window;
+    backlog.count += 1;
+    return true;
+}
+
+inline const ClosedMeasurementWindow *oldestClosedWindow(const MeasurementBacklog &backlog)
+{
+    return backlog.count ? &backlog.windows[backlog.head] : nullptr;
+}
+
+inline void popOldestClosedWindow(MeasurementBacklog &backlog)
+{
+    if (!backlog.count)
+        return;
+    backlog.windows[backlog.head] = ClosedMeasurementWindow();
+    backlog.head = (backlog.head + 1) % kBacklogCapacity;
+    backlog.count -= 1;
+}
 } // namespace OpenRadiationMeasurementWindow
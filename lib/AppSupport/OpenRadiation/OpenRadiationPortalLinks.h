@@ -9,7 +9,7 @@
 #include <Arduino.h>
 
 #include <cmath>
-#include <cstdio>
+#include "Publishing/NumberFormat.h"
 
 namespace OpenRadiationPortalLinks
 {
@@ -28,11 +28,7 @@ inline String buildOpenRadiationMapUrl(float latitude, float longitude)
     if (!hasUsableCoordinates(latitude, longitude))
         return String();
 
-    char latBuffer[24];
-    char lonBuffer[24];
-    std::snprintf(latBuffer, sizeof(latBuffer), "%.6f", static_cast<double>(latitude));
-    std::snprintf(lonBuffer, sizeof(lonBuffer), "%.6f", static_cast<double>(longitude));
-
-    return String("https://request.openradiation.net/openradiation/14/") + latBuffer + "/" + lonBuffer;
+    return String("https://request.openradiation.net/openradiation/14/") +
+           NumberFormat::Fixed(latitude, 6).c_str() + "/" + NumberFormat::Fixed(longitude, 6).c_str();
 }
 } // namespace OpenRadiationPortalLinks
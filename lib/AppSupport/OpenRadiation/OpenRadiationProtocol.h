@@ -42,6 +42,21 @@ inline String buildMeasurementLookupPath(const String &reportUuid, const String
            "&response=complete&withEnclosedObject=no";
 }
 
+// Rejections of the measurement itself will not succeed on retry, e.g. a
+// report UUID the API already accepted. Everything else, including auth
+// failures, keeps the window queued.
+inline bool isPermanentRejection(int statusCode)
+{
+    return statusCode == 400 || statusCode == 409 || statusCode == 422;
+}
+
+// A wrong or expired API key: the measurement is fine, the user has to
+// fix the settings.
+inline bool isAuthFailure(int statusCode)
+{
+    return statusCode == 401 || statusCode == 403;
+}
+
 inline String buildOrganisationReporting(const String &bridgeVersion)
 {
     String value = "radpro-wifi-bridge";
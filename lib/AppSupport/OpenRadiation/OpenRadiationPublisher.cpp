@@ -14,6 +14,7 @@
 #include <esp_system.h>
 #include <cmath>
 #include "Publishing/HttpPublishResponse.h"
+#include "Publishing/PublishPhaseTimer.h"
 #include "Runtime/CooperativePump.h"
 
 namespace
@@ -22,6 +23,7 @@ namespace
     constexpr uint16_t kPort = 443;
     constexpr unsigned long kMinPublishGapMs = 60000;
     constexpr unsigned long kRetryBackoffMs = 120000;
+    constexpr unsigned long kBackfillGapMs = 5000;
     constexpr unsigned long kResponseWaitMs = 15000;
 }
 
@@ -66,11 +68,15 @@ void OpenRadiationPublisher::updateConfig()
 void OpenRadiationPublisher::loop()
 {
     syncHealthState();
+    if (paused_)
+        return;
     publishPending();
 }
 
 void OpenRadiationPublisher::clearPendingData()
 {
+    // Only the open window is dropped; closed windows in backlog_ are
+    // complete measurements and are still submitted later.
     pendingDoseValue_ = String();
     pendingTubeValue_ = String();
     OpenRadiationMeasurementWindow::clearMeasurementWindow(measurementWindow_);
@@ -78,11 +84,14 @@ void OpenRadiationPublisher::clearPendingData()
     haveTubeValue_ = false;
     publishQueued_ = false;
     suppressUntilMs_ = 0;
+    closeDeferredUntilMs_ = 0;
     syncHealthState();
 }
 
 void OpenRadiationPublisher::onCommandResult(DeviceManager::CommandType type, const String &value)
 {
+    if (paused_)
+        return;
     switch (type)
     {
     case DeviceManager::CommandType::TubeRate:
@@ -127,22 +136,22 @@ bool OpenRadiationPublisher::isEnabled() const
 {
     if (!config_.openRadiationEnabled)
         return false;
-    if (!resolveApparatusId().length())
+    // lastConfigError_ is refreshed by updateConfig(), which runs before every loop().
+    if (lastConfigError_.length())
         return false;
-    if (OpenRadiationPayload::buildRequiredCredentialError(config_).length())
+    if (!resolveApparatusId().length())
         return false;
     return true;
 }
 
 String OpenRadiationPublisher::resolveApparatusId() const
 {
-    const DeviceInfoSnapshot info = deviceInfo_.snapshot();
-    return OpenRadiationProtocol::resolveApparatusId(config_.openRadiationDeviceId, info.deviceId);
+    return OpenRadiationProtocol::resolveApparatusId(config_.openRadiationDeviceId, deviceInfo_.deviceId());
 }
 
 bool OpenRadiationPublisher::publishPending()
 {
-    if (!publishQueued_)
+    if (!publishQueued_ && !backlog_.count)
     {
         syncHealthState();
         return false;
@@ -154,30 +163,21 @@ bool OpenRadiationPublisher::publishPending()
         return true;
     }
 
-    if (!haveDoseValue_)
-    {
-        syncHealthState();
-        return true;
-    }
-
-    if (WiFi.status() != WL_CONNECTED)
-    {
-        syncHealthState();
-        return true;
-    }
-
-    unsigned long now = millis();
-    if (suppressUntilMs_ && now < suppressUntilMs_)
-    {
-        syncHealthState();
-        return true;
-    }
+    const unsigned long now = millis();
+    closePendingWindow(now);
+    submitOldestWindow(now);
+    syncHealthState();
+    return true;
+}
 
-    if (now - lastAttemptMs_ < kMinPublishGapMs)
-    {
-        syncHealthState();
-        return true;
-    }
+void OpenRadiationPublisher::closePendingWindow(unsigned long now)
+{
+    if (!publishQueued_ || !haveDoseValue_)
+        return;
+    if (closeDeferredUntilMs_ && now < closeDeferredUntilMs_)
+        return;
+    if (now - lastWindowCloseMs_ < kMinPublishGapMs)
+        return;
 
     float doseRate = pendingDoseValue_.toFloat();
     if (!(doseRate > 0.0f))
@@ -187,17 +187,15 @@ bool OpenRadiationPublisher::publishPending()
         haveDoseValue_ = false;
         haveTubeValue_ = false;
         OpenRadiationMeasurementWindow::clearMeasurementWindow(measurementWindow_);
-        syncHealthState();
-        return true;
+        return;
     }
 
     String endTimestamp;
     if (!makeIsoTimestamp(endTimestamp))
     {
         log_.println("OpenRadiation: waiting for valid system time before publishing.");
-        suppressUntilMs_ = now + 10000;
-        syncHealthState();
-        return true;
+        closeDeferredUntilMs_ = now + 10000;
+        return;
     }
 
     const DeviceInfoSnapshot info = deviceInfo_.snapshot();
@@ -212,70 +210,95 @@ bool OpenRadiationPublisher::publishPending()
     if (fabsf(config_.openRadiationLatitude) < 0.000001f && fabsf(config_.openRadiationLongitude) < 0.000001f)
     {
         log_.println("OpenRadiation: latitude/longitude not configured; skipping publish.");
-        suppressUntilMs_ = now + kRetryBackoffMs;
-        syncHealthState();
-        return true;
+        closeDeferredUntilMs_ = now + kRetryBackoffMs;
+        return;
     }
 
+    OpenRadiationMeasurementWindow::ClosedMeasurementWindow closed;
+    closed.startTime = measurementWindow_.startTime;
+    closed.endTime = endTimestamp;
+    closed.startPulseCount = measurementWindow_.startPulseCount;
+    closed.endPulseCount = info.tubePulseCount;
+    closed.doseRate = doseRate;
+    closed.reportUuid = generateUuid();
+
+    bool droppedOldest = false;
+    OpenRadiationMeasurementWindow::pushClosedWindow(backlog_, closed, droppedOldest);
+    if (droppedOldest)
+        log_.println("OpenRadiation: backlog full; dropped oldest measurement window.");
+
+    lastWindowCloseMs_ = now;
+    closeDeferredUntilMs_ = 0;
+    publishQueued_ = false;
+    haveDoseValue_ = false;
+    haveTubeValue_ = false;
+    OpenRadiationMeasurementWindow::clearMeasurementWindow(measurementWindow_);
+}
+
+void OpenRadiationPublisher::submitOldestWindow(unsigned long now)
+{
+    const OpenRadiationMeasurementWindow::ClosedMeasurementWindow *oldest =
+        OpenRadiationMeasurementWindow::oldestClosedWindow(backlog_);
+    if (!oldest)
+        return;
+
+    if (WiFi.status() != WL_CONNECTED)
+        return;
+    if (suppressUntilMs_ && now < suppressUntilMs_)
+        return;
+    if (now - lastAttemptMs_ < kBackfillGapMs)
+        return;
+
+    const OpenRadiationMeasurementWindow::ClosedMeasurementWindow window = *oldest;
     String payload;
-    String reportUuid;
     String buildError;
-    if (!buildPayload(payload,
-                      reportUuid,
-                      doseRate,
-                      measurementWindow_.startTime,
-                      endTimestamp,
-                      measurementWindow_.startPulseCount,
-                      info.tubePulseCount,
-                      buildError))
+    if (!buildPayload(payload, window, buildError))
     {
         log_.print("OpenRadiation: ");
         log_.println(buildError.length() ? buildError : String("failed to build payload."));
         suppressUntilMs_ = now + kRetryBackoffMs;
-        syncHealthState();
-        return true;
+        return;
     }
 
     const String apparatusId = resolveApparatusId();
     log_.print("OpenRadiation: POST dose=");
-    log_.print(doseRate, 4);
+    log_.print(window.doseRate, 4);
     log_.print(" apparatusId=");
     log_.print(apparatusId);
     log_.print(" reportUuid=");
-    log_.print(reportUuid);
+    log_.print(window.reportUuid);
+    if (backlog_.count > 1)
+    {
+        log_.print(" backlog=");
+        log_.print(static_cast<unsigned>(backlog_.count));
+    }
     log_.println();
 
     lastAttemptMs_ = now;
     health_.noteAttempt(now);
-    bool ok = sendPayload(payload);
-    if (ok)
+    int statusCode = 0;
+    if (sendPayload(payload, statusCode))
     {
-        lastPublishedReportUuid_ = reportUuid;
-        publishQueued_ = false;
-        haveDoseValue_ = false;
-        haveTubeValue_ = false;
-        OpenRadiationMeasurementWindow::clearMeasurementWindow(measurementWindow_);
+        lastPublishedReportUuid_ = window.reportUuid;
+        OpenRadiationMeasurementWindow::popOldestClosedWindow(backlog_);
         lastAttemptMs_ = millis();
+        return;
     }
-    else
+
+    if (OpenRadiationProtocol::isPermanentRejection(statusCode))
     {
-        suppressUntilMs_ = millis() + kRetryBackoffMs;
+        log_.print("OpenRadiation: dropping rejected measurement reportUuid=");
+        log_.println(window.reportUuid);
+        OpenRadiationMeasurementWindow::popOldestClosedWindow(backlog_);
     }
-    syncHealthState();
-    return true;
+    suppressUntilMs_ = millis() + kRetryBackoffMs;
 }
 
 bool OpenRadiationPublisher::buildPayload(String &outJson,
-                                          String &outReportUuid,
-                                          float doseRate,
-                                          const String &startTime,
-                                          const String &endTime,
-                                          const String &startPulseCount,
-                                          const String &endPulseCount,
+                                          const OpenRadiationMeasurementWindow::ClosedMeasurementWindow &window,
                                           String &outError)
 {
     const String apparatusId = resolveApparatusId();
-    outReportUuid = generateUuid();
 
     const DeviceInfoSnapshot info = deviceInfo_.snapshot();
     JsonDocument doc;
@@ -285,12 +308,12 @@ bool OpenRadiationPublisher::buildPayload(String &outJson,
         apparatusId,
         info.firmware,
         OpenRadiationProtocol::buildOrganisationReporting(bridgeVersion_),
-        outReportUuid,
-        doseRate,
-        startTime,
-        endTime,
-        startPulseCount,
-        endPulseCount);
+        window.reportUuid,
+        window.doseRate,
+        window.startTime,
+        window.endTime,
+        window.startPulseCount,
+        window.endPulseCount);
     if (error != OpenRadiationPayload::BuildError::None)
     {
         outError = OpenRadiationPayload::buildErrorText(error);
@@ -302,8 +325,19 @@ bool OpenRadiationPublisher::buildPayload(String &outJson,
     return true;
 }
 
-bool OpenRadiationPublisher::sendPayload(const String &payload)
+bool OpenRadiationPublisher::sendPayload(const String &payload, int &statusCode)
 {
+    statusCode = 0;
+    PublishPhaseTimer timer(&health_);
+    IPAddress address;
+    if (!WiFi.hostByName(OpenRadiationProtocol::kSubmitHost, address))
+    {
+        log_.println("OpenRadiation: DNS lookup failed.");
+        health_.noteFailure(millis(), "dns failed");
+        return false;
+    }
+    timer.lap(PublishPhase::Dns);
+
     WiFiClientSecure client;
     client.setTimeout(15);
     client.setInsecure();
@@ -314,6 +348,7 @@ bool OpenRadiationPublisher::sendPayload(const String &payload)
         health_.noteFailure(millis(), "connect failed");
         return false;
     }
+    timer.lap(PublishPhase::TlsHandshake);
 
     String request;
     request.reserve(payload.length() + 240);
@@ -340,12 +375,18 @@ bool OpenRadiationPublisher::sendPayload(const String &payload)
     }
 
     client.flush();
+    timer.lap(PublishPhase::RequestWrite);
 
     const auto response = HttpPublishResponse::readStatus(
         client,
         kResponseWaitMs,
         []() { return millis(); },
         []() { CooperativePump::service(); });
+    if (response.statusLine.length())
+    {
+        timer.lap(PublishPhase::FirstByte);
+        timer.finish();
+    }
 
     if (!response.success)
     {
@@ -371,6 +412,7 @@ bool OpenRadiationPublisher::sendPayload(const String &payload)
             health_.noteFailure(millis(), "invalid status line", 0, response.statusLine, response.trace);
             break;
         case HttpPublishResponse::FailureKind::HttpError:
+            statusCode = response.statusCode;
             log_.print("OpenRadiation: HTTP ");
             log_.println(response.statusCode);
             if (body.length())
@@ -378,6 +420,12 @@ bool OpenRadiationPublisher::sendPayload(const String &payload)
                 log_.print("OpenRadiation: response body: ");
                 log_.println(body);
             }
+            if (OpenRadiationProtocol::isAuthFailure(response.statusCode))
+            {
+                log_.println("OpenRadiation: API key rejected; keeping backlog until the settings are fixed.");
+                health_.noteFailure(millis(), "API key rejected", response.statusCode, response.statusLine, body.length() ? body : response.trace);
+                break;
+            }
             health_.noteFailure(millis(), body.length() ? body : String("http error"), response.statusCode, response.statusLine, body.length() ? body : response.trace);
             break;
         case HttpPublishResponse::FailureKind::ReadError:
@@ -429,8 +477,8 @@ String OpenRadiationPublisher::readResponseBody(WiFiClientSecure &client, unsign
 void OpenRadiationPublisher::syncHealthState()
 {
     health_.setEnabled(config_.openRadiationEnabled);
-    health_.setPaused(config_.openRadiationEnabled && lastConfigError_.length());
-    health_.setPending(publishQueued_);
+    health_.setPaused(paused_ || (config_.openRadiationEnabled && lastConfigError_.length()));
+    health_.setPending(publishQueued_ || backlog_.count);
     health_.setLastReportUuid(lastPublishedReportUuid_);
 }
 
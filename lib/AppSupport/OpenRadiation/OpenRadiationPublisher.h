@@ -17,6 +17,8 @@
 class OpenRadiationPublisher
 {
 public:
+    static constexpr const char *kPublisherName = "openRadiation";
+
     OpenRadiationPublisher(AppConfig &config,
                            DeviceInfoStore &deviceInfo,
                            Print &log,
@@ -28,18 +30,16 @@ public:
     void loop();
     void onCommandResult(DeviceManager::CommandType type, const String &value);
     void clearPendingData();
+    bool isEnabled() const;
+    void setPaused(bool paused) { paused_ = paused; }
 
 private:
-    bool isEnabled() const;
     bool publishPending();
-    bool sendPayload(const String &payload);
+    void closePendingWindow(unsigned long now);
+    void submitOldestWindow(unsigned long now);
+    bool sendPayload(const String &payload, int &statusCode);
     bool buildPayload(String &outJson,
-                      String &outReportUuid,
-                      float doseRate,
-                      const String &startTime,
-                      const String &endTime,
-                      const String &startPulseCount,
-                      const String &endPulseCount,
+                      const OpenRadiationMeasurementWindow::ClosedMeasurementWindow &window,
                       String &outError);
     bool makeIsoTimestamp(String &out) const;
     String resolveApparatusId() const;
@@ -57,9 +57,13 @@ private:
     String lastPublishedReportUuid_;
     String lastConfigError_;
     OpenRadiationMeasurementWindow::MeasurementWindowState measurementWindow_;
+    OpenRadiationMeasurementWindow::MeasurementBacklog backlog_;
     bool haveDoseValue_ = false;
     bool haveTubeValue_ = false;
     bool publishQueued_ = false;
     unsigned long lastAttemptMs_ = 0;
     unsigned long suppressUntilMs_ = 0;
+    unsigned long lastWindowCloseMs_ = 0;
+    unsigned long closeDeferredUntilMs_ = 0;
+    bool paused_ = false;
 };
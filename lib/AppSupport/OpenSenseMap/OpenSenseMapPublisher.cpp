@@ -8,6 +8,7 @@
 #include "OpenSenseMap/OpenSenseMapPortalLinks.h"
 #include "ConfigPortal/PortalSecurity.h"
 #include "Publishing/HttpPublishResponse.h"
+#include "Publishing/PublishPhaseTimer.h"
 #include "Runtime/CooperativePump.h"
 #include <WiFi.h>
 #include <ArduinoJson.h>
@@ -348,7 +349,7 @@ void OpenSenseMapPublisher::SendPortalForm(WiFiPortalService &portal, const Stri
     if (!portal.manager_.server)
         return;
 
-    String notice = WiFiPortalService::htmlEscape(message);
+    const String &notice = message;
     const String boxUrl = OpenSenseMapPortalLinks::buildOpenSenseMapBoxUrl(
         portal.config_.openSenseBoxId);
     const String rateSettingsUrl = OpenSenseMapPortalLinks::buildOpenSenseMapSensorSettingsUrl(
@@ -361,16 +362,16 @@ void OpenSenseMapPublisher::SendPortalForm(WiFiPortalService &portal, const Stri
         {"{{NOTICE_CLASS}}", notice.length() ? String() : String("hidden")},
         {"{{NOTICE_TEXT}}", notice},
         {"{{OSEM_ENABLED_CHECKED}}", portal.config_.openSenseMapEnabled ? String("checked") : String()},
-        {"{{OSEM_BOX_ID}}", WiFiPortalService::htmlEscape(portal.config_.openSenseBoxId)},
+        {"{{OSEM_BOX_ID}}", portal.config_.openSenseBoxId},
         {"{{OSEM_BOX_LINK_CLASS}}", boxUrl.length() ? String() : String("hidden")},
-        {"{{OSEM_BOX_URL}}", WiFiPortalService::htmlEscape(boxUrl)},
-        {"{{OSEM_API_KEY}}", WiFiPortalService::htmlEscape(portal.config_.openSenseApiKey)},
-        {"{{OSEM_RATE_ID}}", WiFiPortalService::htmlEscape(portal.config_.openSenseTubeRateSensorId)},
-        {"{{OSEM_DOSE_ID}}", WiFiPortalService::htmlEscape(portal.config_.openSenseDoseRateSensorId)},
+        {"{{OSEM_BOX_URL}}", boxUrl},
+        {"{{OSEM_API_KEY}}", portal.config_.openSenseApiKey},
+        {"{{OSEM_RATE_ID}}", portal.config_.openSenseTubeRateSensorId},
+        {"{{OSEM_DOSE_ID}}", portal.config_.openSenseDoseRateSensorId},
         {"{{OSEM_RATE_SETTINGS_CLASS}}", rateSettingsUrl.length() ? String() : String("hidden")},
-        {"{{OSEM_RATE_SETTINGS_URL}}", WiFiPortalService::htmlEscape(rateSettingsUrl)},
+        {"{{OSEM_RATE_SETTINGS_URL}}", rateSettingsUrl},
         {"{{OSEM_DOSE_SETTINGS_CLASS}}", doseSettingsUrl.length() ? String() : String("hidden")},
-        {"{{OSEM_DOSE_SETTINGS_URL}}", WiFiPortalService::htmlEscape(doseSettingsUrl)}};
+        {"{{OSEM_DOSE_SETTINGS_URL}}", doseSettingsUrl}};
 
     portal.appendCommonTemplateVars(vars);
     portal.sendTemplate("/portal/osem.html", vars);
@@ -378,10 +379,22 @@ void OpenSenseMapPublisher::SendPortalForm(WiFiPortalService &portal, const Stri
 
 bool OpenSenseMapPublisher::sendPayload(const JsonDocument &payload)
 {
+    PublishPhaseTimer timer(&health_);
+    IPAddress address;
+    if (!WiFi.hostByName(kHost, address))
+    {
+        log_.println("OpenSenseMap: DNS lookup failed.");
+        health_.noteFailure(millis(), "dns failed");
+        return false;
+    }
+    timer.lap(PublishPhase::Dns);
+
     WiFiClientSecure client;
     client.setTimeout(10);
     client.setCACert(kOpenSenseMapRootCa);
 
+    // Connect by name so SNI and certificate checks see the host; the lookup
+    // above leaves the address in the resolver cache.
     if (!client.connect(kHost, kPort))
     {
         log_.println("OpenSenseMap: connect failed.");
@@ -394,6 +407,7 @@ bool OpenSenseMapPublisher::sendPayload(const JsonDocument &payload)
             lastTlsErrorText_);
         return false;
     }
+    timer.lap(PublishPhase::TlsHandshake);
 
     const size_t contentLength = measureJson(payload);
 
@@ -424,12 +438,18 @@ bool OpenSenseMapPublisher::sendPayload(const JsonDocument &payload)
     }
 
     client.flush();
+    timer.lap(PublishPhase::RequestWrite);
 
     const auto response = HttpPublishResponse::readStatus(
         client,
         kResponseWaitMs,
         []() { return millis(); },
         []() { CooperativePump::service(); });
+    if (response.statusLine.length())
+    {
+        timer.lap(PublishPhase::FirstByte);
+        timer.finish();
+    }
 
     if (!response.success)
     {
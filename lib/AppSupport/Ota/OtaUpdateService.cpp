@@ -10,11 +10,6 @@
 #include <esp_partition.h>
 #include "DeviceManager.h"
 #include "UsbCdcHost.h"
-#include "Mqtt/MqttPublisher.h"
-#include "OpenSenseMap/OpenSenseMapPublisher.h"
-#include "GmcMap/GmcMapPublisher.h"
-#include "Radmon/RadmonPublisher.h"
-#include "Safecast/SafecastPublisher.h"
 
 namespace
 {
@@ -340,26 +335,15 @@ void OtaUpdateService::abort(const String &message)
     reset();
 }
 
-void OtaUpdateService::EnterUpdateMode(DeviceManager &deviceManager,
-                                       UsbCdcHost &usbHost,
-                                       MqttPublisher &mqtt,
-                                       OpenSenseMapPublisher &osem,
-                                       GmcMapPublisher &gmc,
-                                       RadmonPublisher &radmon,
-                                       SafecastPublisher &safecast,
-                                       bool &updateFlag)
+bool OtaUpdateService::StopDeviceIo(DeviceManager &deviceManager, UsbCdcHost &usbHost, bool &updateFlag)
 {
     if (updateFlag)
-        return;
+        return false;
 
     updateFlag = true;
     deviceManager.stop();
     usbHost.stop();
-    mqtt.pause(true);
-    osem.setPaused(true);
-    gmc.setPaused(true);
-    radmon.setPaused(true);
-    safecast.setPaused(true);
+    return true;
 }
 
 OtaUpdateService::Status OtaUpdateService::status() const
@@ -14,11 +14,6 @@
 
 class DeviceManager;
 class UsbCdcHost;
-class MqttPublisher;
-class OpenSenseMapPublisher;
-class GmcMapPublisher;
-class RadmonPublisher;
-class SafecastPublisher;
 
 class OtaUpdateService
 {
@@ -42,16 +37,20 @@ public:
     void abort(const String &message);
     Status status() const;
 
+    template <typename Publishers>
     static void EnterUpdateMode(DeviceManager &deviceManager,
                                 UsbCdcHost &usbHost,
-                                MqttPublisher &mqtt,
-                                OpenSenseMapPublisher &osem,
-                                GmcMapPublisher &gmc,
-                                RadmonPublisher &radmon,
-                                SafecastPublisher &safecast,
-                                bool &updateFlag);
+                                Publishers &publishers,
+                                bool &updateFlag)
+    {
+        if (!StopDeviceIo(deviceManager, usbHost, updateFlag))
+            return;
+        publishers.setPaused(true);
+    }
 
 private:
+    static bool StopDeviceIo(DeviceManager &deviceManager, UsbCdcHost &usbHost, bool &updateFlag);
+
     struct PartInfo
     {
         String path;
@@ -87,10 +87,11 @@ FailureKind waitForReadable(Client &client,
     return FailureKind::NoResponse;
 }
 
+// Appends readable bytes to line and returns true once the newline has been
+// consumed. Returns false when the client runs dry mid-line.
 template <typename Client>
-String readLine(Client &client, size_t maxTraceBytes, String &trace)
+bool appendLine(Client &client, size_t maxTraceBytes, String &line, String &trace)
 {
-    String line;
     while (client.available() > 0)
     {
         const int ch = client.read();
@@ -98,7 +99,7 @@ String readLine(Client &client, size_t maxTraceBytes, String &trace)
             break;
 
         if (ch == '\n')
-            break;
+            return true;
         if (ch == '\r')
             continue;
 
@@ -109,6 +110,14 @@ String readLine(Client &client, size_t maxTraceBytes, String &trace)
             trace += text;
     }
 
+    return false;
+}
+
+template <typename Client>
+String readLine(Client &client, size_t maxTraceBytes, String &trace)
+{
+    String line;
+    appendLine(client, maxTraceBytes, line, trace);
     return line;
 }
 
@@ -120,11 +129,23 @@ Result readStatus(Client &client,
                   size_t maxTraceBytes = 160)
 {
     Result result;
+    const unsigned long startedAt = nowFn();
     result.failure = waitForReadable(client, timeoutMs, nowFn, yieldFn);
     if (result.failure != FailureKind::None)
         return result;
 
-    result.statusLine = readLine(client, maxTraceBytes, result.trace);
+    // Slow links can split the status line across segments; keep reading
+    // until its newline, a disconnect or the overall timeout.
+    while (!appendLine(client, maxTraceBytes, result.statusLine, result.trace))
+    {
+        if (!client.connected() && client.available() <= 0)
+            break;
+        const unsigned long elapsed = nowFn() - startedAt;
+        if (elapsed >= timeoutMs)
+            break;
+        if (waitForReadable(client, timeoutMs - elapsed, nowFn, yieldFn) != FailureKind::None)
+            break;
+    }
     result.statusLine.trim();
     result.trace.trim();
 
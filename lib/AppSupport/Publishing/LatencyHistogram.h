@@ -0,0 +1,100 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+enum class PublishPhase : uint8_t
+{
+    Dns,
+    Connect,
+    TlsHandshake,
+    RequestWrite,
+    FirstByte,
+    Total,
+};
+
+constexpr size_t kPublishPhaseCount = 6;
+
+inline const char *publishPhaseKey(PublishPhase phase)
+{
+    switch (phase)
+    {
+    case PublishPhase::Dns:
+        return "dns";
+    case PublishPhase::Connect:
+        return "connect";
+    case PublishPhase::TlsHandshake:
+        return "tls";
+    case PublishPhase::RequestWrite:
+        return "write";
+    case PublishPhase::FirstByte:
+        return "firstByte";
+    case PublishPhase::Total:
+        return "total";
+    }
+    return "unknown";
+}
+
+// Fixed-bucket millisecond histogram. Percentiles resolve to the upper bound
+// of the bucket that contains them, capped by the largest observed sample.
+class LatencyHistogram
+{
+public:
+    static constexpr size_t kBucketCount = 12;
+
+    static uint32_t bucketUpperMs(size_t index)
+    {
+        static const uint32_t kUpperMs[kBucketCount - 1] = {
+            10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000, 20000};
+        return index < kBucketCount - 1 ? kUpperMs[index] : UINT32_MAX;
+    }
+
+    void record(uint32_t elapsedMs)
+    {
+        size_t index = 0;
+        while (index < kBucketCount - 1 && elapsedMs > bucketUpperMs(index))
+            ++index;
+        counts_[index] += 1;
+        count_ += 1;
+        if (elapsedMs > maxMs_)
+            maxMs_ = elapsedMs;
+    }
+
+    uint32_t count() const { return count_; }
+    uint32_t maxMs() const { return maxMs_; }
+    uint32_t bucketCount(size_t index) const { return index < kBucketCount ? counts_[index] : 0; }
+
+    uint32_t percentileMs(uint32_t percentile) const
+    {
+        if (!count_)
+            return 0;
+        if (percentile > 100)
+            percentile = 100;
+        uint64_t target = (static_cast<uint64_t>(count_) * percentile + 99) / 100;
+        if (target == 0)
+            target = 1;
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBucketCount; ++i)
+        {
+            seen += counts_[i];
+            if (seen >= target)
+            {
+                const uint32_t upper = bucketUpperMs(i);
+                return upper < maxMs_ ? upper : maxMs_;
+            }
+        }
+        return maxMs_;
+    }
+
+private:
+    uint32_t counts_[kBucketCount] = {};
+    uint32_t count_ = 0;
+    uint32_t maxMs_ = 0;
+};
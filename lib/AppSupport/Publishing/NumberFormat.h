@@ -0,0 +1,164 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+// Telemetry number formatting into caller buffers, without String or the
+// printf float path. Fixed-point: the value is scaled by 10^decimals,
+// rounded half away from zero into a uint64_t and printed as two integers,
+// which matches "%.*f" for the magnitudes a detector reports. Values that
+// do not fit the integer range fall back to snprintf.
+//
+// All writers return the length without terminator, or 0 if the text does
+// not fit into capacity (out is then left empty).
+namespace NumberFormat
+{
+static constexpr uint8_t kMaxDecimals = 9;
+// Sign, 20 integer digits, point, kMaxDecimals digits and terminator.
+static constexpr size_t kMaxChars = 32;
+
+namespace detail
+{
+inline size_t putDigits(char *out, uint64_t value, size_t minDigits)
+{
+    char digits[20];
+    size_t count = 0;
+    do
+    {
+        digits[count++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value);
+    while (count < minDigits)
+        digits[count++] = '0';
+    for (size_t i = 0; i < count; ++i)
+        out[i] = digits[count - 1 - i];
+    return count;
+}
+
+inline size_t finish(char *out, size_t capacity, const char *text, size_t length)
+{
+    if (!out || !capacity)
+        return 0;
+    if (length >= capacity)
+    {
+        out[0] = '\0';
+        return 0;
+    }
+    for (size_t i = 0; i < length; ++i)
+        out[i] = text[i];
+    out[length] = '\0';
+    return length;
+}
+} // namespace detail
+
+inline size_t formatUnsigned(char *out, size_t capacity, uint64_t value)
+{
+    char text[kMaxChars];
+    return detail::finish(out, capacity, text, detail::putDigits(text, value, 1));
+}
+
+inline size_t formatSigned(char *out, size_t capacity, int64_t value)
+{
+    char text[kMaxChars];
+    size_t length = 0;
+    uint64_t magnitude = static_cast<uint64_t>(value);
+    if (value < 0)
+    {
+        text[length++] = '-';
+        magnitude = 0 - magnitude;
+    }
+    length += detail::putDigits(text + length, magnitude, 1);
+    return detail::finish(out, capacity, text, length);
+}
+
+// Zero-padded to width digits, e.g. the nanosecond part of a timestamp.
+inline size_t formatUnsignedPadded(char *out, size_t capacity, uint64_t value, uint8_t width)
+{
+    char text[kMaxChars];
+    if (width > 20)
+        width = 20;
+    return detail::finish(out, capacity, text, detail::putDigits(text, value, width));
+}
+
+// decimals above kMaxDecimals are clamped. NaN and infinities are written
+// as "nan", "inf" and "-inf" like printf does.
+inline size_t formatFixed(char *out, size_t capacity, double value, uint8_t decimals)
+{
+    char text[kMaxChars];
+    if (std::isnan(value))
+        return detail::finish(out, capacity, "nan", 3);
+    if (std::isinf(value))
+        return value < 0 ? detail::finish(out, capacity, "-inf", 4) : detail::finish(out, capacity, "inf", 3);
+    if (decimals > kMaxDecimals)
+        decimals = kMaxDecimals;
+
+    static constexpr uint64_t kPow10[] = {1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL,
+                                          1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL};
+    const uint64_t scale = kPow10[decimals];
+    const double magnitude = std::fabs(value) * static_cast<double>(scale) + 0.5;
+    // 2^63: beyond this the scaled value no longer fits; hand it to printf.
+    if (magnitude >= 9223372036854775808.0)
+    {
+        int written = std::snprintf(text, sizeof(text), "%.*f", static_cast<int>(decimals), value);
+        if (written <= 0 || static_cast<size_t>(written) >= sizeof(text))
+        {
+            if (out && capacity)
+                out[0] = '\0';
+            return 0;
+        }
+        return detail::finish(out, capacity, text, static_cast<size_t>(written));
+    }
+
+    const uint64_t scaled = static_cast<uint64_t>(magnitude);
+    size_t length = 0;
+    // Values that round to zero print without a sign.
+    if (value < 0 && scaled)
+        text[length++] = '-';
+    length += detail::putDigits(text + length, scaled / scale, 1);
+    if (decimals)
+    {
+        text[length++] = '.';
+        length += detail::putDigits(text + length, scaled % scale, decimals);
+    }
+    return detail::finish(out, capacity, text, length);
+}
+
+// Stack-held result for call sites that append to a String or Print, e.g.
+// html += NumberFormat::Fixed(latitude, 6).c_str();
+class Text
+{
+public:
+    const char *c_str() const { return text_; }
+    size_t length() const { return length_; }
+
+protected:
+    char text_[kMaxChars] = {};
+    size_t length_ = 0;
+};
+
+class Fixed : public Text
+{
+public:
+    Fixed(double value, uint8_t decimals) { length_ = formatFixed(text_, sizeof(text_), value, decimals); }
+};
+
+class Unsigned : public Text
+{
+public:
+    explicit Unsigned(uint64_t value) { length_ = formatUnsigned(text_, sizeof(text_), value); }
+};
+
+class Signed : public Text
+{
+public:
+    explicit Signed(int64_t value) { length_ = formatSigned(text_, sizeof(text_), value); }
+};
+} // namespace NumberFormat
@@ -0,0 +1,87 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+
+// Change threshold for one metric, written as "0.5" (absolute) or "5%"
+// (relative to the last published value). An empty string or "0" publishes
+// every change but still skips repeats of the same value.
+struct DeadbandSpec
+{
+    double threshold = 0.0;
+    bool relative = false;
+
+    static bool parse(const char *text, DeadbandSpec &out)
+    {
+        out = DeadbandSpec();
+        if (!text)
+            return true;
+        while (*text == ' ')
+            ++text;
+        if (!*text)
+            return true;
+
+        char *end = nullptr;
+        double value = std::strtod(text, &end);
+        if (end == text || !std::isfinite(value) || value < 0.0)
+            return false;
+        while (*end == ' ')
+            ++end;
+        if (*end == '%')
+        {
+            out.relative = true;
+            ++end;
+            while (*end == ' ')
+                ++end;
+        }
+        if (*end)
+            return false;
+        out.threshold = value;
+        return true;
+    }
+};
+
+// Remembers the last value that was let through and decides whether a new
+// reading differs enough to be published. A heartbeat lets the value through
+// anyway once it has been held back for heartbeatMs, so subscribers can tell
+// a quiet metric from a dead bridge.
+class DeadbandFilter
+{
+public:
+    bool shouldPublish(double value, uint32_t nowMs, const DeadbandSpec &spec, uint32_t heartbeatMs)
+    {
+        if (!hasLast_ || !std::isfinite(value) || exceeds(value, spec) ||
+            (heartbeatMs && nowMs - lastMs_ >= heartbeatMs))
+        {
+            hasLast_ = true;
+            last_ = value;
+            lastMs_ = nowMs;
+            return true;
+        }
+        return false;
+    }
+
+    void reset() { hasLast_ = false; }
+
+private:
+    bool exceeds(double value, const DeadbandSpec &spec) const
+    {
+        const double delta = std::fabs(value - last_);
+        if (delta == 0.0)
+            return false;
+        if (spec.relative)
+            return last_ == 0.0 || delta * 100.0 >= std::fabs(last_) * spec.threshold;
+        return delta >= spec.threshold;
+    }
+
+    bool hasLast_ = false;
+    double last_ = 0.0;
+    uint32_t lastMs_ = 0;
+};
@@ -0,0 +1,47 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include "Publishing/PublisherHealth.h"
+
+// Splits one publish request into consecutive phases. lap() records the time
+// since the previous lap; finish() records the time since construction.
+// A null health pointer turns the timer into a no-op (portal test uploads).
+class PublishPhaseTimer
+{
+public:
+    using ClockFn = unsigned long (*)();
+
+    explicit PublishPhaseTimer(PublisherHealth *health, ClockFn nowFn = millis)
+        : health_(health),
+          nowFn_(nowFn),
+          startedAt_(nowFn()),
+          lapStartedAt_(startedAt_)
+    {
+    }
+
+    void lap(PublishPhase phase)
+    {
+        const unsigned long now = nowFn_();
+        if (health_)
+            health_->notePhase(phase, now - lapStartedAt_);
+        lapStartedAt_ = now;
+    }
+
+    void finish()
+    {
+        if (health_)
+            health_->notePhase(PublishPhase::Total, nowFn_() - startedAt_);
+    }
+
+private:
+    PublisherHealth *health_;
+    ClockFn nowFn_;
+    unsigned long startedAt_;
+    unsigned long lapStartedAt_;
+};
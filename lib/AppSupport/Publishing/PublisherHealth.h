@@ -7,6 +7,7 @@
 #pragma once
 
 #include <Arduino.h>
+#include "Publishing/LatencyHistogram.h"
 
 struct PublisherHealthSnapshot
 {
@@ -25,6 +26,7 @@ struct PublisherHealthSnapshot
     String lastError;
     String lastResponseTrace;
     String lastReportUuid;
+    LatencyHistogram latency[kPublishPhaseCount];
 };
 
 class PublisherHealth
@@ -69,6 +71,13 @@ public:
         snapshot_.lastResponseTrace = responseTrace;
     }
 
+    void notePhase(PublishPhase phase, unsigned long elapsedMs)
+    {
+        const size_t index = static_cast<size_t>(phase);
+        if (index < kPublishPhaseCount)
+            snapshot_.latency[index].record(static_cast<uint32_t>(elapsedMs));
+    }
+
     const PublisherHealthSnapshot &snapshot() const { return snapshot_; }
 
 private:
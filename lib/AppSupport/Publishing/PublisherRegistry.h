@@ -0,0 +1,158 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <cstddef>
+#include <cstdint>
+
+// Per-publisher loop accounting, exposed read-only to the bridge info page.
+struct PublisherLoopStats
+{
+    const char *name = "";
+    bool enabled = false;
+    uint32_t calls = 0;
+    uint32_t skipped = 0;
+    uint32_t lastMicros = 0;
+    uint32_t maxMicros = 0;
+    uint64_t totalMicros = 0;
+};
+
+namespace PublisherRegistryDetail
+{
+template <size_t Index, typename... Publishers>
+struct Slots;
+
+template <size_t Index>
+struct Slots<Index>
+{
+    void begin(PublisherLoopStats *) {}
+    void updateConfig(PublisherLoopStats *) {}
+    void loop(PublisherLoopStats *) {}
+    template <typename CommandType>
+    void onCommandResult(PublisherLoopStats *, CommandType, const String &) {}
+    template <typename CommandType>
+    void onIdentityResult(CommandType, const String &) {}
+    void clearPendingData() {}
+    void setPaused(bool) {}
+};
+
+template <size_t Index, typename Head, typename... Tail>
+struct Slots<Index, Head, Tail...>
+{
+    explicit Slots(Head &head, Tail &...tail) : head_(head), tail_(tail...) {}
+
+    void begin(PublisherLoopStats *stats)
+    {
+        stats[Index].name = Head::kPublisherName;
+        tail_.begin(stats);
+    }
+
+    void updateConfig(PublisherLoopStats *stats)
+    {
+        head_.updateConfig();
+        stats[Index].enabled = head_.isEnabled();
+        tail_.updateConfig(stats);
+    }
+
+    void loop(PublisherLoopStats *stats)
+    {
+        PublisherLoopStats &slot = stats[Index];
+        if (!slot.enabled)
+        {
+            slot.skipped += 1;
+        }
+        else
+        {
+            const uint32_t startedAt = micros();
+            head_.loop();
+            const uint32_t elapsed = micros() - startedAt;
+            slot.calls += 1;
+            slot.lastMicros = elapsed;
+            slot.totalMicros += elapsed;
+            if (elapsed > slot.maxMicros)
+                slot.maxMicros = elapsed;
+        }
+        tail_.loop(stats);
+    }
+
+    template <typename CommandType>
+    void onCommandResult(PublisherLoopStats *stats, CommandType type, const String &value)
+    {
+        if (stats[Index].enabled)
+            head_.onCommandResult(type, value);
+        tail_.onCommandResult(stats, type, value);
+    }
+
+    template <typename CommandType>
+    void onIdentityResult(CommandType type, const String &value)
+    {
+        head_.onCommandResult(type, value);
+        tail_.onIdentityResult(type, value);
+    }
+
+    void clearPendingData()
+    {
+        head_.clearPendingData();
+        tail_.clearPendingData();
+    }
+
+    void setPaused(bool paused)
+    {
+        head_.setPaused(paused);
+        tail_.setPaused(paused);
+    }
+
+    Head &head_;
+    Slots<Index + 1, Tail...> tail_;
+};
+} // namespace PublisherRegistryDetail
+
+// Fixed set of publishers dispatched without virtual calls or heap
+// allocation. Each publisher provides kPublisherName, updateConfig(),
+// isEnabled(), loop(), onCommandResult(), clearPendingData() and
+// setPaused(). Disabled publishers are skipped by loop() and
+// onCommandResult(); the enabled flag is refreshed by updateConfig().
+// Device identity (id, model, firmware) is reported once per USB attach,
+// so onIdentityResult() hands it to every publisher, enabled or not, and a
+// publisher switched on later still knows which device it reports for.
+template <typename... Publishers>
+class PublisherRegistry
+{
+public:
+    static constexpr size_t kCount = sizeof...(Publishers);
+
+    explicit PublisherRegistry(Publishers &...publishers) : slots_(publishers...)
+    {
+        slots_.begin(stats_);
+    }
+
+    void updateConfig() { slots_.updateConfig(stats_); }
+    void loop() { slots_.loop(stats_); }
+
+    template <typename CommandType>
+    void onCommandResult(CommandType type, const String &value)
+    {
+        slots_.onCommandResult(stats_, type, value);
+    }
+
+    template <typename CommandType>
+    void onIdentityResult(CommandType type, const String &value)
+    {
+        slots_.onIdentityResult(type, value);
+    }
+
+    void clearPendingData() { slots_.clearPendingData(); }
+    void setPaused(bool paused) { slots_.setPaused(paused); }
+
+    const PublisherLoopStats *loopStats() const { return stats_; }
+    size_t size() const { return kCount; }
+
+private:
+    PublisherRegistryDetail::Slots<0, Publishers...> slots_;
+    PublisherLoopStats stats_[kCount];
+};
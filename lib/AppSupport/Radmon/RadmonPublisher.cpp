@@ -10,6 +10,7 @@
 #include <WebServer.h>
 #include "Led/LedController.h"
 #include "Publishing/HttpPublishResponse.h"
+#include "Publishing/PublishPhaseTimer.h"
 #include "Radmon/RadmonLogRedaction.h"
 #include "Radmon/RadmonPortalLinks.h"
 #include "Runtime/CooperativePump.h"
@@ -193,14 +194,25 @@ void RadmonPublisher::syncHealthState()
 
 bool RadmonPublisher::sendRequest(const String &query)
 {
+    PublishPhaseTimer timer(&health_);
+    IPAddress address;
+    if (!WiFi.hostByName(kHost, address))
+    {
+        log_.println("Radmon: DNS lookup failed.");
+        health_.noteFailure(millis(), "dns failed");
+        return false;
+    }
+    timer.lap(PublishPhase::Dns);
+
     WiFiClient client;
     client.setTimeout(10);
-    if (!client.connect(kHost, kPort))
+    if (!client.connect(address, kPort))
     {
         log_.println("Radmon: connect failed.");
         health_.noteFailure(millis(), "connect failed");
         return false;
     }
+    timer.lap(PublishPhase::Connect);
 
     String request;
     request.reserve(query.length() + 80);
@@ -220,12 +232,18 @@ bool RadmonPublisher::sendRequest(const String &query)
     }
 
     client.flush();
+    timer.lap(PublishPhase::RequestWrite);
 
     const auto response = HttpPublishResponse::readStatus(
         client,
         10000,
         []() { return millis(); },
         []() { CooperativePump::service(); });
+    if (response.statusLine.length())
+    {
+        timer.lap(PublishPhase::FirstByte);
+        timer.finish();
+    }
 
     if (!response.success)
     {
@@ -354,17 +372,17 @@ void RadmonPublisher::SendPortalForm(WiFiPortalService &portal, const String &me
     if (!portal.manager_.server)
         return;
 
-    String notice = WiFiPortalService::htmlEscape(message);
+    const String &notice = message;
     const String stationUrl = RadmonPortalLinks::buildRadmonStationUrl(
         portal.config_.radmonUser);
     WiFiPortalService::TemplateReplacements vars = {
         {"{{NOTICE_CLASS}}", notice.length() ? String() : String("hidden")},
         {"{{NOTICE_TEXT}}", notice},
         {"{{RADMON_ENABLED_CHECKED}}", portal.config_.radmonEnabled ? String("checked") : String()},
-        {"{{RADMON_USER}}", WiFiPortalService::htmlEscape(portal.config_.radmonUser)},
-        {"{{RADMON_PASS}}", WiFiPortalService::htmlEscape(portal.config_.radmonPassword)},
+        {"{{RADMON_USER}}", portal.config_.radmonUser},
+        {"{{RADMON_PASS}}", portal.config_.radmonPassword},
         {"{{RADMON_STATION_LINK_CLASS}}", stationUrl.length() ? String() : String("hidden")},
-        {"{{RADMON_STATION_URL}}", WiFiPortalService::htmlEscape(stationUrl)}};
+        {"{{RADMON_STATION_URL}}", stationUrl}};
 
     portal.appendCommonTemplateVars(vars);
     portal.sendTemplate("/portal/radmon.html", vars);
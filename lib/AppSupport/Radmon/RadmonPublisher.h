@@ -19,6 +19,8 @@ class LedController;
 class RadmonPublisher
 {
 public:
+    static constexpr const char *kPublisherName = "radmon";
+
     RadmonPublisher(AppConfig &config, Print &log, const char *bridgeVersion, PublisherHealth &health);
 
     void begin();
@@ -26,6 +28,7 @@ public:
     void loop();
     void onCommandResult(DeviceManager::CommandType type, const String &value);
     void clearPendingData();
+    bool isEnabled() const;
     void setPaused(bool paused) { paused_ = paused; }
     static void SendPortalForm(WiFiPortalService &portal, const String &message = String());
     static void HandlePortalPost(WebServer &server,
@@ -36,7 +39,6 @@ public:
                                  String &message);
 
 private:
-    bool isEnabled() const;
     bool publishPending();
     bool sendRequest(const String &query);
     void syncHealthState();
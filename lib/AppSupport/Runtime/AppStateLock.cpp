@@ -0,0 +1,55 @@
+// SPDX-FileCopyrightText: 2026 André Fiedler
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "Runtime/AppStateLock.h"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+namespace
+{
+SemaphoreHandle_t g_mutex = nullptr;
+// Recursion depth of the current holder. Only the holder reads or writes it.
+int g_depth = 0;
+}
+
+void AppStateLock::begin()
+{
+    if (!g_mutex)
+        g_mutex = xSemaphoreCreateRecursiveMutex();
+}
+
+bool AppStateLock::lock()
+{
+    if (!g_mutex)
+        return false;
+    xSemaphoreTakeRecursive(g_mutex, portMAX_DELAY);
+    g_depth += 1;
+    return true;
+}
+
+void AppStateLock::unlock()
+{
+    if (!g_mutex)
+        return;
+    g_depth -= 1;
+    xSemaphoreGiveRecursive(g_mutex);
+}
+
+int AppStateLock::releaseAll()
+{
+    if (!g_mutex || xSemaphoreGetMutexHolder(g_mutex) != xTaskGetCurrentTaskHandle())
+        return 0;
+    const int depth = g_depth;
+    for (int i = 0; i < depth; ++i)
+        unlock();
+    return depth;
+}
+
+void AppStateLock::reacquire(int depth)
+{
+    for (int i = 0; i < depth; ++i)
+        lock();
+}
@@ -0,0 +1,69 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+// Serialises the main loop and the portal task around the state they share:
+// AppConfig, the publishers, the log file writer and the device and LED
+// state owned by main.cpp. The main loop holds the lock for each iteration;
+// portal routes that read or change that state take it for the request, and
+// so does the portal task around maintain(). The log file download takes it
+// too, because it flushes LogFileWriter. Static assets, the live log routes,
+// /device.json and /device/stream run without it (DeviceInfoStore and the
+// log ring lock themselves), so they never wait for the loop or hold it up.
+//
+// Network waits must not hold the lock: the cooperative pump drops it while
+// a publisher waits on the main loop, and the test-upload and lookup routes
+// copy what they need and send through a Released scope.
+//
+// Recursive, so a handler may call code that locks again. lock() and
+// unlock() do nothing until begin() has run.
+namespace AppStateLock
+{
+void begin();
+bool lock();
+void unlock();
+// Drops every level the calling task holds and returns how many there were;
+// returns 0 when the task does not hold the lock.
+int releaseAll();
+void reacquire(int depth);
+
+class Guard
+{
+public:
+    Guard() : held_(lock()) {}
+    ~Guard() { release(); }
+
+    Guard(const Guard &) = delete;
+    Guard &operator=(const Guard &) = delete;
+
+    void release()
+    {
+        if (!held_)
+            return;
+        held_ = false;
+        unlock();
+    }
+
+private:
+    bool held_;
+};
+
+// Lets the other task in for the lifetime of the scope, then takes the lock
+// back at the depth the caller held it.
+class Released
+{
+public:
+    Released() : depth_(releaseAll()) {}
+    ~Released() { reacquire(depth_); }
+
+    Released(const Released &) = delete;
+    Released &operator=(const Released &) = delete;
+
+private:
+    int depth_;
+};
+} // namespace AppStateLock
@@ -0,0 +1,59 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <cstdint>
+
+// Temporary poll interval set at runtime (for example over MQTT) that
+// replaces the configured readIntervalMs without touching NVS. It lapses
+// after its duration, or stays until cleared when the duration is 0.
+class ReadIntervalOverride
+{
+public:
+    void set(uint32_t intervalMs, uint32_t durationMs, uint32_t nowMs)
+    {
+        if (!intervalMs)
+        {
+            clear();
+            return;
+        }
+        intervalMs_ = intervalMs;
+        durationMs_ = durationMs;
+        startedMs_ = nowMs;
+    }
+
+    void clear()
+    {
+        intervalMs_ = 0;
+        durationMs_ = 0;
+    }
+
+    bool active(uint32_t nowMs)
+    {
+        if (intervalMs_ && durationMs_ && nowMs - startedMs_ >= durationMs_)
+            clear();
+        return intervalMs_ != 0;
+    }
+
+    uint32_t effective(uint32_t configuredMs, uint32_t nowMs)
+    {
+        return active(nowMs) ? intervalMs_ : configuredMs;
+    }
+
+    // Milliseconds until the override lapses; 0 when inactive or unlimited.
+    uint32_t remainingMs(uint32_t nowMs)
+    {
+        if (!active(nowMs) || !durationMs_)
+            return 0;
+        return durationMs_ - (nowMs - startedMs_);
+    }
+
+private:
+    uint32_t intervalMs_ = 0;
+    uint32_t durationMs_ = 0;
+    uint32_t startedMs_ = 0;
+};
@@ -7,6 +7,7 @@
 #include <time.h>
 
 #include "Publishing/HttpPublishResponse.h"
+#include "Publishing/PublishPhaseTimer.h"
 #include "Runtime/CooperativePump.h"
 #include "Safecast/SafecastLogRedaction.h"
 #include "Safecast/SafecastPayload.h"
@@ -205,32 +206,34 @@ bool SafecastPublisher::publishPending()
     return true;
 }
 
-SafecastPublisher::UploadResult SafecastPublisher::sendTestUpload(const AppConfig &configOverride)
+bool SafecastPublisher::prepareTestUpload(const AppConfig &configOverride, TestUpload &upload, UploadResult &result)
 {
-    UploadResult result;
+    result = UploadResult();
     if (WiFi.status() != WL_CONNECTED)
     {
         result.errorMessage = "Wi-Fi is not connected.";
-        return result;
+        return false;
     }
 
-    SafecastConfig::ResolvedConfig resolved;
-    const SafecastConfig::Error error = SafecastConfig::resolve(configOverride, resolved, true);
+    const SafecastConfig::Error error = SafecastConfig::resolve(configOverride, upload.resolved, true);
     if (error != SafecastConfig::Error::None)
     {
         result.errorMessage = SafecastConfig::errorText(error);
-        return result;
+        return false;
     }
 
-    SafecastPayload::Measurement measurement;
     String buildError;
-    if (!buildMeasurementFromLatest(resolved, measurement, buildError))
+    if (!buildMeasurementFromLatest(upload.resolved, upload.measurement, buildError))
     {
         result.errorMessage = buildError.length() ? buildError : String("No valid detector reading available for Safecast test upload.");
-        return result;
+        return false;
     }
+    return true;
+}
 
-    return uploadMeasurement(resolved, measurement, false);
+SafecastPublisher::UploadResult SafecastPublisher::sendTestUpload(const TestUpload &upload)
+{
+    return uploadMeasurement(upload.resolved, upload.measurement, false);
 }
 
 void SafecastPublisher::syncHealthState()
@@ -415,7 +418,23 @@ SafecastPublisher::UploadResult SafecastPublisher::sendRequest(Client &client,
         SafecastProtocol::buildMeasurementUrl(resolved.resolvedBaseUrl, resolved.apiKey));
     result.attempted = true;
 
-    if (!client.connect(resolved.endpoint.host.c_str(), resolved.endpoint.port))
+    PublishPhaseTimer timer(updateHealthState ? &health_ : nullptr);
+    IPAddress address;
+    if (!WiFi.hostByName(resolved.endpoint.host.c_str(), address))
+    {
+        result.errorMessage = "dns failed";
+        if (updateHealthState)
+            health_.noteFailure(millis(), result.errorMessage);
+        log_.println("Safecast: DNS lookup failed.");
+        return result;
+    }
+    timer.lap(PublishPhase::Dns);
+
+    // TLS needs the host name for SNI; plain HTTP reuses the resolved address.
+    const bool connected = resolved.endpoint.secure
+                               ? client.connect(resolved.endpoint.host.c_str(), resolved.endpoint.port)
+                               : client.connect(address, resolved.endpoint.port);
+    if (!connected)
     {
         result.errorMessage = "connect failed";
         if (updateHealthState)
@@ -423,6 +442,7 @@ SafecastPublisher::UploadResult SafecastPublisher::sendRequest(Client &client,
         log_.println("Safecast: connect failed.");
         return result;
     }
+    timer.lap(resolved.endpoint.secure ? PublishPhase::TlsHandshake : PublishPhase::Connect);
 
     const String requestPath = SafecastProtocol::buildMeasurementPath(resolved.endpoint, resolved.apiKey);
 
@@ -450,12 +470,18 @@ SafecastPublisher::UploadResult SafecastPublisher::sendRequest(Client &client,
     }
 
     client.flush();
+    timer.lap(PublishPhase::RequestWrite);
 
     const auto response = HttpPublishResponse::readStatus(
         client,
         kResponseWaitMs,
         []() { return millis(); },
         []() { CooperativePump::service(); });
+    if (response.statusLine.length())
+    {
+        timer.lap(PublishPhase::FirstByte);
+        timer.finish();
+    }
 
     result.statusCode = response.statusCode;
     result.statusLine = response.statusLine;
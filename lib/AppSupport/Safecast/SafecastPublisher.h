@@ -13,6 +13,8 @@
 class SafecastPublisher
 {
 public:
+    static constexpr const char *kPublisherName = "safecast";
+
     struct UploadResult
     {
         bool attempted = false;
@@ -31,9 +33,21 @@ public:
     void loop();
     void onCommandResult(DeviceManager::CommandType type, const String &value);
     void clearPendingData();
+    bool isEnabled() const;
     void setPaused(bool paused) { paused_ = paused; }
 
-    UploadResult sendTestUpload(const AppConfig &configOverride);
+    struct TestUpload
+    {
+        SafecastConfig::ResolvedConfig resolved;
+        SafecastPayload::Measurement measurement;
+    };
+
+    // Resolves the override and copies the latest reading; needs the app
+    // state lock. On failure result carries the error.
+    bool prepareTestUpload(const AppConfig &configOverride, TestUpload &upload, UploadResult &result);
+    // Sends a prepared upload without touching publisher state, so it can
+    // run while the main loop does.
+    UploadResult sendTestUpload(const TestUpload &upload);
 
 private:
     struct RateSample
@@ -50,7 +64,6 @@ private:
         float latestValue = 0.0f;
     };
 
-    bool isEnabled() const;
     bool publishPending();
     void syncHealthState();
     bool makeIsoTimestamp(String &out) const;
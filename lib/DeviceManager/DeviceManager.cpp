@@ -3,6 +3,8 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include <DeviceManager.h>
+#include "Logging/StructuredLog.h"
+#include "Publishing/NumberFormat.h"
 #include <cstdio>
 #include <time.h>
 
@@ -239,10 +241,8 @@ void DeviceManager::loop()
 
     if (!host_.isConnected())
     {
-        if (line_handler_ && (awaiting_response_ || has_current_command_ || !command_queue_.empty()))
-        {
-            line_handler_(String("USB not connected; clearing pending commands. queued=") + command_queue_.size());
-        }
+        if (log_ && (awaiting_response_ || has_current_command_ || !command_queue_.empty()))
+            BRIDGE_LOGW(*log_, "Device", "USB not connected; clearing pending commands. queued=%u", command_queue_.size());
         awaiting_response_ = false;
         has_current_command_ = false;
         current_command_ = PendingCommand{};
@@ -263,20 +263,20 @@ void DeviceManager::loop()
 
         if ((millis() - last_request_ms_) > DEVICE_ID_RESPONSE_TIMEOUT_MS)
         {
-            if (line_handler_)
+            if (log_)
             {
-                String cmdLabel = current_command_.command.length()
-                                      ? current_command_.command
-                                      : String("type=") + String(static_cast<int>(current_command_.type));
-                line_handler_(String("Command timeout: ") + cmdLabel + " retry=" + current_command_.retry);
+                if (current_command_.command.length())
+                    BRIDGE_LOGW(*log_, "Device", "Command timeout: %s retry=%u", current_command_.command, current_command_.retry);
+                else
+                    BRIDGE_LOGW(*log_, "Device", "Command timeout: type=%d retry=%u", current_command_.type, current_command_.retry);
             }
 
             if (current_command_.type == CommandType::DeviceId && !device_id_logged_ && current_command_.retry == 0 && !initial_deviceid_recovery_done_)
             {
                 // First DeviceId timeout immediately after attach: force a single host restart to re-enumerate cleanly.
                 initial_deviceid_recovery_done_ = true;
-                if (line_handler_)
-                    line_handler_(String("DeviceId timed out immediately after attach; restarting USB host once."));
+                if (log_)
+                    BRIDGE_LOGW(*log_, "Device", "DeviceId timed out immediately after attach; restarting USB host once.");
                 awaiting_response_ = false;
                 has_current_command_ = false;
                 command_queue_.clear();
@@ -419,14 +419,14 @@ void DeviceManager::onLine(const String &line)
                 }
             }
 
-            if (line_handler_)
+            if (log_)
             {
                 if (model.length())
-                    line_handler_(String("Device Model: ") + model);
+                    BRIDGE_LOGI(*log_, "Device", "Device Model: %s", model);
                 if (firmware.length())
-                    line_handler_(String("Firmware: ") + firmware);
+                    BRIDGE_LOGI(*log_, "Device", "Firmware: %s", firmware);
                 if (locale.length())
-                    line_handler_(String("Locale: ") + locale);
+                    BRIDGE_LOGI(*log_, "Device", "Locale: %s", locale);
             }
 
             if (model.length())
@@ -456,8 +456,8 @@ void DeviceManager::onLine(const String &line)
         String value = extractPayload(trimmed);
         if (value != "0" && value != "1")
             return;
-        if (line_handler_)
-            line_handler_(String("Device Power: ") + (value == "1" ? "ON" : "OFF"));
+        if (log_)
+            BRIDGE_LOGI(*log_, "Device", "Device Power: %s", value == "1" ? "ON" : "OFF");
         emitResult(CommandType::DevicePower, value, true);
         handleSuccess();
         break;
@@ -467,8 +467,8 @@ void DeviceManager::onLine(const String &line)
         String value = extractPayload(trimmed);
         if (!isDecimalString(value))
             return;
-        if (line_handler_)
-            line_handler_(String("Battery Voltage: ") + value + " V");
+        if (log_)
+            BRIDGE_LOGI(*log_, "Device", "Battery Voltage: %s V", value);
         emitResult(CommandType::DeviceBatteryVoltage, value, true);
 
         float voltage = value.toFloat();
@@ -477,10 +477,10 @@ void DeviceManager::onLine(const String &line)
             percent = 0.0f;
         if (percent > 100.0f)
             percent = 100.0f;
-        uint8_t percentInt = static_cast<uint8_t>(percent + 0.5f);
-        if (line_handler_)
-            line_handler_(String("Battery Percent: ") + percentInt + " %");
-        emitResult(CommandType::DeviceBatteryPercent, String(percentInt), true);
+        NumberFormat::Unsigned percentText(static_cast<uint8_t>(percent + 0.5f));
+        if (log_)
+            BRIDGE_LOGI(*log_, "Device", "Battery Percent: %s %%", percentText.c_str());
+        emitResult(CommandType::DeviceBatteryPercent, String(percentText.c_str()), true);
         handleSuccess();
         break;
     }
@@ -489,14 +489,14 @@ void DeviceManager::onLine(const String &line)
         String value = extractPayload(trimmed);
         if (!isUnsignedIntegerString(value))
             return;
-        if (line_handler_)
+        if (log_)
         {
             time_t ts = static_cast<time_t>(value.toInt());
             struct tm tm_info;
             gmtime_r(&ts, &tm_info);
             char buf[32];
             strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S UTC", &tm_info);
-            line_handler_(String("Device Time: ") + buf + " (" + value + ")");
+            BRIDGE_LOGI(*log_, "Device", "Device Time: %s (%s)", static_cast<const char *>(buf), value);
         }
         emitResult(CommandType::DeviceTime, value, true);
         handleSuccess();
@@ -507,8 +507,8 @@ void DeviceManager::onLine(const String &line)
         String zone = extractPayload(trimmed);
         if (!isDecimalString(zone, true))
             return;
-        if (line_handler_)
-            line_handler_(String("Device Time Zone: ") + zone);
+        if (log_)
+            BRIDGE_LOGI(*log_, "Device", "Device Time Zone: %s", zone);
         emitResult(CommandType::DeviceTimeZone, zone, true);
         handleSuccess();
         break;
@@ -530,8 +530,8 @@ void DeviceManager::onLine(const String &line)
         String value = extractPayload(trimmed);
         if (!isUnsignedIntegerString(value))
             return;
-        if (line_handler_)
-            line_handler_(String("Tube Lifetime: ") + value + " s");
+        if (log_)
+            BRIDGE_LOGI(*log_, "Device", "Tube Lifetime: %s s", value);
         emitResult(CommandType::TubeTime, value, true);
         handleSuccess();
         break;
@@ -541,8 +541,8 @@ void DeviceManager::onLine(const String &line)
         String value = extractPayload(trimmed, true);
         if (!isUnsignedIntegerString(value))
             return;
-        if (line_handler_)
-            line_handler_(String("Tube Pulse Count: ") + value);
+        if (log_)
+            BRIDGE_LOGI(*log_, "Device", "Tube Pulse Count: %s", value);
         emitResult(CommandType::TubePulseCount, value, true);
         handleSuccess();
         break;
@@ -552,8 +552,8 @@ void DeviceManager::onLine(const String &line)
         String value = extractPayload(trimmed, true);
         if (!isDecimalString(value))
             return;
-        if (line_handler_)
-            line_handler_(String("Tube Rate: ") + value + " cpm");
+        if (log_)
+            BRIDGE_LOGI(*log_, "Device", "Tube Rate: %s cpm", value);
         emitResult(CommandType::TubeRate, value, true);
 
         float rate = value.toFloat();
@@ -562,10 +562,10 @@ void DeviceManager::onLine(const String &line)
             float sensitivity = device_sensitivity_cpm_per_uSv_;
             if (sensitivity > 0.0f)
             {
-                float dose = rate / sensitivity;
-                if (line_handler_)
-                    line_handler_(String("Dose Rate: ") + String(dose, 5) + " µSv/h");
-                emitResult(CommandType::TubeDoseRate, String(dose, 5), true);
+                NumberFormat::Fixed doseText(rate / sensitivity, 5);
+                if (log_)
+                    BRIDGE_LOGI(*log_, "Device", "Dose Rate: %s µSv/h", doseText.c_str());
+                emitResult(CommandType::TubeDoseRate, String(doseText.c_str()), true);
             }
         }
         handleSuccess();
@@ -576,8 +576,8 @@ void DeviceManager::onLine(const String &line)
         String value = extractPayload(trimmed);
         if (!isDecimalString(value))
             return;
-        if (line_handler_)
-            line_handler_(String("Tube Dead Time: ") + value + " s");
+        if (log_)
+            BRIDGE_LOGI(*log_, "Device", "Tube Dead Time: %s s", value);
         emitResult(CommandType::TubeDeadTime, value, true);
         handleSuccess();
         break;
@@ -587,8 +587,8 @@ void DeviceManager::onLine(const String &line)
         String value = extractPayload(trimmed);
         if (!isDecimalString(value))
             return;
-        if (line_handler_)
-            line_handler_(String("Dead Time Compensation: ") + value + " s");
+        if (log_)
+            BRIDGE_LOGI(*log_, "Device", "Dead Time Compensation: %s s", value);
         emitResult(CommandType::TubeDeadTimeCompensation, value, true);
         handleSuccess();
         break;
@@ -598,8 +598,8 @@ void DeviceManager::onLine(const String &line)
         String value = extractPayload(trimmed);
         if (!isDecimalString(value))
             return;
-        if (line_handler_)
-            line_handler_(String("HV Frequency: ") + value + " Hz");
+        if (log_)
+            BRIDGE_LOGI(*log_, "Device", "HV Frequency: %s Hz", value);
         emitResult(CommandType::TubeHVFrequency, value, true);
         handleSuccess();
         break;
@@ -609,8 +609,8 @@ void DeviceManager::onLine(const String &line)
         String value = extractPayload(trimmed);
         if (!isDecimalString(value))
             return;
-        if (line_handler_)
-            line_handler_(String("HV Duty Cycle: ") + value);
+        if (log_)
+            BRIDGE_LOGI(*log_, "Device", "HV Duty Cycle: %s", value);
         emitResult(CommandType::TubeHVDutyCycle, value, true);
         handleSuccess();
         break;
@@ -642,8 +642,8 @@ void DeviceManager::onLine(const String &line)
     }
     case CommandType::Generic:
     {
-        if (line_handler_)
-            line_handler_(String("") + current_command_.command + " -> " + trimmed);
+        if (log_)
+            BRIDGE_LOGI(*log_, "Device", "%s -> %s", current_command_.command, trimmed);
         handleSuccess();
         break;
     }
@@ -766,10 +766,8 @@ void DeviceManager::handleError()
         retry.ready_ms = millis() + DEVICE_ID_RETRY_DELAY_MS;
         command_queue_.insert(command_queue_.begin(), retry);
         retryScheduled = true;
-        if (line_handler_)
-        {
-            line_handler_(String("Retrying DeviceId (attempt ") + String(retry.retry + 1) + "/" + String(DEVICE_ID_MAX_RETRY + 1) + ")");
-        }
+        if (log_)
+            BRIDGE_LOGW(*log_, "Device", "Retrying DeviceId (attempt %u/%u)", retry.retry + 1, DEVICE_ID_MAX_RETRY + 1);
     }
     else if ((current_command_.type == CommandType::TubePulseCount || current_command_.type == CommandType::TubeRate ||
               current_command_.type == CommandType::DevicePower ||
@@ -782,14 +780,14 @@ void DeviceManager::handleError()
         command_queue_.push_back(retry);
         retryScheduled = true;
     }
-    else if (line_handler_ && device_id_logged_ &&
+    else if (log_ && device_id_logged_ &&
              current_command_.type != CommandType::TubePulseCount &&
              current_command_.type != CommandType::TubeRate &&
              current_command_.type != CommandType::DevicePower &&
              current_command_.type != CommandType::DeviceBatteryVoltage &&
              current_command_.type != CommandType::DeviceBatteryPercent)
     {
-        line_handler_(String("Command failed: ") + current_command_.command);
+        BRIDGE_LOGW(*log_, "Device", "Command failed: %s", current_command_.command);
     }
 
     if (!retryScheduled)
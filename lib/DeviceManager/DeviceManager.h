@@ -51,7 +51,12 @@ public:
 
     using CommandResultHandler = std::function<void(CommandType, const String &, bool)>;
 
+    // Lines that drive LED state (USB connect/disconnect, device ID,
+    // sensitivity) plus on-demand and verbose output go to the line handler;
+    // routine telemetry and command errors are logged to log as structured
+    // records.
     void setLineHandler(LineHandler handler) { line_handler_ = std::move(handler); }
+    void setLog(Print &log) { log_ = &log; }
     void setRawHandler(RawHandler handler) { raw_handler_ = std::move(handler); }
     void setCommandResultHandler(CommandResultHandler handler) { command_result_handler_ = std::move(handler); }
 
@@ -105,6 +110,7 @@ private:
     UsbCdcHost &host_;
 
     LineHandler line_handler_ = nullptr;
+    Print *log_ = nullptr;
     RawHandler raw_handler_ = nullptr;
     CommandResultHandler command_result_handler_ = nullptr;
 
@@ -30,6 +30,7 @@
 #include "Radmon/RadmonPublisher.h"
 #include "OpenRadiation/OpenRadiationPublisher.h"
 #include "Safecast/SafecastPublisher.h"
+#include "Influx/InfluxPublisher.h"
 #include "BridgeDiagnostics.h"
 #include "PeripheralStarter.h"
 #include "Time/TimeSync.h"
@@ -38,8 +39,13 @@
 #include "Ota/OtaUpdateService.h"
 #include "FileSystem/BridgeFileSystem.h"
 #include "Logging/DebugLogStream.h"
+#include "Logging/LogFileWriter.h"
+#include "Logging/StructuredLog.h"
 #include "Publishing/PublisherHealth.h"
+#include "Publishing/PublisherRegistry.h"
+#include "Runtime/AppStateLock.h"
 #include "Runtime/CooperativePump.h"
+#include "Runtime/ReadIntervalOverride.h"
 #include "UsbRecoveryPolicy.h"
 
 #ifndef BRIDGE_FIRMWARE_VERSION
@@ -62,6 +68,7 @@
 
 static DebugLogStream debugSerial(DBG_SERIAL);
 #define DBG debugSerial
+static LogFileWriter logFileWriter(DBG);
 
 // =========================
 // Startup configuration
@@ -74,6 +81,8 @@ static bool isRunning = false;
 static unsigned long startupDelayMs = INITIAL_STARTUP_DELAY_MS;
 static unsigned long startupStartTime = 0;
 // Forward declarations
+static void handleConsoleCommands();
+static void runConsoleCommand(const char *text);
 static void handleStartupLogic();
 static void runMainLogic();
 static void serviceCooperativeTasksDuringNetworkWait();
@@ -82,7 +91,7 @@ static const char *ledModeName(LedMode mode);
 static const char *deviceActivityFaultName(DeviceActivityFault fault);
 static void updateDeviceErrorState();
 static void handleDeviceActivityTransition(DeviceActivityFault previousFault, DeviceActivityFault currentFault);
-static void clearPendingMeasurementPublishers();
+static uint32_t firmwareBuildId();
 
 // =========================
 // USB Host wrapper
@@ -104,18 +113,29 @@ static bool lastDeviceReadyLogged = false;
 
 static AppConfig appConfig;
 static AppConfigStore configStore;
+static PublisherHealth mqttHealth;
 static PublisherHealth openSenseMapHealth;
 static PublisherHealth gmcMapHealth;
 static PublisherHealth radmonHealth;
 static PublisherHealth openRadiationHealth;
 static PublisherHealth safecastHealth;
-static WiFiPortalService portalService(appConfig, configStore, deviceInfoStore, DBG, ledController, openSenseMapHealth, gmcMapHealth, radmonHealth, openRadiationHealth, safecastHealth);
-static MqttPublisher mqttPublisher(appConfig, DBG, ledController);
+static PublisherHealth influxHealth;
+static WiFiPortalService portalService(appConfig, configStore, deviceInfoStore, DBG, ledController, mqttHealth, openSenseMapHealth, gmcMapHealth, radmonHealth, openRadiationHealth, safecastHealth, influxHealth);
+static MqttPublisher mqttPublisher(appConfig, DBG, ledController, mqttHealth);
 static OpenSenseMapPublisher openSenseMapPublisher(appConfig, DBG, BRIDGE_FIRMWARE_VERSION, openSenseMapHealth);
 static GmcMapPublisher gmcMapPublisher(appConfig, DBG, BRIDGE_FIRMWARE_VERSION, gmcMapHealth);
 static RadmonPublisher radmonPublisher(appConfig, DBG, BRIDGE_FIRMWARE_VERSION, radmonHealth);
 static OpenRadiationPublisher openRadiationPublisher(appConfig, deviceInfoStore, DBG, BRIDGE_FIRMWARE_VERSION, openRadiationHealth);
 static SafecastPublisher safecastPublisher(appConfig, DBG, BRIDGE_FIRMWARE_VERSION, safecastHealth);
+static InfluxPublisher influxPublisher(appConfig, DBG, BRIDGE_FIRMWARE_VERSION, influxHealth);
+static PublisherRegistry<MqttPublisher,
+                         OpenSenseMapPublisher,
+                         GmcMapPublisher,
+                         RadmonPublisher,
+                         OpenRadiationPublisher,
+                         SafecastPublisher,
+                         InfluxPublisher>
+    publishers(mqttPublisher, openSenseMapPublisher, gmcMapPublisher, radmonPublisher, openRadiationPublisher, safecastPublisher, influxPublisher);
 static TimeSync timeSync(DBG);
 static bool deviceReady = false;
 static bool deviceError = false;
@@ -127,6 +147,8 @@ static unsigned long lastUsbRestartAttemptMs = 0;
 static PeripheralStarter peripheralStarter(device_manager, usb, mqttPublisher, openSenseMapPublisher, gmcMapPublisher, radmonPublisher, ledController, DBG, ALLOW_EARLY_START, BRIDGE_FIRMWARE_VERSION);
 static LedMode lastLoggedMode = LedMode::Booting;
 static DeviceActivityMonitor deviceActivityMonitor;
+static ReadIntervalOverride readIntervalOverride;
+static TaskHandle_t mainTaskHandle = nullptr;
 
 // =========================
 // Arduino setup / loop
@@ -136,12 +158,23 @@ void setup()
     // Bring up both Serial endpoints to be safe
     Serial.begin(115200);
     DBG.begin(115200);
+    // RTC memory only holds a previous tail after a warm reset.
+    esp_reset_reason_t resetReason = esp_reset_reason();
+    DBG.beginCrashTail(firmwareBuildId(), resetReason != ESP_RST_POWERON && resetReason != ESP_RST_UNKNOWN);
     delay(300);
 
     // Confirm current app as valid to cancel any pending rollback.
     esp_ota_mark_app_valid_cancel_rollback();
 
     DBG.println("Initializing RadPro WiFi Bridge…");
+    size_t previousBootBytes = 0;
+    DBG.previousBoot(previousBootBytes);
+    if (previousBootBytes)
+    {
+        DBG.print("Log from before the reset kept (");
+        DBG.print(static_cast<unsigned long>(previousBootBytes));
+        DBG.println(" bytes): /logs/previous.txt");
+    }
 
     if (!BridgeFileSystem::mount(DBG, "setup-initial", true))
     {
@@ -188,7 +221,6 @@ void setup()
     }
 #endif
 
-    esp_reset_reason_t resetReason = esp_reset_reason();
     if (resetReason == ESP_RST_BROWNOUT)
     {
         ledController.activateFault(FaultCode::PowerBrownout);
@@ -203,12 +235,15 @@ void setup()
     ledController.update();
 
     diagnostics.initialize();
+    mainTaskHandle = xTaskGetCurrentTaskHandle();
+    AppStateLock::begin();
     CooperativePump::setCallback(serviceCooperativeTasksDuringNetworkWait);
 
     // Record start time for non-blocking startup delay
     startupStartTime = millis();
 
     device_manager.setLineHandler([&](const String &line) { diagnostics.handleLine(line); });
+    device_manager.setLog(DBG);
     device_manager.setRawHandler([&](const uint8_t *data, size_t len) { diagnostics.handleRaw(data, len); });
     usb.setDebugSink(&DBG);
     device_manager.setCommandResultHandler([&](DeviceManager::CommandType type, const String &value, bool success) {
@@ -288,12 +323,13 @@ void setup()
         if (!suppressTelemetry)
         {
             deviceInfoStore.update(type, value);
-            mqttPublisher.onCommandResult(type, value);
-            openSenseMapPublisher.onCommandResult(type, value);
-            gmcMapPublisher.onCommandResult(type, value);
-            radmonPublisher.onCommandResult(type, value);
-            openRadiationPublisher.onCommandResult(type, value);
-            safecastPublisher.onCommandResult(type, value);
+            if (type == DeviceManager::CommandType::DeviceId ||
+                type == DeviceManager::CommandType::DeviceModel ||
+                type == DeviceManager::CommandType::DeviceFirmware ||
+                type == DeviceManager::CommandType::DeviceLocale)
+                publishers.onIdentityResult(type, value);
+            else
+                publishers.onCommandResult(type, value);
         }
     });
 
@@ -309,10 +345,13 @@ void setup()
 
     portalService.begin();
     portalService.setSafecastPublisher(safecastPublisher);
+    portalService.setPublisherLoopStats(publishers.loopStats(), publishers.size());
+    portalService.setLogFileWriter(logFileWriter);
     openRadiationPublisher.begin();
     safecastPublisher.begin();
+    influxPublisher.begin();
     portalService.setOtaStartCallback([&]()
-                                      { OtaUpdateService::EnterUpdateMode(device_manager, usb, mqttPublisher, openSenseMapPublisher, gmcMapPublisher, radmonPublisher, safecastPublisher, updateInProgress); });
+                                      { OtaUpdateService::EnterUpdateMode(device_manager, usb, publishers, updateInProgress); });
     timeSync.loop(WiFi.status() == WL_CONNECTED);
     peripheralStarter.startIfNeeded(WiFi.status() == WL_CONNECTED, timeSync.synced(), kSupportedUsbVidPid);
     mqttPublisher.setPublishCallback([&](bool success)
@@ -327,6 +366,50 @@ void setup()
         {
             mqttError = false;
         } });
+    mqttPublisher.setControlHandler([&](const MqttControlRequest &request) -> const char *
+                                    {
+        switch (request.kind)
+        {
+        case MqttControlRequest::Kind::Interval:
+            readIntervalOverride.set(request.intervalMs, request.durationSeconds * 1000UL, millis());
+            if (request.intervalMs)
+            {
+                DBG.print("Read interval override: ");
+                DBG.print(request.intervalMs);
+                if (request.durationSeconds)
+                {
+                    DBG.print(" ms for ");
+                    DBG.print(request.durationSeconds);
+                    DBG.println(" s.");
+                }
+                else
+                {
+                    DBG.println(" ms until reset.");
+                }
+            }
+            else
+            {
+                DBG.println("Read interval override cleared.");
+            }
+            return nullptr;
+        case MqttControlRequest::Kind::DataLog:
+            if (!deviceReady)
+                return "device not ready";
+            device_manager.requestDataLog(String(request.args));
+            return nullptr;
+        case MqttControlRequest::Kind::RandomData:
+            if (!deviceReady)
+                return "device not ready";
+            device_manager.requestRandomData();
+            return nullptr;
+        case MqttControlRequest::Kind::Poll:
+            if (!deviceReady)
+                return "device not ready";
+            device_manager.requestStats();
+            return nullptr;
+        default:
+            return "not supported";
+        } });
 
     WiFi.mode(WIFI_STA);
     WiFi.setHostname(appConfig.deviceName.c_str());
@@ -337,12 +420,7 @@ void setup()
         portalService.connect(true);
     }
     timeSync.loop(WiFi.status() == WL_CONNECTED);
-    mqttPublisher.updateConfig();
-    openSenseMapPublisher.updateConfig();
-    gmcMapPublisher.updateConfig();
-    radmonPublisher.updateConfig();
-    openRadiationPublisher.updateConfig();
-    safecastPublisher.updateConfig();
+    publishers.updateConfig();
     portalService.maintain();
     diagnostics.updateLedStatus(isRunning, deviceError, mqttError, deviceReady);
     LedMode currentMode = ledController.currentModeForDebug();
@@ -353,13 +431,19 @@ void setup()
         lastLoggedMode = currentMode;
     }
     ledController.update();
+    portalService.startTask();
 }
 
 void loop()
 {
+    // Portal routes that use the configuration or the publishers wait for
+    // the end of this iteration or a publisher network wait; see
+    // AppStateLock.h.
+    AppStateLock::Guard appState;
     const bool wifiConnected = WiFi.status() == WL_CONNECTED;
     timeSync.loop(wifiConnected);
     peripheralStarter.startIfNeeded(wifiConnected, timeSync.synced(), kSupportedUsbVidPid);
+    handleConsoleCommands();
 
     if (!isRunning)
     {
@@ -374,23 +458,22 @@ void loop()
     {
         device_manager.loop();
     }
-    portalService.syncIfRequested();
-    portalService.maintain();
-    portalService.process();
+    if (!portalService.taskRunning())
+    {
+        portalService.syncIfRequested();
+        portalService.maintain();
+        portalService.process();
+    }
     if (!updateInProgress && peripheralStarter.started())
     {
-        mqttPublisher.updateConfig();
-        mqttPublisher.loop();
-        openSenseMapPublisher.updateConfig();
-        openSenseMapPublisher.loop();
-        gmcMapPublisher.updateConfig();
-        gmcMapPublisher.loop();
-        radmonPublisher.updateConfig();
-        radmonPublisher.loop();
-        openRadiationPublisher.updateConfig();
-        openRadiationPublisher.loop();
-        safecastPublisher.updateConfig();
-        safecastPublisher.loop();
+        publishers.updateConfig();
+        publishers.loop();
+    }
+    // OTA unmounts LittleFS.
+    if (!updateInProgress)
+    {
+        logFileWriter.setEnabled(appConfig.logFileEnabled);
+        logFileWriter.loop();
     }
 
     const bool usbConnected = usb.isConnected();
@@ -406,11 +489,7 @@ void loop()
             commandError = false;
             updateDeviceErrorState();
             deviceInfoStore.clearLiveData();
-            openSenseMapPublisher.clearPendingData();
-            gmcMapPublisher.clearPendingData();
-            radmonPublisher.clearPendingData();
-            openRadiationPublisher.clearPendingData();
-            safecastPublisher.clearPendingData();
+            publishers.clearPendingData();
         }
 
         if (deviceReady)
@@ -456,11 +535,123 @@ void loop()
     }
     diagnostics.updateLedStatus(isRunning, deviceError, mqttError, deviceReady);
     ledController.update();
+    appState.release();
 
     // Keep loop snappy; USB host runs in its own tasks
     delay(5);
 }
 
+// =========================
+// Serial console
+// =========================
+// Runs on every loop iteration; delay and early start only apply while the
+// startup countdown is still running.
+// Collects console input without blocking the loop; a command runs once
+// its line ends. Longer lines are discarded whole.
+static void handleConsoleCommands()
+{
+    static char line[64];
+    static size_t lineLength = 0;
+    static bool lineOverflow = false;
+
+    while (DBG.available() > 0)
+    {
+        const int c = DBG.read();
+        if (c < 0)
+            break;
+        if (c != '\n' && c != '\r')
+        {
+            if (lineLength < sizeof(line) - 1)
+                line[lineLength++] = static_cast<char>(c);
+            else
+                lineOverflow = true;
+            continue;
+        }
+
+        line[lineLength] = '\0';
+        const bool complete = !lineOverflow;
+        lineLength = 0;
+        lineOverflow = false;
+        if (complete)
+            runConsoleCommand(line);
+    }
+}
+
+static void runConsoleCommand(const char *text)
+{
+    String command(text);
+    command.trim();
+    if (!command.length())
+        return;
+
+    if (!isRunning && command.startsWith("delay "))
+    {
+        long newDelay = command.substring(6).toInt();
+        if (newDelay > 0)
+        {
+            startupDelayMs = (unsigned long)newDelay;
+            startupStartTime = millis(); // reset timer
+            DBG.print("Startup delay updated to: ");
+            DBG.print(startupDelayMs);
+            DBG.println(" ms");
+        }
+    }
+    else if (command.equalsIgnoreCase("raw on"))
+    {
+        device_manager.setRawLogging(true);
+        DBG.println("USB raw logging enabled.");
+    }
+    else if (command.equalsIgnoreCase("raw off"))
+    {
+        device_manager.setRawLogging(false);
+        DBG.println("USB raw logging disabled.");
+    }
+    else if (command.equalsIgnoreCase("raw toggle"))
+    {
+        device_manager.toggleRawLogging();
+        DBG.print("USB raw logging toggled ");
+        DBG.println(device_manager.rawLoggingEnabled() ? "ON." : "OFF.");
+    }
+    else if (command.startsWith("log "))
+    {
+        String level = command.substring(4);
+        level.trim();
+        if (level.equalsIgnoreCase("error"))
+            StructuredLog::setLevel(LogLevel::Error);
+        else if (level.equalsIgnoreCase("warn"))
+            StructuredLog::setLevel(LogLevel::Warn);
+        else if (level.equalsIgnoreCase("info"))
+            StructuredLog::setLevel(LogLevel::Info);
+        else if (level.equalsIgnoreCase("debug"))
+        {
+            if (BRIDGE_LOG_LEVEL >= static_cast<int>(LogLevel::Debug))
+                StructuredLog::setLevel(LogLevel::Debug);
+            else
+                DBG.println("Debug records are not compiled in; build with -DBRIDGE_LOG_LEVEL=4.");
+        }
+        DBG.print("Log level: ");
+        DBG.println(LogRecord::levelName(StructuredLog::level()));
+    }
+    else if (command.equalsIgnoreCase("usb debug on"))
+    {
+        diagnostics.setUsbDebugEnabled(true);
+    }
+    else if (command.equalsIgnoreCase("usb debug off"))
+    {
+        diagnostics.setUsbDebugEnabled(false);
+    }
+    else if (command.equalsIgnoreCase("usb debug toggle"))
+    {
+        diagnostics.toggleUsbDebug();
+    }
+    else if (!isRunning && ALLOW_EARLY_START)
+    {
+        // handleStartupLogic() starts once the peripherals are up.
+        startupDelayMs = 0;
+        DBG.println("Early start triggered by user!");
+    }
+}
+
 // =========================
 // Startup state machine
 // =========================
@@ -481,60 +672,7 @@ static void handleStartupLogic()
         isRunning = true;
     }
 
-    // 2) User commands on DBG (e.g., CP210x UART)
-    if (DBG.available() > 0)
-    {
-        String command = DBG.readStringUntil('\n');
-        command.trim();
-
-        if (command.startsWith("delay "))
-        {
-            long newDelay = command.substring(6).toInt();
-            if (newDelay > 0)
-            {
-                startupDelayMs = (unsigned long)newDelay;
-                startupStartTime = millis(); // reset timer
-                DBG.print("Startup delay updated to: ");
-                DBG.print(startupDelayMs);
-                DBG.println(" ms");
-            }
-        }
-        else if (command.equalsIgnoreCase("raw on"))
-        {
-            device_manager.setRawLogging(true);
-            DBG.println("USB raw logging enabled.");
-        }
-        else if (command.equalsIgnoreCase("raw off"))
-        {
-            device_manager.setRawLogging(false);
-            DBG.println("USB raw logging disabled.");
-        }
-        else if (command.equalsIgnoreCase("raw toggle"))
-        {
-            device_manager.toggleRawLogging();
-            DBG.print("USB raw logging toggled ");
-            DBG.println(device_manager.rawLoggingEnabled() ? "ON." : "OFF.");
-        }
-        else if (command.equalsIgnoreCase("usb debug on"))
-        {
-            diagnostics.setUsbDebugEnabled(true);
-        }
-        else if (command.equalsIgnoreCase("usb debug off"))
-        {
-            diagnostics.setUsbDebugEnabled(false);
-        }
-        else if (command.equalsIgnoreCase("usb debug toggle"))
-        {
-            diagnostics.toggleUsbDebug();
-        }
-        else if (ALLOW_EARLY_START && command.length() > 0)
-        {
-            isRunning = true;
-            DBG.println("Early start triggered by user!");
-        }
-    }
-
-    // 3) If starting now, announce and switch LED to a short "go" blink
+    // 2) If starting now, announce and switch LED to a short "go" blink
     if (isRunning)
     {
         DBG.println("Starting RadPro WiFi Bridge…");
@@ -564,7 +702,7 @@ static void runMainLogic()
     // Poll rad-pro statistics according to configured interval
     static unsigned long lastStatsRequest = 0;
     unsigned long now = millis();
-    uint32_t interval = appConfig.readIntervalMs;
+    uint32_t interval = readIntervalOverride.effective(appConfig.readIntervalMs, now);
     if (interval < kMinReadIntervalMs)
         interval = kMinReadIntervalMs;
     uint32_t stalePulseTimeoutMs = DeviceActivityMonitor::kDefaultStalePulseTimeoutMs;
@@ -580,10 +718,22 @@ static void runMainLogic()
 
 static void serviceCooperativeTasksDuringNetworkWait()
 {
+    // Portal test uploads wait on the network from the portal task; the
+    // LED and device state belong to the main loop.
+    if (xTaskGetCurrentTaskHandle() != mainTaskHandle)
+    {
+        delay(10);
+        return;
+    }
+
     portalService.process();
     diagnostics.updateLedStatus(isRunning, deviceError, mqttError, deviceReady);
     ledController.update();
-    delay(10);
+    {
+        // A publisher waiting on the network must not hold the portal off.
+        AppStateLock::Released released;
+        delay(10);
+    }
     yield();
 }
 
@@ -592,14 +742,6 @@ static void updateDeviceErrorState()
     deviceError = commandError || deviceActivityMonitor.hasFault();
 }
 
-static void clearPendingMeasurementPublishers()
-{
-    openSenseMapPublisher.clearPendingData();
-    gmcMapPublisher.clearPendingData();
-    radmonPublisher.clearPendingData();
-    openRadiationPublisher.clearPendingData();
-}
-
 static void handleDeviceActivityTransition(DeviceActivityFault previousFault, DeviceActivityFault currentFault)
 {
     if (previousFault == currentFault)
@@ -614,7 +756,7 @@ static void handleDeviceActivityTransition(DeviceActivityFault previousFault, De
     DBG.print("Device telemetry alarm: ");
     DBG.println(deviceActivityFaultName(currentFault));
     deviceInfoStore.clearMeasurements();
-    clearPendingMeasurementPublishers();
+    publishers.clearPendingData();
 }
 
 static const char *commandTypeName(DeviceManager::CommandType type)
@@ -702,3 +844,18 @@ static const char *ledModeName(LedMode mode)
     }
     return "Unknown";
 }
+
+// Ties the RTC log tail to this build: its records point at format strings
+// that only this image is guaranteed to have at the same addresses.
+static uint32_t firmwareBuildId()
+{
+#ifdef HAS_ESP_APP_DESC
+    const esp_app_desc_t *desc = esp_app_get_description();
+#else
+    const esp_app_desc_t *desc = esp_ota_get_app_description();
+#endif
+    uint32_t id = 0;
+    if (desc)
+        memcpy(&id, desc->app_elf_sha256, sizeof(id));
+    return id;
+}
@@ -0,0 +1,88 @@
+// SPDX-FileCopyrightText: 2026 André Fiedler
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "Logging/ByteFifo.h"
+
+namespace
+{
+bool push(ByteFifo &fifo, const std::string &text)
+{
+    return fifo.push(reinterpret_cast<const uint8_t *>(text.data()), text.size());
+}
+
+std::string pop(ByteFifo &fifo, size_t maxLength)
+{
+    uint8_t out[64];
+    const size_t length = fifo.pop(out, maxLength < sizeof(out) ? maxLength : sizeof(out));
+    return std::string(reinterpret_cast<const char *>(out), length);
+}
+
+void testKeepsOrderAcrossTheWrap()
+{
+    uint8_t buffer[8];
+    ByteFifo fifo;
+    assert(!fifo.ready());
+    fifo.attach(buffer, sizeof(buffer));
+    assert(fifo.ready() && fifo.empty());
+
+    assert(push(fifo, "abcdef"));
+    assert(pop(fifo, 4) == "abcd");
+    // Wraps: two bytes at the end, four at the start.
+    assert(push(fifo, "ghijkl"));
+    assert(fifo.size() == 8);
+    assert(pop(fifo, 3) == "efg");
+    assert(pop(fifo, 64) == "hijkl");
+    assert(fifo.empty());
+    assert(pop(fifo, 64).empty());
+}
+
+void testDropsWritesThatDoNotFitWhole()
+{
+    uint8_t buffer[8];
+    ByteFifo fifo;
+    fifo.attach(buffer, sizeof(buffer));
+    assert(push(fifo, "12345"));
+    assert(!push(fifo, "6789"));
+    assert(!push(fifo, "too long for it"));
+    assert(push(fifo, "678"));
+    assert(fifo.takeDropped() == 4 + 15);
+    assert(fifo.takeDropped() == 0);
+    assert(pop(fifo, 64) == "12345678");
+    assert(push(fifo, ""));
+}
+
+void testPopUntilStopsInFrontOfMarker()
+{
+    uint8_t storage[8];
+    ByteFifo fifo;
+    fifo.attach(storage, sizeof(storage));
+    assert(push(fifo, "abcde"));
+    assert(pop(fifo, 5) == "abcde");
+    // Wraps: "xy", marker, "z" sits across the end of storage.
+    assert(push(fifo, std::string("xy\0z", 4)));
+
+    uint8_t out[8];
+    assert(fifo.popUntil(out, sizeof(out), 0) == 2);
+    assert(std::memcmp(out, "xy", 2) == 0);
+    assert(fifo.popUntil(out, sizeof(out), 0) == 0);
+    assert(fifo.size() == 2);
+    assert(fifo.pop(out, 1) == 1 && out[0] == 0);
+    assert(fifo.popUntil(out, sizeof(out), 0) == 1 && out[0] == 'z');
+    assert(fifo.empty());
+}
+} // namespace
+
+int main()
+{
+    testKeepsOrderAcrossTheWrap();
+    testDropsWritesThatDoNotFitWhole();
+    testPopUntilStopsInFrontOfMarker();
+    std::cout << "Byte FIFO tests passed\n";
+    return 0;
+}
@@ -0,0 +1,118 @@
+// SPDX-FileCopyrightText: 2026 André Fiedler
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "DeviceInfo/DeviceInfoDelta.h"
+
+namespace
+{
+struct Values
+{
+    std::string fields[DeviceInfoDelta::FieldCount];
+
+    const char *operator()(DeviceInfoDelta::Field field, size_t &length) const
+    {
+        length = fields[field].size();
+        return fields[field].c_str();
+    }
+};
+
+std::string render(uint32_t mask, const Values &values, long ageMs, size_t capacity = DeviceInfoDelta::kMaxJsonBytes)
+{
+    char out[DeviceInfoDelta::kMaxJsonBytes];
+    const size_t length = DeviceInfoDelta::writeJson(out, capacity, mask, values, ageMs);
+    return std::string(out, length);
+}
+
+void testRevisionsTrackChangedFields()
+{
+    DeviceInfoDelta::Revisions revisions;
+    assert(revisions.current() == 0);
+    assert(revisions.changedSince(0) == DeviceInfoDelta::kAllFields);
+
+    revisions.touch(DeviceInfoDelta::DeviceId);
+    revisions.touch(DeviceInfoDelta::TubeRate);
+    const uint32_t seen = revisions.current();
+    assert(seen == 2);
+    assert(revisions.changedSince(seen) == 0);
+    assert(revisions.changedSince(1) == DeviceInfoDelta::bit(DeviceInfoDelta::TubeRate));
+
+    revisions.touch(DeviceInfoDelta::TubePulseCount);
+    revisions.touch(DeviceInfoDelta::TubeRate);
+    assert(revisions.changedSince(seen) ==
+           (DeviceInfoDelta::bit(DeviceInfoDelta::TubeRate) | DeviceInfoDelta::bit(DeviceInfoDelta::TubePulseCount)));
+
+    // A revision from before a reboot is ahead of the store.
+    assert(revisions.changedSince(100) == DeviceInfoDelta::kAllFields);
+}
+
+void testRevisionFromAnotherBootStartsOver()
+{
+    DeviceInfoDelta::Revisions revisions;
+    revisions.touch(DeviceInfoDelta::DeviceId);
+    revisions.touch(DeviceInfoDelta::TubeRate);
+    revisions.touch(DeviceInfoDelta::TubeRate);
+
+    // The page saw revision 3 of the last boot, and this boot is at 3 too.
+    const uint32_t since = DeviceInfoDelta::resumeRevision("1111-3", 2222);
+    assert(since == 0);
+    assert(revisions.changedSince(since) == DeviceInfoDelta::kAllFields);
+
+    // Same boot: only what changed after the client's revision.
+    assert(DeviceInfoDelta::resumeRevision("2222-3", 2222) == 3);
+    assert(revisions.changedSince(3) == 0);
+    assert(revisions.changedSince(DeviceInfoDelta::resumeRevision("2222-2", 2222)) ==
+           DeviceInfoDelta::bit(DeviceInfoDelta::TubeRate));
+
+    // A new page, or an id without an epoch.
+    assert(DeviceInfoDelta::resumeRevision("", 2222) == 0);
+    assert(DeviceInfoDelta::resumeRevision("3", 2222) == 0);
+}
+
+void testWritesOnlyMaskedFields()
+{
+    Values values;
+    values.fields[DeviceInfoDelta::DeviceId] = "RP-1";
+    values.fields[DeviceInfoDelta::TubeRate] = "12.5";
+    values.fields[DeviceInfoDelta::TubePulseCount] = "8812";
+
+    assert(render(0, values, -1) == "{}");
+    assert(render(DeviceInfoDelta::bit(DeviceInfoDelta::DeviceId), values, 250) == "{\"deviceId\":\"RP-1\"}");
+    assert(render(DeviceInfoDelta::bit(DeviceInfoDelta::TubeRate) | DeviceInfoDelta::bit(DeviceInfoDelta::TubePulseCount), values, 250) ==
+           "{\"tubeRate\":\"12.5\",\"tubePulseCount\":\"8812\",\"measurementAgeMs\":250}");
+}
+
+void testClearedFieldsAndMissingMeasurementAreNull()
+{
+    Values values;
+    assert(render(DeviceInfoDelta::bit(DeviceInfoDelta::BatteryVoltage) | DeviceInfoDelta::bit(DeviceInfoDelta::TubeDoseRate), values, -1) ==
+           "{\"batteryVoltage\":null,\"tubeDoseRate\":null,\"measurementAgeMs\":null}");
+}
+
+void testEscapesValuesAndRejectsSmallBuffers()
+{
+    Values values;
+    values.fields[DeviceInfoDelta::Model] = "Bosean \"FS-600\"\\";
+    assert(render(DeviceInfoDelta::bit(DeviceInfoDelta::Model), values, -1) == "{\"model\":\"Bosean \\\"FS-600\\\"\\\\\"}");
+
+    const std::string full = render(DeviceInfoDelta::bit(DeviceInfoDelta::Model), values, -1);
+    assert(render(DeviceInfoDelta::bit(DeviceInfoDelta::Model), values, -1, full.size()) == full);
+    assert(render(DeviceInfoDelta::bit(DeviceInfoDelta::Model), values, -1, full.size() - 1).empty());
+}
+} // namespace
+
+int main()
+{
+    testRevisionsTrackChangedFields();
+    testRevisionFromAnotherBootStartsOver();
+    testWritesOnlyMaskedFields();
+    testClearedFieldsAndMissingMeasurementAreNull();
+    testEscapesValuesAndRejectsSmallBuffers();
+    std::cout << "Device info delta tests passed" << std::endl;
+    return 0;
+}
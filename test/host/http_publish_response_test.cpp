@@ -99,11 +99,31 @@ void testNoResponseBeforeDisconnectIsReported()
 }
 } // namespace
 
+void testStatusLineSplitAcrossSegmentsIsReassembled()
+{
+    FakeClient client{
+        {5, 4, 3, 2, 1, 0, 0, 0, 18, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0},
+        {true},
+        "HTTP/1.1 201 Created\r\n"};
+
+    unsigned long now = 0;
+    const auto result = HttpPublishResponse::readStatus(
+        client,
+        100,
+        [&now]() { return now; },
+        [&now]() { now += 10; });
+
+    assert(result.success);
+    assert(result.statusCode == 201);
+    assert(std::string(result.statusLine.c_str()) == "HTTP/1.1 201 Created");
+}
+
 int main()
 {
     testAcceptsHttp10StatusAfterDelayedReadableBytes();
     testMalformedStatusCapturesTrace();
     testNoResponseBeforeDisconnectIsReported();
+    testStatusLineSplitAcrossSegmentsIsReassembled();
     std::cout << "http publish response tests passed\n";
     return 0;
 }
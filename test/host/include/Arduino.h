@@ -16,6 +16,8 @@
 #include <sstream>
 #include <string>
 
+#define F(text) (text)
+
 class String
 {
 public:
@@ -52,6 +54,12 @@ public:
         value_ = stream.str();
     }
 
+    bool reserve(size_t size)
+    {
+        value_.reserve(size);
+        return true;
+    }
+
     String &operator+=(const char *value)
     {
         value_ += value ? value : "";
@@ -304,6 +312,7 @@ public:
 };
 
 inline unsigned long g_test_millis = 0;
+inline unsigned long g_test_micros = 0;
 inline uint8_t g_neopixel_pin = 0;
 inline uint8_t g_neopixel_r = 0;
 inline uint8_t g_neopixel_g = 0;
@@ -314,6 +323,16 @@ inline unsigned long millis()
     return g_test_millis;
 }
 
+inline unsigned long micros()
+{
+    return g_test_micros;
+}
+
+inline void advanceMicros(unsigned long delta)
+{
+    g_test_micros += delta;
+}
+
 inline void setMillis(unsigned long value)
 {
     g_test_millis = value;
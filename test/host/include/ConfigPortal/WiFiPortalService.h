@@ -0,0 +1,75 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "AppConfig/AppConfig.h"
+#include "Arduino.h"
+#include "WebServer.h"
+
+// Host stand-in for the portal surface that publisher SendPortalForm()
+// helpers touch. Shadows the firmware header, which needs WiFiManager.
+class WiFiPortalService
+{
+public:
+    using TemplateReplacements = std::vector<std::pair<String, String>>;
+
+    struct Manager
+    {
+        WebServer *server = nullptr;
+    };
+
+    explicit WiFiPortalService(AppConfig &config) : config_(config) {}
+
+    static String htmlEscape(const String &value)
+    {
+        String escaped;
+        for (size_t i = 0; i < value.length(); ++i)
+        {
+            switch (value[i])
+            {
+            case '&':
+                escaped += "&amp;";
+                break;
+            case '<':
+                escaped += "&lt;";
+                break;
+            case '>':
+                escaped += "&gt;";
+                break;
+            case '"':
+                escaped += "&quot;";
+                break;
+            case '\'':
+                escaped += "&#39;";
+                break;
+            default:
+                escaped += value[i];
+                break;
+            }
+        }
+        return escaped;
+    }
+
+    void appendCommonTemplateVars(TemplateReplacements &)
+    {
+    }
+
+    bool sendTemplate(const char *path, const TemplateReplacements &replacements)
+    {
+        lastTemplatePath = path ? path : "";
+        lastReplacements = replacements;
+        return true;
+    }
+
+    AppConfig &config_;
+    Manager manager_;
+    String lastTemplatePath;
+    TemplateReplacements lastReplacements;
+};
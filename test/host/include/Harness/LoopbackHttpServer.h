@@ -0,0 +1,396 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <arpa/inet.h>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <netinet/in.h>
+#include <poll.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace Harness
+{
+enum class ResponseAction
+{
+    Respond,
+    Reset,
+    Hang,
+    CloseWithoutResponse,
+};
+
+// One scripted reply. latencyMs delays the first byte, dripIntervalMs
+// sends the response one byte at a time, Hang holds the connection open
+// until the client gives up (or hangMs passes) and Reset aborts with RST.
+struct ScriptedResponse
+{
+    ResponseAction action = ResponseAction::Respond;
+    int status = 200;
+    std::string reason = "OK";
+    std::string contentType = "text/plain";
+    std::string body;
+    unsigned latencyMs = 0;
+    unsigned dripIntervalMs = 0;
+    unsigned hangMs = 30000;
+};
+
+struct RecordedRequest
+{
+    std::string method;
+    std::string target;
+    std::string version;
+    std::vector<std::pair<std::string, std::string>> headers;
+    std::string body;
+    uint32_t connection = 0;
+
+    std::string header(const char *name) const
+    {
+        const std::string wanted = lower(name);
+        for (const auto &entry : headers)
+        {
+            if (lower(entry.first) == wanted)
+                return entry.second;
+        }
+        return std::string();
+    }
+
+    static std::string lower(std::string text)
+    {
+        for (char &c : text)
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        return text;
+    }
+};
+
+// Minimal HTTP/1.1 server on 127.0.0.1 with an ephemeral port. Replies come
+// from a FIFO of scripted responses and fall back to the default response
+// when the queue is empty. Each connection is served on its own thread and
+// kept alive unless the client sends "Connection: close" or speaks HTTP/1.0.
+class LoopbackHttpServer
+{
+public:
+    LoopbackHttpServer() = default;
+    LoopbackHttpServer(const LoopbackHttpServer &) = delete;
+    LoopbackHttpServer &operator=(const LoopbackHttpServer &) = delete;
+
+    ~LoopbackHttpServer()
+    {
+        stop();
+    }
+
+    bool start()
+    {
+        listenFd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (listenFd_ < 0)
+            return false;
+
+        const int reuse = 1;
+        ::setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_port = 0;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(addr);
+        if (::bind(listenFd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 ||
+            ::listen(listenFd_, 16) != 0 ||
+            ::getsockname(listenFd_, reinterpret_cast<sockaddr *>(&addr), &length) != 0)
+        {
+            ::close(listenFd_);
+            listenFd_ = -1;
+            return false;
+        }
+
+        port_ = ntohs(addr.sin_port);
+        running_ = true;
+        acceptThread_ = std::thread([this]() { acceptLoop(); });
+        return true;
+    }
+
+    void stop()
+    {
+        if (!running_.exchange(false))
+            return;
+        if (acceptThread_.joinable())
+            acceptThread_.join();
+        ::close(listenFd_);
+        listenFd_ = -1;
+
+        std::vector<std::thread> workers;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            workers.swap(workers_);
+        }
+        for (std::thread &worker : workers)
+        {
+            if (worker.joinable())
+                worker.join();
+        }
+    }
+
+    uint16_t port() const
+    {
+        return port_;
+    }
+
+    void setDefaultResponse(const ScriptedResponse &response)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        defaultResponse_ = response;
+    }
+
+    void enqueue(const ScriptedResponse &response)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        scripted_.push_back(response);
+    }
+
+    std::vector<RecordedRequest> requests() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return requests_;
+    }
+
+    size_t requestCount() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return requests_.size();
+    }
+
+    uint32_t connectionCount() const
+    {
+        return connections_.load();
+    }
+
+    void clearRecords()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        requests_.clear();
+        connections_ = 0;
+    }
+
+private:
+    static constexpr int kPollMs = 10;
+    static constexpr int kIdleKeepAliveMs = 2000;
+
+    void acceptLoop()
+    {
+        while (running_)
+        {
+            pollfd entry = {listenFd_, POLLIN, 0};
+            if (::poll(&entry, 1, kPollMs) <= 0)
+                continue;
+            const int clientFd = ::accept(listenFd_, nullptr, nullptr);
+            if (clientFd < 0)
+                continue;
+
+            const uint32_t connection = ++connections_;
+            std::lock_guard<std::mutex> lock(mutex_);
+            workers_.emplace_back([this, clientFd, connection]() { serve(clientFd, connection); });
+        }
+    }
+
+    void serve(int fd, uint32_t connection)
+    {
+        std::string pending;
+        while (running_)
+        {
+            RecordedRequest request;
+            if (!readRequest(fd, pending, request))
+                break;
+            request.connection = connection;
+
+            ScriptedResponse response;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                requests_.push_back(request);
+                if (scripted_.empty())
+                {
+                    response = defaultResponse_;
+                }
+                else
+                {
+                    response = scripted_.front();
+                    scripted_.pop_front();
+                }
+            }
+
+            const bool keepAlive = request.version == "HTTP/1.1" &&
+                                   RecordedRequest::lower(request.header("Connection")) != "close";
+            if (!respond(fd, response, keepAlive) || !keepAlive)
+                break;
+        }
+        if (fd >= 0)
+            ::close(fd);
+    }
+
+    bool waitReadable(int fd, int timeoutMs)
+    {
+        int waited = 0;
+        while (running_ && waited < timeoutMs)
+        {
+            pollfd entry = {fd, POLLIN, 0};
+            const int ready = ::poll(&entry, 1, kPollMs);
+            if (ready > 0)
+                return true;
+            waited += kPollMs;
+        }
+        return false;
+    }
+
+    bool fill(int fd, std::string &pending)
+    {
+        if (!waitReadable(fd, kIdleKeepAliveMs))
+            return false;
+        char buffer[1024];
+        const ssize_t received = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (received <= 0)
+            return false;
+        pending.append(buffer, static_cast<size_t>(received));
+        return true;
+    }
+
+    bool readRequest(int fd, std::string &pending, RecordedRequest &request)
+    {
+        size_t headerEnd = pending.find("\r\n\r\n");
+        while (headerEnd == std::string::npos)
+        {
+            if (!fill(fd, pending))
+                return false;
+            headerEnd = pending.find("\r\n\r\n");
+        }
+
+        const std::string head = pending.substr(0, headerEnd);
+        pending.erase(0, headerEnd + 4);
+
+        size_t lineEnd = head.find("\r\n");
+        const std::string requestLine = head.substr(0, lineEnd);
+        const size_t firstSpace = requestLine.find(' ');
+        const size_t lastSpace = requestLine.rfind(' ');
+        if (firstSpace == std::string::npos || lastSpace == firstSpace)
+            return false;
+        request.method = requestLine.substr(0, firstSpace);
+        request.target = requestLine.substr(firstSpace + 1, lastSpace - firstSpace - 1);
+        request.version = requestLine.substr(lastSpace + 1);
+
+        while (lineEnd != std::string::npos)
+        {
+            const size_t start = lineEnd + 2;
+            lineEnd = head.find("\r\n", start);
+            const std::string line = head.substr(start, lineEnd == std::string::npos ? std::string::npos : lineEnd - start);
+            const size_t colon = line.find(':');
+            if (colon == std::string::npos)
+                continue;
+            std::string value = line.substr(colon + 1);
+            value.erase(0, value.find_first_not_of(' '));
+            request.headers.emplace_back(line.substr(0, colon), value);
+        }
+
+        const size_t bodyLength = std::strtoul(request.header("Content-Length").c_str(), nullptr, 10);
+        while (pending.size() < bodyLength)
+        {
+            if (!fill(fd, pending))
+                return false;
+        }
+        request.body = pending.substr(0, bodyLength);
+        pending.erase(0, bodyLength);
+        return true;
+    }
+
+    bool sendAll(int fd, const char *data, size_t length)
+    {
+        size_t offset = 0;
+        while (offset < length)
+        {
+            const ssize_t sent = ::send(fd, data + offset, length - offset, MSG_NOSIGNAL);
+            if (sent <= 0)
+                return false;
+            offset += static_cast<size_t>(sent);
+        }
+        return true;
+    }
+
+    void sleepMs(unsigned ms)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    }
+
+    bool respond(int &fd, const ScriptedResponse &response, bool keepAlive)
+    {
+        if (response.latencyMs)
+            sleepMs(response.latencyMs);
+
+        switch (response.action)
+        {
+        case ResponseAction::Reset:
+        {
+            const linger abort = {1, 0};
+            ::setsockopt(fd, SOL_SOCKET, SO_LINGER, &abort, sizeof(abort));
+            ::close(fd);
+            fd = -1;
+            return false;
+        }
+        case ResponseAction::Hang:
+        {
+            // Returns once the client closes its side or hangMs passes.
+            char scratch[256];
+            unsigned waited = 0;
+            while (running_ && waited < response.hangMs)
+            {
+                pollfd entry = {fd, POLLIN, 0};
+                if (::poll(&entry, 1, kPollMs) > 0 && ::recv(fd, scratch, sizeof(scratch), 0) <= 0)
+                    break;
+                waited += kPollMs;
+            }
+            return false;
+        }
+        case ResponseAction::CloseWithoutResponse:
+            return false;
+        case ResponseAction::Respond:
+            break;
+        }
+
+        std::string message = "HTTP/1.1 " + std::to_string(response.status) + " " + response.reason + "\r\n";
+        message += "Content-Type: " + response.contentType + "\r\n";
+        message += "Content-Length: " + std::to_string(response.body.size()) + "\r\n";
+        message += keepAlive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+        message += response.body;
+
+        if (!response.dripIntervalMs)
+            return sendAll(fd, message.data(), message.size());
+
+        for (const char c : message)
+        {
+            if (!running_ || !sendAll(fd, &c, 1))
+                return false;
+            sleepMs(response.dripIntervalMs);
+        }
+        return true;
+    }
+
+    int listenFd_ = -1;
+    uint16_t port_ = 0;
+    std::atomic<bool> running_{false};
+    std::atomic<uint32_t> connections_{0};
+    std::thread acceptThread_;
+    mutable std::mutex mutex_;
+    std::vector<std::thread> workers_;
+    std::deque<ScriptedResponse> scripted_;
+    ScriptedResponse defaultResponse_;
+    std::vector<RecordedRequest> requests_;
+};
+} // namespace Harness
@@ -0,0 +1,111 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Arduino.h"
+#include "IPAddress.h"
+
+// Routing table shared by the WiFi, WiFiClient and WiFiClientSecure shims.
+// Publishers keep their real host names and ports; each routed host
+// resolves to 127.0.0.<n> and connecting to (host, port) lands on the
+// loopback port of a Harness::LoopbackHttpServer. Unrouted hosts fail DNS.
+namespace LoopbackNetwork
+{
+struct Route
+{
+    std::string host;
+    uint16_t port = 0;
+    uint16_t localPort = 0;
+    bool tls = false;
+    unsigned long connectLatencyMs = 0;
+};
+
+struct Stats
+{
+    uint32_t dnsLookups = 0;
+    uint32_t dnsFailures = 0;
+    uint32_t connects = 0;
+    uint32_t connectFailures = 0;
+};
+
+inline std::vector<Route> g_routes;
+inline Stats g_stats;
+
+inline void reset()
+{
+    g_routes.clear();
+    g_stats = Stats();
+}
+
+// tls marks endpoints that only accept WiFiClientSecure. TLS itself is not
+// emulated; connectLatencyMs advances the fake millis() clock on connect so
+// handshake time shows up in the publish phase timings.
+inline void route(const char *host,
+                  uint16_t port,
+                  uint16_t localPort,
+                  bool tls = false,
+                  unsigned long connectLatencyMs = 0)
+{
+    Route entry;
+    entry.host = host ? host : "";
+    entry.port = port;
+    entry.localPort = localPort;
+    entry.tls = tls;
+    entry.connectLatencyMs = connectLatencyMs;
+    g_routes.push_back(entry);
+}
+
+inline const Stats &stats()
+{
+    return g_stats;
+}
+
+inline int hostIndex(const char *host)
+{
+    if (!host)
+        return -1;
+    for (size_t i = 0; i < g_routes.size(); ++i)
+    {
+        if (g_routes[i].host == host)
+            return static_cast<int>(i);
+    }
+    return -1;
+}
+
+inline bool resolve(const char *host, IPAddress &address)
+{
+    g_stats.dnsLookups += 1;
+    const int index = hostIndex(host);
+    if (index < 0 || index > 253)
+    {
+        g_stats.dnsFailures += 1;
+        return false;
+    }
+    address = IPAddress(127, 0, 0, static_cast<uint8_t>(index + 1));
+    return true;
+}
+
+inline const Route *find(const IPAddress &address, uint16_t port)
+{
+    if (address[0] != 127 || address[3] == 0)
+        return nullptr;
+    const size_t hostSlot = static_cast<size_t>(address[3] - 1);
+    if (hostSlot >= g_routes.size())
+        return nullptr;
+    const std::string &host = g_routes[hostSlot].host;
+    for (const Route &entry : g_routes)
+    {
+        if (entry.host == host && entry.port == port)
+            return &entry;
+    }
+    return nullptr;
+}
+} // namespace LoopbackNetwork
@@ -0,0 +1,49 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "Arduino.h"
+
+class IPAddress
+{
+public:
+    IPAddress() = default;
+
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : bytes_{a, b, c, d} {}
+
+    uint8_t operator[](int index) const
+    {
+        return bytes_[index];
+    }
+
+    bool operator==(const IPAddress &other) const
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            if (bytes_[i] != other.bytes_[i])
+                return false;
+        }
+        return true;
+    }
+
+    bool operator!=(const IPAddress &other) const
+    {
+        return !(*this == other);
+    }
+
+    String toString() const
+    {
+        char buffer[16];
+        std::snprintf(buffer, sizeof(buffer), "%u.%u.%u.%u", bytes_[0], bytes_[1], bytes_[2], bytes_[3]);
+        return String(buffer);
+    }
+
+private:
+    uint8_t bytes_[4] = {0, 0, 0, 0};
+};
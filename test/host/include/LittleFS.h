@@ -0,0 +1,89 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "Arduino.h"
+
+// In-memory stand-in for LittleFS. Files live in one static map, so data
+// written before a simulated reboot is still there afterwards; reset()
+// wipes the whole "flash".
+class File
+{
+public:
+    File() = default;
+    File(std::string *data, bool append) : data_(data), position_(append && data ? data->size() : 0) {}
+
+    explicit operator bool() const { return data_ != nullptr; }
+    size_t size() const { return data_ ? data_->size() : 0; }
+
+    bool seek(size_t position)
+    {
+        if (!data_ || position > data_->size())
+            return false;
+        position_ = position;
+        return true;
+    }
+
+    size_t read(uint8_t *buffer, size_t length)
+    {
+        if (!data_ || position_ >= data_->size())
+            return 0;
+        const size_t available = data_->size() - position_;
+        const size_t count = length < available ? length : available;
+        data_->copy(reinterpret_cast<char *>(buffer), count, position_);
+        position_ += count;
+        return count;
+    }
+
+    size_t write(const uint8_t *buffer, size_t length)
+    {
+        if (!data_)
+            return 0;
+        data_->replace(position_, length, reinterpret_cast<const char *>(buffer), length);
+        position_ += length;
+        return length;
+    }
+
+    void close() { data_ = nullptr; }
+
+private:
+    std::string *data_ = nullptr;
+    size_t position_ = 0;
+};
+
+class LittleFSFS
+{
+public:
+    File open(const char *path, const char *mode = "r")
+    {
+        const std::string key = path ? path : "";
+        const std::string how = mode ? mode : "r";
+        auto it = files_.find(key);
+        if (how == "r")
+            return it == files_.end() ? File() : File(&it->second, false);
+        if (how == "w")
+        {
+            files_[key].clear();
+            return File(&files_[key], false);
+        }
+        return File(&files_[key], true);
+    }
+
+    bool exists(const char *path) const { return path && files_.count(path) != 0; }
+    bool remove(const char *path) { return path && files_.erase(path) != 0; }
+    void reset() { files_.clear(); }
+
+private:
+    std::unordered_map<std::string, std::string> files_;
+};
+
+inline LittleFSFS LittleFS;
@@ -0,0 +1,69 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "Arduino.h"
+#include "IPAddress.h"
+
+// Form arguments and the remote address are all the publisher portal
+// handlers read from the request.
+class WebServer
+{
+public:
+    class RequestClient
+    {
+    public:
+        IPAddress remoteIP() const
+        {
+            return IPAddress(192, 168, 4, 2);
+        }
+    };
+
+    void setArg(const char *name, const String &value)
+    {
+        for (auto &entry : args_)
+        {
+            if (entry.first == name)
+            {
+                entry.second = value;
+                return;
+            }
+        }
+        args_.emplace_back(String(name), value);
+    }
+
+    bool hasArg(const char *name) const
+    {
+        for (const auto &entry : args_)
+        {
+            if (entry.first == name)
+                return true;
+        }
+        return false;
+    }
+
+    String arg(const char *name) const
+    {
+        for (const auto &entry : args_)
+        {
+            if (entry.first == name)
+                return entry.second;
+        }
+        return String();
+    }
+
+    RequestClient client() const
+    {
+        return RequestClient();
+    }
+
+private:
+    std::vector<std::pair<String, String>> args_;
+};
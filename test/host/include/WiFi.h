@@ -6,6 +6,10 @@
 
 #pragma once
 
+#include "Harness/LoopbackNetwork.h"
+#include "IPAddress.h"
+#include "WiFiClient.h"
+
 enum wl_status_t
 {
     WL_IDLE_STATUS = 0,
@@ -26,6 +30,11 @@ public:
         status_ = status;
     }
 
+    int hostByName(const char *host, IPAddress &address)
+    {
+        return LoopbackNetwork::resolve(host, address) ? 1 : 0;
+    }
+
 private:
     wl_status_t status_ = WL_DISCONNECTED;
 };
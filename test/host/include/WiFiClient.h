@@ -0,0 +1,254 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "Arduino.h"
+#include "Harness/LoopbackNetwork.h"
+#include "IPAddress.h"
+
+// Socket-backed stand-in for the Arduino WiFiClient. Connects through the
+// LoopbackNetwork routing table, buffers writes until flush() or the first
+// read, and never blocks in available(). A reset from the peer closes the
+// client and reports nothing available, like the ESP32 core does.
+class WiFiClient : public Print
+{
+public:
+    WiFiClient() = default;
+    WiFiClient(const WiFiClient &) = delete;
+    WiFiClient &operator=(const WiFiClient &) = delete;
+
+    ~WiFiClient() override
+    {
+        stop();
+    }
+
+    int connect(IPAddress address, uint16_t port)
+    {
+        stop();
+        const LoopbackNetwork::Route *target = LoopbackNetwork::find(address, port);
+        if (!target || target->tls != secureTransport())
+        {
+            LoopbackNetwork::g_stats.connectFailures += 1;
+            return 0;
+        }
+        if (target->connectLatencyMs)
+            advanceMillis(target->connectLatencyMs);
+        if (!openSocket(target->localPort))
+        {
+            LoopbackNetwork::g_stats.connectFailures += 1;
+            return 0;
+        }
+        LoopbackNetwork::g_stats.connects += 1;
+        return 1;
+    }
+
+    int connect(const char *host, uint16_t port)
+    {
+        IPAddress address;
+        if (!LoopbackNetwork::resolve(host, address))
+        {
+            LoopbackNetwork::g_stats.connectFailures += 1;
+            return 0;
+        }
+        return connect(address, port);
+    }
+
+    // Seconds, matching WiFiClient::setTimeout() in the ESP32 core.
+    void setTimeout(uint32_t seconds)
+    {
+        timeoutSeconds_ = seconds;
+        applyTimeout();
+    }
+
+    using Print::write;
+
+    size_t write(uint8_t ch) override
+    {
+        if (fd_ < 0)
+        {
+            writeError_ = 1;
+            return 0;
+        }
+        outbound_.push_back(static_cast<char>(ch));
+        if (outbound_.size() >= kSendChunkBytes)
+            sendOutbound();
+        return fd_ < 0 ? 0 : 1;
+    }
+
+    void flush()
+    {
+        sendOutbound();
+    }
+
+    int available()
+    {
+        sendOutbound();
+        receive();
+        return static_cast<int>(inbound_.size() - inboundOffset_);
+    }
+
+    int read()
+    {
+        if (available() <= 0)
+            return -1;
+        return static_cast<unsigned char>(inbound_[inboundOffset_++]);
+    }
+
+    int read(uint8_t *buffer, size_t size)
+    {
+        const int ready = available();
+        if (ready <= 0)
+            return -1;
+        const size_t count = std::min(size, static_cast<size_t>(ready));
+        std::memcpy(buffer, inbound_.data() + inboundOffset_, count);
+        inboundOffset_ += count;
+        return static_cast<int>(count);
+    }
+
+    int peek()
+    {
+        if (available() <= 0)
+            return -1;
+        return static_cast<unsigned char>(inbound_[inboundOffset_]);
+    }
+
+    uint8_t connected()
+    {
+        receive();
+        return fd_ >= 0 && !peerClosed_ ? 1 : 0;
+    }
+
+    void stop()
+    {
+        if (fd_ >= 0)
+            ::close(fd_);
+        fd_ = -1;
+        peerClosed_ = false;
+        outbound_.clear();
+        inbound_.clear();
+        inboundOffset_ = 0;
+    }
+
+    int getWriteError() const
+    {
+        return writeError_;
+    }
+
+    explicit operator bool()
+    {
+        return connected() != 0;
+    }
+
+protected:
+    virtual bool secureTransport() const
+    {
+        return false;
+    }
+
+private:
+    static constexpr size_t kSendChunkBytes = 1436;
+
+    bool openSocket(uint16_t localPort)
+    {
+        fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (fd_ < 0)
+            return false;
+
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(localPort);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (::connect(fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0)
+        {
+            ::close(fd_);
+            fd_ = -1;
+            return false;
+        }
+
+        const int noDelay = 1;
+        ::setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        writeError_ = 0;
+        applyTimeout();
+        return true;
+    }
+
+    void applyTimeout()
+    {
+        if (fd_ < 0 || !timeoutSeconds_)
+            return;
+        timeval tv = {};
+        tv.tv_sec = static_cast<time_t>(timeoutSeconds_);
+        ::setsockopt(fd_, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    }
+
+    void sendOutbound()
+    {
+        size_t offset = 0;
+        while (fd_ >= 0 && offset < outbound_.size())
+        {
+            const ssize_t sent = ::send(fd_, outbound_.data() + offset, outbound_.size() - offset, MSG_NOSIGNAL);
+            if (sent <= 0)
+            {
+                writeError_ = 1;
+                stop();
+                return;
+            }
+            offset += static_cast<size_t>(sent);
+        }
+        outbound_.clear();
+    }
+
+    void receive()
+    {
+        if (fd_ < 0 || peerClosed_)
+            return;
+        if (inboundOffset_ == inbound_.size())
+        {
+            inbound_.clear();
+            inboundOffset_ = 0;
+        }
+
+        char buffer[512];
+        while (true)
+        {
+            const ssize_t received = ::recv(fd_, buffer, sizeof(buffer), MSG_DONTWAIT);
+            if (received > 0)
+            {
+                inbound_.append(buffer, static_cast<size_t>(received));
+                continue;
+            }
+            if (received == 0)
+            {
+                peerClosed_ = true;
+                return;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+                return;
+
+            // Connection reset: drop whatever was buffered, as the core does.
+            stop();
+            return;
+        }
+    }
+
+    int fd_ = -1;
+    uint32_t timeoutSeconds_ = 0;
+    int writeError_ = 0;
+    bool peerClosed_ = false;
+    std::string outbound_;
+    std::string inbound_;
+    size_t inboundOffset_ = 0;
+};
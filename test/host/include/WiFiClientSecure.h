@@ -0,0 +1,59 @@
+/*
+ * SPDX-FileCopyrightText: 2026 André Fiedler
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include "WiFiClient.h"
+
+// Plaintext over loopback: certificate and handshake settings are recorded
+// but not enforced. Only routes registered with tls=true accept this client,
+// and plain WiFiClient connections to those routes fail.
+class WiFiClientSecure : public WiFiClient
+{
+public:
+    void setCACert(const char *rootCa)
+    {
+        caCert_ = rootCa;
+    }
+
+    void setInsecure()
+    {
+        insecure_ = true;
+    }
+
+    void setHandshakeTimeout(unsigned long seconds)
+    {
+        handshakeTimeoutSeconds_ = seconds;
+    }
+
+    int lastError(char *buffer, const size_t size)
+    {
+        if (buffer && size)
+            buffer[0] = '\0';
+        return 0;
+    }
+
+    const char *caCert() const
+    {
+        return caCert_;
+    }
+
+    bool insecure() const
+    {
+        return insecure_;
+    }
+
+protected:
+    bool secureTransport() const override
+    {
+        return true;
+    }
+
+private:
+    const char *caCert_ = nullptr;
+    bool insecure_ = false;
+    unsigned long handshakeTimeoutSeconds_ = 0;
+};
@@ -0,0 +1,293 @@
+// SPDX-FileCopyrightText: 2026 André Fiedler
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Influx/InfluxBatchBuffer.h"
+#include "Influx/InfluxGzip.h"
+#include "Influx/InfluxLineProtocol.h"
+
+namespace
+{
+std::string format(const InfluxLineProtocol::Point &point)
+{
+    char buffer[InfluxLineProtocol::kMaxLineBytes];
+    const size_t length = InfluxLineProtocol::formatPoint(buffer, sizeof(buffer), point);
+    return std::string(buffer, length);
+}
+
+InfluxLineProtocol::Point samplePoint()
+{
+    InfluxLineProtocol::Point point;
+    point.measurement = "radpro";
+    point.deviceId = "A1B2C3";
+    point.cpm = "42.5";
+    point.doseRate = "0.27";
+    point.pulses = "123456";
+    point.seconds = 1760000000;
+    point.nanoseconds = 123456000;
+    return point;
+}
+
+void appendLine(InfluxBatchBuffer &buffer, const std::string &line, unsigned long nowMs)
+{
+    size_t capacity = 0;
+    size_t dropped = 0;
+    char *out = buffer.beginLine(capacity, dropped);
+    assert(line.size() <= capacity);
+    std::memcpy(out, line.data(), line.size());
+    buffer.commitLine(line.size(), nowMs);
+}
+
+// Decoder for the fixed-Huffman single-block members InfluxGzip produces.
+class FixedInflater
+{
+public:
+    explicit FixedInflater(const std::vector<uint8_t> &data) : data_(data) {}
+
+    bool inflate(std::string &out)
+    {
+        if (data_.size() < InfluxGzip::kHeaderBytes + InfluxGzip::kTrailerBytes ||
+            data_[0] != 0x1F || data_[1] != 0x8B || data_[2] != 0x08)
+            return false;
+        pos_ = InfluxGzip::kHeaderBytes * 8;
+        if (bits(1) != 1 || bits(2) != 1)
+            return false;
+
+        while (true)
+        {
+            const unsigned symbol = literalLength();
+            if (symbol < 256)
+            {
+                out.push_back(static_cast<char>(symbol));
+                continue;
+            }
+            if (symbol == 256)
+                break;
+            const unsigned lengthIndex = symbol - 257;
+            const size_t length = InfluxGzip::detail::kLengthBase[lengthIndex] + bits(InfluxGzip::detail::kLengthExtra[lengthIndex]);
+            const unsigned distanceIndex = code(5);
+            const size_t distance = InfluxGzip::detail::kDistanceBase[distanceIndex] + bits(InfluxGzip::detail::kDistanceExtra[distanceIndex]);
+            if (distance > out.size())
+                return false;
+            for (size_t i = 0; i < length; ++i)
+                out.push_back(out[out.size() - distance]);
+        }
+
+        const size_t trailer = (pos_ + 7) / 8;
+        if (trailer + InfluxGzip::kTrailerBytes != data_.size())
+            return false;
+        const uint32_t crc = le32(trailer);
+        const uint32_t size = le32(trailer + 4);
+        return crc == InfluxGzip::crc32(reinterpret_cast<const uint8_t *>(out.data()), out.size()) && size == out.size();
+    }
+
+private:
+    uint32_t bits(unsigned count)
+    {
+        uint32_t value = 0;
+        for (unsigned i = 0; i < count; ++i, ++pos_)
+            value |= static_cast<uint32_t>((data_[pos_ / 8] >> (pos_ % 8)) & 1u) << i;
+        return value;
+    }
+
+    uint32_t code(unsigned count)
+    {
+        uint32_t value = 0;
+        for (unsigned i = 0; i < count; ++i)
+            value = (value << 1) | bits(1);
+        return value;
+    }
+
+    unsigned literalLength()
+    {
+        uint32_t value = code(7);
+        if (value <= 0x17)
+            return 256 + value;
+        value = (value << 1) | bits(1);
+        if (value >= 0x30 && value <= 0xBF)
+            return value - 0x30;
+        if (value >= 0xC0 && value <= 0xC7)
+            return 280 + (value - 0xC0);
+        value = (value << 1) | bits(1);
+        return 144 + (value - 0x190);
+    }
+
+    uint32_t le32(size_t offset) const
+    {
+        return static_cast<uint32_t>(data_[offset]) |
+               (static_cast<uint32_t>(data_[offset + 1]) << 8) |
+               (static_cast<uint32_t>(data_[offset + 2]) << 16) |
+               (static_cast<uint32_t>(data_[offset + 3]) << 24);
+    }
+
+    const std::vector<uint8_t> &data_;
+    size_t pos_ = 0;
+};
+
+std::vector<uint8_t> gzip(const std::string &input, size_t capacity = 8192)
+{
+    std::vector<uint8_t> out(capacity);
+    InfluxGzip::Workspace workspace;
+    const size_t length = InfluxGzip::compress(reinterpret_cast<const uint8_t *>(input.data()),
+                                               input.size(),
+                                               out.data(),
+                                               out.size(),
+                                               workspace);
+    out.resize(length);
+    return out;
+}
+
+void testFormatsAllFieldsWithNanosecondTimestamp()
+{
+    assert(format(samplePoint()) ==
+           "radpro,device=A1B2C3 cpm=42.5,dose_rate=0.27,pulses=123456i 1760000000123456000\n");
+}
+
+void testEscapesMeasurementAndTagText()
+{
+    InfluxLineProtocol::Point point = samplePoint();
+    point.measurement = "rad pro,x";
+    point.deviceId = "a=b c,d\n";
+    point.pulses = nullptr;
+    assert(format(point) ==
+           "rad\\ pro\\,x,device=a\\=b\\ c\\,d cpm=42.5,dose_rate=0.27 1760000000123456000\n");
+}
+
+void testSkipsInvalidFieldsAndEmptyTag()
+{
+    InfluxLineProtocol::Point point = samplePoint();
+    point.deviceId = "";
+    point.cpm = "nan";
+    point.pulses = "12.5";
+    point.nanoseconds = 7;
+    assert(format(point) == "radpro dose_rate=0.27 1760000000000000007\n");
+
+    point.doseRate = "";
+    assert(format(point).empty());
+}
+
+void testRejectsPointThatDoesNotFit()
+{
+    char buffer[32];
+    assert(InfluxLineProtocol::formatPoint(buffer, sizeof(buffer), samplePoint()) == 0);
+}
+
+void testBatchTakesWholeLinesUpToByteLimit()
+{
+    InfluxBatchBuffer buffer;
+    appendLine(buffer, "m v=1 1\n", 100);
+    appendLine(buffer, "m v=22 2\n", 200);
+    appendLine(buffer, "m v=333 3\n", 300);
+    assert(buffer.lineCount() == 3);
+    assert(buffer.oldestAgeMs(1100) == 1000);
+
+    size_t lines = 0;
+    assert(buffer.batchBytes(18, lines) == 17);
+    assert(lines == 2);
+    assert(std::string(buffer.data(), 17) == "m v=1 1\nm v=22 2\n");
+
+    buffer.consume(lines);
+    assert(buffer.lineCount() == 1);
+    assert(std::string(buffer.data(), buffer.size()) == "m v=333 3\n");
+    assert(buffer.oldestAgeMs(1100) == 800);
+}
+
+void testFullBufferDropsOldestLines()
+{
+    InfluxBatchBuffer buffer;
+    for (size_t i = 0; i < InfluxBatchBuffer::kMaxLines; ++i)
+        appendLine(buffer, "m v=" + std::to_string(i) + " 1\n", i);
+    assert(buffer.lineCount() == InfluxBatchBuffer::kMaxLines);
+
+    size_t capacity = 0;
+    size_t dropped = 0;
+    buffer.beginLine(capacity, dropped);
+    assert(dropped == 1);
+    assert(std::string(buffer.data(), 8) == "m v=1 1\n");
+
+    // Long lines run out of bytes before they run out of slots.
+    InfluxBatchBuffer bytes;
+    const std::string longLine = std::string(InfluxLineProtocol::kMaxLineBytes - 1, 'x') + "\n";
+    size_t total = 0;
+    for (int i = 0; i < 60; ++i)
+    {
+        bytes.beginLine(capacity, dropped);
+        total += dropped;
+        appendLine(bytes, longLine, 0);
+    }
+    assert(total > 0);
+    assert(bytes.size() <= InfluxBatchBuffer::kCapacityBytes);
+    assert(bytes.size() == bytes.lineCount() * longLine.size());
+}
+
+void testCrc32MatchesReferenceValue()
+{
+    assert(InfluxGzip::crc32(reinterpret_cast<const uint8_t *>("123456789"), 9) == 0xCBF43926u);
+}
+
+void testGzipRoundTripsRepetitiveBatch()
+{
+    std::string batch;
+    for (int i = 0; i < 30; ++i)
+    {
+        InfluxLineProtocol::Point point = samplePoint();
+        const std::string cpm = std::to_string(40 + i % 7) + ".5";
+        point.cpm = cpm.c_str();
+        point.seconds += static_cast<uint32_t>(i * 10);
+        batch += format(point);
+    }
+
+    const std::vector<uint8_t> packed = gzip(batch);
+    assert(!packed.empty());
+    assert(packed.size() * 3 < batch.size());
+
+    std::string unpacked;
+    FixedInflater inflater(packed);
+    assert(inflater.inflate(unpacked));
+    assert(unpacked == batch);
+}
+
+void testGzipRoundTripsHighBytesAndLongRuns()
+{
+    std::string input(600, 'a');
+    for (int i = 0; i < 256; ++i)
+        input.push_back(static_cast<char>(i));
+    input += std::string(300, 'a');
+
+    const std::vector<uint8_t> packed = gzip(input);
+    std::string unpacked;
+    FixedInflater inflater(packed);
+    assert(inflater.inflate(unpacked));
+    assert(unpacked == input);
+}
+
+void testGzipReportsOverflow()
+{
+    std::string input;
+    for (int i = 0; i < 400; ++i)
+        input.push_back(static_cast<char>((i * 131 + 7) & 0xFF));
+    assert(gzip(input, 64).empty());
+}
+} // namespace
+
+int main()
+{
+    testFormatsAllFieldsWithNanosecondTimestamp();
+    testEscapesMeasurementAndTagText();
+    testSkipsInvalidFieldsAndEmptyTag();
+    testRejectsPointThatDoesNotFit();
+    testBatchTakesWholeLinesUpToByteLimit();
+    testFullBufferDropsOldestLines();
+    testCrc32MatchesReferenceValue();
+    testGzipRoundTripsRepetitiveBatch();
+    testGzipRoundTripsHighBytesAndLongRuns();
+    testGzipReportsOverflow();
+    std::cout << "Influx line protocol tests passed\n";
+    return 0;
+}
@@ -63,6 +63,15 @@ void testStaleCursorRequestsReset()
     assert(window.oldestId == 201);
     assert(window.latestId == 203);
 }
+
+void testEvictedOnlyWhenLinesWereSkipped()
+{
+    assert(!LogCursorWindow::evicted(0, 500));
+    assert(!LogCursorWindow::evicted(10, 0));
+    assert(!LogCursorWindow::evicted(10, 11));
+    assert(!LogCursorWindow::evicted(20, 11));
+    assert(LogCursorWindow::evicted(10, 12));
+}
 } // namespace
 
 int main()
@@ -70,6 +79,7 @@ int main()
     testZeroCursorReturnsFullBuffer();
     testCursorReturnsOnlyNewEntries();
     testStaleCursorRequestsReset();
+    testEvictedOnlyWhenLinesWereSkipped();
     std::cout << "log cursor window tests passed\n";
     return 0;
 }
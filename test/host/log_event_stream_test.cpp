@@ -0,0 +1,70 @@
+// SPDX-FileCopyrightText: 2026 André Fiedler
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "Logging/LogEventStream.h"
+
+namespace
+{
+void testFramesLinesAsEvents()
+{
+    char buffer[80];
+    size_t used = LogEventStream::appendEvent(buffer, sizeof(buffer), 0, 9001, 42, "Wi-Fi connected", 15);
+    used = LogEventStream::appendEvent(buffer, sizeof(buffer), used, 9001, 43, "", 0);
+    assert(std::string(buffer, used) == "id: 9001-42\ndata: Wi-Fi connected\n\nid: 9001-43\ndata: \n\n");
+}
+
+void testLeavesBufferUntouchedWhenFull()
+{
+    char buffer[24];
+    const size_t used = LogEventStream::appendEvent(buffer, sizeof(buffer), 0, 1, 7, "short", 5);
+    assert(used == std::strlen("id: 1-7\ndata: short\n\n"));
+    assert(LogEventStream::appendEvent(buffer, sizeof(buffer), used, 1, 8, "next", 4) == used);
+    // Exactly full still fits.
+    char exact[21];
+    assert(LogEventStream::appendEvent(exact, sizeof(exact), 0, 1, 7, "short", 5) == 21);
+    assert(LogEventStream::appendEvent(exact, 20, 0, 1, 7, "short", 5) == 0);
+
+    const std::string longest(LogRing::kMaxLineLength, 'x');
+    char large[LogEventStream::kMaxEventBytes];
+    assert(LogEventStream::appendEvent(large, sizeof(large), 0, 4294967295u, 4294967295u, longest.data(), longest.size()) > 0);
+}
+
+void testParsesIdsFromThisBootOnly()
+{
+    uint32_t id = 99;
+    assert(LogEventStream::parseEventId("9001-42", 9001, id));
+    assert(id == 42);
+    assert(LogEventStream::parseEventId("9001-0", 9001, id));
+    assert(id == 0);
+
+    // Same line number, earlier boot: the client has not seen this boot's
+    // line 42, so it starts over.
+    id = 99;
+    assert(!LogEventStream::parseEventId("1234-42", 9001, id));
+    assert(id == 0);
+
+    const char *const invalid[] = {"", "42", "9001-", "-42", "9001-4x", "9001-4-2", "9001 42"};
+    for (const char *text : invalid)
+    {
+        id = 99;
+        assert(!LogEventStream::parseEventId(text, 9001, id));
+        assert(id == 0);
+    }
+    assert(!LogEventStream::parseEventId(nullptr, 9001, id));
+}
+} // namespace
+
+int main()
+{
+    testFramesLinesAsEvents();
+    testLeavesBufferUntouchedWhenFull();
+    testParsesIdsFromThisBootOnly();
+    std::cout << "Log event stream tests passed\n";
+    return 0;
+}
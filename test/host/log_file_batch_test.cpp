@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: 2026 André Fiedler
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <cassert>
+#include <iostream>
+#include <string>
+
+#include "Logging/LogFileBatch.h"
+
+namespace
+{
+bool add(LogFileBatch &batch, const std::string &text, uint32_t nowMs)
+{
+    return batch.add(text.data(), text.size(), nowMs);
+}
+
+void testCollectsLinesUntilFull()
+{
+    char buffer[16];
+    LogFileBatch batch;
+    assert(!add(batch, "x", 0));
+    batch.attach(buffer, sizeof(buffer));
+    assert(batch.empty());
+
+    assert(add(batch, "one", 0));
+    assert(add(batch, "two", 0));
+    assert(std::string(batch.data(), batch.size()) == "one\ntwo\n");
+    // 8 used, 8 free: "seventh" plus '\n' fits exactly, anything more not.
+    assert(!add(batch, "eighths!", 0));
+    assert(batch.size() == 8);
+    assert(add(batch, "seventh", 0));
+    assert(batch.size() == sizeof(buffer));
+}
+
+void testWritesWhenMostlyFullOrAged()
+{
+    char buffer[40];
+    LogFileBatch batch;
+    batch.attach(buffer, sizeof(buffer));
+    assert(!batch.due(0));
+
+    assert(add(batch, "short", 1000));
+    assert(!batch.due(1000));
+    assert(!batch.due(1000 + LogFileBatch::kMaxAgeMs - 1));
+    assert(batch.due(1000 + LogFileBatch::kMaxAgeMs));
+
+    batch.markWritten(2000);
+    assert(batch.empty());
+    // 30 of 40 bytes is mostly full, but the rate limit still holds it back.
+    assert(add(batch, std::string(29, 'a'), 3000));
+    assert(batch.mostlyFull());
+    assert(!batch.due(2000 + LogFileBatch::kMinWriteIntervalMs - 1));
+    assert(batch.due(2000 + LogFileBatch::kMinWriteIntervalMs));
+}
+
+void testFirstWriteIsNotRateLimited()
+{
+    char buffer[8];
+    LogFileBatch batch;
+    batch.attach(buffer, sizeof(buffer));
+    assert(add(batch, "abcdef", 5));
+    assert(batch.due(5));
+}
+} // namespace
+
+int main()
+{
+    testCollectsLinesUntilFull();
+    testWritesWhenMostlyFullOrAged();
+    testFirstWriteIsNotRateLimited();
+    std::cout << "Log file batch tests passed" << std::endl;
+    return 0;
+}
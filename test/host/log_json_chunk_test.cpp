@@ -0,0 +1,58 @@
+// SPDX-FileCopyrightText: 2026 André Fiedler
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "Logging/LogJsonChunk.h"
+
+namespace
+{
+size_t append(char *out, size_t capacity, size_t used, const std::string &text, bool first)
+{
+    return LogJsonChunk::appendLine(out, capacity, used, text.data(), text.size(), first);
+}
+
+void testEscapesLinesIntoArrayElements()
+{
+    char buffer[128];
+    size_t used = append(buffer, sizeof(buffer), 0, "MQTT: \"ok\"", true);
+    used = append(buffer, sizeof(buffer), used, "C:\\tmp\tx", false);
+    used = append(buffer, sizeof(buffer), used, std::string("bell\x07", 5), false);
+    used = append(buffer, sizeof(buffer), used, "", false);
+    used = append(buffer, sizeof(buffer), used, "µSv/h", false);
+    assert(std::string(buffer, used) ==
+           "\"MQTT: \\\"ok\\\"\",\"C:\\\\tmp\\tx\",\"bell\\u0007\",\"\",\"µSv/h\"");
+}
+
+void testLeavesBufferUntouchedWhenFull()
+{
+    char buffer[16];
+    const size_t used = append(buffer, sizeof(buffer), 0, "abc", true);
+    assert(used == 5);
+    assert(append(buffer, sizeof(buffer), used, "0123456789", false) == used);
+    assert(append(buffer, sizeof(buffer), used, "01234567", false) == sizeof(buffer));
+    // An escape that would straddle the end is not split.
+    assert(append(buffer, 7, 0, "ab\x01", true) == 0);
+}
+
+void testWorstCaseLineFits()
+{
+    const std::string line(LogRing::kMaxLineLength, '\x01');
+    char buffer[LogJsonChunk::kMaxLineBytes];
+    assert(append(buffer, sizeof(buffer), 0, line, false) == sizeof(buffer));
+    assert(append(buffer, sizeof(buffer) - 1, 0, line, false) == 0);
+}
+} // namespace
+
+int main()
+{
+    testEscapesLinesIntoArrayElements();
+    testLeavesBufferUntouchedWhenFull();
+    testWorstCaseLineFits();
+    std::cout << "Log JSON chunk tests passed\n";
+    return 0;
+}
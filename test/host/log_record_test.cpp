@@ -0,0 +1,160 @@
+// SPDX-FileCopyrightText: 2026 André Fiedler
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Logging/LogRecord.h"
+#include "Logging/LogRing.h"
+#include "Logging/StructuredLog.h"
+
+namespace
+{
+template <typename... Args>
+std::string render(LogLevel level, const char *tag, const char *format, const Args &...args)
+{
+    uint8_t record[LogRecord::kMaxRecordBytes];
+    const size_t length = LogRecord::encode(record, sizeof(record), level, tag, format, args...);
+    assert(length > 0);
+    char text[LogRecord::kMaxTextBytes];
+    const size_t textLength = LogRecord::format(record, length, text, sizeof(text));
+    assert(text[textLength] == '\0');
+    return std::string(text, textLength);
+}
+
+class CapturePrint : public Print
+{
+public:
+    size_t write(uint8_t ch) override
+    {
+        text.push_back(static_cast<char>(ch));
+        return 1;
+    }
+    std::string text;
+};
+
+class CaptureSink : public LogRecordSink
+{
+public:
+    void writeRecord(const uint8_t *record, size_t length) override
+    {
+        char text[LogRecord::kMaxTextBytes];
+        lines.push_back(std::string(text, LogRecord::format(record, length, text, sizeof(text))));
+    }
+    std::vector<std::string> lines;
+};
+
+void testFormatsArgumentsLikePrintf()
+{
+    const std::string command("GET tubeRate");
+    assert(render(LogLevel::Warn, "Device", "Command timeout: %s retry=%u", command, 2u) ==
+           "[W] Device: Command timeout: GET tubeRate retry=2");
+    assert(render(LogLevel::Info, "MQTT", "%d%% %5.2f|%-4s|%c|%x|%llu", -7, 3.14159, "ab", 'z', 255, 1ULL << 40) ==
+           "[I] MQTT: -7% " " 3.14|ab  |z|ff|1099511627776");
+    assert(render(LogLevel::Error, "T", "%.3s", "abcdef") == "[E] T: abc");
+    assert(render(LogLevel::Debug, "T", "no args") == "[D] T: no args");
+}
+
+void testUsesArgumentTypeOverSpecifier()
+{
+    // A wrong specifier prints the value instead of misreading it.
+    assert(render(LogLevel::Info, "T", "%s %d %f", 42, 2.5, "text") == "[I] T: 42 2.5 text");
+    assert(render(LogLevel::Info, "T", "%lu %ld", static_cast<uint8_t>(200), static_cast<int64_t>(-5)) == "[I] T: 200 -5");
+    assert(render(LogLevel::Info, "T", "%x", -1) == "[I] T: ffffffff");
+    // Missing arguments render as '?', extra ones are ignored.
+    assert(render(LogLevel::Info, "T", "%d and %d", 1) == "[I] T: 1 and ?");
+    assert(render(LogLevel::Info, "T", "one", 1, 2) == "[I] T: one");
+    const char *nothing = nullptr;
+    assert(render(LogLevel::Info, "T", "%s", nothing) == "[I] T: (null)");
+}
+
+void testCutsLongStringsAndFullRecords()
+{
+    const std::string longText(300, 'x');
+    const std::string line = render(LogLevel::Info, "T", "%s", longText);
+    assert(line == "[I] T: " + std::string(LogRecord::kMaxStringBytes, 'x'));
+
+    uint8_t small[40];
+    const size_t length = LogRecord::encode(small, sizeof(small), LogLevel::Info, "T", "%s|%d", longText, 5);
+    assert(length > 0 && length <= sizeof(small));
+    char text[64];
+    LogRecord::format(small, length, text, sizeof(text));
+    assert(std::string(text) == "[I] T: ?|?");
+
+    char tiny[10];
+    uint8_t record[LogRecord::kMaxRecordBytes];
+    const size_t recordLength = LogRecord::encode(record, sizeof(record), LogLevel::Info, "Tag", "%s", longText);
+    assert(LogRecord::format(record, recordLength, tiny, sizeof(tiny)) == sizeof(tiny) - 1);
+    assert(std::string(tiny) == "[I] Tag: ");
+}
+
+void testRingFormatsRecordsWhenRead()
+{
+    char arena[512];
+    LogRing::Slot slots[8];
+    LogRing ring;
+    ring.attach(arena, sizeof(arena), slots, 8);
+
+    const char text[] = "plain\nhalf";
+    ring.append(reinterpret_cast<const uint8_t *>(text), sizeof(text) - 1);
+    uint8_t record[LogRecord::kMaxRecordBytes];
+    const size_t length = LogRecord::encode(record, sizeof(record), LogLevel::Info, "USB", "rate=%d cpm", 42);
+    ring.appendRecord(record, length);
+    const char nul[] = {'a', '\0', 'b', '\n'};
+    ring.append(reinterpret_cast<const uint8_t *>(nul), sizeof(nul));
+
+    std::vector<std::string> lines;
+    ring.forEachAfter(0, [&lines](uint32_t, const char *line, size_t lineLength) {
+        lines.emplace_back(line, lineLength);
+        return true;
+    });
+    assert(lines.size() == 4);
+    assert(lines[0] == "plain");
+    assert(lines[1] == "half");
+    assert(lines[2] == "[I] USB: rate=42 cpm");
+    assert(lines[3] == "ab");
+}
+
+void testDispatchesToSinkOrFormatsInPlace()
+{
+    CapturePrint console;
+    CapturePrint other;
+    CaptureSink sink;
+    StructuredLog::attach(console, sink);
+
+    BRIDGE_LOGI(console, "MQTT", "connected in %lu ms", 120ul);
+    BRIDGE_LOGI(other, "MQTT", "connected in %lu ms", 80ul);
+    assert(console.text.empty());
+    assert(sink.lines.size() == 1 && sink.lines[0] == "[I] MQTT: connected in 120 ms");
+    assert(other.text == "[I] MQTT: connected in 80 ms\n");
+
+    // Debug is compiled out by default; the runtime level filters the rest.
+    int evaluated = 0;
+    BRIDGE_LOGD(console, "T", "%d", ++evaluated);
+    assert(evaluated == 0);
+    StructuredLog::setLevel(LogLevel::Warn);
+    BRIDGE_LOGI(console, "T", "hidden");
+    BRIDGE_LOGW(console, "T", "shown");
+    assert(sink.lines.size() == 2 && sink.lines[1] == "[W] T: shown");
+    StructuredLog::setLevel(LogLevel::Info);
+
+    StructuredLog::detach(sink);
+    BRIDGE_LOGE(console, "T", "direct");
+    assert(console.text == "[E] T: direct\n");
+}
+} // namespace
+
+int main()
+{
+    testFormatsArgumentsLikePrintf();
+    testUsesArgumentTypeOverSpecifier();
+    testCutsLongStringsAndFullRecords();
+    testRingFormatsRecordsWhenRead();
+    testDispatchesToSinkOrFormatsInPlace();
+    std::cout << "Log record tests passed\n";
+    return 0;
+}
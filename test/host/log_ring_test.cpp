@@ -0,0 +1,173 @@
+// SPDX-FileCopyrightText: 2026 André Fiedler
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Logging/LogRing.h"
+
+namespace
+{
+using Lines = std::vector<std::pair<uint32_t, std::string>>;
+
+void write(LogRing &ring, const std::string &text)
+{
+    ring.append(reinterpret_cast<const uint8_t *>(text.data()), text.size());
+}
+
+Lines lines(const LogRing &ring)
+{
+    Lines out;
+    ring.forEach([&out](uint32_t id, const char *text, size_t length) {
+        out.emplace_back(id, std::string(text, length));
+    });
+    return out;
+}
+
+void testSplitsLinesAndKeepsPendingText()
+{
+    char arena[256];
+    LogRing::Slot slots[8];
+    LogRing ring;
+    assert(!ring.ready());
+    ring.attach(arena, sizeof(arena), slots, 8);
+    assert(ring.ready());
+    assert(ring.latestId() == 0);
+
+    write(ring, "par");
+    assert(ring.count() == 1);
+    assert(ring.latestId() == 1);
+    write(ring, "tial\r\nnext\n\nopen");
+
+    const Lines stored = lines(ring);
+    assert(stored.size() == 4);
+    assert(stored[0] == std::make_pair(1u, std::string("partial")));
+    assert(stored[1] == std::make_pair(2u, std::string("next")));
+    assert(stored[2] == std::make_pair(3u, std::string("")));
+    assert(stored[3] == std::make_pair(4u, std::string("open")));
+    // The open line does not move the cursor while complete lines exist.
+    assert(ring.latestId() == 3);
+}
+
+void testEvictsWhenSlotsRunOut()
+{
+    char arena[256];
+    LogRing::Slot slots[3];
+    LogRing ring;
+    ring.attach(arena, sizeof(arena), slots, 3);
+    for (int i = 1; i <= 5; ++i)
+        write(ring, "line " + std::to_string(i) + "\n");
+
+    const Lines stored = lines(ring);
+    assert(stored.size() == 3);
+    assert(stored.front() == std::make_pair(3u, std::string("line 3")));
+    assert(stored.back() == std::make_pair(5u, std::string("line 5")));
+    assert(ring.latestId() == 5);
+}
+
+void testEvictsAndWrapsWhenArenaRunsOut()
+{
+    char arena[32];
+    LogRing::Slot slots[16];
+    LogRing ring;
+    ring.attach(arena, sizeof(arena), slots, 16);
+
+    // 10-byte lines: three fit, the fourth wraps around the arena end.
+    std::vector<std::string> written;
+    for (int i = 0; i < 20; ++i)
+    {
+        std::string line = "entry-" + std::to_string(1000 + i);
+        written.push_back(line);
+        write(ring, line + "\n");
+
+        const Lines stored = lines(ring);
+        assert(!stored.empty() && stored.size() <= 3);
+        size_t total = 0;
+        for (size_t j = 0; j < stored.size(); ++j)
+        {
+            const size_t index = written.size() - stored.size() + j;
+            assert(stored[j].first == index + 1);
+            assert(stored[j].second == written[index]);
+            total += stored[j].second.size();
+        }
+        assert(total <= sizeof(arena));
+    }
+}
+
+void testBreaksAndTruncatesLongLines()
+{
+    char arena[1024];
+    LogRing::Slot slots[8];
+    LogRing ring;
+    ring.attach(arena, sizeof(arena), slots, 8);
+    write(ring, std::string(LogRing::kMaxLineLength + 5, 'x') + "\n");
+
+    Lines stored = lines(ring);
+    assert(stored.size() == 2);
+    assert(stored[0].second.size() == LogRing::kMaxLineLength);
+    assert(stored[1].second == "xxxxx");
+
+    char tiny[8];
+    ring.attach(tiny, sizeof(tiny), slots, 8);
+    write(ring, "0123456789\n");
+    stored = lines(ring);
+    assert(stored.size() == 1);
+    assert(stored[0].second == "01234567");
+}
+
+void testForEachAfterSkipsToCursorAndStops()
+{
+    char arena[32];
+    LogRing::Slot slots[4];
+    LogRing ring;
+    ring.attach(arena, sizeof(arena), slots, 4);
+    assert(ring.oldestId() == 0);
+
+    // 10-byte lines wrap around the arena, as in the test above.
+    for (int i = 0; i < 6; ++i)
+        write(ring, "entry-" + std::to_string(1000 + i) + "\n");
+    write(ring, "open");
+    assert(ring.oldestId() == 4);
+
+    Lines seen;
+    auto collect = [&seen](uint32_t id, const char *text, size_t length) {
+        seen.emplace_back(id, std::string(text, length));
+        return true;
+    };
+    ring.forEachAfter(0, collect);
+    assert(seen.size() == 3);
+    assert(seen.front() == std::make_pair(4u, std::string("entry-1003")));
+    // The unterminated line is never streamed.
+    assert(seen.back() == std::make_pair(6u, std::string("entry-1005")));
+
+    seen.clear();
+    ring.forEachAfter(4, collect);
+    assert(seen.size() == 2 && seen.front().first == 5);
+    seen.clear();
+    ring.forEachAfter(6, collect);
+    ring.forEachAfter(99, collect);
+    assert(seen.empty());
+
+    ring.forEachAfter(0, [&seen](uint32_t id, const char *text, size_t length) {
+        seen.emplace_back(id, std::string(text, length));
+        return false;
+    });
+    assert(seen.size() == 1 && seen.front().first == 4);
+}
+} // namespace
+
+int main()
+{
+    testSplitsLinesAndKeepsPendingText();
+    testEvictsWhenSlotsRunOut();
+    testEvictsAndWrapsWhenArenaRunsOut();
+    testBreaksAndTruncatesLongLines();
+    testForEachAfterSkipsToCursorAndStops();
+    std::cout << "Log ring tests passed\n";
+    return 0;
+}
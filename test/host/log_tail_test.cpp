@@ -0,0 +1,125 @@
+// SPDX-FileCopyrightText: 2026 André Fiedler
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "Logging/LogTail.h"
+
+namespace
+{
+constexpr uint32_t kFirmware = 0x12345678;
+
+void write(LogTail &tail, const std::string &text)
+{
+    tail.append(reinterpret_cast<const uint8_t *>(text.data()), text.size());
+}
+
+template <typename... Args>
+void writeRecord(LogTail &tail, const char *tag, const char *format, const Args &...args)
+{
+    uint8_t record[LogRecord::kMaxRecordBytes];
+    const size_t length = LogRecord::encode(record, sizeof(record), LogLevel::Warn, tag, format, args...);
+    tail.appendRecord(record, length);
+}
+
+std::string render(const LogTail &tail)
+{
+    char out[1024];
+    return std::string(out, tail.render(out, sizeof(out)));
+}
+
+void testRendersTextAndRecordsInOrder()
+{
+    uint32_t memory[64];
+    LogTail tail;
+    tail.reset(memory, sizeof(memory), kFirmware);
+    assert(tail.ready() && tail.size() == 0);
+
+    write(tail, "boot\r\n");
+    writeRecord(tail, "MQTT", "queue full; %u dropped", 3u);
+    write(tail, std::string("a\0b\r\n", 5));
+    assert(render(tail) == "boot\r\n[W] MQTT: queue full; 3 dropped\r\nab\r\n");
+}
+
+void testEvictsWholeFramesAndSkipsTheCutLine()
+{
+    uint32_t memory[16]; // 64 bytes: 20 header, 44 data
+    LogTail tail;
+    tail.reset(memory, sizeof(memory), kFirmware);
+    assert(tail.capacity() == 44);
+
+    writeRecord(tail, "T", "%d", 1);
+    write(tail, "first line\n");
+    write(tail, "second line\n");
+    write(tail, "third line\n");
+    assert(tail.size() <= tail.capacity());
+    // The record went whole; "first line" lost its start and is skipped.
+    assert(render(tail) == "second line\nthird line\n");
+
+    // Text longer than the tail keeps its end.
+    write(tail, std::string(50, 'x') + "\n");
+    assert(tail.size() == tail.capacity());
+    assert(render(tail) == "");
+    write(tail, "next\n");
+    assert(render(tail) == "next\n");
+}
+
+void testAdoptsOnlyAWellFormedTailOfTheSameBuild()
+{
+    uint32_t memory[64];
+    {
+        LogTail tail;
+        tail.reset(memory, sizeof(memory), kFirmware);
+        write(tail, "before the reset\n");
+        writeRecord(tail, "Device", "timeout after %u ms", 500u);
+    }
+
+    LogTail adopted;
+    assert(adopted.adopt(memory, sizeof(memory), kFirmware));
+    assert(render(adopted) == "before the reset\n[W] Device: timeout after 500 ms\r\n");
+
+    LogTail otherBuild;
+    assert(!otherBuild.adopt(memory, sizeof(memory), kFirmware + 1));
+    assert(!otherBuild.ready() && render(otherBuild).empty());
+
+    // A frame whose length runs past the stored bytes is garbage.
+    uint32_t corrupt[64];
+    std::memcpy(corrupt, memory, sizeof(memory));
+    uint8_t *data = reinterpret_cast<uint8_t *>(corrupt) + sizeof(LogTail::Header);
+    const size_t frame = std::strlen("before the reset\n");
+    assert(data[frame] == LogTail::kFrameMarker);
+    data[frame + 1] = 0xFF;
+    LogTail broken;
+    assert(!broken.adopt(corrupt, sizeof(corrupt), kFirmware));
+
+    // Power-on garbage.
+    uint32_t noise[64];
+    std::memset(noise, 0xA5, sizeof(noise));
+    assert(!broken.adopt(noise, sizeof(noise), kFirmware));
+}
+
+void testRenderStopsAtCapacity()
+{
+    uint32_t memory[64];
+    LogTail tail;
+    tail.reset(memory, sizeof(memory), kFirmware);
+    writeRecord(tail, "Tag", "%s", "a message that will not fit");
+    char out[8];
+    assert(tail.render(out, sizeof(out)) == sizeof(out));
+    assert(std::string(out, sizeof(out)) == "[W] Tag:");
+}
+} // namespace
+
+int main()
+{
+    testRendersTextAndRecordsInOrder();
+    testEvictsWholeFramesAndSkipsTheCutLine();
+    testAdoptsOnlyAWellFormedTailOfTheSameBuild();
+    testRenderStopsAtCapacity();
+    std::cout << "Log tail tests passed" << std::endl;
+    return 0;
+}
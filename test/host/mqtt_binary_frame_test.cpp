@@ -0,0 +1,95 @@
+// SPDX-FileCopyrightText: 2026 André Fiedler
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+
+#include "Mqtt/MqttBinaryFrame.h"
+
+namespace
+{
+void testEncodesFullCycleLittleEndian()
+{
+    MqttBinaryFrame frame;
+    assert(frame.empty());
+    frame.setTimestamp(1760000000);
+    assert(frame.set(MqttBinaryFrame::DevicePower, "1"));
+    assert(frame.set(MqttBinaryFrame::TubePulseCount, "123456"));
+    assert(frame.set(MqttBinaryFrame::TubeRate, "42.5"));
+    assert(frame.set(MqttBinaryFrame::TubeDoseRate, "0.28051"));
+    assert(frame.set(MqttBinaryFrame::BatteryVoltage, "4.125"));
+    assert(frame.set(MqttBinaryFrame::BatteryPercent, "93"));
+
+    uint8_t out[MqttBinaryFrame::kFrameBytes];
+    assert(frame.encode(out, sizeof(out), 0x01020304) == MqttBinaryFrame::kFrameBytes);
+    assert(out[0] == MqttBinaryFrame::kVersion);
+    assert(out[1] == 0x3F);
+    assert(out[2] == 0x01);
+    assert(out[3] == 0);
+    assert(out[4] == 0x04 && out[5] == 0x03 && out[6] == 0x02 && out[7] == 0x01);
+    // 42.5f is 0x422A0000.
+    assert(out[12] == 0x00 && out[13] == 0x00 && out[14] == 0x2A && out[15] == 0x42);
+
+    MqttBinaryFrame::Decoded decoded;
+    assert(MqttBinaryFrame::decode(out, sizeof(out), decoded));
+    assert(decoded.sequence == 0x01020304);
+    assert(decoded.timestamp == 1760000000);
+    assert(decoded.powerOn);
+    assert(decoded.pulseCount == 123456);
+    assert(decoded.tubeRate == 42.5f);
+    assert(std::fabs(decoded.doseRate - 0.28051f) < 1e-6f);
+    assert(decoded.batteryVoltage == 4.125f);
+    assert(decoded.batteryPercent == 93.0f);
+}
+
+void testAbsentAndInvalidFieldsStayOutOfTheMask()
+{
+    MqttBinaryFrame frame;
+    assert(frame.set(MqttBinaryFrame::TubeRate, "12"));
+    assert(!frame.set(MqttBinaryFrame::TubeDoseRate, "n/a"));
+    assert(!frame.set(MqttBinaryFrame::TubePulseCount, "-5"));
+    assert(!frame.set(MqttBinaryFrame::DevicePower, "ON"));
+    assert(!frame.set(MqttBinaryFrame::BatteryVoltage, "inf"));
+    assert(!frame.set(MqttBinaryFrame::BatteryPercent, ""));
+    assert(frame.has(MqttBinaryFrame::TubeRate));
+    assert(!frame.has(MqttBinaryFrame::TubeDoseRate));
+
+    uint8_t out[MqttBinaryFrame::kFrameBytes];
+    assert(frame.encode(out, sizeof(out), 7) == MqttBinaryFrame::kFrameBytes);
+    MqttBinaryFrame::Decoded decoded;
+    assert(MqttBinaryFrame::decode(out, sizeof(out), decoded));
+    assert(decoded.mask == 0x01);
+    assert(!decoded.powerOn);
+    assert(decoded.timestamp == 0);
+    assert(decoded.doseRate == 0.0f && decoded.pulseCount == 0);
+
+    frame.clear();
+    assert(frame.empty());
+    assert(!frame.has(MqttBinaryFrame::TubeRate));
+}
+
+void testRejectsShortBuffersAndUnknownVersions()
+{
+    MqttBinaryFrame frame;
+    frame.set(MqttBinaryFrame::TubeRate, "1");
+    uint8_t out[MqttBinaryFrame::kFrameBytes];
+    assert(frame.encode(out, sizeof(out) - 1, 1) == 0);
+    assert(frame.encode(out, sizeof(out), 1) == sizeof(out));
+
+    MqttBinaryFrame::Decoded decoded;
+    assert(!MqttBinaryFrame::decode(out, sizeof(out) - 1, decoded));
+    out[0] = MqttBinaryFrame::kVersion + 1;
+    assert(!MqttBinaryFrame::decode(out, sizeof(out), decoded));
+}
+} // namespace
+
+int main()
+{
+    testEncodesFullCycleLittleEndian();
+    testAbsentAndInvalidFieldsStayOutOfTheMask();
+    testRejectsShortBuffersAndUnknownVersions();
+    std::cout << "MQTT binary frame tests passed\n";
+    return 0;
+}
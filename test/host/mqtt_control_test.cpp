@@ -0,0 +1,96 @@
+// SPDX-FileCopyrightText: 2026 André Fiedler
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "Mqtt/MqttControl.h"
+#include "Runtime/ReadIntervalOverride.h"
+
+namespace
+{
+const char *parse(const char *command, const std::string &payload, MqttControlRequest &request)
+{
+    return MqttControlRequest::parse(command,
+                                     reinterpret_cast<const uint8_t *>(payload.data()),
+                                     payload.size(),
+                                     500,
+                                     request);
+}
+
+void testParsesIntervalRequests()
+{
+    MqttControlRequest request;
+    assert(parse("interval", "1000 600", request) == nullptr);
+    assert(request.kind == MqttControlRequest::Kind::Interval);
+    assert(request.intervalMs == 1000 && request.durationSeconds == 600);
+
+    assert(parse("interval", " 750\n", request) == nullptr);
+    assert(request.intervalMs == 750 && request.durationSeconds == 0);
+
+    assert(parse("interval", "default", request) == nullptr);
+    assert(request.intervalMs == 0);
+    assert(parse("interval", "", request) == nullptr);
+    assert(request.intervalMs == 0);
+    assert(parse("interval", "0", request) == nullptr);
+    assert(request.intervalMs == 0);
+
+    assert(std::strcmp(parse("interval", "100", request), "interval below minimum") == 0);
+    assert(parse("interval", "fast", request) != nullptr);
+    assert(parse("interval", "1000 ten", request) != nullptr);
+    assert(parse("interval", "1000 60 5", request) != nullptr);
+}
+
+void testParsesDeviceRequests()
+{
+    MqttControlRequest request;
+    assert(parse("datalog", "", request) == nullptr);
+    assert(request.kind == MqttControlRequest::Kind::DataLog);
+    assert(request.args[0] == '\0');
+    assert(parse("datalog", "1760000000", request) == nullptr);
+    assert(std::strcmp(request.args, "1760000000") == 0);
+    assert(parse("datalog", "1\nSET x", request) != nullptr);
+    assert(parse("datalog", std::string(40, '1'), request) != nullptr);
+
+    assert(parse("randomdata", "", request) == nullptr);
+    assert(request.kind == MqttControlRequest::Kind::RandomData);
+    assert(parse("poll", "", request) == nullptr);
+    assert(request.kind == MqttControlRequest::Kind::Poll);
+    assert(parse("republish", "1", request) == nullptr);
+    assert(request.kind == MqttControlRequest::Kind::Republish);
+    assert(std::strcmp(MqttControlRequest::name(request.kind), "republish") == 0);
+
+    assert(std::strcmp(parse("reboot", "", request), "unknown command") == 0);
+    assert(std::strcmp(parse("interval", std::string(100, '1'), request), "payload too long") == 0);
+}
+
+void testReadIntervalOverrideLapses()
+{
+    ReadIntervalOverride override;
+    assert(override.effective(60000, 0) == 60000);
+
+    override.set(1000, 10000, 0xFFFFF000u);
+    assert(override.effective(60000, 0xFFFFF000u + 9999u) == 1000);
+    assert(override.remainingMs(0xFFFFF000u + 4000u) == 6000);
+    assert(override.effective(60000, 0xFFFFF000u + 10000u) == 60000);
+    assert(!override.active(0xFFFFF000u + 10001u));
+
+    override.set(2000, 0, 5);
+    assert(override.effective(60000, 5 + 86400000u) == 2000);
+    assert(override.remainingMs(10) == 0);
+    override.set(0, 0, 10);
+    assert(override.effective(60000, 11) == 60000);
+}
+} // namespace
+
+int main()
+{
+    testParsesIntervalRequests();
+    testParsesDeviceRequests();
+    testReadIntervalOverrideLapses();
+    std::cout << "MQTT control tests passed\n";
+    return 0;
+}
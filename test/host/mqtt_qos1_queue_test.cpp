@@ -0,0 +1,137 @@
+// SPDX-FileCopyrightText: 2026 André Fiedler
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Mqtt/MqttOutboundQueue.h"
+#include "Mqtt/MqttQos1.h"
+
+namespace
+{
+void testEncodesQos1PublishHeader()
+{
+    uint8_t packet[64];
+    const size_t length = MqttQos1::encodePublishHeader(packet, sizeof(packet), "a/b", 0x1234, 5, true, false);
+    const std::vector<uint8_t> expected = {0x33, 12, 0x00, 0x03, 'a', '/', 'b', 0x12, 0x34};
+    assert(length == expected.size());
+    assert(std::vector<uint8_t>(packet, packet + length) == expected);
+
+    const size_t dupLength = MqttQos1::encodePublishHeader(packet, sizeof(packet), "a/b", 7, 5, false, true);
+    assert(dupLength == expected.size());
+    assert(packet[0] == (MqttQos1::kPublish | MqttQos1::kFlagQos1 | MqttQos1::kFlagDup));
+}
+
+void testEncodesMultiByteRemainingLength()
+{
+    uint8_t packet[16];
+    const size_t length = MqttQos1::encodePublishHeader(packet, sizeof(packet), "t", 1, 200, false, false);
+    // 2 + 1 + 2 + 200 = 205 -> 0xCD 0x01
+    assert(length == 1 + 2 + 2 + 1 + 2);
+    assert(packet[1] == 0xCD);
+    assert(packet[2] == 0x01);
+}
+
+void testRejectsInvalidHeaders()
+{
+    uint8_t packet[8];
+    assert(MqttQos1::encodePublishHeader(packet, sizeof(packet), "topic/too/long", 1, 1, false, false) == 0);
+    assert(MqttQos1::encodePublishHeader(packet, sizeof(packet), "t", 0, 1, false, false) == 0);
+    assert(MqttQos1::encodePublishHeader(packet, sizeof(packet), "", 1, 1, false, false) == 0);
+}
+
+void testFramerFindsPubAcksBetweenOtherPackets()
+{
+    MqttQos1::InboundFramer framer;
+    // CONNACK, PUBLISH with a 130-byte body, PINGRESP, PUBACK 0x0102.
+    std::vector<uint8_t> stream = {0x20, 0x02, 0x00, 0x00};
+    stream.push_back(0x30);
+    stream.push_back(0x82);
+    stream.push_back(0x01);
+    for (int i = 0; i < 130; ++i)
+        stream.push_back(0x40);
+    stream.insert(stream.end(), {0xD0, 0x00, 0x40, 0x02, 0x01, 0x02});
+
+    // Feed in uneven pieces to cover packets split across reads.
+    size_t pos = 0;
+    size_t step = 1;
+    while (pos < stream.size())
+    {
+        const size_t n = std::min(step, stream.size() - pos);
+        framer.feed(stream.data() + pos, n);
+        pos += n;
+        step = step % 7 + 2;
+    }
+
+    uint16_t id = 0;
+    assert(framer.takeAck(id));
+    assert(id == 0x0102);
+    assert(!framer.takeAck(id));
+}
+
+void testFramerKeepsNewestAcksWhenFull()
+{
+    MqttQos1::InboundFramer framer;
+    for (uint16_t i = 1; i <= MqttQos1::InboundFramer::kAckSlots + 2; ++i)
+    {
+        const uint8_t ack[] = {0x40, 0x02, static_cast<uint8_t>(i >> 8), static_cast<uint8_t>(i & 0xFF)};
+        framer.feed(ack, sizeof(ack));
+    }
+    uint16_t id = 0;
+    assert(framer.takeAck(id));
+    assert(id == 3);
+    framer.reset();
+    assert(!framer.takeAck(id));
+}
+
+void testQueueIsFifoAndBounded()
+{
+    MqttOutboundQueue queue;
+    assert(queue.push(1, "one", 3, true));
+    assert(queue.push(2, "two!", 4, false));
+    assert(queue.size() == 2);
+    assert(queue.bytes() == 7);
+
+    MqttOutboundQueue::Entry entry;
+    assert(queue.front(entry));
+    assert(entry.slot == 1 && entry.retain && std::string(entry.payload, entry.length) == "one");
+    queue.pop();
+    assert(queue.front(entry));
+    assert(entry.slot == 2 && !entry.retain && std::string(entry.payload, entry.length) == "two!");
+    queue.pop();
+    assert(queue.empty());
+    assert(!queue.front(entry));
+
+    const std::string big(MqttOutboundQueue::kMaxPayloadBytes, 'x');
+    size_t pushed = 0;
+    while (queue.push(0, big.data(), big.size(), false))
+        ++pushed;
+    assert(pushed == MqttOutboundQueue::kCapacityBytes / MqttOutboundQueue::kMaxPayloadBytes);
+    assert(!queue.push(0, big.data(), MqttOutboundQueue::kMaxPayloadBytes + 1, false));
+
+    queue.clear();
+    for (size_t i = 0; i < MqttOutboundQueue::kMaxEntries; ++i)
+        assert(queue.push(static_cast<uint8_t>(i), "1", 1, false));
+    assert(!queue.fits(1));
+    queue.pop();
+    assert(queue.push(200, "2", 1, false));
+    assert(queue.front(entry));
+    assert(entry.slot == 1);
+}
+} // namespace
+
+int main()
+{
+    testEncodesQos1PublishHeader();
+    testEncodesMultiByteRemainingLength();
+    testRejectsInvalidHeaders();
+    testFramerFindsPubAcksBetweenOtherPackets();
+    testFramerKeepsNewestAcksWhenFull();
+    testQueueIsFifoAndBounded();
+    std::cout << "MQTT QoS 1 queue tests passed\n";
+    return 0;
+}
@@ -0,0 +1,163 @@
+// SPDX-FileCopyrightText: 2026 André Fiedler
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Links MqttSpool.cpp.
+
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "Arduino.h"
+#include "LittleFS.h"
+#include "Mqtt/MqttSpool.h"
+
+namespace
+{
+class NullPrint : public Print
+{
+public:
+    size_t write(uint8_t) override { return 1; }
+};
+
+NullPrint g_log;
+
+void append(MqttSpool &spool, uint8_t slot, const char *payload)
+{
+    assert(spool.append(slot, payload, std::strlen(payload), false));
+}
+
+std::string take(MqttSpool &spool, uint8_t expectedSlot)
+{
+    uint8_t slot = 0;
+    bool retain = false;
+    char payload[64];
+    size_t length = 0;
+    assert(spool.take(slot, retain, payload, sizeof(payload), length));
+    assert(slot == expectedSlot);
+    return std::string(payload, length);
+}
+
+void testTakesRecordsInOrder()
+{
+    LittleFS.reset();
+    MqttSpool spool(g_log);
+    spool.begin();
+    assert(spool.empty());
+
+    append(spool, 1, "first");
+    append(spool, 2, "second");
+    assert(!spool.empty());
+    assert(take(spool, 1) == "first");
+    spool.commit();
+    assert(take(spool, 2) == "second");
+    assert(spool.empty());
+    assert(spool.pendingBytes() == 0);
+}
+
+void testFinalRecordSurvivesRebootUntilAcked()
+{
+    LittleFS.reset();
+    {
+        MqttSpool spool(g_log);
+        spool.begin();
+        append(spool, 3, "only");
+        assert(take(spool, 3) == "only");
+        // Taken but not acknowledged: the file must stay.
+        assert(spool.empty());
+        assert(LittleFS.exists(MqttSpool::kPath));
+    }
+
+    // Reboot before the PUBACK: the record is replayed.
+    MqttSpool spool(g_log);
+    spool.begin();
+    assert(!spool.empty());
+    assert(take(spool, 3) == "only");
+
+    // The ack for the final record removes the spool.
+    spool.commit();
+    assert(!LittleFS.exists(MqttSpool::kPath));
+    assert(!LittleFS.exists(MqttSpool::kOffsetPath));
+
+    MqttSpool afterAck(g_log);
+    afterAck.begin();
+    assert(afterAck.empty());
+}
+
+void testRebootResumesFromSavedAck()
+{
+    LittleFS.reset();
+    const size_t total = MqttSpool::kCommitEvery + 3;
+    {
+        MqttSpool spool(g_log);
+        spool.begin();
+        for (size_t i = 0; i < total; ++i)
+            append(spool, static_cast<uint8_t>(i), "x");
+        for (size_t i = 0; i < MqttSpool::kCommitEvery; ++i)
+        {
+            take(spool, static_cast<uint8_t>(i));
+            spool.commit();
+        }
+        // Delivered after the last save, then one in flight.
+        take(spool, MqttSpool::kCommitEvery);
+        spool.commit();
+        take(spool, MqttSpool::kCommitEvery + 1);
+    }
+
+    // Replay starts after the last saved ack, not at the file start.
+    MqttSpool spool(g_log);
+    spool.begin();
+    assert(take(spool, MqttSpool::kCommitEvery) == "x");
+    spool.commit();
+    assert(take(spool, MqttSpool::kCommitEvery + 1) == "x");
+    spool.commit();
+    assert(take(spool, MqttSpool::kCommitEvery + 2) == "x");
+    assert(LittleFS.exists(MqttSpool::kPath));
+    spool.commit();
+    assert(!LittleFS.exists(MqttSpool::kPath));
+}
+
+void testRewindTakesUnackedRecordAgain()
+{
+    LittleFS.reset();
+    MqttSpool spool(g_log);
+    spool.begin();
+    append(spool, 1, "a");
+    append(spool, 2, "b");
+    assert(take(spool, 1) == "a");
+    spool.commit();
+    assert(take(spool, 2) == "b");
+    spool.rewind();
+    assert(!spool.empty());
+    assert(take(spool, 2) == "b");
+    spool.commit();
+    assert(!LittleFS.exists(MqttSpool::kPath));
+}
+
+void testRecordsAppendedAfterLastTakeAreKept()
+{
+    LittleFS.reset();
+    MqttSpool spool(g_log);
+    spool.begin();
+    append(spool, 1, "a");
+    assert(take(spool, 1) == "a");
+    append(spool, 2, "b");
+    spool.commit();
+    assert(LittleFS.exists(MqttSpool::kPath));
+    assert(take(spool, 2) == "b");
+    spool.commit();
+    assert(!LittleFS.exists(MqttSpool::kPath));
+}
+} // namespace
+
+int main()
+{
+    testTakesRecordsInOrder();
+    testFinalRecordSurvivesRebootUntilAcked();
+    testRebootResumesFromSavedAck();
+    testRewindTakesUnackedRecordAgain();
+    testRecordsAppendedAfterLastTakeAreKept();
+    std::cout << "MQTT spool tests passed\n";
+    return 0;
+}
@@ -0,0 +1,105 @@
+// SPDX-FileCopyrightText: 2026 André Fiedler
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <cassert>
+#include <iostream>
+#include <string>
+
+#include "Mqtt/MqttStateAggregate.h"
+
+namespace
+{
+std::string render(const MqttStateAggregate &aggregate, uint32_t timestamp)
+{
+    char buffer[MqttStateAggregate::kMaxPayloadBytes];
+    const size_t length = aggregate.serialize(buffer, sizeof(buffer), timestamp);
+    return std::string(buffer, length);
+}
+
+void testRendersPollCycleWithTimestamp()
+{
+    MqttStateAggregate aggregate;
+    assert(aggregate.set("devicePower", "ON"));
+    assert(aggregate.set("tubePulseCount", "123456"));
+    assert(aggregate.set("tubeRate", "42.5"));
+    assert(aggregate.set("tubeDoseRate", "0.27000"));
+    assert(aggregate.set("deviceBatteryVoltage", "4.05"));
+    assert(aggregate.set("deviceBatteryPercent", "88"));
+
+    assert(render(aggregate, 1760000000) ==
+           "{\"ts\":1760000000,\"devicePower\":\"ON\",\"tubePulseCount\":123456,\"tubeRate\":42.5,"
+           "\"tubeDoseRate\":0.27000,\"deviceBatteryVoltage\":4.05,\"deviceBatteryPercent\":88}");
+}
+
+void testOmitsTimestampUntilClockIsSet()
+{
+    MqttStateAggregate aggregate;
+    assert(render(aggregate, 0) == "{}");
+    aggregate.set("tubeRate", "7");
+    assert(render(aggregate, 0) == "{\"tubeRate\":7}");
+}
+
+void testReplacesExistingLeaf()
+{
+    MqttStateAggregate aggregate;
+    aggregate.set("tubeRate", "1");
+    assert(aggregate.has("tubeRate"));
+    aggregate.set("tubeRate", "2");
+    assert(aggregate.fieldCount() == 1);
+    assert(render(aggregate, 5) == "{\"ts\":5,\"tubeRate\":2}");
+
+    aggregate.clear();
+    assert(aggregate.empty());
+    assert(!aggregate.has("tubeRate"));
+}
+
+void testQuotesAndEscapesNonNumbers()
+{
+    MqttStateAggregate aggregate;
+    aggregate.set("a", "01");
+    aggregate.set("b", ".5");
+    aggregate.set("c", "1e3");
+    aggregate.set("d", "say \"hi\"\\\n");
+    assert(render(aggregate, 0) == "{\"a\":\"01\",\"b\":\".5\",\"c\":1e3,\"d\":\"say \\\"hi\\\"\\\\\"}");
+}
+
+void testRejectsOversizedInput()
+{
+    MqttStateAggregate aggregate;
+    assert(!aggregate.set("tubeRate", std::string(MqttStateAggregate::kMaxValueBytes, '9').c_str()));
+    assert(aggregate.empty());
+
+    static const char *kLeaves[] = {"l0", "l1", "l2", "l3", "l4", "l5", "l6", "l7", "l8"};
+    for (size_t i = 0; i < MqttStateAggregate::kMaxFields; ++i)
+        assert(aggregate.set(kLeaves[i], "1"));
+    assert(!aggregate.set(kLeaves[MqttStateAggregate::kMaxFields], "1"));
+
+    char small[16];
+    assert(aggregate.serialize(small, sizeof(small), 0) == 0);
+}
+
+void testJsonNumberGrammar()
+{
+    assert(MqttStateAggregate::isJsonNumber("0"));
+    assert(MqttStateAggregate::isJsonNumber("-0.25"));
+    assert(MqttStateAggregate::isJsonNumber("12E-3"));
+    assert(!MqttStateAggregate::isJsonNumber(""));
+    assert(!MqttStateAggregate::isJsonNumber("-"));
+    assert(!MqttStateAggregate::isJsonNumber("1."));
+    assert(!MqttStateAggregate::isJsonNumber("+1"));
+    assert(!MqttStateAggregate::isJsonNumber("nan"));
+}
+} // namespace
+
+int main()
+{
+    testRendersPollCycleWithTimestamp();
+    testOmitsTimestampUntilClockIsSet();
+    testReplacesExistingLeaf();
+    testQuotesAndEscapesNonNumbers();
+    testRejectsOversizedInput();
+    testJsonNumberGrammar();
+    std::cout << "MQTT state aggregate tests passed\n";
+    return 0;
+}
@@ -0,0 +1,105 @@
+// SPDX-FileCopyrightText: 2026 André Fiedler
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Per-sample cost of formatting a dose rate: NumberFormat against the
+// printf float path and the String(float, decimals) conversion it replaces.
+// The String row goes through the host shim, so compare it for allocation
+// behaviour rather than absolute speed; on the ESP32 the same call runs
+// dtostrf plus a heap allocation.
+
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include "Arduino.h"
+#include "GmcMap/GmcMapPayload.h"
+#include "Publishing/NumberFormat.h"
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+volatile size_t sink = 0;
+
+float sampleDose(size_t i)
+{
+    return static_cast<float>(i % 20000) / 153.8f;
+}
+
+void report(const char *label, size_t iterations, Clock::duration elapsed)
+{
+    const double nanoseconds = std::chrono::duration<double, std::nano>(elapsed).count();
+    std::cout << label << ": " << iterations << " values in " << nanoseconds / 1e6 << " ms ("
+              << (iterations ? nanoseconds / iterations : 0.0) << " ns/value)\n";
+}
+
+void benchmarkNumberFormat(size_t iterations)
+{
+    char text[NumberFormat::kMaxChars];
+    const auto startedAt = Clock::now();
+    for (size_t i = 0; i < iterations; ++i)
+        sink = sink + NumberFormat::formatFixed(text, sizeof(text), sampleDose(i), 5);
+    report("NumberFormat::formatFixed", iterations, Clock::now() - startedAt);
+}
+
+void benchmarkSnprintf(size_t iterations)
+{
+    char text[NumberFormat::kMaxChars];
+    const auto startedAt = Clock::now();
+    for (size_t i = 0; i < iterations; ++i)
+        sink = sink + static_cast<size_t>(std::snprintf(text, sizeof(text), "%.5f", static_cast<double>(sampleDose(i))));
+    report("snprintf(\"%.5f\")", iterations, Clock::now() - startedAt);
+}
+
+void benchmarkArduinoString(size_t iterations)
+{
+    const auto startedAt = Clock::now();
+    for (size_t i = 0; i < iterations; ++i)
+        sink = sink + String(sampleDose(i), 5).length();
+    report("String(dose, 5) (host shim)", iterations, Clock::now() - startedAt);
+}
+
+void benchmarkGmcMapCpm(size_t iterations)
+{
+    char text[NumberFormat::kMaxChars];
+    auto startedAt = Clock::now();
+    for (size_t i = 0; i < iterations; ++i)
+        sink = sink + GmcMapPayload::formatCpm(text, sizeof(text), static_cast<float>(i % 5000) + 0.4f);
+    report("GmcMapPayload::formatCpm (buffer)", iterations, Clock::now() - startedAt);
+
+    startedAt = Clock::now();
+    for (size_t i = 0; i < iterations; ++i)
+        sink = sink + GmcMapPayload::formatCpm(static_cast<float>(i % 5000) + 0.4f).length();
+    report("GmcMapPayload::formatCpm (String)", iterations, Clock::now() - startedAt);
+}
+
+void checkSameText(size_t iterations)
+{
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        char ours[NumberFormat::kMaxChars];
+        NumberFormat::formatFixed(ours, sizeof(ours), sampleDose(i), 5);
+        const String reference(sampleDose(i), 5);
+        assert(std::strlen(ours) == reference.length());
+    }
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    // The argument is in thousands of values, matching the other benchmark's
+    // small default iteration counts.
+    const size_t thousands = argc > 1 ? static_cast<size_t>(std::strtoul(argv[1], nullptr, 10)) : 200;
+    const size_t iterations = thousands * 1000;
+
+    checkSameText(20000);
+    benchmarkNumberFormat(iterations);
+    benchmarkSnprintf(iterations);
+    benchmarkArduinoString(iterations);
+    benchmarkGmcMapCpm(iterations);
+    return sink == 0 ? 1 : 0;
+}
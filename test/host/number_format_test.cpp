@@ -0,0 +1,107 @@
+// SPDX-FileCopyrightText: 2026 André Fiedler
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "Publishing/NumberFormat.h"
+
+namespace
+{
+std::string fixed(double value, uint8_t decimals)
+{
+    char text[NumberFormat::kMaxChars];
+    const size_t length = NumberFormat::formatFixed(text, sizeof(text), value, decimals);
+    assert(length == std::strlen(text));
+    return text;
+}
+
+std::string printfFixed(double value, int decimals)
+{
+    char text[64];
+    std::snprintf(text, sizeof(text), "%.*f", decimals, value);
+    return text;
+}
+
+void testFixedMatchesPrintfForTelemetryValues()
+{
+    assert(fixed(0.28051f, 5) == "0.28051");
+    assert(fixed(42.5, 1) == "42.5");
+    assert(fixed(42.0, 0) == "42");
+    assert(fixed(4.05, 2) == "4.05");
+    assert(fixed(0.000004, 5) == "0.00000");
+    assert(fixed(-0.000004, 5) == "0.00000");
+    assert(fixed(-12.345678, 6) == "-12.345678");
+    assert(fixed(1234567.0, 3) == "1234567.000");
+
+    // Rate / sensitivity as computed in DeviceManager, over a typical range.
+    for (int cpm = 0; cpm < 20000; cpm += 7)
+    {
+        const float dose = static_cast<float>(cpm) / 153.8f;
+        const std::string ours = fixed(dose, 5);
+        const std::string reference = printfFixed(dose, 5);
+        // Exact ties may round the other way; anything else must match.
+        if (ours != reference)
+        {
+            const double scaled = static_cast<double>(dose) * 100000.0;
+            assert(std::fabs(scaled - std::floor(scaled) - 0.5) < 1e-6);
+        }
+    }
+}
+
+void testRoundsHalfAwayFromZero()
+{
+    assert(fixed(28.5, 0) == "29");
+    assert(fixed(28.49, 0) == "28");
+    assert(fixed(-28.5, 0) == "-29");
+    assert(fixed(0.125, 2) == "0.13");
+    assert(fixed(9.9999996, 6) == "10.000000");
+}
+
+void testSpecialValuesAndLimits()
+{
+    assert(fixed(NAN, 2) == "nan");
+    assert(fixed(INFINITY, 2) == "inf");
+    assert(fixed(-INFINITY, 2) == "-inf");
+    assert(fixed(1.5, 12) == "1.500000000");
+    assert(fixed(1e20, 1) == printfFixed(1e20, 1));
+
+    char small[4];
+    assert(NumberFormat::formatFixed(small, sizeof(small), 12.5, 1) == 0);
+    assert(small[0] == '\0');
+    assert(NumberFormat::formatFixed(small, sizeof(small), 2.5, 1) == 3);
+    assert(std::string(small) == "2.5");
+}
+
+void testIntegers()
+{
+    char text[NumberFormat::kMaxChars];
+    assert(NumberFormat::formatUnsigned(text, sizeof(text), 0) == 1 && std::string(text) == "0");
+    assert(NumberFormat::formatUnsigned(text, sizeof(text), 18446744073709551615ULL) == 20);
+    assert(std::string(text) == "18446744073709551615");
+    assert(NumberFormat::formatSigned(text, sizeof(text), -9223372036854775807LL - 1) == 20);
+    assert(std::string(text) == "-9223372036854775808");
+    assert(NumberFormat::formatUnsignedPadded(text, sizeof(text), 42, 9) == 9);
+    assert(std::string(text) == "000000042");
+
+    assert(std::string(NumberFormat::Unsigned(93).c_str()) == "93");
+    assert(std::string(NumberFormat::Signed(-7).c_str()) == "-7");
+    NumberFormat::Fixed dose(0.27, 5);
+    assert(dose.length() == 7 && std::string(dose.c_str()) == "0.27000");
+}
+} // namespace
+
+int main()
+{
+    testFixedMatchesPrintfForTelemetryValues();
+    testRoundsHalfAwayFromZero();
+    testSpecialValuesAndLimits();
+    testIntegers();
+    std::cout << "Number format tests passed\n";
+    return 0;
+}
@@ -8,10 +8,16 @@
 
 #include "OpenRadiation/OpenRadiationMeasurementWindow.h"
 
+using OpenRadiationMeasurementWindow::ClosedMeasurementWindow;
+using OpenRadiationMeasurementWindow::MeasurementBacklog;
 using OpenRadiationMeasurementWindow::MeasurementWindowState;
 using OpenRadiationMeasurementWindow::armMeasurementWindow;
 using OpenRadiationMeasurementWindow::clearMeasurementWindow;
 using OpenRadiationMeasurementWindow::hasMeasurementWindow;
+using OpenRadiationMeasurementWindow::kBacklogCapacity;
+using OpenRadiationMeasurementWindow::oldestClosedWindow;
+using OpenRadiationMeasurementWindow::popOldestClosedWindow;
+using OpenRadiationMeasurementWindow::pushClosedWindow;
 using OpenRadiationMeasurementWindow::replaceMeasurementWindow;
 
 namespace
@@ -64,6 +70,72 @@ void testReplaceClearsStaleWindowWhenTimestampIsMissing()
     assert(!hasMeasurementWindow(state));
     assert(std::string(state.startPulseCount.c_str()).empty());
 }
+
+ClosedMeasurementWindow makeClosedWindow(int index)
+{
+    ClosedMeasurementWindow window;
+    window.startTime = String("2026-04-17T18:") + String(10 + index) + ":00Z";
+    window.endTime = String("2026-04-17T18:") + String(10 + index) + ":05Z";
+    window.startPulseCount = String(100 * index);
+    window.endPulseCount = String(100 * index + 42);
+    window.doseRate = 0.1f * static_cast<float>(index + 1);
+    window.reportUuid = String("uuid-") + String(index);
+    return window;
+}
+
+void testBacklogDrainsClosedWindowsInOrder()
+{
+    MeasurementBacklog backlog;
+    bool dropped = true;
+    assert(pushClosedWindow(backlog, makeClosedWindow(1), dropped));
+    assert(!dropped);
+    assert(pushClosedWindow(backlog, makeClosedWindow(2), dropped));
+
+    assert(backlog.count == 2);
+    assert(std::string(oldestClosedWindow(backlog)->reportUuid.c_str()) == "uuid-1");
+    assert(std::string(oldestClosedWindow(backlog)->endTime.c_str()) == "2026-04-17T18:11:05Z");
+    popOldestClosedWindow(backlog);
+    assert(std::string(oldestClosedWindow(backlog)->reportUuid.c_str()) == "uuid-2");
+    popOldestClosedWindow(backlog);
+    assert(oldestClosedWindow(backlog) == nullptr);
+    popOldestClosedWindow(backlog);
+    assert(backlog.count == 0);
+}
+
+void testBacklogRejectsDuplicateAndMissingReportUuids()
+{
+    MeasurementBacklog backlog;
+    bool dropped = false;
+    assert(pushClosedWindow(backlog, makeClosedWindow(1), dropped));
+    assert(!pushClosedWindow(backlog, makeClosedWindow(1), dropped));
+
+    ClosedMeasurementWindow anonymous = makeClosedWindow(2);
+    anonymous.reportUuid = String();
+    assert(!pushClosedWindow(backlog, anonymous, dropped));
+    assert(backlog.count == 1);
+}
+
+void testFullBacklogOverwritesOldestWindow()
+{
+    MeasurementBacklog backlog;
+    bool dropped = false;
+    for (size_t i = 0; i < kBacklogCapacity; ++i)
+    {
+        assert(pushClosedWindow(backlog, makeClosedWindow(static_cast<int>(i)), dropped));
+        assert(!dropped);
+    }
+
+    assert(pushClosedWindow(backlog, makeClosedWindow(static_cast<int>(kBacklogCapacity)), dropped));
+    assert(dropped);
+    assert(backlog.count == kBacklogCapacity);
+    assert(std::string(oldestClosedWindow(backlog)->reportUuid.c_str()) == "uuid-1");
+
+    // The dropped UUID may be queued again; the newest stays last in line.
+    for (size_t i = 1; i < kBacklogCapacity; ++i)
+        popOldestClosedWindow(backlog);
+    assert(std::string(oldestClosedWindow(backlog)->reportUuid.c_str()) ==
+           std::string("uuid-") + std::to_string(kBacklogCapacity));
+}
 } // namespace
 
 int main()
@@ -73,6 +145,9 @@ int main()
     testEmptyTimestampDoesNotArmTheWindow();
     testReplaceRefreshesQueuedMeasurementWindow();
     testReplaceClearsStaleWindowWhenTimestampIsMissing();
+    testBacklogDrainsClosedWindowsInOrder();
+    testBacklogRejectsDuplicateAndMissingReportUuids();
+    testFullBacklogOverwritesOldestWindow();
     std::cout << "openradiation measurement window tests passed\n";
     return 0;
 }
@@ -43,6 +43,24 @@ void testReturnsEmptyLookupPathWhenInputsMissing()
     assert(std::string(OpenRadiationProtocol::buildMeasurementLookupPath("", "api-key").c_str()).empty());
     assert(std::string(OpenRadiationProtocol::buildMeasurementLookupPath("uuid", "").c_str()).empty());
 }
+
+void testOnlyNonRetryableClientErrorsArePermanentRejections()
+{
+    assert(OpenRadiationProtocol::isPermanentRejection(400));
+    assert(OpenRadiationProtocol::isPermanentRejection(409));
+    assert(OpenRadiationProtocol::isPermanentRejection(422));
+    assert(!OpenRadiationProtocol::isPermanentRejection(401));
+    assert(!OpenRadiationProtocol::isPermanentRejection(403));
+    assert(!OpenRadiationProtocol::isPermanentRejection(404));
+    assert(!OpenRadiationProtocol::isPermanentRejection(408));
+    assert(!OpenRadiationProtocol::isPermanentRejection(429));
+    assert(!OpenRadiationProtocol::isPermanentRejection(500));
+    assert(!OpenRadiationProtocol::isPermanentRejection(0));
+
+    assert(OpenRadiationProtocol::isAuthFailure(401));
+    assert(OpenRadiationProtocol::isAuthFailure(403));
+    assert(!OpenRadiationProtocol::isAuthFailure(400));
+}
 } // namespace
 
 int main()
@@ -52,6 +70,7 @@ int main()
     testDeviceIdFallbackIsUsedWhenConfigMissing();
     testBuildsMeasurementLookupPathFromTrimmedValues();
     testReturnsEmptyLookupPathWhenInputsMissing();
+    testOnlyNonRetryableClientErrorsArePermanentRejections();
     std::cout << "openradiation protocol tests passed\n";
     return 0;
 }
@@ -0,0 +1,87 @@
+// SPDX-FileCopyrightText: 2026 André Fiedler
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "ConfigPortal/PortalAssets.h"
+
+namespace
+{
+// Layout written by tools/compress_portal_assets.py.
+const std::string kManifest =
+    "3416561725b7ba3f /portal/js/backup-page.js\n"
+    "a9fbde45d0ddfc7b /portal/portal.css\r\n"
+    "f3c90e092e4f1911 /portal/locales/en.json";
+
+void testFindsHashesByExactPath()
+{
+    char hash[PortalAssets::kHashChars + 1];
+    assert(PortalAssets::findHash(kManifest.data(), kManifest.size(), "/portal/js/backup-page.js", hash));
+    assert(std::strcmp(hash, "3416561725b7ba3f") == 0);
+    assert(PortalAssets::findHash(kManifest.data(), kManifest.size(), "/portal/portal.css", hash));
+    assert(std::strcmp(hash, "a9fbde45d0ddfc7b") == 0);
+    assert(PortalAssets::findHash(kManifest.data(), kManifest.size(), "/portal/locales/en.json", hash));
+    assert(std::strcmp(hash, "f3c90e092e4f1911") == 0);
+
+    assert(!PortalAssets::findHash(kManifest.data(), kManifest.size(), "/portal/js/backup-page", hash));
+    assert(!PortalAssets::findHash(kManifest.data(), kManifest.size(), "/portal/locales/de.json", hash));
+    assert(!PortalAssets::findHash(kManifest.data(), kManifest.size(), "", hash));
+    assert(!PortalAssets::findHash(nullptr, 0, "/portal/portal.css", hash));
+
+    const std::string truncated = "a9fbde45d0dd";
+    assert(!PortalAssets::findHash(truncated.data(), truncated.size(), "/portal/portal.css", hash));
+}
+
+void testFormatsStrongEtags()
+{
+    char etag[PortalAssets::kEtagBytes];
+    PortalAssets::formatEtag("a9fbde45d0ddfc7b", false, etag);
+    assert(std::strcmp(etag, "\"a9fbde45d0ddfc7b\"") == 0);
+    PortalAssets::formatEtag("a9fbde45d0ddfc7b", true, etag);
+    assert(std::strcmp(etag, "\"a9fbde45d0ddfc7b-gz\"") == 0);
+}
+
+void testMatchesIfNoneMatch()
+{
+    const char *etag = "\"a9fbde45d0ddfc7b-gz\"";
+    assert(PortalAssets::etagMatches("\"a9fbde45d0ddfc7b-gz\"", etag));
+    assert(PortalAssets::etagMatches("W/\"a9fbde45d0ddfc7b-gz\"", etag));
+    assert(PortalAssets::etagMatches("\"old\", \"a9fbde45d0ddfc7b-gz\"", etag));
+    assert(PortalAssets::etagMatches(" * ", etag));
+    assert(PortalAssets::etagMatches("\"with,comma\",\"a9fbde45d0ddfc7b-gz\"", etag));
+
+    assert(!PortalAssets::etagMatches("\"a9fbde45d0ddfc7b\"", etag));
+    assert(!PortalAssets::etagMatches("", etag));
+    assert(!PortalAssets::etagMatches(nullptr, etag));
+    assert(!PortalAssets::etagMatches("*", ""));
+}
+
+void testAcceptsGzipUnlessRefused()
+{
+    assert(PortalAssets::acceptsGzip("gzip, deflate, br"));
+    assert(PortalAssets::acceptsGzip("br;q=1.0, gzip;q=0.8"));
+    assert(PortalAssets::acceptsGzip("x-gzip"));
+    assert(PortalAssets::acceptsGzip("deflate,gzip"));
+
+    assert(!PortalAssets::acceptsGzip("gzip;q=0"));
+    assert(!PortalAssets::acceptsGzip("gzip; q=0.000, deflate"));
+    assert(!PortalAssets::acceptsGzip("identity"));
+    assert(!PortalAssets::acceptsGzip("gzipped"));
+    assert(!PortalAssets::acceptsGzip(""));
+    assert(!PortalAssets::acceptsGzip(nullptr));
+}
+} // namespace
+
+int main()
+{
+    testFindsHashesByExactPath();
+    testFormatsStrongEtags();
+    testMatchesIfNoneMatch();
+    testAcceptsGzipUnlessRefused();
+    std::cout << "Portal asset tests passed" << std::endl;
+    return 0;
+}
@@ -27,6 +27,7 @@ function testPostFormsIncludeCsrfToken() {
     assertFormHasCsrfToken('data/portal/radmon.html', '/radmon')
     assertFormHasCsrfToken('data/portal/gmc.html', '/gmc')
     assertFormHasCsrfToken('data/portal/safecast.html', '/safecast')
+    assertFormHasCsrfToken('data/portal/influx.html', '/influx')
     assertFormHasCsrfToken('data/portal/backup.html', '/backup/restore')
 }
 
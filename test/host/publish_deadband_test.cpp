@@ -0,0 +1,95 @@
+// SPDX-FileCopyrightText: 2026 André Fiedler
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+
+#include "Publishing/PublishDeadband.h"
+
+namespace
+{
+void testParsesAbsoluteAndRelativeThresholds()
+{
+    DeadbandSpec spec;
+    assert(DeadbandSpec::parse("0.5", spec));
+    assert(spec.threshold == 0.5 && !spec.relative);
+    assert(DeadbandSpec::parse(" 5 % ", spec));
+    assert(spec.threshold == 5.0 && spec.relative);
+    assert(DeadbandSpec::parse("", spec));
+    assert(spec.threshold == 0.0 && !spec.relative);
+    assert(DeadbandSpec::parse(nullptr, spec));
+
+    assert(!DeadbandSpec::parse("abc", spec));
+    assert(!DeadbandSpec::parse("-1", spec));
+    assert(!DeadbandSpec::parse("5%%", spec));
+    assert(!DeadbandSpec::parse("1 V", spec));
+}
+
+void testAbsoluteDeadbandComparesAgainstLastPublished()
+{
+    DeadbandFilter filter;
+    DeadbandSpec spec;
+    DeadbandSpec::parse("1", spec);
+
+    assert(filter.shouldPublish(20.0, 0, spec, 0));
+    assert(!filter.shouldPublish(20.4, 1000, spec, 0));
+    // Slow drift adds up against the last published value.
+    assert(!filter.shouldPublish(20.8, 2000, spec, 0));
+    assert(filter.shouldPublish(21.0, 3000, spec, 0));
+    assert(!filter.shouldPublish(20.5, 4000, spec, 0));
+    assert(filter.shouldPublish(19.9, 5000, spec, 0));
+}
+
+void testRelativeDeadband()
+{
+    DeadbandFilter filter;
+    DeadbandSpec spec;
+    DeadbandSpec::parse("10%", spec);
+
+    assert(filter.shouldPublish(100.0, 0, spec, 0));
+    assert(!filter.shouldPublish(109.0, 1, spec, 0));
+    assert(filter.shouldPublish(90.0, 2, spec, 0));
+    assert(filter.shouldPublish(0.0, 3, spec, 0));
+    assert(!filter.shouldPublish(0.0, 4, spec, 0));
+    assert(filter.shouldPublish(0.1, 5, spec, 0));
+}
+
+void testZeroThresholdSkipsOnlyRepeats()
+{
+    DeadbandFilter filter;
+    const DeadbandSpec spec;
+    assert(filter.shouldPublish(1.0, 0, spec, 0));
+    assert(!filter.shouldPublish(1.0, 1, spec, 0));
+    assert(filter.shouldPublish(0.0, 2, spec, 0));
+}
+
+void testHeartbeatAndReset()
+{
+    DeadbandFilter filter;
+    DeadbandSpec spec;
+    DeadbandSpec::parse("100", spec);
+
+    assert(filter.shouldPublish(5.0, 0xFFFFF000u, spec, 60000));
+    assert(!filter.shouldPublish(5.0, 0xFFFFF000u + 59999u, spec, 60000));
+    // Survives millis() wrapping around.
+    assert(filter.shouldPublish(5.0, 0xFFFFF000u + 60000u, spec, 60000));
+    assert(!filter.shouldPublish(5.0, 0xFFFFF000u + 60001u, spec, 60000));
+
+    filter.reset();
+    assert(filter.shouldPublish(5.0, 1, spec, 60000));
+    assert(filter.shouldPublish(NAN, 2, spec, 60000));
+}
+} // namespace
+
+int main()
+{
+    testParsesAbsoluteAndRelativeThresholds();
+    testAbsoluteDeadbandComparesAgainstLastPublished();
+    testRelativeDeadband();
+    testZeroThresholdSkipsOnlyRepeats();
+    testHeartbeatAndReset();
+    std::cout << "Publish deadband tests passed\n";
+    return 0;
+}
@@ -6,6 +6,7 @@
 #include <iostream>
 #include <string>
 
+#include "Publishing/PublishPhaseTimer.h"
 #include "Publishing/PublisherHealth.h"
 
 namespace
@@ -68,6 +69,74 @@ void testTracksLastReportUuidSeparatelyFromSuccessCounters()
     health.noteFailure(4000, "temporary upstream error");
     assert(std::string(health.snapshot().lastReportUuid.c_str()) == "report-123");
 }
+
+void testLatencyHistogramReportsBucketPercentiles()
+{
+    LatencyHistogram histogram;
+    assert(histogram.percentileMs(50) == 0);
+
+    for (int i = 0; i < 90; ++i)
+        histogram.record(40);
+    for (int i = 0; i < 9; ++i)
+        histogram.record(700);
+    histogram.record(30000);
+
+    assert(histogram.count() == 100);
+    assert(histogram.maxMs() == 30000);
+    assert(histogram.percentileMs(50) == 50);
+    assert(histogram.percentileMs(95) == 1000);
+    assert(histogram.percentileMs(99) == 1000);
+    assert(histogram.percentileMs(100) == 30000);
+}
+
+void testPercentileIsCappedByObservedMaximum()
+{
+    LatencyHistogram histogram;
+    histogram.record(120);
+    histogram.record(130);
+
+    assert(histogram.percentileMs(50) == 130);
+    assert(histogram.percentileMs(99) == 130);
+}
+
+unsigned long g_fakeClockMs = 0;
+
+unsigned long fakeClock()
+{
+    return g_fakeClockMs;
+}
+
+void testPhaseTimerRecordsLapsAndTotal()
+{
+    PublisherHealth health;
+    g_fakeClockMs = 1000;
+    PublishPhaseTimer timer(&health, fakeClock);
+
+    g_fakeClockMs = 1008;
+    timer.lap(PublishPhase::Dns);
+    g_fakeClockMs = 1208;
+    timer.lap(PublishPhase::TlsHandshake);
+    g_fakeClockMs = 1220;
+    timer.lap(PublishPhase::RequestWrite);
+    g_fakeClockMs = 1620;
+    timer.lap(PublishPhase::FirstByte);
+    timer.finish();
+
+    const auto &latency = health.snapshot().latency;
+    assert(latency[static_cast<size_t>(PublishPhase::Dns)].maxMs() == 8);
+    assert(latency[static_cast<size_t>(PublishPhase::Connect)].count() == 0);
+    assert(latency[static_cast<size_t>(PublishPhase::TlsHandshake)].maxMs() == 200);
+    assert(latency[static_cast<size_t>(PublishPhase::RequestWrite)].maxMs() == 12);
+    assert(latency[static_cast<size_t>(PublishPhase::FirstByte)].maxMs() == 400);
+    assert(latency[static_cast<size_t>(PublishPhase::Total)].maxMs() == 620);
+}
+
+void testPhaseTimerWithoutHealthIsNoOp()
+{
+    PublishPhaseTimer timer(nullptr, fakeClock);
+    timer.lap(PublishPhase::Dns);
+    timer.finish();
+}
 } // namespace
 
 int main()
@@ -75,6 +144,10 @@ int main()
     testFailureTrackingCapturesErrorAndTrace();
     testSuccessResetsConsecutiveFailures();
     testTracksLastReportUuidSeparatelyFromSuccessCounters();
+    testLatencyHistogramReportsBucketPercentiles();
+    testPercentileIsCappedByObservedMaximum();
+    testPhaseTimerRecordsLapsAndTotal();
+    testPhaseTimerWithoutHealthIsNoOp();
     std::cout << "publisher health tests passed\n";
     return 0;
 }
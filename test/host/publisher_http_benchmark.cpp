@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: 2026 André Fiedler
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Loopback throughput of the Radmon publish path, compared with raw
+// keep-alive round trips through the same WiFiClient shim. Links
+// RadmonPublisher.cpp, AppConfig.cpp and CooperativePump.cpp; needs -pthread.
+
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+#include "Arduino.h"
+#include "Harness/LoopbackHttpServer.h"
+#include "Harness/LoopbackNetwork.h"
+#include "Publishing/HttpPublishResponse.h"
+#include "Radmon/RadmonPublisher.h"
+#include "Runtime/CooperativePump.h"
+#include "WiFi.h"
+
+namespace
+{
+class NullPrint : public Print
+{
+public:
+    size_t write(uint8_t) override
+    {
+        return 1;
+    }
+};
+
+using Clock = std::chrono::steady_clock;
+
+void report(const char *label, size_t requests, Clock::duration elapsed)
+{
+    const double seconds = std::chrono::duration<double>(elapsed).count();
+    std::cout << label << ": " << requests << " requests in " << seconds * 1000.0 << " ms ("
+              << (seconds > 0.0 ? requests / seconds : 0.0) << " req/s)\n";
+}
+
+void benchmarkRadmonPublishes(Harness::LoopbackHttpServer &server, size_t iterations)
+{
+    AppConfig config;
+    config.radmonEnabled = true;
+    config.radmonUser = "bench";
+    config.radmonPassword = "secret";
+    NullPrint log;
+    PublisherHealth health;
+    RadmonPublisher publisher(config, log, "bench", health);
+    publisher.begin();
+
+    server.clearRecords();
+    const auto startedAt = Clock::now();
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        advanceMillis(60001);
+        publisher.onCommandResult(DeviceManager::CommandType::TubeRate, "42");
+        publisher.onCommandResult(DeviceManager::CommandType::TubeDoseRate, "0.25");
+        publisher.loop();
+    }
+    report("radmon publish (connection per request)", iterations, Clock::now() - startedAt);
+
+    const auto snapshot = health.snapshot();
+    assert(snapshot.successes == iterations);
+    assert(server.connectionCount() == iterations);
+}
+
+void benchmarkKeepAliveRoundTrips(Harness::LoopbackHttpServer &server, size_t iterations)
+{
+    server.clearRecords();
+    WiFiClient client;
+    assert(client.connect("radmon.org", 80));
+
+    const auto startedAt = Clock::now();
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        client.print("GET /radmon.php HTTP/1.1\r\nHost: radmon.org\r\n\r\n");
+        const auto response = HttpPublishResponse::readStatus(
+            client, 10000, []() { return millis(); }, []() { CooperativePump::service(); });
+        assert(response.success);
+        String trace;
+        while (HttpPublishResponse::readLine(client, 0, trace).length() || client.available())
+        {
+        }
+    }
+    report("raw round trip (keep-alive)", iterations, Clock::now() - startedAt);
+    assert(server.connectionCount() == 1);
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const size_t iterations = argc > 1 ? static_cast<size_t>(std::strtoul(argv[1], nullptr, 10)) : 200;
+
+    Harness::LoopbackHttpServer server;
+    const bool started = server.start();
+    assert(started);
+    (void)started;
+    LoopbackNetwork::reset();
+    LoopbackNetwork::route("radmon.org", 80, server.port());
+    WiFi.setStatus(WL_CONNECTED);
+    // Fake time stands still while waiting, so no response can time out.
+    CooperativePump::setCallback([]() { std::this_thread::yield(); });
+
+    benchmarkRadmonPublishes(server, iterations);
+    benchmarkKeepAliveRoundTrips(server, iterations);
+
+    CooperativePump::clearCallback();
+    return 0;
+}
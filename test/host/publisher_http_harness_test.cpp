@@ -0,0 +1,477 @@
+// SPDX-FileCopyrightText: 2026 André Fiedler
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Links RadmonPublisher.cpp, GmcMapPublisher.cpp, InfluxPublisher.cpp,
+// AppConfig.cpp and CooperativePump.cpp; needs -pthread.
+
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "Arduino.h"
+#include "GmcMap/GmcMapPublisher.h"
+#include "Influx/InfluxPublisher.h"
+#include "Harness/LoopbackHttpServer.h"
+#include "Harness/LoopbackNetwork.h"
+#include "Publishing/HttpPublishResponse.h"
+#include "Radmon/RadmonPublisher.h"
+#include "Runtime/CooperativePump.h"
+#include "WiFi.h"
+#include "WiFiClientSecure.h"
+
+namespace
+{
+// Each cooperative pump tick sleeps 1 ms of wall time and advances the fake
+// clock by 10 ms, so the publishers' 10 s response timeout is about 1 s.
+constexpr unsigned long kFakeMsPerPump = 10;
+
+class CapturePrint : public Print
+{
+public:
+    size_t write(uint8_t ch) override
+    {
+        text.push_back(static_cast<char>(ch));
+        return 1;
+    }
+
+    bool contains(const char *needle) const
+    {
+        return text.find(needle) != std::string::npos;
+    }
+
+    std::string text;
+};
+
+void pumpWallClock()
+{
+    advanceMillis(kFakeMsPerPump);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+void prepareNetwork(Harness::LoopbackHttpServer &server, const char *host, uint16_t port, bool tls = false)
+{
+    const bool started = server.start();
+    assert(started);
+    (void)started;
+    LoopbackNetwork::reset();
+    LoopbackNetwork::route(host, port, server.port(), tls);
+    WiFi.setStatus(WL_CONNECTED);
+    CooperativePump::setCallback(&pumpWallClock);
+    setMillis(120000);
+}
+
+void configureRadmon(AppConfig &config)
+{
+    config.radmonEnabled = true;
+    config.radmonUser = "station one";
+    config.radmonPassword = "p&ss";
+}
+
+void queueRadmonReading(RadmonPublisher &publisher)
+{
+    publisher.onCommandResult(DeviceManager::CommandType::TubeRate, "42.5");
+    publisher.onCommandResult(DeviceManager::CommandType::TubeDoseRate, "0.27");
+}
+
+void testRadmonPublishReachesLoopbackEndpoint()
+{
+    Harness::LoopbackHttpServer server;
+    prepareNetwork(server, "radmon.org", 80);
+
+    AppConfig config;
+    configureRadmon(config);
+    CapturePrint log;
+    PublisherHealth health;
+    RadmonPublisher publisher(config, log, "1.2.3", health);
+    publisher.begin();
+    queueRadmonReading(publisher);
+    publisher.loop();
+
+    const auto requests = server.requests();
+    assert(requests.size() == 1);
+    assert(requests[0].method == "GET");
+    assert(requests[0].target ==
+           "/radmon.php?function=submit&user=station%20one&password=p%26ss"
+           "&value=42.5&unit=CPM&value2=0.27&unit2=uSv/h");
+    assert(requests[0].header("Host") == "radmon.org");
+    assert(requests[0].header("Connection") == "close");
+    assert(requests[0].header("User-Agent") == "RadPro-WiFi-Bridge/1.2.3");
+
+    const auto snapshot = health.snapshot();
+    assert(snapshot.successes == 1);
+    assert(snapshot.lastStatusCode == 200);
+    assert(!snapshot.pending);
+    assert(snapshot.latency[static_cast<size_t>(PublishPhase::Dns)].count() == 1);
+    assert(snapshot.latency[static_cast<size_t>(PublishPhase::Total)].count() == 1);
+    assert(!log.contains("p&ss"));
+}
+
+void testRadmonBacksOffAfterHttpErrorAndRetries()
+{
+    Harness::LoopbackHttpServer server;
+    prepareNetwork(server, "radmon.org", 80);
+    Harness::ScriptedResponse unavailable;
+    unavailable.status = 503;
+    unavailable.reason = "Service Unavailable";
+    server.enqueue(unavailable);
+
+    AppConfig config;
+    configureRadmon(config);
+    CapturePrint log;
+    PublisherHealth health;
+    RadmonPublisher publisher(config, log, "1.2.3", health);
+    publisher.begin();
+    queueRadmonReading(publisher);
+
+    publisher.loop();
+    assert(server.requestCount() == 1);
+    auto snapshot = health.snapshot();
+    assert(snapshot.failures == 1);
+    assert(snapshot.lastStatusCode == 503);
+    assert(snapshot.pending);
+    assert(log.contains("Radmon: HTTP 503"));
+
+    advanceMillis(30000);
+    publisher.loop();
+    assert(server.requestCount() == 1);
+
+    advanceMillis(31000);
+    publisher.loop();
+    assert(server.requestCount() == 2);
+    snapshot = health.snapshot();
+    assert(snapshot.successes == 1);
+    assert(snapshot.consecutiveFailures == 0);
+    assert(!snapshot.pending);
+}
+
+void testRadmonConnectionResetCountsAsNoResponse()
+{
+    Harness::LoopbackHttpServer server;
+    prepareNetwork(server, "radmon.org", 80);
+    Harness::ScriptedResponse reset;
+    reset.action = Harness::ResponseAction::Reset;
+    server.setDefaultResponse(reset);
+
+    AppConfig config;
+    configureRadmon(config);
+    CapturePrint log;
+    PublisherHealth health;
+    RadmonPublisher publisher(config, log, "1.2.3", health);
+    publisher.begin();
+    queueRadmonReading(publisher);
+    publisher.loop();
+
+    const auto snapshot = health.snapshot();
+    assert(snapshot.failures == 1);
+    assert(std::string(snapshot.lastError.c_str()) == "no response");
+    assert(log.contains("Radmon: no response before disconnect"));
+}
+
+void testRadmonTimesOutOnHungEndpoint()
+{
+    Harness::LoopbackHttpServer server;
+    prepareNetwork(server, "radmon.org", 80);
+    Harness::ScriptedResponse hang;
+    hang.action = Harness::ResponseAction::Hang;
+    server.setDefaultResponse(hang);
+
+    AppConfig config;
+    configureRadmon(config);
+    CapturePrint log;
+    PublisherHealth health;
+    RadmonPublisher publisher(config, log, "1.2.3", health);
+    publisher.begin();
+    queueRadmonReading(publisher);
+
+    const unsigned long startedAt = millis();
+    publisher.loop();
+    assert(millis() - startedAt >= 10000);
+
+    const auto snapshot = health.snapshot();
+    assert(snapshot.failures == 1);
+    assert(log.contains("Radmon: no response before timeout"));
+}
+
+void testRadmonFailsDnsForUnroutedHost()
+{
+    Harness::LoopbackHttpServer server;
+    prepareNetwork(server, "example.invalid", 80);
+
+    AppConfig config;
+    configureRadmon(config);
+    CapturePrint log;
+    PublisherHealth health;
+    RadmonPublisher publisher(config, log, "1.2.3", health);
+    publisher.begin();
+    queueRadmonReading(publisher);
+    publisher.loop();
+
+    assert(server.requestCount() == 0);
+    assert(LoopbackNetwork::stats().dnsFailures == 1);
+    assert(std::string(health.snapshot().lastError.c_str()) == "dns failed");
+}
+
+void testGmcMapParsesSlowDripResponse()
+{
+    Harness::LoopbackHttpServer server;
+    prepareNetwork(server, "www.gmcmap.com", 80);
+    Harness::ScriptedResponse drip;
+    drip.body = "<!--  sendmail.asp-->OK.ERR0";
+    drip.latencyMs = 20;
+    drip.dripIntervalMs = 1;
+    server.setDefaultResponse(drip);
+
+    AppConfig config;
+    config.gmcMapEnabled = true;
+    config.gmcMapAccountId = "12345";
+    config.gmcMapDeviceId = "67890";
+    CapturePrint log;
+    PublisherHealth health;
+    GmcMapPublisher publisher(config, log, "1.2.3", health);
+    publisher.begin();
+    publisher.onCommandResult(DeviceManager::CommandType::TubeRate, "30");
+    publisher.onCommandResult(DeviceManager::CommandType::TubeDoseRate, "0.19");
+    publisher.loop();
+
+    const auto requests = server.requests();
+    assert(requests.size() == 1);
+    assert(requests[0].target.find("/log2.asp?AID=12345&GID=67890&CPM=30") == 0);
+    assert(requests[0].header("Host") == "www.gmcmap.com");
+
+    const auto snapshot = health.snapshot();
+    assert(snapshot.successes == 1);
+    assert(snapshot.lastStatusCode == 200);
+}
+
+void configureInflux(AppConfig &config)
+{
+    config.influxEnabled = true;
+    config.influxUrl = "http://influx.local:8086/api/v2/write?org=home&bucket=rad&precision=ns";
+    config.influxToken = "t0ken";
+    config.influxPointIntervalSeconds = 1;
+    config.influxBatchPoints = 3;
+    config.influxGzip = false;
+}
+
+void queueInfluxCycle(InfluxPublisher &publisher, const char *cpm)
+{
+    advanceMillis(1000);
+    publisher.onCommandResult(DeviceManager::CommandType::TubeRate, cpm);
+    publisher.onCommandResult(DeviceManager::CommandType::TubePulseCount, "1200");
+    publisher.onCommandResult(DeviceManager::CommandType::TubeDoseRate, "0.25");
+}
+
+size_t countLines(const std::string &body)
+{
+    size_t lines = 0;
+    for (const char c : body)
+        lines += c == '\n' ? 1 : 0;
+    return lines;
+}
+
+Harness::ScriptedResponse noContent()
+{
+    Harness::ScriptedResponse response;
+    response.status = 204;
+    response.reason = "No Content";
+    return response;
+}
+
+void testInfluxSendsOneBatchedPost()
+{
+    Harness::LoopbackHttpServer server;
+    prepareNetwork(server, "influx.local", 8086);
+    server.setDefaultResponse(noContent());
+
+    AppConfig config;
+    configureInflux(config);
+    CapturePrint log;
+    PublisherHealth health;
+    InfluxPublisher publisher(config, log, "1.2.3", health);
+    publisher.begin();
+    publisher.onCommandResult(DeviceManager::CommandType::DeviceId, "A1B2C3");
+
+    queueInfluxCycle(publisher, "40");
+    queueInfluxCycle(publisher, "41");
+    publisher.loop();
+    assert(server.requestCount() == 0);
+
+    queueInfluxCycle(publisher, "42");
+    publisher.loop();
+
+    const auto requests = server.requests();
+    assert(requests.size() == 1);
+    assert(requests[0].method == "POST");
+    assert(requests[0].target == "/api/v2/write?org=home&bucket=rad&precision=ns");
+    assert(requests[0].header("Authorization") == "Token t0ken");
+    assert(requests[0].header("Content-Encoding").empty());
+    assert(countLines(requests[0].body) == 3);
+    assert(requests[0].body.find("radpro,device=A1B2C3 cpm=40,dose_rate=0.25,pulses=1200i 1") == 0);
+    assert(requests[0].body.find("cpm=42,") != std::string::npos);
+    assert(publisher.bufferedPoints() == 0);
+    assert(health.snapshot().lastStatusCode == 204);
+    assert(!health.snapshot().pending);
+    assert(!log.contains("t0ken"));
+}
+
+void testInfluxKeepsPointsThroughOutageAndDrains()
+{
+    Harness::LoopbackHttpServer server;
+    prepareNetwork(server, "influx.local", 8086);
+    server.setDefaultResponse(noContent());
+    Harness::ScriptedResponse unavailable;
+    unavailable.status = 503;
+    unavailable.reason = "Service Unavailable";
+    server.enqueue(unavailable);
+
+    AppConfig config;
+    configureInflux(config);
+    CapturePrint log;
+    PublisherHealth health;
+    InfluxPublisher publisher(config, log, "1.2.3", health);
+    publisher.begin();
+
+    WiFi.setStatus(WL_DISCONNECTED);
+    for (int i = 0; i < 80; ++i)
+    {
+        queueInfluxCycle(publisher, "40");
+        publisher.loop();
+    }
+    assert(server.requestCount() == 0);
+    assert(publisher.bufferedPoints() == 80);
+
+    WiFi.setStatus(WL_CONNECTED);
+    publisher.loop();
+    assert(server.requestCount() == 1);
+    assert(publisher.bufferedPoints() == 80);
+    assert(health.snapshot().pending);
+
+    // Backoff, then the backlog goes out in body-size-limited batches.
+    for (int i = 0; i < 10 && publisher.bufferedPoints(); ++i)
+    {
+        advanceMillis(30000);
+        publisher.loop();
+    }
+    const auto requests = server.requests();
+    assert(requests.size() == 3);
+    assert(requests[1].body.size() <= InfluxPublisher::kMaxBatchBytes);
+    assert(countLines(requests[1].body) + countLines(requests[2].body) == 80);
+    assert(publisher.bufferedPoints() == 0);
+    assert(!health.snapshot().pending);
+}
+
+void testInfluxFallsBackToPlainWhenGzipIsRefused()
+{
+    Harness::LoopbackHttpServer server;
+    prepareNetwork(server, "influx.local", 8086);
+    server.setDefaultResponse(noContent());
+    Harness::ScriptedResponse unsupported;
+    unsupported.status = 415;
+    unsupported.reason = "Unsupported Media Type";
+    server.enqueue(unsupported);
+
+    AppConfig config;
+    configureInflux(config);
+    config.influxGzip = true;
+    CapturePrint log;
+    PublisherHealth health;
+    InfluxPublisher publisher(config, log, "1.2.3", health);
+    publisher.begin();
+    for (int i = 0; i < 3; ++i)
+        queueInfluxCycle(publisher, "40");
+
+    publisher.loop();
+    publisher.loop();
+
+    const auto requests = server.requests();
+    assert(requests.size() == 2);
+    assert(requests[0].header("Content-Encoding") == "gzip");
+    assert(static_cast<unsigned char>(requests[0].body[0]) == 0x1F);
+    assert(static_cast<unsigned char>(requests[0].body[1]) == 0x8B);
+    assert(requests[0].body.size() < requests[1].body.size());
+    assert(requests[1].header("Content-Encoding").empty());
+    assert(countLines(requests[1].body) == 3);
+    assert(publisher.bufferedPoints() == 0);
+    assert(log.contains("sending uncompressed"));
+}
+
+void testKeepAliveServesSequentialRequestsOnOneConnection()
+{
+    Harness::LoopbackHttpServer server;
+    prepareNetwork(server, "api.example.org", 80);
+
+    WiFiClient client;
+    assert(client.connect("api.example.org", 80));
+    for (int i = 0; i < 3; ++i)
+    {
+        client.print("GET /ping HTTP/1.1\r\nHost: api.example.org\r\n\r\n");
+        const auto response = HttpPublishResponse::readStatus(
+            client, 10000, []() { return millis(); }, []() { CooperativePump::service(); });
+        assert(response.success);
+        // Skip headers up to the blank line; the default body is empty.
+        String trace;
+        while (HttpPublishResponse::readLine(client, 0, trace).length() || client.available())
+        {
+        }
+    }
+    client.stop();
+
+    assert(server.requestCount() == 3);
+    assert(server.connectionCount() == 1);
+}
+
+void testTlsRoutesOnlyAcceptSecureClient()
+{
+    Harness::LoopbackHttpServer server;
+    prepareNetwork(server, "api.safecast.org", 443, true);
+    Harness::ScriptedResponse created;
+    created.status = 201;
+    created.reason = "Created";
+    created.contentType = "application/json";
+    created.body = "{\"id\":1}";
+    server.setDefaultResponse(created);
+
+    WiFiClient plain;
+    assert(!plain.connect("api.safecast.org", 443));
+
+    WiFiClientSecure secure;
+    secure.setInsecure();
+    assert(secure.connect("api.safecast.org", 443));
+    const std::string body = "{\"value\":12}";
+    secure.print("POST /measurements.json?api_key=k HTTP/1.1\r\nHost: api.safecast.org\r\n"
+                 "Content-Type: application/json\r\nConnection: close\r\nContent-Length: ");
+    secure.print(String(static_cast<unsigned int>(body.size())));
+    secure.print("\r\n\r\n");
+    secure.print(body.c_str());
+    const auto response = HttpPublishResponse::readStatus(
+        secure, 10000, []() { return millis(); }, []() { CooperativePump::service(); });
+    assert(response.success);
+    assert(response.statusCode == 201);
+
+    const auto requests = server.requests();
+    assert(requests.size() == 1);
+    assert(requests[0].body == body);
+    assert(LoopbackNetwork::stats().connectFailures == 1);
+}
+} // namespace
+
+int main()
+{
+    testRadmonPublishReachesLoopbackEndpoint();
+    testRadmonBacksOffAfterHttpErrorAndRetries();
+    testRadmonConnectionResetCountsAsNoResponse();
+    testRadmonTimesOutOnHungEndpoint();
+    testRadmonFailsDnsForUnroutedHost();
+    testGmcMapParsesSlowDripResponse();
+    testInfluxSendsOneBatchedPost();
+    testInfluxKeepsPointsThroughOutageAndDrains();
+    testInfluxFallsBackToPlainWhenGzipIsRefused();
+    testKeepAliveServesSequentialRequestsOnOneConnection();
+    testTlsRoutesOnlyAcceptSecureClient();
+    CooperativePump::clearCallback();
+    std::cout << "Publisher HTTP harness tests passed\n";
+    return 0;
+}
@@ -0,0 +1,166 @@
+// SPDX-FileCopyrightText: 2026 André Fiedler
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <cassert>
+#include <iostream>
+#include <string>
+
+#include "Publishing/PublisherRegistry.h"
+
+namespace
+{
+enum class FakeCommand
+{
+    DeviceId,
+    TubeRate,
+    TubeDoseRate
+};
+
+struct FakePublisher
+{
+    bool enabled = true;
+    bool paused = false;
+    unsigned long loopCostMicros = 0;
+    int updateCalls = 0;
+    int loopCalls = 0;
+    int resultCalls = 0;
+    int clearCalls = 0;
+    FakeCommand lastType = FakeCommand::TubeRate;
+    std::string lastValue;
+
+    void updateConfig() { ++updateCalls; }
+    bool isEnabled() const { return enabled; }
+    void loop()
+    {
+        ++loopCalls;
+        advanceMicros(loopCostMicros);
+    }
+    void onCommandResult(FakeCommand type, const String &value)
+    {
+        ++resultCalls;
+        lastType = type;
+        lastValue = value.c_str();
+    }
+    void clearPendingData() { ++clearCalls; }
+    void setPaused(bool value) { paused = value; }
+};
+
+struct FirstPublisher : FakePublisher
+{
+    static constexpr const char *kPublisherName = "first";
+};
+
+struct SecondPublisher : FakePublisher
+{
+    static constexpr const char *kPublisherName = "second";
+};
+
+void testDispatchesToEveryEnabledPublisher()
+{
+    FirstPublisher first;
+    SecondPublisher second;
+    PublisherRegistry<FirstPublisher, SecondPublisher> registry(first, second);
+
+    assert(registry.size() == 2);
+    assert(std::string(registry.loopStats()[0].name) == "first");
+    assert(std::string(registry.loopStats()[1].name) == "second");
+
+    registry.updateConfig();
+    registry.loop();
+    registry.onCommandResult(FakeCommand::TubeDoseRate, "0.12");
+
+    assert(first.updateCalls == 1 && second.updateCalls == 1);
+    assert(first.loopCalls == 1 && second.loopCalls == 1);
+    assert(first.resultCalls == 1 && second.resultCalls == 1);
+    assert(second.lastType == FakeCommand::TubeDoseRate);
+    assert(second.lastValue == "0.12");
+}
+
+void testDisabledPublisherIsSkippedButStillReconfigured()
+{
+    FirstPublisher first;
+    SecondPublisher second;
+    second.enabled = false;
+    PublisherRegistry<FirstPublisher, SecondPublisher> registry(first, second);
+
+    registry.updateConfig();
+    registry.loop();
+    registry.onCommandResult(FakeCommand::TubeRate, "42");
+
+    assert(second.updateCalls == 1);
+    assert(second.loopCalls == 0);
+    assert(second.resultCalls == 0);
+    assert(!registry.loopStats()[1].enabled);
+    assert(registry.loopStats()[1].skipped == 1);
+
+    second.enabled = true;
+    registry.updateConfig();
+    registry.loop();
+    assert(second.loopCalls == 1);
+    assert(registry.loopStats()[1].enabled);
+}
+
+void testIdentityReachesDisabledPublishers()
+{
+    FirstPublisher first;
+    SecondPublisher second;
+    second.enabled = false;
+    PublisherRegistry<FirstPublisher, SecondPublisher> registry(first, second);
+
+    registry.updateConfig();
+    registry.onIdentityResult(FakeCommand::DeviceId, "RP-1");
+
+    assert(first.resultCalls == 1 && second.resultCalls == 1);
+    assert(second.lastType == FakeCommand::DeviceId);
+    assert(second.lastValue == "RP-1");
+}
+
+void testMeasuresLoopTimePerPublisher()
+{
+    FirstPublisher first;
+    SecondPublisher second;
+    first.loopCostMicros = 150;
+    second.loopCostMicros = 900;
+    PublisherRegistry<FirstPublisher, SecondPublisher> registry(first, second);
+
+    registry.updateConfig();
+    registry.loop();
+    first.loopCostMicros = 50;
+    registry.loop();
+
+    const PublisherLoopStats &firstStats = registry.loopStats()[0];
+    const PublisherLoopStats &secondStats = registry.loopStats()[1];
+    assert(firstStats.calls == 2);
+    assert(firstStats.lastMicros == 50);
+    assert(firstStats.maxMicros == 150);
+    assert(firstStats.totalMicros == 200);
+    assert(secondStats.lastMicros == 900);
+    assert(secondStats.totalMicros == 1800);
+}
+
+void testPauseAndClearReachAllPublishers()
+{
+    FirstPublisher first;
+    SecondPublisher second;
+    second.enabled = false;
+    PublisherRegistry<FirstPublisher, SecondPublisher> registry(first, second);
+
+    registry.setPaused(true);
+    registry.clearPendingData();
+
+    assert(first.paused && second.paused);
+    assert(first.clearCalls == 1 && second.clearCalls == 1);
+}
+} // namespace
+
+int main()
+{
+    testDispatchesToEveryEnabledPublisher();
+    testDisabledPublisherIsSkippedButStillReconfigured();
+    testIdentityReachesDisabledPublishers();
+    testMeasuresLoopTimePerPublisher();
+    testPauseAndClearReachAllPublishers();
+    std::cout << "publisher registry tests passed\n";
+    return 0;
+}
@@ -0,0 +1,89 @@
+// SPDX-FileCopyrightText: 2026 André Fiedler
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "Mqtt/TlsFingerprint.h"
+
+namespace
+{
+std::string separated(const char *separator)
+{
+    std::string text;
+    for (int i = 0; i < 32; ++i)
+    {
+        if (i)
+            text += separator;
+        char pair[3];
+        snprintf(pair, sizeof(pair), "%02X", i * 7);
+        text += pair;
+    }
+    return text;
+}
+
+void testParsesPlainAndSeparatedHex()
+{
+    uint8_t digest[TlsFingerprint::kBytes] = {};
+    std::string plain = separated("");
+    assert(TlsFingerprint::parse(plain.c_str(), digest));
+    for (int i = 0; i < 32; ++i)
+        assert(digest[i] == static_cast<uint8_t>(i * 7));
+
+    std::string colons = separated(":");
+    assert(colons.size() == TlsFingerprint::kMaxTextLength);
+    std::memset(digest, 0, sizeof(digest));
+    assert(TlsFingerprint::parse(colons.c_str(), digest));
+    assert(digest[31] == static_cast<uint8_t>(31 * 7));
+
+    std::string lower = separated(" ");
+    for (char &c : lower)
+        c = static_cast<char>(tolower(c));
+    assert(TlsFingerprint::parse(lower.c_str(), digest));
+}
+
+void testEmptyIsReportedSeparately()
+{
+    uint8_t digest[TlsFingerprint::kBytes] = {};
+    bool empty = false;
+    assert(!TlsFingerprint::parse("", digest, &empty));
+    assert(empty);
+    assert(!TlsFingerprint::parse(nullptr, digest, &empty));
+    assert(empty);
+    assert(!TlsFingerprint::parse(" : ", digest, &empty));
+    assert(empty);
+}
+
+void testRejectsMalformedInput()
+{
+    uint8_t digest[TlsFingerprint::kBytes] = {};
+    bool empty = true;
+    std::string plain = separated("");
+
+    assert(!TlsFingerprint::parse(plain.substr(0, 62).c_str(), digest, &empty));
+    assert(!empty);
+    assert(!TlsFingerprint::parse(plain.substr(0, 63).c_str(), digest));
+    assert(!TlsFingerprint::parse((plain + "00").c_str(), digest));
+
+    std::string bad = plain;
+    bad[10] = 'g';
+    assert(!TlsFingerprint::parse(bad.c_str(), digest));
+
+    // A separator may only sit between byte pairs.
+    std::string split = plain;
+    split.insert(1, ":");
+    assert(!TlsFingerprint::parse(split.c_str(), digest));
+}
+} // namespace
+
+int main()
+{
+    testParsesPlainAndSeparatedHex();
+    testEmptyIsReportedSeparately();
+    testRejectsMalformedInput();
+    std::cout << "TLS fingerprint tests passed\n";
+    return 0;
+}
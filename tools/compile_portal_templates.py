@@ -0,0 +1,167 @@
+# SPDX-FileCopyrightText: 2026 André Fiedler
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+
+"""
+Compiles data/portal/*.html into PortalTemplates.generated.h, a table of
+PortalTemplate::Template entries (see lib/AppSupport/ConfigPortal/
+PortalTemplate.h). Each page becomes its literal text in flash plus a
+segment list with {{PLACEHOLDER}} indices, so the portal streams pages
+without loading them into RAM. Values are HTML-escaped at render time;
+{{{PLACEHOLDER}}} marks a slot that takes markup. Quoted /portal/ asset
+URLs get ?v=<content hash> appended (see portal_assets.py), so a changed
+script or stylesheet has a new URL and the old one can be cached
+indefinitely. Each entry also records the hash of its source page, which
+the firmware compares with the LittleFS manifest to prefer a newer page
+from a filesystem-only update.
+
+Runs as a PlatformIO pre-build script (writes into $BUILD_DIR/generated and
+adds it to the include path) or standalone:
+
+    python3 tools/compile_portal_templates.py data/portal out.h
+"""
+
+import re
+import sys
+from pathlib import Path
+
+from portal_assets import asset_hash, asset_hashes, page_files
+
+# {{NAME}} is escaped, {{{NAME}}} is raw markup.
+PLACEHOLDER = re.compile(rb"\{\{(\{)?([A-Z0-9_]+)\}\}(?(1)\})")
+ASSET_URL = re.compile(rb"([\"'])(/portal/[^\"'?#\s]+)\1")
+MAX_SEGMENT_BYTES = 0xFFFF
+
+
+def _identifier(path: Path) -> str:
+    words = re.split(r"[^A-Za-z0-9]+", path.stem)
+    return "k" + "".join(word[:1].upper() + word[1:] for word in words if word)
+
+
+def _c_literal(data: bytes) -> str:
+    """
+    Renders bytes as adjacent C string literals, one per source line.
+    Octal escapes always use three digits so a following digit cannot
+    extend them.
+    """
+    lines = []
+    current = []
+    for byte in data:
+        if byte == 0x5C:
+            current.append("\\\\")
+        elif byte == 0x22:
+            current.append('\\"')
+        elif byte == 0x0A:
+            current.append("\\n")
+            lines.append("".join(current))
+            current = []
+            continue
+        elif 0x20 <= byte < 0x7F and byte != 0x3F:
+            # '?' is escaped to rule out trigraphs.
+            current.append(chr(byte))
+        else:
+            current.append(f"\\{byte:03o}")
+    if current:
+        lines.append("".join(current))
+    if not lines:
+        return '""'
+    return "\n    ".join(f'"{line}"' for line in lines)
+
+
+def _version_asset_urls(source: bytes, hashes: dict) -> bytes:
+    def versioned(match):
+        url = match.group(2).decode("utf-8")
+        if url not in hashes:
+            return match.group(0)
+        quote = match.group(1)
+        return quote + f"{url}?v={hashes[url]}".encode("utf-8") + quote
+
+    return ASSET_URL.sub(versioned, source)
+
+
+def _compile_page(path: Path, hashes: dict):
+    source = _version_asset_urls(path.read_bytes(), hashes)
+    text = bytearray()
+    fields = []
+    segments = []
+
+    def add_literal(chunk: bytes):
+        while chunk:
+            part = chunk[:MAX_SEGMENT_BYTES]
+            segments.append((len(text), len(part), -1, False))
+            text.extend(part)
+            chunk = chunk[MAX_SEGMENT_BYTES:]
+
+    position = 0
+    for match in PLACEHOLDER.finditer(source):
+        add_literal(source[position:match.start()])
+        name = "{{" + match.group(2).decode("ascii") + "}}"
+        if name not in fields:
+            fields.append(name)
+        segments.append((0, 0, fields.index(name), match.group(1) is not None))
+        position = match.end()
+    add_literal(source[position:])
+    return bytes(text), fields, segments
+
+
+def generate(portal_dir: Path, output: Path) -> None:
+    pages = page_files(portal_dir)
+    hashes = asset_hashes(portal_dir)
+    out = [
+        "// Generated by tools/compile_portal_templates.py from data/portal/*.html.",
+        "// Do not edit; rebuild instead.",
+        "",
+        "#pragma once",
+        "",
+        '#include "ConfigPortal/PortalTemplate.h"',
+        "",
+        "namespace PortalTemplates",
+        "{",
+    ]
+    entries = []
+    for page in pages:
+        name = _identifier(page)
+        text, fields, segments = _compile_page(page, hashes)
+        out.append(f"    // /portal/{page.name}: {len(text)} bytes of text, {len(fields)} placeholders")
+        out.append(f"    constexpr char {name}Text[] =")
+        out.append(f"    {_c_literal(text)};")
+        if fields:
+            field_list = ", ".join(f'"{field}"' for field in fields)
+            out.append(f"    constexpr const char *{name}Fields[] = {{{field_list}}};")
+        out.append(f"    constexpr PortalTemplate::Segment {name}Segments[] = {{")
+        for offset, length, field, raw in segments:
+            out.append(f"        {{{offset}, {length}, {field}, {'true' if raw else 'false'}}},")
+        out.append("    };")
+        out.append("")
+        fields_ref = f"{name}Fields" if fields else "nullptr"
+        entries.append(
+            f'        {{"/portal/{page.name}", "{asset_hash(page.read_bytes())}", {name}Text, {name}Segments, '
+            f"sizeof({name}Segments) / sizeof({name}Segments[0]), {fields_ref}, {len(fields)}}},"
+        )
+    out.append("    constexpr PortalTemplate::Template kAll[] = {")
+    out.extend(entries)
+    out.append("    };")
+    out.append("    constexpr size_t kCount = sizeof(kAll) / sizeof(kAll[0]);")
+    out.append("} // namespace PortalTemplates")
+    out.append("")
+
+    content = "\n".join(out)
+    output.parent.mkdir(parents=True, exist_ok=True)
+    # Leave the header untouched when nothing changed so it does not
+    # trigger a rebuild of the portal.
+    if output.exists() and output.read_text(encoding="utf-8") == content:
+        return
+    output.write_text(content, encoding="utf-8")
+    print(f"[compile_portal_templates] {len(pages)} pages -> {output}")
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 3:
+        sys.exit("usage: compile_portal_templates.py <portal dir> <output header>")
+    generate(Path(sys.argv[1]), Path(sys.argv[2]))
+else:
+    Import("env")  # Provided by PlatformIO
+
+    generated_dir = Path(env.subst("$BUILD_DIR")) / "generated"
+    generate(Path(env["PROJECT_DIR"]) / "data" / "portal", generated_dir / "PortalTemplates.generated.h")
+    env.Append(CPPPATH=[str(generated_dir)])
@@ -0,0 +1,66 @@
+# SPDX-FileCopyrightText: 2026 André Fiedler
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+
+"""
+Stores a gzip copy next to every portal script, stylesheet and locale in
+data/portal and writes data/portal/assets.sha, one line per asset or page:
+
+    <first 16 hex digits of the SHA-256 of the original> /portal/<path>
+
+The firmware serves the .gz copy with a strong ETag built from that hash
+(see lib/AppSupport/ConfigPortal/PortalAssets.h), and
+compile_portal_templates.py appends ?v=<hash> to the asset URLs in the
+pages so browsers can cache them for good. The HTML pages are listed too,
+without a .gz copy, so the firmware can tell when LittleFS holds a newer
+page than the one compiled in.
+
+Runs as a PlatformIO pre-build script, so the copies exist before the
+LittleFS image is built, or standalone:
+
+    python3 tools/compress_portal_assets.py data/portal
+"""
+
+import gzip
+import sys
+from pathlib import Path
+
+from portal_assets import MANIFEST_NAME, asset_files, asset_hash, asset_url, page_files
+
+
+def _write_if_changed(path: Path, data: bytes) -> bool:
+    if path.exists() and path.read_bytes() == data:
+        return False
+    path.write_bytes(data)
+    return True
+
+
+def compress(portal_dir: Path) -> None:
+    lines = []
+    changed = 0
+    for path in asset_files(portal_dir):
+        data = path.read_bytes()
+        # mtime=0 keeps the output identical between builds, so an unchanged
+        # asset does not alter the filesystem image.
+        packed = gzip.compress(data, compresslevel=9, mtime=0)
+        if _write_if_changed(path.with_name(path.name + ".gz"), packed):
+            changed += 1
+        lines.append(f"{asset_hash(data)} {asset_url(portal_dir, path)}\n")
+    for path in page_files(portal_dir):
+        lines.append(f"{asset_hash(path.read_bytes())} {asset_url(portal_dir, path)}\n")
+
+    manifest = "".join(lines).encode("ascii")
+    if _write_if_changed(portal_dir / MANIFEST_NAME, manifest):
+        changed += 1
+    if changed:
+        print(f"[compress_portal_assets] {len(lines)} manifest entries, {changed} files updated in {portal_dir}")
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 2:
+        sys.exit("usage: compress_portal_assets.py <portal dir>")
+    compress(Path(sys.argv[1]))
+else:
+    Import("env")  # Provided by PlatformIO
+
+    compress(Path(env["PROJECT_DIR"]) / "data" / "portal")
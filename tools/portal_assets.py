@@ -0,0 +1,43 @@
+# SPDX-FileCopyrightText: 2026 André Fiedler
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+
+"""
+Which files under data/portal are cacheable assets or pages and how their
+content hash is computed; shared by compress_portal_assets.py and
+compile_portal_templates.py so the manifest, the page URLs and the
+compiled pages agree.
+"""
+
+import hashlib
+from pathlib import Path
+
+ASSET_SUFFIXES = (".css", ".js", ".json")
+MANIFEST_NAME = "assets.sha"
+# Matches PortalAssets::kHashChars in the firmware.
+HASH_CHARS = 16
+
+
+def asset_files(portal_dir: Path):
+    return sorted(
+        path
+        for path in portal_dir.rglob("*")
+        if path.is_file() and path.suffix in ASSET_SUFFIXES
+    )
+
+
+def page_files(portal_dir: Path):
+    return sorted(portal_dir.glob("*.html"))
+
+
+def asset_url(portal_dir: Path, path: Path) -> str:
+    return "/portal/" + path.relative_to(portal_dir).as_posix()
+
+
+def asset_hash(data: bytes) -> str:
+    return hashlib.sha256(data).hexdigest()[:HASH_CHARS]
+
+
+def asset_hashes(portal_dir: Path) -> dict:
+    """Maps each asset URL to the hash of its content."""
+    return {asset_url(portal_dir, path): asset_hash(path.read_bytes()) for path in asset_files(portal_dir)}